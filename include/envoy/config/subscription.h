@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/api/v2/discovery.pb.h"
 #include "envoy/common/exception.h"
 #include "envoy/common/pure.h"
 #include "envoy/stats/stats_macros.h"
@@ -29,6 +30,21 @@ public:
   virtual void onConfigUpdate(const ResourceVector& resources,
                               const std::string& version_info) PURE;
 
+  /**
+   * Called when an incremental configuration update is received. Only subscriptions using the
+   * incremental xDS protocol deliver updates this way.
+   * @param added_resources resources that have been added or updated since the last update,
+   *        together with their per resource versions.
+   * @param removed_resources names of resources that have been removed since the last update.
+   * @param system_version_info aggregate version of the xDS server, for debugging only.
+   * @throw EnvoyException with reason if the configuration is rejected. Otherwise the configuration
+   *        is accepted and the per resource versions are reflected in subsequent requests.
+   */
+  virtual void
+  onConfigUpdate(const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+                 const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                 const std::string& system_version_info) PURE;
+
   /**
    * Called when either the Subscription is unable to fetch a config update or when onConfigUpdate
    * invokes an exception.
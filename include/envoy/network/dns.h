@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <list>
 #include <memory>
@@ -51,6 +52,30 @@ public:
    */
   virtual ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
                                   ResolveCb callback) PURE;
+
+  /**
+   * Called when a resolution attempt is complete, along with how long the result stays valid.
+   * @param address_list supplies the list of resolved IP addresses. The list will be empty if
+   *                     the resolution failed.
+   * @param ttl supplies the smallest TTL of the DNS records the addresses came from. It is zero if
+   *            the resolution failed or the addresses did not come from DNS records, e.g. for
+   *            numeric addresses and hosts file entries.
+   */
+  typedef std::function<void(const std::list<Address::InstanceConstSharedPtr>&& address_list,
+                             std::chrono::seconds ttl)>
+      ResolveWithTtlCb;
+
+  /**
+   * Initiate an async DNS resolution that also reports the TTL of the result.
+   * @param dns_name supplies the DNS name to lookup.
+   * @param dns_lookup_family the DNS IP version lookup policy.
+   * @param callback supplies the callback to invoke when the resolution is complete.
+   * @return if non-null, a handle that can be used to cancel the resolution.
+   *         This is only valid until the invocation of callback or ~DnsResolver().
+   */
+  virtual ActiveDnsQuery* resolveWithTtl(const std::string& dns_name,
+                                         DnsLookupFamily dns_lookup_family,
+                                         ResolveWithTtlCb callback) PURE;
 };
 
 typedef std::shared_ptr<DnsResolver> DnsResolverSharedPtr;
@@ -81,6 +81,13 @@ public:
    * @param event supplies the connection event
    */
   virtual void raiseEvent(ConnectionEvent event) PURE;
+
+  /**
+   * Attempt to write any data buffered for the connection. This can be used by a transport socket
+   * that deferred writes until some asynchronous operation, such as a step of a TLS handshake, has
+   * completed.
+   */
+  virtual void flushWriteBuffer() PURE;
 };
 
 /**
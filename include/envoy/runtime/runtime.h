@@ -38,6 +38,30 @@ public:
 
 typedef std::unique_ptr<RandomGenerator> RandomGeneratorPtr;
 
+/**
+ * A runtime key interned by Loader::internKey(). Snapshots keep the values of interned keys in an
+ * array indexed by index(), so looking up an interned key doesn't hash its name. Keys looked up
+ * on the data path should be interned when their config is loaded.
+ */
+class InternedKey {
+public:
+  InternedKey(const std::string& name, uint32_t index) : name_(name), index_(index) {}
+
+  /**
+   * @return const std::string& the runtime key.
+   */
+  const std::string& name() const { return name_; }
+
+  /**
+   * @return uint32_t the index of the key in the snapshots of the loader that interned it.
+   */
+  uint32_t index() const { return index_; }
+
+private:
+  std::string name_;
+  uint32_t index_;
+};
+
 /**
  * A snapshot of runtime data.
  */
@@ -48,6 +72,7 @@ public:
   struct Entry {
     std::string raw_string_value_;
     absl::optional<uint64_t> uint_value_;
+    absl::optional<double> double_value_;
     absl::optional<envoy::type::FractionalPercent> fractional_percent_value_;
     absl::optional<bool> bool_value_;
   };
@@ -165,6 +190,25 @@ public:
                               const envoy::type::FractionalPercent& default_value,
                               uint64_t random_value) const PURE;
 
+  /**
+   * Same as featureEnabled(const std::string&, uint64_t) for an interned key.
+   */
+  virtual bool featureEnabled(const InternedKey& key, uint64_t default_value) const PURE;
+
+  /**
+   * Same as featureEnabled(const std::string&, uint64_t, uint64_t, uint64_t) for an interned key.
+   */
+  virtual bool featureEnabled(const InternedKey& key, uint64_t default_value, uint64_t random_value,
+                              uint64_t num_buckets) const PURE;
+
+  /**
+   * Same as featureEnabled(const std::string&, const envoy::type::FractionalPercent&, uint64_t) for
+   * an interned key.
+   */
+  virtual bool featureEnabled(const InternedKey& key,
+                              const envoy::type::FractionalPercent& default_value,
+                              uint64_t random_value) const PURE;
+
   /**
    * Fetch raw runtime data based on key.
    * @param key supplies the key to fetch.
@@ -181,6 +225,25 @@ public:
    */
   virtual uint64_t getInteger(const std::string& key, uint64_t default_value) const PURE;
 
+  /**
+   * Same as getInteger(const std::string&, uint64_t) for an interned key.
+   */
+  virtual uint64_t getInteger(const InternedKey& key, uint64_t default_value) const PURE;
+
+  /**
+   * Fetch a floating point runtime key. Integer values are also returned as doubles.
+   * @param key supplies the key to fetch.
+   * @param default_value supplies the value to return if the key does not exist or it does not
+   *        contain a number.
+   * @return double the runtime value or the default value.
+   */
+  virtual double getDouble(const std::string& key, double default_value) const PURE;
+
+  /**
+   * Same as getDouble(const std::string&, double) for an interned key.
+   */
+  virtual double getDouble(const InternedKey& key, double default_value) const PURE;
+
   /**
    * Fetch the OverrideLayers that provide values in this snapshot. Layers are ordered from bottom
    * to top; for instance, the second layer's entries override the first layer's entries, and so on.
@@ -211,6 +274,15 @@ public:
    * @param values the values to merge
    */
   virtual void mergeValues(const std::unordered_map<std::string, std::string>& values) PURE;
+
+  /**
+   * Intern a runtime key, so that snapshots can look it up by index rather than by name. This must
+   * be called on the main thread, typically when loading the config that uses the key. Interning
+   * a key again returns the same InternedKey.
+   * @param key supplies the key to intern.
+   * @return InternedKey the interned key, which is valid for the lifetime of the loader.
+   */
+  virtual InternedKey internKey(const std::string& key) PURE;
 };
 
 using LoaderPtr = std::unique_ptr<Loader>;
@@ -51,6 +51,13 @@ public:
    */
   virtual void getParentStats(GetParentStatsInfo& info) PURE;
 
+  /**
+   * Retrieve the resumable upstream TLS sessions of our parent process.
+   * @return std::string the sessions as serialized by Ssl::ContextManager::exportClientSessions()
+   *         in the parent, or empty if there is no parent.
+   */
+  virtual std::string getParentTlsSessions() PURE;
+
   /**
    * Initialize the restarter after primary server initialization begins. The hot restart
    * implementation needs to be created early to deal with shared memory, logging, etc. so
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -28,6 +29,14 @@
 namespace Envoy {
 namespace Server {
 
+/**
+ * The time taken by a phase of server startup.
+ */
+struct StartupPhase {
+  std::string name_;
+  std::chrono::microseconds duration_;
+};
+
 /**
  * An instance of the running server.
  */
@@ -177,6 +186,19 @@ public:
    */
   virtual time_t startTimeFirstEpoch() PURE;
 
+  /**
+   * Records the time taken by a phase of server startup, e.g. loading the static clusters.
+   * @param name supplies the name of the phase.
+   * @param duration supplies the time the phase took.
+   */
+  virtual void recordStartupPhase(const std::string& name,
+                                  std::chrono::microseconds duration) PURE;
+
+  /**
+   * @return the time taken by each completed phase of server startup, in the order they completed.
+   */
+  virtual const std::vector<StartupPhase>& startupPhases() PURE;
+
   /**
    * @return the server-wide stats store.
    */
@@ -164,6 +164,13 @@ public:
    */
   virtual bool hotRestartDisabled() const PURE;
 
+  /**
+   * @return bool indicating whether hot restart stats are kept in a shared memory region that grows
+   *         as stats are added, rather than in a table sized by maxStats() with names truncated
+   *         to the max name length.
+   */
+  virtual bool growableHotRestartStats() const PURE;
+
   /**
    * @return bool indicating whether system signal listeners are enabled.
    */
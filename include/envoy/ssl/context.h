@@ -10,6 +10,7 @@ namespace Envoy {
 namespace Ssl {
 
 typedef std::unique_ptr<envoy::admin::v2alpha::CertificateDetails> CertificateDetailsPtr;
+typedef std::unique_ptr<envoy::admin::v2alpha::CertificateVerification> CertificateVerificationPtr;
 
 /**
  * SSL Context is used as a template for SSL connection configuration.
@@ -32,6 +33,12 @@ public:
    * @return certificate details conforming to proto admin.v2alpha.certs.
    */
   virtual std::vector<CertificateDetailsPtr> getCertChainInformation() const PURE;
+
+  /**
+   * @return details of the peer certificate chains whose verification outcome is cached,
+   *         conforming to proto admin.v2alpha.certs.
+   */
+  virtual std::vector<CertificateVerificationPtr> getVerificationCacheInformation() const PURE;
 };
 typedef std::shared_ptr<Context> ContextSharedPtr;
 
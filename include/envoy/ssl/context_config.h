@@ -6,6 +6,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/ssl/certificate_validation_context_config.h"
+#include "envoy/ssl/private_key_method.h"
 #include "envoy/ssl/tls_certificate_config.h"
 
 namespace Envoy {
@@ -57,6 +58,18 @@ public:
    */
   virtual unsigned maxProtocolVersion() const PURE;
 
+  /**
+   * @return whether record protection is handed over to the kernel after the handshake, where
+   *         supported.
+   */
+  virtual bool kernelTlsOffload() const PURE;
+
+  /**
+   * @return PrivateKeyMethodProviderSharedPtr the provider performing private key operations
+   *         asynchronously, or nullptr if they are performed synchronously during the handshake.
+   */
+  virtual PrivateKeyMethodProviderSharedPtr privateKeyMethodProvider() const PURE;
+
   /**
    * @return true if the ContextConfig is able to provide secrets to create SSL context,
    * and false if dynamic secrets are expected but are not downloaded from SDS server yet.
@@ -119,6 +132,12 @@ public:
    * are candidates for decrypting received tickets.
    */
   virtual const std::vector<SessionTicketKey>& sessionTicketKeys() const PURE;
+
+  /**
+   * @return True if sessions resumed by session ID may be kept in a cache shared with other
+   * contexts, false if they are kept in a cache of this context only.
+   */
+  virtual bool sharedSessionCache() const PURE;
 };
 
 typedef std::unique_ptr<ServerContextConfig> ServerContextConfigPtr;
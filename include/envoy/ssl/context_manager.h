@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <string>
 
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
@@ -38,6 +39,22 @@ public:
    * Iterate through all currently allocated contexts.
    */
   virtual void iterateContexts(std::function<void(const Context&)> callback) PURE;
+
+  /**
+   * Serializes the resumable sessions of all client contexts, so that they can be handed to
+   * another process, e.g. the child during a hot restart.
+   * @return std::string the serialized sessions, in a format only meant for importClientSessions().
+   */
+  virtual std::string exportClientSessions() PURE;
+
+  /**
+   * Supplies sessions serialized by exportClientSessions() of another process. Client contexts
+   * created later with the same configuration as a context the sessions were exported from start
+   * out with its sessions, so that their first connections can resume instead of doing a full
+   * handshake. Malformed input is ignored.
+   * @param sessions supplies the serialized sessions.
+   */
+  virtual void importClientSessions(const std::string& sessions) PURE;
 };
 
 } // namespace Ssl
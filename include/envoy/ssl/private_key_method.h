@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * Callbacks of a connection whose handshake waits for an asynchronous private key operation.
+ */
+class PrivateKeyConnectionCallbacks {
+public:
+  virtual ~PrivateKeyConnectionCallbacks() {}
+
+  /**
+   * Called on the dispatcher of the connection when its pending private key operation has
+   * completed, successfully or not. The handshake can then be resumed.
+   */
+  virtual void onPrivateKeyMethodComplete() PURE;
+};
+
+/**
+ * Performs the private key operations of TLS handshakes asynchronously, through BoringSSL's
+ * private key method. While an operation is pending, SSL_do_handshake() fails with
+ * SSL_ERROR_WANT_PRIVATE_KEY_OPERATION, and the connection is told when to call it again.
+ */
+class PrivateKeyMethodProvider {
+public:
+  virtual ~PrivateKeyMethodProvider() {}
+
+  /**
+   * Binds a connection to the provider. This must be called before the handshake starts.
+   * @param ssl supplies the connection.
+   * @param cb supplies the callbacks told about completed operations.
+   * @param dispatcher supplies the dispatcher of the connection, on which the callbacks are called.
+   */
+  virtual void registerPrivateKeyMethod(SSL* ssl, PrivateKeyConnectionCallbacks& cb,
+                                        Event::Dispatcher& dispatcher) PURE;
+
+  /**
+   * Unbinds a connection from the provider. The callbacks of the connection are not called after
+   * this, even for an operation that is still pending.
+   * @param ssl supplies the connection.
+   */
+  virtual void unregisterPrivateKeyMethod(SSL* ssl) PURE;
+
+  /**
+   * @return const SSL_PRIVATE_KEY_METHOD& the private key method to install on the SSL_CTX of
+   *         connections bound to the provider.
+   */
+  virtual const SSL_PRIVATE_KEY_METHOD& boringSslPrivateKeyMethod() const PURE;
+};
+
+typedef std::shared_ptr<PrivateKeyMethodProvider> PrivateKeyMethodProviderSharedPtr;
+
+} // namespace Ssl
+} // namespace Envoy
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 
 #include "envoy/api/v2/core/base.pb.h"
+#include "envoy/common/time.h"
 #include "envoy/network/address.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/health_check_host_monitor.h"
@@ -123,6 +125,23 @@ public:
    * Set the current priority.
    */
   virtual void priority(uint32_t) PURE;
+
+  /**
+   * Record the response time of a request completed by this host. This feeds the peak EWMA
+   * latency estimate used by latency aware load balancers. May be called from any thread.
+   * @param response_time supplies the time between the end of the request and the end of the
+   *        response.
+   * @param now supplies the current monotonic time.
+   */
+  virtual void recordResponseTime(std::chrono::microseconds response_time,
+                                  MonotonicTime now) const PURE;
+
+  /**
+   * @param now supplies the current monotonic time.
+   * @return the peak EWMA of the host's response time in microseconds, decayed to now. Returns 0
+   *         if no response time has been recorded yet.
+   */
+  virtual double peakEwmaResponseTime(MonotonicTime now) const PURE;
 };
 
 typedef std::shared_ptr<const HostDescription> HostDescriptionConstSharedPtr;
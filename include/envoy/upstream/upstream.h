@@ -388,6 +388,7 @@ public:
 // clang-format off
 #define ALL_CLUSTER_STATS(COUNTER, GAUGE, HISTOGRAM)                                               \
   COUNTER  (lb_healthy_panic)                                                                      \
+  COUNTER  (lb_hash_bounded_load_spillover)                                                        \
   COUNTER  (lb_local_cluster_not_ok)                                                               \
   COUNTER  (lb_recalculate_zone_structures)                                                        \
   COUNTER  (lb_zone_cluster_too_small)                                                             \
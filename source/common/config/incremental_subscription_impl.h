@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "envoy/api/v2/discovery.pb.h"
+#include "envoy/config/subscription.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/grpc/async_client.h"
+#include "envoy/grpc/status.h"
+#include "envoy/local_info/local_info.h"
+
+#include "common/common/assert.h"
+#include "common/common/logger.h"
+#include "common/config/grpc_stream.h"
+#include "common/config/utility.h"
+#include "common/grpc/common.h"
+#include "common/protobuf/protobuf.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * A single IncrementalDiscoveryRequest waiting to be sent. Requests are only built from this at
+ * send time so that the initial request carries the resource versions known at that point.
+ */
+struct IncrementalRequestQueueItem {
+  std::vector<std::string> subscribe_;
+  std::vector<std::string> unsubscribe_;
+  std::string response_nonce_;
+  absl::optional<google::rpc::Status> error_detail_;
+  // Whether this is the first request on a (re)established stream. Such a request subscribes to
+  // every resource of interest and reports the versions we already hold.
+  bool initial_{};
+};
+
+/**
+ * Subscription for a single xDS API over the incremental xDS protocol. Only the resources that
+ * changed are exchanged with the management server: responses carry added/updated resources and
+ * the names of removed ones, and requests carry only changes to the set of subscribed resources.
+ */
+template <class ResourceType>
+class IncrementalSubscriptionImpl
+    : public Subscription<ResourceType>,
+      public GrpcStream<envoy::api::v2::IncrementalDiscoveryRequest,
+                        envoy::api::v2::IncrementalDiscoveryResponse, IncrementalRequestQueueItem> {
+public:
+  IncrementalSubscriptionImpl(const LocalInfo::LocalInfo& local_info,
+                              Grpc::AsyncClientPtr async_client, Event::Dispatcher& dispatcher,
+                              Runtime::RandomGenerator& random,
+                              const Protobuf::MethodDescriptor& service_method,
+                              SubscriptionStats stats, Stats::Scope& scope,
+                              const RateLimitSettings& rate_limit_settings)
+      : GrpcStream<envoy::api::v2::IncrementalDiscoveryRequest,
+                   envoy::api::v2::IncrementalDiscoveryResponse, IncrementalRequestQueueItem>(
+            std::move(async_client), service_method, random, dispatcher, scope,
+            rate_limit_settings),
+        stats_(stats),
+        type_url_(Grpc::Common::typeUrl(ResourceType().GetDescriptor()->full_name())),
+        local_info_(local_info) {}
+
+  // Config::Subscription
+  void start(const std::vector<std::string>& resources,
+             SubscriptionCallbacks<ResourceType>& callbacks) override {
+    callbacks_ = &callbacks;
+    resource_names_ = std::set<std::string>(resources.begin(), resources.end());
+    stats_.update_attempt_.inc();
+    this->establishNewStream();
+  }
+
+  void updateResources(const std::vector<std::string>& resources) override {
+    const std::set<std::string> new_resource_names(resources.begin(), resources.end());
+    IncrementalRequestQueueItem item;
+    std::set_difference(new_resource_names.begin(), new_resource_names.end(),
+                        resource_names_.begin(), resource_names_.end(),
+                        std::back_inserter(item.subscribe_));
+    std::set_difference(resource_names_.begin(), resource_names_.end(),
+                        new_resource_names.begin(), new_resource_names.end(),
+                        std::back_inserter(item.unsubscribe_));
+    for (const std::string& name : item.unsubscribe_) {
+      resource_versions_.erase(name);
+    }
+    resource_names_ = new_resource_names;
+    stats_.update_attempt_.inc();
+    if (item.subscribe_.empty() && item.unsubscribe_.empty()) {
+      return;
+    }
+    this->queueDiscoveryRequest(item);
+  }
+
+  // Config::GrpcStream
+  void sendDiscoveryRequest(const IncrementalRequestQueueItem& queue_item) override {
+    if (!this->grpcStreamAvailable()) {
+      ENVOY_LOG(debug, "No stream available to send IncrementalDiscoveryRequest for {}",
+                type_url_);
+      return;
+    }
+    envoy::api::v2::IncrementalDiscoveryRequest request;
+    request.set_type_url(type_url_);
+    if (queue_item.initial_) {
+      // The node only needs to be sent on the first request of a stream.
+      request.mutable_node()->MergeFrom(local_info_.node());
+      for (const std::string& name : resource_names_) {
+        request.add_resource_names_subscribe(name);
+      }
+      for (const auto& resource_version : resource_versions_) {
+        (*request.mutable_initial_resource_versions())[resource_version.first] =
+            resource_version.second;
+      }
+    } else {
+      for (const std::string& name : queue_item.subscribe_) {
+        request.add_resource_names_subscribe(name);
+      }
+      for (const std::string& name : queue_item.unsubscribe_) {
+        request.add_resource_names_unsubscribe(name);
+      }
+    }
+    request.set_response_nonce(queue_item.response_nonce_);
+    if (queue_item.error_detail_.has_value()) {
+      request.mutable_error_detail()->CopyFrom(queue_item.error_detail_.value());
+    }
+    ENVOY_LOG(trace, "Sending IncrementalDiscoveryRequest for {}: {}", type_url_,
+              request.DebugString());
+    this->sendMessage(request);
+  }
+
+  void handleStreamEstablished() override {
+    IncrementalRequestQueueItem item;
+    item.initial_ = true;
+    this->queueDiscoveryRequest(item);
+  }
+
+  void handleEstablishmentFailure() override {
+    stats_.update_failure_.inc();
+    stats_.update_attempt_.inc();
+    ENVOY_LOG(debug, "incremental update for {} failed", type_url_);
+    callbacks_->onConfigUpdateFailed(nullptr);
+  }
+
+  void
+  handleResponse(std::unique_ptr<envoy::api::v2::IncrementalDiscoveryResponse>&& message) override {
+    ENVOY_LOG(debug, "Received incremental gRPC message for {} at version {}", type_url_,
+              message->system_version_info());
+    IncrementalRequestQueueItem ack;
+    ack.response_nonce_ = message->nonce();
+    try {
+      for (const auto& resource : message->resources()) {
+        if (resource.resource().type_url() != type_url_) {
+          throw EnvoyException(fmt::format("{} does not match {} type URL in incremental response",
+                                           resource.resource().type_url(), type_url_));
+        }
+      }
+      callbacks_->onConfigUpdate(message->resources(), message->removed_resources(),
+                                 message->system_version_info());
+      for (const auto& resource : message->resources()) {
+        resource_versions_[callbacks_->resourceName(resource.resource())] = resource.version();
+      }
+      for (const std::string& name : message->removed_resources()) {
+        resource_versions_.erase(name);
+      }
+      stats_.update_success_.inc();
+      stats_.update_attempt_.inc();
+      stats_.version_.set(HashUtil::xxHash64(message->system_version_info()));
+      ENVOY_LOG(debug, "incremental config for {} accepted with {} resources added and {} removed",
+                type_url_, message->resources().size(), message->removed_resources().size());
+    } catch (const EnvoyException& e) {
+      stats_.update_rejected_.inc();
+      stats_.update_attempt_.inc();
+      ENVOY_LOG(warn, "incremental config for {} rejected: {}", type_url_, e.what());
+      callbacks_->onConfigUpdateFailed(&e);
+      google::rpc::Status error_detail;
+      error_detail.set_code(Grpc::Status::GrpcStatus::Internal);
+      error_detail.set_message(e.what());
+      ack.error_detail_ = error_detail;
+    }
+    this->queueDiscoveryRequest(ack);
+  }
+
+private:
+  SubscriptionStats stats_;
+  const std::string type_url_;
+  const LocalInfo::LocalInfo& local_info_;
+  SubscriptionCallbacks<ResourceType>* callbacks_{};
+  // Resources currently subscribed to. An empty set means all resources of the type (wildcard).
+  std::set<std::string> resource_names_;
+  // Versions of the resources we currently hold, reported to the server on reconnect so that
+  // unchanged resources are not resent.
+  std::unordered_map<std::string, std::string> resource_versions_;
+};
+
+} // namespace Config
+} // namespace Envoy
@@ -12,6 +12,7 @@
 #include "common/config/grpc_mux_subscription_impl.h"
 #include "common/config/grpc_subscription_impl.h"
 #include "common/config/http_subscription_impl.h"
+#include "common/config/incremental_subscription_impl.h"
 #include "common/config/utility.h"
 #include "common/protobuf/protobuf.h"
 
@@ -35,13 +36,16 @@ public:
    * @param grpc_method fully qualified name of v2 gRPC API bidi streaming method (as per protobuf
    *        service description).
    * @param api reference to the Api object
+   * @param incremental_grpc_method fully qualified name of v2 incremental gRPC API bidi streaming
+   *        method (as per protobuf service description). Empty if the API has no incremental
+   *        variant.
    */
   template <class ResourceType>
   static std::unique_ptr<Subscription<ResourceType>> subscriptionFromConfigSource(
       const envoy::api::v2::core::ConfigSource& config, const LocalInfo::LocalInfo& local_info,
       Event::Dispatcher& dispatcher, Upstream::ClusterManager& cm, Runtime::RandomGenerator& random,
       Stats::Scope& scope, const std::string& rest_method, const std::string& grpc_method,
-      Api::Api& api) {
+      Api::Api& api, const std::string& incremental_grpc_method = "") {
     std::unique_ptr<Subscription<ResourceType>> result;
     SubscriptionStats stats = Utility::generateStats(scope);
     switch (config.config_source_specifier_case()) {
@@ -78,6 +82,21 @@ public:
             scope, Utility::parseRateLimitSettings(api_config_source)));
         break;
       }
+      case envoy::api::v2::core::ApiConfigSource::INCREMENTAL_GRPC: {
+        if (incremental_grpc_method.empty()) {
+          throw EnvoyException("INCREMENTAL_GRPC is not supported for this xDS API:\n" +
+                               config.DebugString());
+        }
+        result.reset(new IncrementalSubscriptionImpl<ResourceType>(
+            local_info,
+            Config::Utility::factoryForGrpcApiConfigSource(cm.grpcAsyncClientManager(),
+                                                           config.api_config_source(), scope)
+                ->create(),
+            dispatcher, random,
+            *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(incremental_grpc_method),
+            stats, scope, Utility::parseRateLimitSettings(api_config_source)));
+        break;
+      }
       default:
         NOT_REACHED_GCOVR_EXCL_LINE;
       }
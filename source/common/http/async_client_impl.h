@@ -55,6 +55,11 @@ public:
 
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
+  /**
+   * @return whether any request or stream started through this client is still in flight.
+   */
+  bool hasActiveStreams() const { return !active_streams_.empty(); }
+
 private:
   Upstream::ClusterInfoConstSharedPtr cluster_;
   Router::FilterConfig config_;
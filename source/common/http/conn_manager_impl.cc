@@ -1,8 +1,8 @@
 #include "common/http/conn_manager_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
-#include <list>
 #include <memory>
 #include <string>
 #include <vector>
@@ -39,7 +39,7 @@ namespace Http {
 
 namespace {
 
-template <class T> using FilterList = std::list<std::unique_ptr<T>>;
+template <class T> using FilterList = std::vector<std::unique_ptr<T>>;
 
 // Shared helper for recording the latest filter used.
 template <class T>
@@ -229,6 +229,11 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
     }
   }
 
+  if (stream.state_.created_filter_chain_) {
+    decoder_filters_size_hint_ = stream.decoder_filters_.size();
+    encoder_filters_size_hint_ = stream.encoder_filters_.size();
+  }
+
   read_callbacks_->connection().dispatcher().deferredDelete(stream.removeFromList(streams_));
 }
 
@@ -507,14 +512,16 @@ void ConnectionManagerImpl::ActiveStream::addStreamDecoderFilterWorker(
     StreamDecoderFilterSharedPtr filter, bool dual_filter) {
   ActiveStreamDecoderFilterPtr wrapper(new ActiveStreamDecoderFilter(*this, filter, dual_filter));
   filter->setDecoderFilterCallbacks(*wrapper);
-  wrapper->moveIntoListBack(std::move(wrapper), decoder_filters_);
+  wrapper->position_ = decoder_filters_.size();
+  decoder_filters_.emplace_back(std::move(wrapper));
 }
 
 void ConnectionManagerImpl::ActiveStream::addStreamEncoderFilterWorker(
     StreamEncoderFilterSharedPtr filter, bool dual_filter) {
   ActiveStreamEncoderFilterPtr wrapper(new ActiveStreamEncoderFilter(*this, filter, dual_filter));
   filter->setEncoderFilterCallbacks(*wrapper);
-  wrapper->moveIntoList(std::move(wrapper), encoder_filters_);
+  // Encoder filters are invoked in the reverse order they are added in, see createFilterChain().
+  encoder_filters_.emplace_back(std::move(wrapper));
 }
 
 void ConnectionManagerImpl::ActiveStream::addAccessLogHandler(
@@ -781,12 +788,12 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
 
 void ConnectionManagerImpl::ActiveStream::decodeHeaders(ActiveStreamDecoderFilter* filter,
                                                         HeaderMap& headers, bool end_stream) {
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry;
-  std::list<ActiveStreamDecoderFilterPtr>::iterator continue_data_entry = decoder_filters_.end();
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator entry;
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator continue_data_entry = decoder_filters_.end();
   if (!filter) {
     entry = decoder_filters_.begin();
   } else {
-    entry = std::next(filter->entry());
+    entry = decoder_filters_.begin() + filter->position_ + 1;
   }
 
   for (; entry != decoder_filters_.end(); entry++) {
@@ -851,13 +858,13 @@ void ConnectionManagerImpl::ActiveStream::decodeData(ActiveStreamDecoderFilter*
     return;
   }
 
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry;
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator entry;
   auto trailers_added_entry = decoder_filters_.end();
   const bool trailers_exists_at_start = request_trailers_ != nullptr;
   if (!filter) {
     entry = decoder_filters_.begin();
   } else {
-    entry = std::next(filter->entry());
+    entry = decoder_filters_.begin() + filter->position_ + 1;
   }
 
   for (; entry != decoder_filters_.end(); entry++) {
@@ -991,11 +998,11 @@ void ConnectionManagerImpl::ActiveStream::decodeTrailers(ActiveStreamDecoderFilt
     return;
   }
 
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry;
+  std::vector<ActiveStreamDecoderFilterPtr>::iterator entry;
   if (!filter) {
     entry = decoder_filters_.begin();
   } else {
-    entry = std::next(filter->entry());
+    entry = decoder_filters_.begin() + filter->position_ + 1;
   }
 
   for (; entry != decoder_filters_.end(); entry++) {
@@ -1028,7 +1035,7 @@ void ConnectionManagerImpl::ActiveStream::disarmRequestTimeout() {
   }
 }
 
-std::list<ConnectionManagerImpl::ActiveStreamEncoderFilterPtr>::iterator
+std::vector<ConnectionManagerImpl::ActiveStreamEncoderFilterPtr>::iterator
 ConnectionManagerImpl::ActiveStream::commonEncodePrefix(ActiveStreamEncoderFilter* filter,
                                                         bool end_stream) {
   // Only do base state setting on the initial call. Subsequent calls for filtering do not touch
@@ -1041,7 +1048,7 @@ ConnectionManagerImpl::ActiveStream::commonEncodePrefix(ActiveStreamEncoderFilte
   if (!filter) {
     return encoder_filters_.begin();
   } else {
-    return std::next(filter->entry());
+    return encoder_filters_.begin() + filter->position_ + 1;
   }
 }
 
@@ -1106,7 +1113,7 @@ void ConnectionManagerImpl::ActiveStream::encode100ContinueHeaders(
   // filter. This is simpler than that case because 100 continue implies no
   // end-stream, and because there are normal headers coming there's no need for
   // complex continuation logic.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, false);
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, false);
   for (; entry != encoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::Encode100ContinueHeaders));
     state_.filter_call_state_ |= FilterCallState::Encode100ContinueHeaders;
@@ -1137,8 +1144,9 @@ void ConnectionManagerImpl::ActiveStream::encodeHeaders(ActiveStreamEncoderFilte
   resetIdleTimer();
   disarmRequestTimeout();
 
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, end_stream);
-  std::list<ActiveStreamEncoderFilterPtr>::iterator continue_data_entry = encoder_filters_.end();
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry =
+      commonEncodePrefix(filter, end_stream);
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator continue_data_entry = encoder_filters_.end();
 
   for (; entry != encoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeHeaders));
@@ -1279,7 +1287,7 @@ void ConnectionManagerImpl::ActiveStream::encodeMetadata(ActiveStreamEncoderFilt
 
   // Metadata currently go through all filters.
   ASSERT(filter == nullptr);
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = encoder_filters_.begin();
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry = encoder_filters_.begin();
   for (; entry != encoder_filters_.end(); entry++) {
     FilterMetadataStatus status = (*entry)->handle_->encodeMetadata(*metadata_map_ptr);
     ENVOY_STREAM_LOG(trace, "encode metadata called: filter={} status={}", *this,
@@ -1337,7 +1345,8 @@ void ConnectionManagerImpl::ActiveStream::encodeData(ActiveStreamEncoderFilter*
     return;
   }
 
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, end_stream);
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry =
+      commonEncodePrefix(filter, end_stream);
   auto trailers_added_entry = encoder_filters_.end();
 
   const bool trailers_exists_at_start = response_trailers_ != nullptr;
@@ -1403,7 +1412,7 @@ void ConnectionManagerImpl::ActiveStream::encodeTrailers(ActiveStreamEncoderFilt
     return;
   }
 
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, true);
+  std::vector<ActiveStreamEncoderFilterPtr>::iterator entry = commonEncodePrefix(filter, true);
   for (; entry != encoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeTrailers));
     state_.filter_call_state_ |= FilterCallState::EncodeTrailers;
@@ -1490,6 +1499,11 @@ bool ConnectionManagerImpl::ActiveStream::createFilterChain() {
   if (state_.created_filter_chain_) {
     return false;
   }
+  // The streams of a connection usually get the same filter chain, so make room for the filters
+  // of the previous stream up front.
+  decoder_filters_.reserve(connection_manager_.decoder_filters_size_hint_);
+  encoder_filters_.reserve(connection_manager_.encoder_filters_size_hint_);
+
   bool upgrade_rejected = false;
   auto upgrade = request_headers_ ? request_headers_->Upgrade() : nullptr;
   state_.created_filter_chain_ = true;
@@ -1507,7 +1521,6 @@ bool ConnectionManagerImpl::ActiveStream::createFilterChain() {
       state_.successful_upgrade_ = true;
       connection_manager_.stats_.named_.downstream_cx_upgrades_total_.inc();
       connection_manager_.stats_.named_.downstream_cx_upgrades_active_.inc();
-      return true;
     } else {
       upgrade_rejected = true;
       // Fall through to the default filter chain. The function calling this
@@ -1515,7 +1528,16 @@ bool ConnectionManagerImpl::ActiveStream::createFilterChain() {
     }
   }
 
-  connection_manager_.config_.filterFactory().createFilterChain(*this);
+  if (!state_.successful_upgrade_) {
+    connection_manager_.config_.filterFactory().createFilterChain(*this);
+  }
+
+  // Encoder filters are invoked in the reverse order they are added in. They are appended while
+  // the chain is created and reversed once here.
+  std::reverse(encoder_filters_.begin(), encoder_filters_.end());
+  for (size_t i = 0; i < encoder_filters_.size(); i++) {
+    encoder_filters_[i]->position_ = i;
+  }
   return !upgrade_rejected;
 }
 
@@ -129,6 +129,8 @@ private:
     Tracing::Config& tracingConfig() override;
 
     ActiveStream& parent_;
+    // The position of the filter in the filters of its direction, in the order they are invoked.
+    uint32_t position_{};
     bool headers_continued_ : 1;
     bool continue_headers_continued_ : 1;
     bool stopped_ : 1;
@@ -141,8 +143,7 @@ private:
    * Wrapper for a stream decoder filter.
    */
   struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
-                                     public StreamDecoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamDecoderFilter> {
+                                     public StreamDecoderFilterCallbacks {
     ActiveStreamDecoderFilter(ActiveStream& parent, StreamDecoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -224,8 +225,7 @@ private:
    * Wrapper for a stream encoder filter.
    */
   struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
-                                     public StreamEncoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamEncoderFilter> {
+                                     public StreamEncoderFilterCallbacks {
     ActiveStreamEncoderFilter(ActiveStream& parent, StreamEncoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -287,7 +287,7 @@ private:
     void addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr filter, bool dual_filter);
     void addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr filter, bool dual_filter);
     void chargeStats(const HeaderMap& headers);
-    std::list<ActiveStreamEncoderFilterPtr>::iterator
+    std::vector<ActiveStreamEncoderFilterPtr>::iterator
     commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream);
     const Network::Connection* connection();
     void addDecodedData(ActiveStreamDecoderFilter& filter, Buffer::Instance& data, bool streaming);
@@ -423,9 +423,11 @@ private:
     HeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     HeaderMapPtr request_trailers_;
-    std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
-    std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
-    std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
+    // The filters are kept in the order they are invoked in, and only added while the filter chain
+    // is created, so that iterating them doesn't chase list nodes.
+    std::vector<ActiveStreamDecoderFilterPtr> decoder_filters_;
+    std::vector<ActiveStreamEncoderFilterPtr> encoder_filters_;
+    std::vector<AccessLog::InstanceSharedPtr> access_log_handlers_;
     Stats::TimespanPtr request_response_timespan_;
     // Per-stream idle timeout.
     Event::TimerPtr stream_idle_timer_;
@@ -504,6 +506,9 @@ private:
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
   TimeSource& time_source_;
+  // The number of filters of the last stream that created a filter chain, reserved by the next.
+  size_t decoder_filters_size_hint_{};
+  size_t encoder_filters_size_hint_{};
 };
 
 } // namespace Http
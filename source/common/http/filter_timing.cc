@@ -0,0 +1,226 @@
+#include "common/http/filter_timing.h"
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+#include "common/protobuf/protobuf.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Http {
+
+FilterTiming::FilterTiming(const std::string& stats_prefix, Stats::Scope& scope,
+                           Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                           TimeSource& time_source, uint64_t sampling,
+                           bool record_in_dynamic_metadata)
+    : stats_prefix_(stats_prefix + "filter_timing."), scope_(scope), runtime_(runtime),
+      random_(random), time_source_(time_source),
+      sampling_key_(runtime.internKey("http_connection_manager.filter_timing_sampling")),
+      sampling_(sampling), record_in_dynamic_metadata_(record_in_dynamic_metadata) {}
+
+FilterTiming::Filter& FilterTiming::addFilter(absl::string_view chain, uint32_t index,
+                                              const std::string& name) {
+  const std::string key = absl::StrCat(chain, ".", index, ".", name);
+  const std::string prefix = absl::StrCat(stats_prefix_, key, ".");
+  filters_.push_back(Filter{
+      key, FilterTimingStats{ALL_FILTER_TIMING_STATS(POOL_HISTOGRAM_PREFIX(scope_, prefix))}});
+  return filters_.back();
+}
+
+bool FilterTiming::sampled() const {
+  return runtime_.snapshot().featureEnabled(sampling_key_, sampling_, random_.random(), 10000);
+}
+
+const std::string& FilterTiming::dynamicMetadataNamespace() {
+  CONSTRUCT_ON_FIRST_USE(std::string, "envoy.filter_timing");
+}
+
+namespace {
+class CallbackTimer;
+} // namespace
+
+struct TimedFilterChainFactoryCallbacks::Timers {
+  // The timer of the innermost running callback.
+  CallbackTimer* running_{};
+};
+
+namespace {
+
+/**
+ * The time spent in the callbacks of one direction of a filter.
+ */
+struct CallbackTime {
+  std::chrono::nanoseconds elapsed_{};
+  // Whether any callback of the direction ran. Only these directions are recorded, so that e.g. a
+  // stream reset before the response does not record an encode time of 0.
+  bool invoked_{};
+};
+
+/**
+ * Adds the time spent in a filter callback to the time of the filter, minus the time spent in the
+ * callbacks of other filters it runs.
+ */
+class CallbackTimer {
+public:
+  CallbackTimer(TimeSource& time_source, TimedFilterChainFactoryCallbacks::Timers& timers,
+                CallbackTime& time)
+      : time_source_(time_source), timers_(timers), time_(time), outer_(timers.running_),
+        start_(time_source.monotonicTime()) {
+    time_.invoked_ = true;
+    if (outer_ != nullptr) {
+      outer_->time_.elapsed_ +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(start_ - outer_->start_);
+    }
+    timers_.running_ = this;
+  }
+
+  ~CallbackTimer() {
+    const MonotonicTime now = time_source_.monotonicTime();
+    time_.elapsed_ += std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_);
+    timers_.running_ = outer_;
+    if (outer_ != nullptr) {
+      outer_->start_ = now;
+    }
+  }
+
+private:
+  TimeSource& time_source_;
+  TimedFilterChainFactoryCallbacks::Timers& timers_;
+  CallbackTime& time_;
+  CallbackTimer* const outer_;
+  MonotonicTime start_;
+};
+
+/**
+ * Wraps a decoder filter, an encoder filter or a filter that is both, timing its callbacks. The
+ * times of the directions whose callbacks ran are recorded when the stream is destroyed.
+ */
+class TimedFilter : public StreamFilter {
+public:
+  TimedFilter(FilterTiming& timing, FilterTiming::Filter& filter,
+              std::shared_ptr<TimedFilterChainFactoryCallbacks::Timers> timers,
+              StreamDecoderFilterSharedPtr decoder_filter,
+              StreamEncoderFilterSharedPtr encoder_filter)
+      : timing_(timing), filter_(filter), timers_(std::move(timers)),
+        decoder_filter_(std::move(decoder_filter)), encoder_filter_(std::move(encoder_filter)) {}
+
+  // Http::StreamFilterBase
+  void onDestroy() override {
+    // The connection manager destroys filters that are both decoder and encoder filters once.
+    if (decoder_filter_ != nullptr) {
+      decoder_filter_->onDestroy();
+    } else {
+      encoder_filter_->onDestroy();
+    }
+    recordTimes();
+  }
+
+  // Http::StreamDecoderFilter
+  FilterHeadersStatus decodeHeaders(HeaderMap& headers, bool end_stream) override {
+    CallbackTimer timer(timing_.timeSource(), *timers_, decode_time_);
+    return decoder_filter_->decodeHeaders(headers, end_stream);
+  }
+  FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override {
+    CallbackTimer timer(timing_.timeSource(), *timers_, decode_time_);
+    return decoder_filter_->decodeData(data, end_stream);
+  }
+  FilterTrailersStatus decodeTrailers(HeaderMap& trailers) override {
+    CallbackTimer timer(timing_.timeSource(), *timers_, decode_time_);
+    return decoder_filter_->decodeTrailers(trailers);
+  }
+  void setDecoderFilterCallbacks(StreamDecoderFilterCallbacks& callbacks) override {
+    stream_callbacks_ = &callbacks;
+    decoder_filter_->setDecoderFilterCallbacks(callbacks);
+  }
+
+  // Http::StreamEncoderFilter
+  FilterHeadersStatus encode100ContinueHeaders(HeaderMap& headers) override {
+    CallbackTimer timer(timing_.timeSource(), *timers_, encode_time_);
+    return encoder_filter_->encode100ContinueHeaders(headers);
+  }
+  FilterHeadersStatus encodeHeaders(HeaderMap& headers, bool end_stream) override {
+    CallbackTimer timer(timing_.timeSource(), *timers_, encode_time_);
+    return encoder_filter_->encodeHeaders(headers, end_stream);
+  }
+  FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override {
+    CallbackTimer timer(timing_.timeSource(), *timers_, encode_time_);
+    return encoder_filter_->encodeData(data, end_stream);
+  }
+  FilterTrailersStatus encodeTrailers(HeaderMap& trailers) override {
+    CallbackTimer timer(timing_.timeSource(), *timers_, encode_time_);
+    return encoder_filter_->encodeTrailers(trailers);
+  }
+  FilterMetadataStatus encodeMetadata(MetadataMap& metadata_map) override {
+    CallbackTimer timer(timing_.timeSource(), *timers_, encode_time_);
+    return encoder_filter_->encodeMetadata(metadata_map);
+  }
+  void setEncoderFilterCallbacks(StreamEncoderFilterCallbacks& callbacks) override {
+    stream_callbacks_ = &callbacks;
+    encoder_filter_->setEncoderFilterCallbacks(callbacks);
+  }
+
+private:
+  void recordTimes() {
+    ProtobufWkt::Struct times;
+    if (decode_time_.invoked_) {
+      filter_.stats_.decode_time_us_.recordValue(
+          std::chrono::duration_cast<std::chrono::microseconds>(decode_time_.elapsed_).count());
+      (*times.mutable_fields())["decode_time_us"].set_number_value(
+          decode_time_.elapsed_.count() / 1000.0);
+    }
+    if (encode_time_.invoked_) {
+      filter_.stats_.encode_time_us_.recordValue(
+          std::chrono::duration_cast<std::chrono::microseconds>(encode_time_.elapsed_).count());
+      (*times.mutable_fields())["encode_time_us"].set_number_value(
+          encode_time_.elapsed_.count() / 1000.0);
+    }
+
+    if (timing_.recordInDynamicMetadata() && stream_callbacks_ != nullptr &&
+        !times.fields().empty()) {
+      ProtobufWkt::Struct metadata;
+      (*metadata.mutable_fields())[filter_.key_].mutable_struct_value()->Swap(&times);
+      stream_callbacks_->streamInfo().setDynamicMetadata(FilterTiming::dynamicMetadataNamespace(),
+                                                         metadata);
+    }
+  }
+
+  FilterTiming& timing_;
+  FilterTiming::Filter& filter_;
+  const std::shared_ptr<TimedFilterChainFactoryCallbacks::Timers> timers_;
+  const StreamDecoderFilterSharedPtr decoder_filter_;
+  const StreamEncoderFilterSharedPtr encoder_filter_;
+  StreamFilterCallbacks* stream_callbacks_{};
+  CallbackTime decode_time_;
+  CallbackTime encode_time_;
+};
+
+} // namespace
+
+TimedFilterChainFactoryCallbacks::TimedFilterChainFactoryCallbacks(
+    FilterChainFactoryCallbacks& callbacks, FilterTiming& timing)
+    : callbacks_(callbacks), timing_(timing), timers_(std::make_shared<Timers>()) {}
+
+void TimedFilterChainFactoryCallbacks::addStreamDecoderFilter(StreamDecoderFilterSharedPtr filter) {
+  ASSERT(filter_ != nullptr);
+  callbacks_.addStreamDecoderFilter(
+      std::make_shared<TimedFilter>(timing_, *filter_, timers_, std::move(filter), nullptr));
+}
+
+void TimedFilterChainFactoryCallbacks::addStreamEncoderFilter(StreamEncoderFilterSharedPtr filter) {
+  ASSERT(filter_ != nullptr);
+  callbacks_.addStreamEncoderFilter(
+      std::make_shared<TimedFilter>(timing_, *filter_, timers_, nullptr, std::move(filter)));
+}
+
+void TimedFilterChainFactoryCallbacks::addStreamFilter(StreamFilterSharedPtr filter) {
+  ASSERT(filter_ != nullptr);
+  callbacks_.addStreamFilter(
+      std::make_shared<TimedFilter>(timing_, *filter_, timers_, filter, filter));
+}
+
+void TimedFilterChainFactoryCallbacks::addAccessLogHandler(AccessLog::InstanceSharedPtr handler) {
+  callbacks_.addAccessLogHandler(std::move(handler));
+}
+
+} // namespace Http
+} // namespace Envoy
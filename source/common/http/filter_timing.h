@@ -0,0 +1,136 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/http/filter.h"
+#include "envoy/runtime/runtime.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * All stats for the time spent in a filter. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_FILTER_TIMING_STATS(HISTOGRAM)                                                         \
+  HISTOGRAM(decode_time_us)                                                                        \
+  HISTOGRAM(encode_time_us)
+// clang-format on
+
+/**
+ * Struct definition for the stats of the time spent in a filter. @see stats_macros.h
+ */
+struct FilterTimingStats {
+  ALL_FILTER_TIMING_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Measures the time spent in the callbacks of the filters of a sample of the streams of a
+ * connection manager. The time a stream spends in each filter is recorded in histograms of the
+ * filter, and optionally in the dynamic metadata of the stream for access logs. Streams that are
+ * not sampled get their filters without any wrapping, so they don't pay for the measurements.
+ */
+class FilterTiming {
+public:
+  /**
+   * The filters created by one filter factory of a filter chain, e.g. the second filter of the
+   * "http" chain, "envoy.lua".
+   */
+  struct Filter {
+    // Identifies the filter in the stats and in the dynamic metadata, e.g. "http.1.envoy.lua".
+    const std::string key_;
+    FilterTimingStats stats_;
+  };
+
+  /**
+   * @param stats_prefix supplies the stats prefix of the connection manager.
+   * @param sampling supplies the percentage of streams to time, in the range 0-10000, unless
+   *        overridden by the http_connection_manager.filter_timing_sampling runtime key.
+   * @param record_in_dynamic_metadata supplies whether the time spent in the filters is recorded
+   *        in the dynamic metadata of the sampled streams.
+   */
+  FilterTiming(const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+               Runtime::RandomGenerator& random, TimeSource& time_source, uint64_t sampling,
+               bool record_in_dynamic_metadata);
+
+  /**
+   * Adds a filter, with stats named <stats_prefix>filter_timing.<chain>.<index>.<name>. The
+   * index keeps apart filters of the same chain configured with the same name.
+   * @param chain supplies the filter chain of the filter, e.g. "http" or an upgrade type.
+   * @param index supplies the position of the filter in its chain.
+   * @param name supplies the name of the filter.
+   * @return Filter& the filter, valid for the lifetime of this object.
+   */
+  Filter& addFilter(absl::string_view chain, uint32_t index, const std::string& name);
+
+  /**
+   * @return bool whether the filters of a new stream are timed.
+   */
+  bool sampled() const;
+
+  TimeSource& timeSource() { return time_source_; }
+  bool recordInDynamicMetadata() const { return record_in_dynamic_metadata_; }
+
+  /**
+   * The dynamic metadata namespace the time spent in the filters is recorded in.
+   */
+  static const std::string& dynamicMetadataNamespace();
+
+private:
+  const std::string stats_prefix_;
+  Stats::Scope& scope_;
+  Runtime::Loader& runtime_;
+  Runtime::RandomGenerator& random_;
+  TimeSource& time_source_;
+  const Runtime::InternedKey sampling_key_;
+  const uint64_t sampling_;
+  const bool record_in_dynamic_metadata_;
+  std::list<Filter> filters_;
+};
+
+typedef std::unique_ptr<FilterTiming> FilterTimingPtr;
+
+/**
+ * Filter chain factory callbacks adding the filters of a sampled stream to the callbacks of the
+ * stream, each wrapped so that the time spent in its callbacks is measured. When a callback runs
+ * the callbacks of other filters, e.g. a decoder filter sending a local reply, only the innermost
+ * callback is timed, so that the time of each filter excludes the time of the others.
+ */
+class TimedFilterChainFactoryCallbacks : public FilterChainFactoryCallbacks {
+public:
+  TimedFilterChainFactoryCallbacks(FilterChainFactoryCallbacks& callbacks, FilterTiming& timing);
+
+  /**
+   * Sets the filter that the filters added next are timed as.
+   */
+  void setFilter(FilterTiming::Filter& filter) { filter_ = &filter; }
+
+  // Http::FilterChainFactoryCallbacks
+  void addStreamDecoderFilter(StreamDecoderFilterSharedPtr filter) override;
+  void addStreamEncoderFilter(StreamEncoderFilterSharedPtr filter) override;
+  void addStreamFilter(StreamFilterSharedPtr filter) override;
+  void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override;
+
+  /**
+   * The callback timers of the filters of a stream.
+   */
+  struct Timers;
+
+private:
+  FilterChainFactoryCallbacks& callbacks_;
+  FilterTiming& timing_;
+  FilterTiming::Filter* filter_{};
+  const std::shared_ptr<Timers> timers_;
+};
+
+} // namespace Http
+} // namespace Envoy
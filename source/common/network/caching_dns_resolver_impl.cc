@@ -0,0 +1,139 @@
+#include "common/network/caching_dns_resolver_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+// Size of the cache below which expired entries are only removed by lookups.
+constexpr size_t MinExpirySweepSize = 64;
+} // namespace
+
+CachingDnsResolverImpl::CachingDnsResolverImpl(DnsResolverSharedPtr resolver,
+                                               TimeSource& time_source, Stats::Scope& scope,
+                                               std::chrono::milliseconds min_ttl,
+                                               std::chrono::milliseconds max_ttl,
+                                               std::chrono::milliseconds negative_ttl)
+    : resolver_(resolver), time_source_(time_source),
+      stats_({ALL_DNS_CACHE_STATS(POOL_COUNTER_PREFIX(scope, "dns_cache."),
+                                  POOL_GAUGE_PREFIX(scope, "dns_cache."))}),
+      min_ttl_(min_ttl), max_ttl_(max_ttl), negative_ttl_(negative_ttl),
+      next_expiry_sweep_size_(MinExpirySweepSize) {}
+
+CachingDnsResolverImpl::~CachingDnsResolverImpl() {
+  // The wrapped resolver may outlive us, so make sure it doesn't call back into a deleted cache.
+  for (const auto& in_flight : in_flight_) {
+    if (in_flight.second->query_ != nullptr) {
+      in_flight.second->query_->cancel();
+    }
+  }
+}
+
+void CachingDnsResolverImpl::PendingResolution::cancel() {
+  // The resolution itself continues, so that its result is cached for later calls.
+  removeFromList(parent_.pending_resolutions_);
+}
+
+ActiveDnsQuery* CachingDnsResolverImpl::resolve(const std::string& dns_name,
+                                                DnsLookupFamily dns_lookup_family,
+                                                ResolveCb callback) {
+  return resolveWithTtl(dns_name, dns_lookup_family,
+                        [callback](const std::list<Address::InstanceConstSharedPtr>&& address_list,
+                                   std::chrono::seconds) { callback(std::move(address_list)); });
+}
+
+ActiveDnsQuery* CachingDnsResolverImpl::resolveWithTtl(const std::string& dns_name,
+                                                       DnsLookupFamily dns_lookup_family,
+                                                       ResolveWithTtlCb callback) {
+  const Key key{dns_name, dns_lookup_family};
+  const MonotonicTime now = time_source_.monotonicTime();
+  auto entry = cache_.find(key);
+  if (entry != cache_.end()) {
+    if (entry->second.expiry_ > now) {
+      std::list<Address::InstanceConstSharedPtr> address_list = entry->second.address_list_;
+      std::chrono::seconds ttl(0);
+      if (address_list.empty()) {
+        stats_.negative_hit_.inc();
+      } else {
+        stats_.hit_.inc();
+        ttl = std::chrono::duration_cast<std::chrono::seconds>(entry->second.expiry_ - now);
+      }
+      callback(std::move(address_list), ttl);
+      return nullptr;
+    }
+    cache_.erase(entry);
+    stats_.entries_.set(cache_.size());
+  }
+
+  InFlightResolutionPtr& in_flight = in_flight_[key];
+  if (in_flight != nullptr) {
+    stats_.coalesced_.inc();
+    PendingResolutionPtr pending(new PendingResolution(*in_flight, callback));
+    pending->moveIntoListBack(std::move(pending), in_flight->pending_resolutions_);
+    return in_flight->pending_resolutions_.back().get();
+  }
+
+  stats_.miss_.inc();
+  in_flight = std::make_unique<InFlightResolution>();
+  InFlightResolution& resolution = *in_flight;
+  PendingResolutionPtr pending(new PendingResolution(resolution, callback));
+  pending->moveIntoListBack(std::move(pending), resolution.pending_resolutions_);
+  ActiveDnsQuery* query = resolver_->resolveWithTtl(
+      dns_name, dns_lookup_family,
+      [this, key](const std::list<Address::InstanceConstSharedPtr>&& address_list,
+                  std::chrono::seconds ttl) { onResolution(key, std::move(address_list), ttl); });
+  if (query == nullptr) {
+    // The resolution completed synchronously and has already been delivered.
+    return nullptr;
+  }
+  resolution.query_ = query;
+  return resolution.pending_resolutions_.front().get();
+}
+
+void CachingDnsResolverImpl::onResolution(const Key& key,
+                                          std::list<Address::InstanceConstSharedPtr>&& address_list,
+                                          std::chrono::seconds ttl) {
+  auto it = in_flight_.find(key);
+  ASSERT(it != in_flight_.end());
+  InFlightResolutionPtr resolution = std::move(it->second);
+  in_flight_.erase(it);
+
+  std::chrono::milliseconds cache_ttl = negative_ttl_;
+  if (!address_list.empty()) {
+    cache_ttl = std::min(std::max<std::chrono::milliseconds>(ttl, min_ttl_), max_ttl_);
+  }
+  if (cache_ttl.count() > 0) {
+    const MonotonicTime now = time_source_.monotonicTime();
+    if (cache_.size() >= next_expiry_sweep_size_) {
+      removeExpiredEntries(now);
+    }
+    cache_[key] = {address_list, now + cache_ttl};
+    stats_.entries_.set(cache_.size());
+  }
+  ENVOY_LOG(debug, "DNS resolution of {} with {} addresses cached for {}ms", key.first,
+            address_list.size(), cache_ttl.count());
+
+  while (!resolution->pending_resolutions_.empty()) {
+    PendingResolutionPtr pending =
+        resolution->pending_resolutions_.front()->removeFromList(resolution->pending_resolutions_);
+    std::list<Address::InstanceConstSharedPtr> pending_address_list = address_list;
+    pending->callback_(std::move(pending_address_list), ttl);
+  }
+}
+
+void CachingDnsResolverImpl::removeExpiredEntries(MonotonicTime now) {
+  for (auto it = cache_.begin(); it != cache_.end();) {
+    if (it->second.expiry_ <= now) {
+      it = cache_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  next_expiry_sweep_size_ = std::max(MinExpirySweepSize, 2 * cache_.size());
+}
+
+} // namespace Network
+} // namespace Envoy
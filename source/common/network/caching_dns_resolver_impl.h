@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/common/time.h"
+#include "envoy/network/dns.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/linked_object.h"
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * All DNS cache stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_DNS_CACHE_STATS(COUNTER, GAUGE)                                                        \
+  COUNTER(hit)                                                                                     \
+  COUNTER(negative_hit)                                                                            \
+  COUNTER(miss)                                                                                    \
+  COUNTER(coalesced)                                                                               \
+  GAUGE  (entries)
+// clang-format on
+
+/**
+ * Struct definition for all DNS cache stats. @see stats_macros.h
+ */
+struct DnsCacheStats {
+  ALL_DNS_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * DnsResolver that caches the results of another resolver for the TTL of their DNS records, so
+ * that clusters resolving the same name share a single query per TTL. Failed resolutions are
+ * cached for a fixed negative TTL, and concurrent resolutions of the same name are coalesced into
+ * a single query. All calls and callbacks are assumed to happen on the thread that owns the
+ * wrapped resolver.
+ */
+class CachingDnsResolverImpl : public DnsResolver, Logger::Loggable<Logger::Id::upstream> {
+public:
+  /**
+   * @param resolver supplies the resolver to cache the results of.
+   * @param time_source supplies the time source used to expire entries.
+   * @param scope supplies the scope to create the dns_cache.* stats in.
+   * @param min_ttl supplies the shortest time a successful resolution is cached for.
+   * @param max_ttl supplies the longest time a successful resolution is cached for.
+   * @param negative_ttl supplies how long a failed resolution is cached for.
+   */
+  CachingDnsResolverImpl(DnsResolverSharedPtr resolver, TimeSource& time_source,
+                         Stats::Scope& scope, std::chrono::milliseconds min_ttl,
+                         std::chrono::milliseconds max_ttl, std::chrono::milliseconds negative_ttl);
+  ~CachingDnsResolverImpl();
+
+  // Network::DnsResolver
+  ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                          ResolveCb callback) override;
+  ActiveDnsQuery* resolveWithTtl(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                                 ResolveWithTtlCb callback) override;
+
+  /**
+   * @return the number of cached resolutions, including expired ones not yet removed.
+   */
+  size_t size() const { return cache_.size(); }
+
+private:
+  typedef std::pair<std::string, DnsLookupFamily> Key;
+
+  struct CacheEntry {
+    std::list<Address::InstanceConstSharedPtr> address_list_;
+    MonotonicTime expiry_;
+  };
+
+  struct InFlightResolution;
+
+  /**
+   * A resolve() call waiting for an in flight resolution of its name.
+   */
+  struct PendingResolution : public ActiveDnsQuery, LinkedObject<PendingResolution> {
+    PendingResolution(InFlightResolution& parent, ResolveWithTtlCb callback)
+        : parent_(parent), callback_(callback) {}
+
+    // Network::ActiveDnsQuery
+    void cancel() override;
+
+    InFlightResolution& parent_;
+    const ResolveWithTtlCb callback_;
+  };
+
+  typedef std::unique_ptr<PendingResolution> PendingResolutionPtr;
+
+  /**
+   * A resolution of a name by the wrapped resolver, with the calls waiting for it.
+   */
+  struct InFlightResolution {
+    ActiveDnsQuery* query_{};
+    std::list<PendingResolutionPtr> pending_resolutions_;
+  };
+
+  typedef std::unique_ptr<InFlightResolution> InFlightResolutionPtr;
+
+  void onResolution(const Key& key, std::list<Address::InstanceConstSharedPtr>&& address_list,
+                    std::chrono::seconds ttl);
+  void removeExpiredEntries(MonotonicTime now);
+
+  const DnsResolverSharedPtr resolver_;
+  TimeSource& time_source_;
+  DnsCacheStats stats_;
+  const std::chrono::milliseconds min_ttl_;
+  const std::chrono::milliseconds max_ttl_;
+  const std::chrono::milliseconds negative_ttl_;
+  std::map<Key, CacheEntry> cache_;
+  std::map<Key, InFlightResolutionPtr> in_flight_;
+  // Expired entries are removed once the cache grows to this size, which is then set to twice the
+  // remaining size. Lookups remove the expired entries they find, so this only bounds the entries
+  // of names that are no longer resolved.
+  size_t next_expiry_sweep_size_;
+};
+
+} // namespace Network
+} // namespace Envoy
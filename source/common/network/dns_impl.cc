@@ -1,11 +1,15 @@
 #include "common/network/dns_impl.h"
 
+#include <arpa/inet.h>
+#include <arpa/nameser.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
@@ -20,6 +24,12 @@
 namespace Envoy {
 namespace Network {
 
+namespace {
+// Maximum number of record TTLs parsed from a DNS answer. Answers with more records are rare, and
+// the TTLs of the records beyond this are ignored.
+constexpr int MaxAddrTtls = 32;
+} // namespace
+
 DnsResolverImpl::DnsResolverImpl(
     Event::Dispatcher& dispatcher,
     const std::vector<Network::Address::InstanceConstSharedPtr>& resolvers)
@@ -75,7 +85,8 @@ void DnsResolverImpl::initializeChannel(ares_options* options, int optmask) {
 }
 
 void DnsResolverImpl::PendingResolution::onAresHostCallback(int status, int timeouts,
-                                                            hostent* hostent) {
+                                                            hostent* hostent,
+                                                            std::chrono::seconds ttl) {
   // We receive ARES_EDESTRUCTION when destructing with pending queries.
   if (status == ARES_EDESTRUCTION) {
     ASSERT(owned_);
@@ -120,8 +131,11 @@ void DnsResolverImpl::PendingResolution::onAresHostCallback(int status, int time
 
   if (completed_) {
     if (!cancelled_) {
+      if (address_list.empty()) {
+        ttl = std::chrono::seconds(0);
+      }
       try {
-        callback_(std::move(address_list));
+        callback_(std::move(address_list), ttl);
       } catch (const EnvoyException& e) {
         ENVOY_LOG(critical, "EnvoyException in c-ares callback");
         dispatcher_.post([s = std::string(e.what())] { throw EnvoyException(s); });
@@ -190,8 +204,50 @@ void DnsResolverImpl::onAresSocketStateChange(int fd, int read, int write) {
                           (write ? Event::FileReadyType::Write : 0));
 }
 
+void DnsResolverImpl::PendingResolution::onAresSearchCallback(int status, int timeouts,
+                                                              unsigned char* abuf, int alen) {
+  if (status != ARES_SUCCESS) {
+    onAresHostCallback(status, timeouts, nullptr, std::chrono::seconds(0));
+    return;
+  }
+
+  hostent* hostent = nullptr;
+  int naddrttls = MaxAddrTtls;
+  int ttl = std::numeric_limits<int>::max();
+  if (family_ == AF_INET) {
+    ares_addrttl addrttls[MaxAddrTtls];
+    status = ares_parse_a_reply(abuf, alen, &hostent, addrttls, &naddrttls);
+    for (int i = 0; status == ARES_SUCCESS && i < naddrttls; ++i) {
+      ttl = std::min(ttl, addrttls[i].ttl);
+    }
+  } else {
+    ares_addr6ttl addrttls[MaxAddrTtls];
+    status = ares_parse_aaaa_reply(abuf, alen, &hostent, addrttls, &naddrttls);
+    for (int i = 0; status == ARES_SUCCESS && i < naddrttls; ++i) {
+      ttl = std::min(ttl, addrttls[i].ttl);
+    }
+  }
+  if (status != ARES_SUCCESS || naddrttls == 0) {
+    ttl = 0;
+  }
+
+  onAresHostCallback(status, timeouts, hostent, std::chrono::seconds(std::max(ttl, 0)));
+  // Note: this object may have been deleted by onAresHostCallback().
+  if (hostent != nullptr) {
+    ares_free_hostent(hostent);
+  }
+}
+
 ActiveDnsQuery* DnsResolverImpl::resolve(const std::string& dns_name,
                                          DnsLookupFamily dns_lookup_family, ResolveCb callback) {
+  return resolveWithTtl(dns_name, dns_lookup_family,
+                        [callback](const std::list<Address::InstanceConstSharedPtr>&& address_list,
+                                   std::chrono::seconds) { callback(std::move(address_list)); });
+}
+
+ActiveDnsQuery* DnsResolverImpl::resolveWithTtl(const std::string& dns_name,
+                                                DnsLookupFamily dns_lookup_family,
+                                                ResolveWithTtlCb callback) {
   // TODO(hennna): Add DNS caching which will allow testing the edge case of a
   // failed initial call to getHostByName followed by a synchronous IPv4
   // resolution.
@@ -223,12 +279,37 @@ ActiveDnsQuery* DnsResolverImpl::resolve(const std::string& dns_name,
 }
 
 void DnsResolverImpl::PendingResolution::getHostByName(int family) {
-  ares_gethostbyname(channel_, dns_name_.c_str(), family,
-                     [](void* arg, int status, int timeouts, hostent* hostent) {
-                       static_cast<PendingResolution*>(arg)->onAresHostCallback(status, timeouts,
-                                                                                hostent);
-                     },
-                     this);
+  family_ = family;
+
+  // Numeric addresses are resolved synchronously by ares_gethostbyname().
+  uint8_t numeric_address[sizeof(in6_addr)];
+  if (inet_pton(family, dns_name_.c_str(), numeric_address) == 1) {
+    ares_gethostbyname(channel_, dns_name_.c_str(), family,
+                       [](void* arg, int status, int timeouts, hostent* hostent) {
+                         static_cast<PendingResolution*>(arg)->onAresHostCallback(
+                             status, timeouts, hostent, std::chrono::seconds(0));
+                       },
+                       this);
+    return;
+  }
+
+  hostent* file_hostent;
+  if (ares_gethostbyname_file(channel_, dns_name_.c_str(), family, &file_hostent) ==
+      ARES_SUCCESS) {
+    onAresHostCallback(ARES_SUCCESS, 0, file_hostent, std::chrono::seconds(0));
+    // Note: this object may have been deleted by onAresHostCallback().
+    ares_free_hostent(file_hostent);
+    return;
+  }
+
+  // Other names are looked up with the same DNS query ares_gethostbyname() would send, but the
+  // answer is parsed here so that the TTLs of its records are known.
+  ares_search(channel_, dns_name_.c_str(), ns_c_in, family == AF_INET ? ns_t_a : ns_t_aaaa,
+              [](void* arg, int status, int timeouts, unsigned char* abuf, int alen) {
+                static_cast<PendingResolution*>(arg)->onAresSearchCallback(status, timeouts, abuf,
+                                                                           alen);
+              },
+              this);
 }
 
 } // namespace Network
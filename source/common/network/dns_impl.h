@@ -2,6 +2,7 @@
 
 #include <netdb.h>
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <unordered_map>
@@ -34,13 +35,15 @@ public:
   // Network::DnsResolver
   ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
                           ResolveCb callback) override;
+  ActiveDnsQuery* resolveWithTtl(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                                 ResolveWithTtlCb callback) override;
 
 private:
   friend class DnsResolverImplPeer;
   struct PendingResolution : public ActiveDnsQuery {
     // Network::ActiveDnsQuery
-    PendingResolution(ResolveCb callback, Event::Dispatcher& dispatcher, ares_channel channel,
-                      const std::string& dns_name)
+    PendingResolution(ResolveWithTtlCb callback, Event::Dispatcher& dispatcher,
+                      ares_channel channel, const std::string& dns_name)
         : callback_(callback), dispatcher_(dispatcher), channel_(channel), dns_name_(dns_name) {}
 
     void cancel() override {
@@ -54,16 +57,27 @@ private:
      * @param status return status of call to ares_gethostbyname.
      * @param timeouts the number of times the request timed out.
      * @param hostent structure that stores information about a given host.
+     * @param ttl the smallest TTL of the records the addresses in hostent came from.
      */
-    void onAresHostCallback(int status, int timeouts, hostent* hostent);
+    void onAresHostCallback(int status, int timeouts, hostent* hostent, std::chrono::seconds ttl);
     /**
-     * wrapper function of call to ares_gethostbyname.
+     * c-ares ares_search() query callback. Parses the A or AAAA records of the answer, along
+     * with their TTLs.
+     * @param status return status of call to ares_search.
+     * @param timeouts the number of times the request timed out.
+     * @param abuf the answer.
+     * @param alen the length of the answer.
+     */
+    void onAresSearchCallback(int status, int timeouts, unsigned char* abuf, int alen);
+    /**
+     * Resolve the name for an address family. Numeric addresses and hosts file entries are
+     * resolved synchronously, other names with a DNS query.
      * @param family currently AF_INET and AF_INET6 are supported.
      */
     void getHostByName(int family);
 
     // Caller supplied callback to invoke on query completion or error.
-    const ResolveCb callback_;
+    const ResolveWithTtlCb callback_;
     // Dispatcher to post any callback_ exceptions to.
     Event::Dispatcher& dispatcher_;
     // Does the object own itself? Resource reclamation occurs via self-deleting
@@ -76,6 +90,8 @@ private:
     // If dns_lookup_family is "fallback", fallback to v4 address if v6
     // resolution failed.
     bool fallback_if_failed_ = false;
+    // Address family of the current lookup.
+    int family_ = AF_UNSPEC;
     const ares_channel channel_;
     const std::string dns_name_;
   };
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Structure for associating data with server names, e.g. the SNI of TLS connections. Exact names
+ * are found with a single hash lookup of the whole name. Wildcard domains are kept in a trie of
+ * labels stored from the last label to the first, so "*.example.com" is found by walking "com"
+ * and "example", and the longest wildcard matching a name is found in a single walk of its labels,
+ * without copying it. The cost of a lookup is therefore bound by the number of labels of the name
+ * rather than the number of names added.
+ *
+ * Three kinds of names can be added:
+ * - exact names, e.g. "www.example.com", matching only that name.
+ * - wildcard names, e.g. "*.example.com", matching any name with more labels than
+ *   "example.com", e.g. "www.example.com" and "a.b.example.com", but not "example.com".
+ * - the empty name, matching names that match nothing else, and requests without a server name.
+ *
+ * An exact match wins over a wildcard match, and a longer wildcard wins over a shorter one.
+ */
+template <class T> class ServerNameTrie {
+public:
+  /**
+   * Returns the data of a name, adding the name with default constructed data if it wasn't added
+   * yet.
+   * @param server_name supplies an exact name, a wildcard name made of "*." and a domain without
+   *        empty labels, or the empty name. "*." alone would match every non-empty name.
+   * @return T& the data associated with the name.
+   */
+  T& add(absl::string_view server_name) {
+    if (server_name.empty()) {
+      return getOrCreate(any_);
+    }
+    if (!absl::StartsWith(server_name, "*.")) {
+      return getOrCreate(exact_names_[std::string(server_name)]);
+    }
+
+    server_name.remove_prefix(2);
+    Node* node = &root_;
+    bool labels_left = !server_name.empty();
+    while (labels_left) {
+      std::unique_ptr<Node>& child =
+          node->children_[std::string(popLabel(server_name, labels_left))];
+      if (child == nullptr) {
+        child = std::make_unique<Node>();
+      }
+      node = child.get();
+    }
+    return getOrCreate(node->wildcard_);
+  }
+
+  /**
+   * @param server_name supplies the server name to match, which may be empty.
+   * @return const T* the data of the best match for the name, or nullptr if nothing matches.
+   */
+  const T* find(absl::string_view server_name) const {
+    if (!exact_names_.empty()) {
+      const auto exact_match = exact_names_.find(server_name);
+      if (exact_match != exact_names_.end()) {
+        return exact_match->second.get();
+      }
+    }
+
+    const Node* node = &root_;
+    const T* wildcard_match = nullptr;
+    bool labels_left = !server_name.empty();
+    while (node != nullptr && labels_left) {
+      // The name has labels left past this node, so a wildcard stored here matches it.
+      if (node->wildcard_ != nullptr) {
+        wildcard_match = node->wildcard_.get();
+      }
+      if (node->children_.empty()) {
+        break;
+      }
+      const auto child = node->children_.find(popLabel(server_name, labels_left));
+      node = child != node->children_.end() ? child->second.get() : nullptr;
+    }
+
+    return wildcard_match != nullptr ? wildcard_match : any_.get();
+  }
+
+private:
+  struct Node {
+    // Keyed by the label preceding the labels of this node.
+    absl::flat_hash_map<std::string, std::unique_ptr<Node>> children_;
+    // The data of the wildcard for the domain of this node.
+    std::unique_ptr<T> wildcard_;
+  };
+
+  static T& getOrCreate(std::unique_ptr<T>& data) {
+    if (data == nullptr) {
+      data = std::make_unique<T>();
+    }
+    return *data;
+  }
+
+  // Removes the last label from a name and returns it. Labels may be empty, so labels_left is
+  // cleared once the first label of the name is removed, rather than when the name is empty.
+  static absl::string_view popLabel(absl::string_view& name, bool& labels_left) {
+    const size_t dot = name.rfind('.');
+    if (dot == absl::string_view::npos) {
+      const absl::string_view label = name;
+      name = absl::string_view();
+      labels_left = false;
+      return label;
+    }
+    const absl::string_view label = name.substr(dot + 1);
+    name = name.substr(0, dot);
+    return label;
+  }
+
+  absl::flat_hash_map<std::string, std::unique_ptr<T>> exact_names_;
+  // The trie of wildcard domains.
+  Node root_;
+  std::unique_ptr<T> any_;
+};
+
+} // namespace Network
+} // namespace Envoy
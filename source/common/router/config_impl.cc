@@ -483,12 +483,10 @@ void RouteEntryImplBase::finalizeResponseHeaders(Http::HeaderMap& headers,
 absl::optional<RouteEntryImplBase::RuntimeData>
 RouteEntryImplBase::loadRuntimeData(const envoy::api::v2::route::RouteMatch& route_match) {
   absl::optional<RuntimeData> runtime;
-  RuntimeData runtime_data;
 
   if (route_match.has_runtime_fraction()) {
-    runtime_data.fractional_runtime_default_ = route_match.runtime_fraction().default_value();
-    runtime_data.fractional_runtime_key_ = route_match.runtime_fraction().runtime_key();
-    return runtime_data;
+    runtime = RuntimeData{loader_.internKey(route_match.runtime_fraction().runtime_key()),
+                          route_match.runtime_fraction().default_value()};
   }
 
   return runtime;
@@ -439,8 +439,9 @@ protected:
 
 private:
   struct RuntimeData {
-    std::string fractional_runtime_key_{};
-    envoy::type::FractionalPercent fractional_runtime_default_{};
+    // Interned since it is looked up on every match of the route.
+    Runtime::InternedKey fractional_runtime_key_;
+    envoy::type::FractionalPercent fractional_runtime_default_;
   };
 
   class DynamicRouteEntry : public RouteEntry, public Route {
@@ -1,5 +1,6 @@
 #include "common/router/router.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -531,6 +532,34 @@ void Filter::onResponseTimeout() {
   onUpstreamReset(UpstreamResetType::GlobalTimeout, absl::optional<Http::StreamResetReason>());
 }
 
+void Filter::recordPeakEwmaResponseTime(const Upstream::HostDescription& upstream_host,
+                                        bool failed) {
+  if (cluster_->lbType() != Upstream::LoadBalancerType::PeakEwma) {
+    return;
+  }
+
+  const MonotonicTime now = callbacks_->dispatcher().timeSource().monotonicTime();
+  absl::optional<std::chrono::microseconds> response_time;
+  if (DateUtil::timePointValid(downstream_request_complete_time_)) {
+    response_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        now - downstream_request_complete_time_);
+  }
+  if (failed) {
+    // A reset may come long before the timeout, e.g. when the host refuses connections, so charge
+    // at least the timeout, as a timed out request would.
+    const std::chrono::milliseconds penalty = timeout_.per_try_timeout_.count() > 0
+                                                  ? timeout_.per_try_timeout_
+                                                  : timeout_.global_timeout_;
+    if (penalty.count() > 0) {
+      response_time = std::max<std::chrono::microseconds>(
+          response_time.value_or(std::chrono::microseconds(0)), penalty);
+    }
+  }
+  if (response_time) {
+    upstream_host.recordResponseTime(response_time.value(), now);
+  }
+}
+
 void Filter::onUpstreamReset(UpstreamResetType type,
                              const absl::optional<Http::StreamResetReason>& reset_reason) {
   ASSERT(type == UpstreamResetType::GlobalTimeout || upstream_request_);
@@ -546,6 +575,7 @@ void Filter::onUpstreamReset(UpstreamResetType type,
       upstream_host->outlierDetector().putHttpResponseCode(
           enumToInt(type == UpstreamResetType::Reset ? Http::Code::ServiceUnavailable
                                                      : timeout_response_code_));
+      recordPeakEwmaResponseTime(*upstream_host, true);
     }
   }
 
@@ -792,6 +822,9 @@ void Filter::onUpstreamComplete() {
     upstream_request_->resetStream();
   }
 
+  // This is independent of dynamic stats so that the balancer works when they are disabled.
+  recordPeakEwmaResponseTime(*upstream_request_->upstream_host_, false);
+
   if (config_.emit_dynamic_stats_ && !callbacks_->streamInfo().healthCheck() &&
       DateUtil::timePointValid(downstream_request_complete_time_)) {
     Event::Dispatcher& dispatcher = callbacks_->dispatcher();
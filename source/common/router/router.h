@@ -380,6 +380,9 @@ private:
   void onUpstreamComplete();
   void onUpstreamReset(UpstreamResetType type,
                        const absl::optional<Http::StreamResetReason>& reset_reason);
+  // Feeds the response time estimate of the peak EWMA load balancer. A failed request counts as
+  // taking at least as long as the request timeout, so that a host failing fast does not look fast.
+  void recordPeakEwmaResponseTime(const Upstream::HostDescription& upstream_host, bool failed);
   void sendNoHealthyUpstreamResponse();
   bool setupRetry(bool end_stream);
   bool setupRedirect(const Http::HeaderMap& headers);
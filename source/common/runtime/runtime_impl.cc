@@ -17,6 +17,7 @@
 #include "common/runtime/runtime_features.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "openssl/rand.h"
 
 namespace Envoy {
@@ -167,19 +168,11 @@ bool SnapshotImpl::deprecatedFeatureEnabled(const std::string& key) const {
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value,
                                   uint64_t random_value, uint64_t num_buckets) const {
-  return random_value % num_buckets < std::min(getInteger(key, default_value), num_buckets);
+  return entryFeatureEnabled(find(key), default_value, random_value, num_buckets);
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value) const {
-  // Avoid PRNG if we know we don't need it.
-  uint64_t cutoff = std::min(getInteger(key, default_value), static_cast<uint64_t>(100));
-  if (cutoff == 0) {
-    return false;
-  } else if (cutoff == 100) {
-    return true;
-  } else {
-    return generator_.random() % 100 < cutoff;
-  }
+  return entryFeatureEnabled(find(key), default_value);
 }
 
 bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value,
@@ -188,11 +181,11 @@ bool SnapshotImpl::featureEnabled(const std::string& key, uint64_t default_value
 }
 
 const std::string& SnapshotImpl::get(const std::string& key) const {
-  auto entry = values_.find(key);
-  if (entry == values_.end()) {
+  const Entry* entry = find(key);
+  if (entry == nullptr) {
     return EMPTY_STRING;
   } else {
-    return entry->second.raw_string_value_;
+    return entry->raw_string_value_;
   }
 }
 
@@ -204,62 +197,154 @@ bool SnapshotImpl::featureEnabled(const std::string& key,
 bool SnapshotImpl::featureEnabled(const std::string& key,
                                   const envoy::type::FractionalPercent& default_value,
                                   uint64_t random_value) const {
-  const auto& entry = values_.find(key);
+  return entryFeatureEnabled(find(key), default_value, random_value);
+}
+
+bool SnapshotImpl::featureEnabled(const InternedKey& key, uint64_t default_value) const {
+  return entryFeatureEnabled(find(key), default_value);
+}
+
+bool SnapshotImpl::featureEnabled(const InternedKey& key, uint64_t default_value,
+                                  uint64_t random_value, uint64_t num_buckets) const {
+  return entryFeatureEnabled(find(key), default_value, random_value, num_buckets);
+}
+
+bool SnapshotImpl::featureEnabled(const InternedKey& key,
+                                  const envoy::type::FractionalPercent& default_value,
+                                  uint64_t random_value) const {
+  return entryFeatureEnabled(find(key), default_value, random_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value) const {
+  return entryInteger(find(key), default_value);
+}
+
+uint64_t SnapshotImpl::getInteger(const InternedKey& key, uint64_t default_value) const {
+  return entryInteger(find(key), default_value);
+}
+
+double SnapshotImpl::getDouble(const std::string& key, double default_value) const {
+  return entryDouble(find(key), default_value);
+}
+
+double SnapshotImpl::getDouble(const InternedKey& key, double default_value) const {
+  return entryDouble(find(key), default_value);
+}
+
+bool SnapshotImpl::getBoolean(const std::string& key, bool& value) const {
+  const Entry* entry = find(key);
+  if (entry != nullptr && entry->bool_value_.has_value()) {
+    value = entry->bool_value_.value();
+    return true;
+  }
+  return false;
+}
+
+const std::vector<Snapshot::OverrideLayerConstPtr>& SnapshotImpl::getLayers() const {
+  return *layers_;
+}
+
+const Snapshot::Entry* SnapshotImpl::find(const std::string& key) const {
+  auto entry = values_->find(key);
+  return entry == values_->end() ? nullptr : &entry->second;
+}
+
+const Snapshot::Entry* SnapshotImpl::find(const InternedKey& key) const {
+  // A key interned after this snapshot was created has no value in it, otherwise the loader would
+  // have published a snapshot indexing the key before any config using it.
+  return key.index() < interned_values_.size() ? interned_values_[key.index()] : nullptr;
+}
+
+bool SnapshotImpl::entryFeatureEnabled(const Entry* entry, uint64_t default_value) const {
+  // Avoid PRNG if we know we don't need it.
+  uint64_t cutoff = std::min(entryInteger(entry, default_value), static_cast<uint64_t>(100));
+  if (cutoff == 0) {
+    return false;
+  } else if (cutoff == 100) {
+    return true;
+  } else {
+    return generator_.random() % 100 < cutoff;
+  }
+}
+
+bool SnapshotImpl::entryFeatureEnabled(const Entry* entry, uint64_t default_value,
+                                       uint64_t random_value, uint64_t num_buckets) {
+  return random_value % num_buckets < std::min(entryInteger(entry, default_value), num_buckets);
+}
+
+bool SnapshotImpl::entryFeatureEnabled(const Entry* entry,
+                                       const envoy::type::FractionalPercent& default_value,
+                                       uint64_t random_value) {
   envoy::type::FractionalPercent percent;
-  if (entry != values_.end() && entry->second.fractional_percent_value_.has_value()) {
-    percent = entry->second.fractional_percent_value_.value();
-  } else if (entry != values_.end() && entry->second.uint_value_.has_value()) {
+  if (entry != nullptr && entry->fractional_percent_value_.has_value()) {
+    percent = entry->fractional_percent_value_.value();
+  } else if (entry != nullptr && entry->uint_value_.has_value()) {
     // Check for > 100 because the runtime value is assumed to be specified as
     // an integer, and it also ensures that truncating the uint64_t runtime
     // value into a uint32_t percent numerator later is safe
-    if (entry->second.uint_value_.value() > 100) {
+    if (entry->uint_value_.value() > 100) {
       return true;
     }
 
     // The runtime value was specified as an integer rather than a fractional
     // percent proto. To preserve legacy semantics, we treat it as a percentage
     // (i.e. denominator of 100).
-    percent.set_numerator(entry->second.uint_value_.value());
+    percent.set_numerator(entry->uint_value_.value());
     percent.set_denominator(envoy::type::FractionalPercent::HUNDRED);
   } else {
-    percent = default_value;
+    return ProtobufPercentHelper::evaluateFractionalPercent(default_value, random_value);
   }
 
   return ProtobufPercentHelper::evaluateFractionalPercent(percent, random_value);
 }
 
-uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value) const {
-  auto entry = values_.find(key);
-  if (entry == values_.end() || !entry->second.uint_value_) {
+uint64_t SnapshotImpl::entryInteger(const Entry* entry, uint64_t default_value) {
+  if (entry == nullptr || !entry->uint_value_) {
     return default_value;
   } else {
-    return entry->second.uint_value_.value();
+    return entry->uint_value_.value();
   }
 }
 
-bool SnapshotImpl::getBoolean(const std::string& key, bool& value) const {
-  auto entry = values_.find(key);
-  if (entry != values_.end() && entry->second.bool_value_.has_value()) {
-    value = entry->second.bool_value_.value();
-    return true;
+double SnapshotImpl::entryDouble(const Entry* entry, double default_value) {
+  if (entry == nullptr || !entry->double_value_) {
+    return default_value;
+  } else {
+    return entry->double_value_.value();
   }
-  return false;
-}
-
-const std::vector<Snapshot::OverrideLayerConstPtr>& SnapshotImpl::getLayers() const {
-  return layers_;
 }
 
 SnapshotImpl::SnapshotImpl(RandomGenerator& generator, RuntimeStats& stats,
-                           std::vector<OverrideLayerConstPtr>&& layers)
-    : layers_{std::move(layers)}, generator_{generator}, stats_{stats} {
-  for (const auto& layer : layers_) {
+                           std::vector<OverrideLayerConstPtr>&& layers,
+                           const std::vector<std::string>& interned_keys)
+    : layers_{std::make_shared<std::vector<OverrideLayerConstPtr>>(std::move(layers))},
+      generator_{generator}, stats_{stats} {
+  auto values = std::make_shared<EntryMap>();
+  for (const auto& layer : *layers_) {
     for (const auto& kv : layer->values()) {
-      values_.erase(kv.first);
-      values_.emplace(kv.first, kv.second);
+      values->erase(kv.first);
+      values->emplace(kv.first, kv.second);
     }
   }
-  stats.num_keys_.set(values_.size());
+  values_ = std::move(values);
+  stats.num_keys_.set(values_->size());
+  indexInternedKeys(interned_keys);
+}
+
+SnapshotImpl::SnapshotImpl(const SnapshotImpl& snapshot,
+                           const std::vector<std::string>& interned_keys)
+    : layers_{snapshot.layers_}, values_{snapshot.values_},
+      interned_values_{snapshot.interned_values_}, generator_{snapshot.generator_},
+      stats_{snapshot.stats_} {
+  indexInternedKeys(interned_keys);
+}
+
+void SnapshotImpl::indexInternedKeys(const std::vector<std::string>& interned_keys) {
+  // Entries of an unordered_map are not moved by lookups, and values_ is immutable from here on.
+  interned_values_.reserve(interned_keys.size());
+  for (size_t i = interned_values_.size(); i < interned_keys.size(); ++i) {
+    interned_values_.push_back(find(interned_keys[i]));
+  }
 }
 
 SnapshotImpl::Entry SnapshotImpl::createEntry(const std::string& value) {
@@ -291,6 +376,16 @@ bool SnapshotImpl::parseEntryUintValue(Entry& entry) {
   uint64_t converted_uint64;
   if (StringUtil::atoull(entry.raw_string_value_.c_str(), converted_uint64)) {
     entry.uint_value_ = converted_uint64;
+    entry.double_value_ = converted_uint64;
+    return true;
+  }
+  return false;
+}
+
+bool SnapshotImpl::parseEntryDoubleValue(Entry& entry) {
+  double converted_double;
+  if (absl::SimpleAtod(entry.raw_string_value_, &converted_double)) {
+    entry.double_value_ = converted_double;
     return true;
   }
   return false;
@@ -395,11 +490,16 @@ LoaderImpl::LoaderImpl(DoNotLoadSnapshot /* unused */, RandomGenerator& generato
 std::unique_ptr<SnapshotImpl> LoaderImpl::createNewSnapshot() {
   std::vector<Snapshot::OverrideLayerConstPtr> layers;
   layers.emplace_back(std::make_unique<const AdminLayer>(admin_layer_));
-  return std::make_unique<SnapshotImpl>(generator_, stats_, std::move(layers));
+  return std::make_unique<SnapshotImpl>(generator_, stats_, std::move(layers), interned_keys_);
 }
 
 void LoaderImpl::loadNewSnapshot() {
-  ThreadLocal::ThreadLocalObjectSharedPtr ptr = createNewSnapshot();
+  snapshot_ = createNewSnapshot();
+  publishSnapshot();
+}
+
+void LoaderImpl::publishSnapshot() {
+  ThreadLocal::ThreadLocalObjectSharedPtr ptr = snapshot_;
   tls_->set([ptr = std::move(ptr)](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return ptr;
   });
@@ -412,6 +512,26 @@ void LoaderImpl::mergeValues(const std::unordered_map<std::string, std::string>&
   loadNewSnapshot();
 }
 
+InternedKey LoaderImpl::internKey(const std::string& key) {
+  auto it = interned_key_indices_.find(key);
+  if (it != interned_key_indices_.end()) {
+    return InternedKey(key, it->second);
+  }
+
+  const uint32_t index = interned_keys_.size();
+  interned_key_indices_.emplace(key, index);
+  interned_keys_.push_back(key);
+  // Published snapshots treat keys interned after them as having no value. That only holds if a
+  // snapshot indexing the key is published before any config using it reaches the workers. TLS
+  // updates are posted in order, so publishing one now is enough. Most keys have no value, so
+  // this is rare and interning stays cheap.
+  if (snapshot_->contains(key)) {
+    snapshot_ = std::make_shared<SnapshotImpl>(*snapshot_, interned_keys_);
+    publishSnapshot();
+  }
+  return InternedKey(key, index);
+}
+
 DiskBackedLoaderImpl::DiskBackedLoaderImpl(Event::Dispatcher& dispatcher,
                                            ThreadLocal::SlotAllocator& tls,
                                            const std::string& root_symlink_path,
@@ -450,7 +570,7 @@ std::unique_ptr<SnapshotImpl> DiskBackedLoaderImpl::createNewSnapshot() {
     ENVOY_LOG(debug, "error loading runtime values from disk: {}", e.what());
   }
   layers.push_back(std::make_unique<AdminLayer>(admin_layer_));
-  return std::make_unique<SnapshotImpl>(generator_, stats_, std::move(layers));
+  return std::make_unique<SnapshotImpl>(generator_, stats_, std::move(layers), interned_keys_);
 }
 
 } // namespace Runtime
@@ -62,13 +62,25 @@ struct RuntimeStats {
 
 /**
  * Implementation of Snapshot whose source is the vector of layers passed to the constructor.
+ * Values are parsed when their layer is loaded, and the values of interned keys are indexed when
+ * the snapshot is created, so lookups of interned keys are a bounds check and an array access.
  */
 class SnapshotImpl : public Snapshot,
                      public ThreadLocal::ThreadLocalObject,
                      Logger::Loggable<Logger::Id::runtime> {
 public:
+  /**
+   * @param interned_keys supplies the keys interned by the loader, ordered by index.
+   */
   SnapshotImpl(RandomGenerator& generator, RuntimeStats& stats,
-               std::vector<OverrideLayerConstPtr>&& layers);
+               std::vector<OverrideLayerConstPtr>&& layers,
+               const std::vector<std::string>& interned_keys);
+
+  /**
+   * Create a snapshot with the same values as another one, which also indexes the keys interned
+   * since that one was created.
+   */
+  SnapshotImpl(const SnapshotImpl& snapshot, const std::vector<std::string>& interned_keys);
 
   // Runtime::Snapshot
   bool deprecatedFeatureEnabled(const std::string& key) const override;
@@ -81,10 +93,23 @@ public:
                       const envoy::type::FractionalPercent& default_value) const override;
   bool featureEnabled(const std::string& key, const envoy::type::FractionalPercent& default_value,
                       uint64_t random_value) const override;
+  bool featureEnabled(const InternedKey& key, uint64_t default_value) const override;
+  bool featureEnabled(const InternedKey& key, uint64_t default_value, uint64_t random_value,
+                      uint64_t num_buckets) const override;
+  bool featureEnabled(const InternedKey& key, const envoy::type::FractionalPercent& default_value,
+                      uint64_t random_value) const override;
   const std::string& get(const std::string& key) const override;
   uint64_t getInteger(const std::string& key, uint64_t default_value) const override;
+  uint64_t getInteger(const InternedKey& key, uint64_t default_value) const override;
+  double getDouble(const std::string& key, double default_value) const override;
+  double getDouble(const InternedKey& key, double default_value) const override;
   const std::vector<OverrideLayerConstPtr>& getLayers() const override;
 
+  /**
+   * @return whether the key has a value in this snapshot.
+   */
+  bool contains(const std::string& key) const { return values_->count(key) > 0; }
+
   static Entry createEntry(const std::string& value);
 
   // Returns true and sets 'value' to the key if found.
@@ -99,15 +124,36 @@ private:
     if (parseEntryUintValue(entry)) {
       return;
     }
+    if (parseEntryDoubleValue(entry)) {
+      return;
+    }
     parseEntryFractionalPercentValue(entry);
   }
 
   static bool parseEntryBooleanValue(Entry& entry);
   static bool parseEntryUintValue(Entry& entry);
+  static bool parseEntryDoubleValue(Entry& entry);
   static void parseEntryFractionalPercentValue(Entry& entry);
 
-  const std::vector<OverrideLayerConstPtr> layers_;
-  EntryMap values_;
+  const Entry* find(const std::string& key) const;
+  const Entry* find(const InternedKey& key) const;
+  void indexInternedKeys(const std::vector<std::string>& interned_keys);
+  bool entryFeatureEnabled(const Entry* entry, uint64_t default_value) const;
+  static bool entryFeatureEnabled(const Entry* entry, uint64_t default_value,
+                                  uint64_t random_value, uint64_t num_buckets);
+  static bool entryFeatureEnabled(const Entry* entry,
+                                  const envoy::type::FractionalPercent& default_value,
+                                  uint64_t random_value);
+  static uint64_t entryInteger(const Entry* entry, uint64_t default_value);
+  static double entryDouble(const Entry* entry, double default_value);
+
+  // The layers and merged values are immutable, and shared with the snapshots created from this
+  // one to index more interned keys.
+  const std::shared_ptr<const std::vector<OverrideLayerConstPtr>> layers_;
+  std::shared_ptr<const EntryMap> values_;
+  // The values of the interned keys, indexed by InternedKey::index(). Keys without a value map to
+  // nullptr.
+  std::vector<const Entry*> interned_values_;
   RandomGenerator& generator_;
   RuntimeStats& stats_;
 };
@@ -180,6 +226,7 @@ public:
   // Runtime::Loader
   Snapshot& snapshot() override;
   void mergeValues(const std::unordered_map<std::string, std::string>& values) override;
+  InternedKey internKey(const std::string& key) override;
 
 protected:
   // Identical the the public constructor but does not call loadSnapshot(). Subclasses must call
@@ -197,11 +244,17 @@ protected:
   RandomGenerator& generator_;
   RuntimeStats stats_;
   AdminLayer admin_layer_;
+  // Interned keys, ordered by index.
+  std::vector<std::string> interned_keys_;
 
 private:
   RuntimeStats generateStats(Stats::Store& store);
+  void publishSnapshot();
 
   ThreadLocal::SlotPtr tls_;
+  std::unordered_map<std::string, uint32_t> interned_key_indices_;
+  // The most recently published snapshot.
+  std::shared_ptr<SnapshotImpl> snapshot_;
 };
 
 /**
@@ -0,0 +1,239 @@
+#include "common/stats/growable_raw_stat_data_allocator.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Stats {
+
+namespace {
+
+// The number of index slots the region starts with.
+constexpr uint64_t InitialIndexCapacity = 1024;
+
+} // namespace
+
+const uint64_t GrowableRawStatDataAllocator::MinRegionSize = 1024 * 1024;
+
+constexpr uint64_t GrowableRawStatDataAllocator::BlockAlignment;
+constexpr uint64_t GrowableRawStatDataAllocator::MaxRecycledBlockSize;
+constexpr uint64_t GrowableRawStatDataAllocator::NumFreeLists;
+constexpr uint64_t GrowableRawStatDataAllocator::EmptySlot;
+constexpr uint64_t GrowableRawStatDataAllocator::FreedSlot;
+
+GrowableRawStatDataAllocator::GrowableRawStatDataAllocator(Thread::BasicLockable& mutex,
+                                                           uint8_t* region, uint64_t reserved_size,
+                                                           bool initialize, GrowCb grow_cb)
+    : mutex_(mutex), region_(region), header_(reinterpret_cast<Header*>(region)),
+      reserved_size_(reserved_size), grow_cb_(grow_cb) {
+  RELEASE_ASSERT(reserved_size_ >= MinRegionSize, "");
+  RELEASE_ASSERT(reinterpret_cast<uintptr_t>(region_) % BlockAlignment == 0, "");
+
+  // We must hold the lock when attaching to an existing region because the other process might be
+  // actively writing to it.
+  Thread::LockGuard lock(mutex_);
+  if (initialize) {
+    RELEASE_ASSERT(grow_cb_(MinRegionSize), "unable to allocate the stats region");
+    header_->size_ = MinRegionSize;
+    header_->used_ = blockSize(sizeof(Header));
+    header_->index_capacity_ = InitialIndexCapacity;
+    header_->index_offset_ = allocIndex(InitialIndexCapacity);
+    RELEASE_ASSERT(header_->index_offset_ != 0, "");
+  } else {
+    RELEASE_ASSERT(header_->size_ >= MinRegionSize && header_->size_ <= reserved_size_, "");
+    RELEASE_ASSERT(header_->used_ <= header_->size_, "");
+  }
+}
+
+uint64_t GrowableRawStatDataAllocator::blockSize(uint64_t size) {
+  return (size + BlockAlignment - 1) & ~(BlockAlignment - 1);
+}
+
+RawStatData* GrowableRawStatDataAllocator::alloc(absl::string_view name) {
+  Thread::LockGuard lock(mutex_);
+  const uint64_t hash = RawStatData::hash(name);
+  uint64_t* slot = findSlot(name, hash);
+  if (*slot != EmptySlot && *slot != FreedSlot) {
+    RawStatData* data = at<RawStatData>(*slot);
+    ++data->ref_count_;
+    return data;
+  }
+
+  // Keep at least a quarter of the slots empty so that probe sequences stay short. Taking a freed
+  // slot doesn't use up an empty one. Rebuilding the index moves the slots, so the slot for the
+  // new stat has to be found again.
+  if (*slot == EmptySlot &&
+      (header_->num_stats_ + header_->num_freed_slots_ + 1) * 4 > header_->index_capacity_ * 3) {
+    if (!rebuildIndex()) {
+      return nullptr;
+    }
+    slot = findSlot(name, hash);
+  }
+
+  const uint64_t offset = allocBlock(blockSize(RawStatData::structSize(name.size())));
+  if (offset == 0) {
+    return nullptr;
+  }
+  if (*slot == FreedSlot) {
+    --header_->num_freed_slots_;
+  }
+  *slot = offset;
+  ++header_->num_stats_;
+
+  // Blocks are zeroed when freed and when the region grows, so only the name and reference count
+  // need to be set.
+  RawStatData* data = at<RawStatData>(offset);
+  data->ref_count_ = 1;
+  memcpy(data->name_, name.data(), name.size());
+  data->name_[name.size()] = '\0';
+  return data;
+}
+
+void GrowableRawStatDataAllocator::free(RawStatData& data) {
+  // We must hold the lock since the reference decrement can race with an alloc above.
+  Thread::LockGuard lock(mutex_);
+  ASSERT(data.ref_count_ > 0);
+  if (--data.ref_count_ > 0) {
+    return;
+  }
+
+  const uint64_t offset = offsetOf(data);
+  uint64_t* slot = findSlot(data.key(), RawStatData::hash(data.key()));
+  ASSERT(*slot == offset);
+  *slot = FreedSlot;
+  --header_->num_stats_;
+  ++header_->num_freed_slots_;
+
+  const uint64_t size = blockSize(RawStatData::structSize(data.key().size()));
+  memset(static_cast<void*>(&data), 0, size);
+  // Larger blocks are left unused. They are only needed for stats with names of about a thousand
+  // characters, which are rare enough that keeping them would not pay for another free list.
+  if (size <= MaxRecycledBlockSize) {
+    uint64_t& free_list = header_->free_lists_[size / BlockAlignment];
+    *at<uint64_t>(offset) = free_list;
+    free_list = offset;
+  }
+}
+
+uint64_t GrowableRawStatDataAllocator::numStats() const {
+  Thread::LockGuard lock(mutex_);
+  return header_->num_stats_;
+}
+
+uint64_t GrowableRawStatDataAllocator::regionSize() const {
+  Thread::LockGuard lock(mutex_);
+  return header_->size_;
+}
+
+std::string GrowableRawStatDataAllocator::version() {
+  return fmt::format("growable.{}.{}", sizeof(Header), sizeof(RawStatData));
+}
+
+uint64_t* GrowableRawStatDataAllocator::findSlot(absl::string_view name, uint64_t hash) {
+  uint64_t* index = at<uint64_t>(header_->index_offset_);
+  const uint64_t mask = header_->index_capacity_ - 1;
+  uint64_t* freed_slot = nullptr;
+  // There is always an empty slot, so this terminates. A new stat takes the first freed slot in its
+  // probe sequence, if any.
+  for (uint64_t i = hash & mask;; i = (i + 1) & mask) {
+    uint64_t& slot = index[i];
+    if (slot == EmptySlot) {
+      return freed_slot != nullptr ? freed_slot : &slot;
+    } else if (slot == FreedSlot) {
+      if (freed_slot == nullptr) {
+        freed_slot = &slot;
+      }
+    } else if (at<RawStatData>(slot)->key() == name) {
+      return &slot;
+    }
+  }
+}
+
+bool GrowableRawStatDataAllocator::rebuildIndex() {
+  // Double the index if it is more than half full of stats. Otherwise most of the used slots are
+  // of freed stats, and rebuilding at the same capacity drops them.
+  uint64_t capacity = header_->index_capacity_;
+  if ((header_->num_stats_ + 1) * 2 > capacity) {
+    capacity *= 2;
+  }
+
+  uint64_t offset;
+  if (header_->spare_index_capacity_ == capacity) {
+    offset = header_->spare_index_offset_;
+  } else {
+    offset = allocIndex(capacity);
+    if (offset == 0) {
+      return false;
+    }
+  }
+
+  uint64_t* old_index = at<uint64_t>(header_->index_offset_);
+  uint64_t* index = at<uint64_t>(offset);
+  const uint64_t mask = capacity - 1;
+  for (uint64_t i = 0; i < header_->index_capacity_; i++) {
+    if (old_index[i] == EmptySlot || old_index[i] == FreedSlot) {
+      continue;
+    }
+    uint64_t j = RawStatData::hash(at<RawStatData>(old_index[i])->key()) & mask;
+    while (index[j] != EmptySlot) {
+      j = (j + 1) & mask;
+    }
+    index[j] = old_index[i];
+  }
+
+  // The old index is kept for the next rebuild at its capacity. A smaller spare is never used
+  // again, as the index does not shrink, so the memory given up to indexes is at most twice that
+  // of the largest one.
+  memset(old_index, 0, header_->index_capacity_ * sizeof(uint64_t));
+  header_->spare_index_offset_ = header_->index_offset_;
+  header_->spare_index_capacity_ = header_->index_capacity_;
+  header_->index_offset_ = offset;
+  header_->index_capacity_ = capacity;
+  header_->num_freed_slots_ = 0;
+  return true;
+}
+
+uint64_t GrowableRawStatDataAllocator::allocBlock(uint64_t size) {
+  if (size <= MaxRecycledBlockSize) {
+    uint64_t& free_list = header_->free_lists_[size / BlockAlignment];
+    if (free_list != 0) {
+      const uint64_t offset = free_list;
+      free_list = *at<uint64_t>(offset);
+      *at<uint64_t>(offset) = 0;
+      return offset;
+    }
+  }
+
+  if (size > reserved_size_ - header_->used_) {
+    return 0;
+  }
+  if (header_->used_ + size > header_->size_) {
+    // Grow geometrically so that the number of grow calls is logarithmic in the number of stats.
+    const uint64_t new_size =
+        std::min(reserved_size_, std::max(header_->used_ + size, header_->size_ * 2));
+    if (!grow_cb_(new_size)) {
+      return 0;
+    }
+    header_->size_ = new_size;
+  }
+  const uint64_t offset = header_->used_;
+  header_->used_ += size;
+  return offset;
+}
+
+uint64_t GrowableRawStatDataAllocator::allocIndex(uint64_t capacity) {
+  // Indexes are too large to come from the free lists, so they are always taken from the end of
+  // the region, which reads as zero, i.e. every slot is empty.
+  static_assert(InitialIndexCapacity * sizeof(uint64_t) > MaxRecycledBlockSize,
+                "indexes must not be allocated from the free lists");
+  return allocBlock(capacity * sizeof(uint64_t));
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "common/common/thread.h"
+#include "common/stats/raw_stat_data.h"
+#include "common/stats/stat_data_allocator_impl.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Allocates RawStatData from a region of memory that can be grown in place, such as a reservation
+ * of address space over a shared memory object that is extended as needed. Unlike
+ * RawStatDataAllocator, neither the number of stats nor the length of their names is fixed up
+ * front: each stat takes only the memory its name needs, and the index used to find stats by name
+ * is resized as stats are added. Everything, including the index, lives in the region and refers
+ * to stats by offset, so processes that map the region at different addresses can share it.
+ */
+class GrowableRawStatDataAllocator : public StatDataAllocatorImpl<RawStatData> {
+public:
+  /**
+   * Called with the stat lock held to grow the usable part of the region to the given number of
+   * bytes. The new memory must read as zero.
+   * @return bool whether the region was grown.
+   */
+  typedef std::function<bool(uint64_t size)> GrowCb;
+
+  /**
+   * @param mutex supplies the lock serializing access to the region, across processes if shared.
+   * @param region supplies the start of the region. It must stay at this address for the life of
+   *        the allocator.
+   * @param reserved_size supplies the size the region can be grown to.
+   * @param initialize supplies whether the region is new, rather than in use by another process.
+   * @param grow_cb supplies the callback to grow the region.
+   */
+  GrowableRawStatDataAllocator(Thread::BasicLockable& mutex, uint8_t* region,
+                               uint64_t reserved_size, bool initialize, GrowCb grow_cb);
+
+  // StatDataAllocator
+  bool requiresBoundedStatNameSize() const override { return false; }
+  RawStatData* alloc(absl::string_view name) override;
+  void free(RawStatData& data) override;
+
+  /**
+   * @return uint64_t the number of stats allocated in the region.
+   */
+  uint64_t numStats() const;
+
+  /**
+   * @return uint64_t the number of bytes of the region that have been grown into.
+   */
+  uint64_t regionSize() const;
+
+  /**
+   * @return std::string a version string for the layout of the region, which changes whenever
+   *         processes with different versions could not share a region.
+   */
+  static std::string version();
+
+  // The size the region is initially grown to.
+  static const uint64_t MinRegionSize;
+
+private:
+  // The number of free lists of stat blocks. Blocks are rounded up to a multiple of
+  // BlockAlignment, and freed blocks of up to MaxRecycledBlockSize are kept on the free list for
+  // their size.
+  static constexpr uint64_t BlockAlignment = 16;
+  static constexpr uint64_t MaxRecycledBlockSize = 1024;
+  static constexpr uint64_t NumFreeLists = MaxRecycledBlockSize / BlockAlignment + 1;
+
+  /**
+   * Laid out at the start of the region. Offsets are from the start of the region.
+   */
+  struct Header {
+    // The number of bytes of the region that have been grown into.
+    uint64_t size_;
+    // The number of bytes of the region handed out, from the start.
+    uint64_t used_;
+    // The open addressing index of stat offsets, with index_capacity_ slots. The capacity is a
+    // power of 2.
+    uint64_t index_offset_;
+    uint64_t index_capacity_;
+    // A previous index kept for reuse when the index is rebuilt at the same capacity, to drop
+    // the slots of freed stats.
+    uint64_t spare_index_offset_;
+    uint64_t spare_index_capacity_;
+    uint64_t num_stats_;
+    uint64_t num_freed_slots_;
+    uint64_t free_lists_[NumFreeLists];
+  };
+
+  // Index slot values other than stat offsets. Offset 0 is the header, so no stat can have it.
+  static constexpr uint64_t EmptySlot = 0;
+  static constexpr uint64_t FreedSlot = 1;
+
+  template <class T> T* at(uint64_t offset) const {
+    return reinterpret_cast<T*>(region_ + offset);
+  }
+  uint64_t offsetOf(const RawStatData& data) const {
+    return reinterpret_cast<const uint8_t*>(&data) - region_;
+  }
+  static uint64_t blockSize(uint64_t size);
+
+  uint64_t* findSlot(absl::string_view name, uint64_t hash) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool rebuildIndex() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  uint64_t allocBlock(uint64_t size) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  uint64_t allocIndex(uint64_t capacity) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  Thread::BasicLockable& mutex_;
+  uint8_t* const region_;
+  Header* const header_ PT_GUARDED_BY(mutex_);
+  const uint64_t reserved_size_;
+  const GrowCb grow_cb_;
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -34,7 +34,8 @@ CdsApiImpl::CdsApiImpl(const envoy::api::v2::core::ConfigSource& cds_config, Clu
       Config::SubscriptionFactory::subscriptionFromConfigSource<envoy::api::v2::Cluster>(
           cds_config, local_info, dispatcher, cm, random, *scope_,
           "envoy.api.v2.ClusterDiscoveryService.FetchClusters",
-          "envoy.api.v2.ClusterDiscoveryService.StreamClusters", api);
+          "envoy.api.v2.ClusterDiscoveryService.StreamClusters", api,
+          "envoy.api.v2.ClusterDiscoveryService.IncrementalClusters");
 }
 
 void CdsApiImpl::onConfigUpdate(const ResourceVector& resources, const std::string& version_info) {
@@ -57,46 +58,14 @@ void CdsApiImpl::onConfigUpdate(const ResourceVector& resources, const std::stri
     const std::string cluster_name = cluster.name();
     try {
       clusters_to_remove.erase(cluster_name);
-      if (cm_.addOrUpdateCluster(
-              cluster, version_info,
-              [this](const std::string&, ClusterManager::ClusterWarmingState state) {
-                // Following if/else block implements a control flow mechanism that can be used
-                // by an ADS implementation to properly sequence CDS and RDS update. It is not
-                // enforcing on ADS. ADS can use it to detect when a previously sent cluster becomes
-                // warm before sending routes that depend on it. This can improve incidence of HTTP
-                // 503 responses from Envoy when a route is used before it's supporting cluster is
-                // ready.
-                //
-                // We achieve that by leaving CDS in the paused state as long as there is at least
-                // one cluster in the warming state. This prevents CDS ACK from being sent to ADS.
-                // Once cluster is warmed up, CDS is resumed, and ACK is sent to ADS, providing a
-                // signal to ADS to proceed with RDS updates.
-                //
-                // Major concern with this approach is CDS being left in the paused state forever.
-                // As long as ClusterManager::removeCluster() is not called on a warming cluster
-                // this is not an issue. CdsApiImpl takes care of doing this properly, and there
-                // is no other component removing clusters from the ClusterManagerImpl. If this
-                // ever changes, we would need to correct the following logic.
-                if (state == ClusterManager::ClusterWarmingState::Starting &&
-                    cm_.warmingClusterCount() == 1) {
-                  cm_.adsMux().pause(Config::TypeUrl::get().Cluster);
-                } else if (state == ClusterManager::ClusterWarmingState::Finished &&
-                           cm_.warmingClusterCount() == 0) {
-                  cm_.adsMux().resume(Config::TypeUrl::get().Cluster);
-                }
-              })) {
-        ENVOY_LOG(debug, "cds: add/update cluster '{}'", cluster_name);
-      }
+      addOrUpdateCluster(cluster, version_info);
     } catch (const EnvoyException& e) {
       exception_msgs.push_back(e.what());
     }
   }
 
   for (auto cluster : clusters_to_remove) {
-    const std::string cluster_name = cluster.first;
-    if (cm_.removeCluster(cluster_name)) {
-      ENVOY_LOG(debug, "cds: remove cluster '{}'", cluster_name);
-    }
+    removeCluster(cluster.first);
   }
 
   version_info_ = version_info;
@@ -106,12 +75,92 @@ void CdsApiImpl::onConfigUpdate(const ResourceVector& resources, const std::stri
   }
 }
 
+void CdsApiImpl::onConfigUpdate(
+    const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+    const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+    const std::string& system_version_info) {
+  cm_.adsMux().pause(Config::TypeUrl::get().ClusterLoadAssignment);
+  Cleanup eds_resume([this] { cm_.adsMux().resume(Config::TypeUrl::get().ClusterLoadAssignment); });
+
+  std::vector<envoy::api::v2::Cluster> clusters;
+  clusters.reserve(added_resources.size());
+  std::unordered_set<std::string> cluster_names;
+  for (const auto& resource : added_resources) {
+    clusters.push_back(MessageUtil::anyConvert<envoy::api::v2::Cluster>(resource.resource()));
+    if (!cluster_names.insert(clusters.back().name()).second) {
+      throw EnvoyException(fmt::format("duplicate cluster {} found", clusters.back().name()));
+    }
+  }
+  for (const auto& cluster : clusters) {
+    MessageUtil::validate(cluster);
+  }
+  // Unlike a state of the world update, clusters not mentioned in the update are left alone and
+  // each added cluster carries its own version.
+  std::vector<std::string> exception_msgs;
+  for (int i = 0; i < added_resources.size(); ++i) {
+    try {
+      addOrUpdateCluster(clusters[i], added_resources[i].version());
+    } catch (const EnvoyException& e) {
+      exception_msgs.push_back(e.what());
+    }
+  }
+  for (const std::string& cluster_name : removed_resources) {
+    removeCluster(cluster_name);
+  }
+
+  version_info_ = system_version_info;
+  runInitializeCallbackIfAny();
+  if (!exception_msgs.empty()) {
+    throw EnvoyException(StringUtil::join(exception_msgs, "\n"));
+  }
+}
+
 void CdsApiImpl::onConfigUpdateFailed(const EnvoyException*) {
   // We need to allow server startup to continue, even if we have a bad
   // config.
   runInitializeCallbackIfAny();
 }
 
+void CdsApiImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& cluster,
+                                    const std::string& version_info) {
+  if (cm_.addOrUpdateCluster(
+          cluster, version_info,
+          [this](const std::string&, ClusterManager::ClusterWarmingState state) {
+            // Following if/else block implements a control flow mechanism that can be used
+            // by an ADS implementation to properly sequence CDS and RDS update. It is not
+            // enforcing on ADS. ADS can use it to detect when a previously sent cluster becomes
+            // warm before sending routes that depend on it. This can improve incidence of HTTP
+            // 503 responses from Envoy when a route is used before it's supporting cluster is
+            // ready.
+            //
+            // We achieve that by leaving CDS in the paused state as long as there is at least
+            // one cluster in the warming state. This prevents CDS ACK from being sent to ADS.
+            // Once cluster is warmed up, CDS is resumed, and ACK is sent to ADS, providing a
+            // signal to ADS to proceed with RDS updates.
+            //
+            // Major concern with this approach is CDS being left in the paused state forever.
+            // As long as ClusterManager::removeCluster() is not called on a warming cluster
+            // this is not an issue. CdsApiImpl takes care of doing this properly, and there
+            // is no other component removing clusters from the ClusterManagerImpl. If this
+            // ever changes, we would need to correct the following logic.
+            if (state == ClusterManager::ClusterWarmingState::Starting &&
+                cm_.warmingClusterCount() == 1) {
+              cm_.adsMux().pause(Config::TypeUrl::get().Cluster);
+            } else if (state == ClusterManager::ClusterWarmingState::Finished &&
+                       cm_.warmingClusterCount() == 0) {
+              cm_.adsMux().resume(Config::TypeUrl::get().Cluster);
+            }
+          })) {
+    ENVOY_LOG(debug, "cds: add/update cluster '{}'", cluster.name());
+  }
+}
+
+void CdsApiImpl::removeCluster(const std::string& cluster_name) {
+  if (cm_.removeCluster(cluster_name)) {
+    ENVOY_LOG(debug, "cds: remove cluster '{}'", cluster_name);
+  }
+}
+
 void CdsApiImpl::runInitializeCallbackIfAny() {
   if (initialize_callback_) {
     initialize_callback_();
@@ -1,11 +1,13 @@
 #include "common/upstream/cluster_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "envoy/admin/v2alpha/config_dump.pb.h"
@@ -207,6 +209,10 @@ ClusterManagerImpl::ClusterManagerImpl(
 
   // Now setup ADS if needed, this might rely on a primary cluster.
   if (bootstrap.dynamic_resources().has_ads_config()) {
+    if (bootstrap.dynamic_resources().ads_config().api_type() ==
+        envoy::api::v2::core::ApiConfigSource::INCREMENTAL_GRPC) {
+      throw EnvoyException("Incremental xDS is not supported over ADS");
+    }
     ads_mux_ = std::make_unique<Config::GrpcMuxImpl>(
         local_info,
         Config::Utility::factoryForGrpcApiConfigSource(
@@ -242,6 +248,11 @@ ClusterManagerImpl::ClusterManagerImpl(
     }
   }
 
+  if (cm_config.has_thread_local_cluster_idle_timeout()) {
+    thread_local_cluster_idle_timeout_ = std::chrono::milliseconds(
+        PROTOBUF_GET_MS_REQUIRED(cm_config, thread_local_cluster_idle_timeout));
+  }
+
   // Once the initial set of static bootstrap clusters are created (including the local cluster),
   // we can instantiate the thread local cluster manager.
   tls_->set([this, local_cluster_name](
@@ -284,7 +295,8 @@ ClusterManagerImpl::ClusterManagerImpl(
 ClusterManagerStats ClusterManagerImpl::generateStats(Stats::Scope& scope) {
   const std::string final_prefix = "cluster_manager.";
   return {ALL_CLUSTER_MANAGER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
-                                    POOL_GAUGE_PREFIX(scope, final_prefix))};
+                                    POOL_GAUGE_PREFIX(scope, final_prefix),
+                                    POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
 }
 
 void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
@@ -460,6 +472,10 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
   //       and easy to understand.
   const bool use_active_map =
       init_helper_.state() != ClusterManagerInitHelper::State::AllClustersInitialized;
+  if (use_active_map && existing_active_cluster != active_clusters_.end()) {
+    // Deliver the pending membership updates of the cluster being replaced.
+    flushThreadLocalClusterUpdates();
+  }
   loadCluster(cluster, version_info, true, use_active_map ? active_clusters_ : warming_clusters_);
 
   if (use_active_map) {
@@ -478,6 +494,8 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
       // If the cluster is being updated, we need to cancel any pending merged updates.
       // Otherwise, applyUpdates() will fire with a dangling cluster reference.
       updates_map_.erase(cluster_name);
+      // Likewise, pending membership updates of the cluster being replaced are delivered first.
+      flushThreadLocalClusterUpdates();
 
       active_clusters_[cluster_name] = std::move(warming_it->second);
       warming_clusters_.erase(warming_it);
@@ -495,17 +513,35 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
 }
 
 void ClusterManagerImpl::createOrUpdateThreadLocalCluster(ClusterData& cluster) {
+  // Deliver any pending membership updates first so workers see them in the order they happened.
+  flushThreadLocalClusterUpdates();
   tls_->runOnAllThreads([this, new_cluster = cluster.cluster_->info(),
                          thread_aware_lb_factory = cluster.loadBalancerFactory()]() -> void {
     ThreadLocalClusterManagerImpl& cluster_manager =
         tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-    if (cluster_manager.thread_local_clusters_.count(new_cluster->name()) > 0) {
+    const bool instantiated = cluster_manager.thread_local_clusters_.count(new_cluster->name()) > 0;
+    if (instantiated) {
       ENVOY_LOG(debug, "updating TLS cluster {}", new_cluster->name());
     } else {
       ENVOY_LOG(debug, "adding TLS cluster {}", new_cluster->name());
     }
 
+    if (cluster_manager.onDemand()) {
+      // The new cluster starts out empty. Its membership arrives as regular updates.
+      ThreadLocalClusterManagerImpl::ClusterSnapshot& snapshot =
+          cluster_manager.cluster_snapshots_[new_cluster->name()];
+      snapshot.info_ = new_cluster;
+      snapshot.lb_factory_ = thread_aware_lb_factory;
+      snapshot.priorities_.clear();
+      // Clusters not yet used on this worker are instantiated on first use. Update callbacks
+      // expect to see every cluster though, so workers that have any instantiate eagerly.
+      if (!instantiated && cluster_manager.update_callbacks_.empty() &&
+          new_cluster->lbType() != LoadBalancerType::OriginalDst) {
+        return;
+      }
+    }
+
     auto thread_local_cluster = new ThreadLocalClusterManagerImpl::ClusterEntry(
         cluster_manager, new_cluster, thread_aware_lb_factory);
     cluster_manager.thread_local_clusters_[new_cluster->name()].reset(thread_local_cluster);
@@ -522,6 +558,8 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
       existing_active_cluster->second->added_via_api_) {
     removed = true;
     init_helper_.removeCluster(*existing_active_cluster->second->cluster_);
+    // Pending membership updates reference the cluster, and must reach the workers first anyway.
+    flushThreadLocalClusterUpdates();
     active_clusters_.erase(existing_active_cluster);
 
     ENVOY_LOG(info, "removing cluster {}", cluster_name);
@@ -529,9 +567,12 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
       ThreadLocalClusterManagerImpl& cluster_manager =
           tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-      ASSERT(cluster_manager.thread_local_clusters_.count(cluster_name) == 1);
+      ASSERT(cluster_manager.thread_local_clusters_.count(cluster_name) == 1 ||
+             cluster_manager.cluster_snapshots_.count(cluster_name) == 1);
       ENVOY_LOG(debug, "removing TLS cluster {}", cluster_name);
       cluster_manager.thread_local_clusters_.erase(cluster_name);
+      cluster_manager.cluster_snapshots_.erase(cluster_name);
+      cluster_manager.lazy_clusters_.erase(cluster_name);
       for (auto& cb : cluster_manager.update_callbacks_) {
         cb->onClusterRemoval(cluster_name);
       }
@@ -615,12 +656,7 @@ void ClusterManagerImpl::updateGauges() {
 ThreadLocalCluster* ClusterManagerImpl::get(const std::string& cluster) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry != cluster_manager.thread_local_clusters_.end()) {
-    return entry->second.get();
-  } else {
-    return nullptr;
-  }
+  return cluster_manager.getCluster(cluster);
 }
 
 Http::ConnectionPool::Instance*
@@ -628,13 +664,13 @@ ClusterManagerImpl::httpConnPoolForCluster(const std::string& cluster, ResourceP
                                            Http::Protocol protocol, LoadBalancerContext* context) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  ThreadLocalClusterManagerImpl::ClusterEntry* entry = cluster_manager.getOrCreateCluster(cluster);
+  if (entry == nullptr) {
     return nullptr;
   }
 
   // Select a host and create a connection pool for it if it does not already exist.
-  return entry->second->connPool(priority, protocol, context);
+  return entry->connPool(priority, protocol, context);
 }
 
 Tcp::ConnectionPool::Instance* ClusterManagerImpl::tcpConnPoolForCluster(
@@ -642,42 +678,111 @@ Tcp::ConnectionPool::Instance* ClusterManagerImpl::tcpConnPoolForCluster(
     Network::TransportSocketOptionsSharedPtr transport_socket_options) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  ThreadLocalClusterManagerImpl::ClusterEntry* entry = cluster_manager.getOrCreateCluster(cluster);
+  if (entry == nullptr) {
     return nullptr;
   }
 
   // Select a host and create a connection pool for it if it does not already exist.
-  return entry->second->tcpConnPool(priority, context, transport_socket_options);
+  return entry->tcpConnPool(priority, context, transport_socket_options);
 }
 
 void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
                                                       const HostVector& hosts_added,
                                                       const HostVector& hosts_removed) {
-  const auto& host_set = cluster.prioritySet().hostSetsPerPriority()[priority];
-
-  // TODO(htuch): Can we skip these copies by exporting out const shared_ptr from HostSet?
-  HostVectorConstSharedPtr hosts_copy(new HostVector(host_set->hosts()));
-  HostVectorConstSharedPtr healthy_hosts_copy(new HostVector(host_set->healthyHosts()));
-  HostVectorConstSharedPtr degraded_hosts_copy(new HostVector(host_set->degradedHosts()));
-  HostsPerLocalityConstSharedPtr hosts_per_locality_copy = host_set->hostsPerLocality().clone();
-  HostsPerLocalityConstSharedPtr healthy_hosts_per_locality_copy =
-      host_set->healthyHostsPerLocality().clone();
-  HostsPerLocalityConstSharedPtr degraded_hosts_per_locality_copy =
-      host_set->degradedHostsPerLocality().clone();
-
-  tls_->runOnAllThreads([this, name = cluster.info()->name(), priority, hosts_copy,
-                         healthy_hosts_copy, degraded_hosts_copy, hosts_per_locality_copy,
-                         healthy_hosts_per_locality_copy, degraded_hosts_per_locality_copy,
-                         locality_weights = host_set->localityWeights(), hosts_added,
-                         hosts_removed]() {
-    ThreadLocalClusterManagerImpl::updateClusterMembership(
-        name, priority,
-        HostSetImpl::updateHostsParams(hosts_copy, hosts_per_locality_copy, healthy_hosts_copy,
-                                       healthy_hosts_per_locality_copy, degraded_hosts_copy,
-                                       degraded_hosts_per_locality_copy),
-        locality_weights, hosts_added, hosts_removed, *tls_);
-  });
+  auto index = pending_thread_local_update_index_.emplace(std::make_pair(&cluster, priority),
+                                                          pending_thread_local_updates_.size());
+  if (index.second) {
+    pending_thread_local_updates_.push_back({&cluster, priority, hosts_added, hosts_removed});
+  } else {
+    // An update for this cluster and priority is already pending. The snapshot taken when flushing
+    // covers both, and the added/removed hosts are merged so that workers see the net change. A
+    // host that is added and then removed (or vice versa) within the batch cancels out.
+    cm_stats_.thread_local_updates_coalesced_.inc();
+    PendingThreadLocalClusterUpdate& pending = pending_thread_local_updates_[index.first->second];
+    const auto merge = [](const HostVector& hosts, HostVector& same, HostVector& opposite) {
+      if (hosts.empty()) {
+        return;
+      }
+      std::unordered_set<HostSharedPtr> cancelled;
+      if (!opposite.empty()) {
+        const std::unordered_set<HostSharedPtr> opposite_set(opposite.begin(), opposite.end());
+        for (const HostSharedPtr& host : hosts) {
+          if (opposite_set.count(host) > 0) {
+            cancelled.insert(host);
+          }
+        }
+      }
+      if (cancelled.empty()) {
+        same.insert(same.end(), hosts.begin(), hosts.end());
+        return;
+      }
+      opposite.erase(std::remove_if(opposite.begin(), opposite.end(),
+                                    [&cancelled](const HostSharedPtr& host) {
+                                      return cancelled.count(host) > 0;
+                                    }),
+                     opposite.end());
+      for (const HostSharedPtr& host : hosts) {
+        if (cancelled.count(host) == 0) {
+          same.push_back(host);
+        }
+      }
+    };
+    merge(hosts_added, pending.hosts_added_, pending.hosts_removed_);
+    merge(hosts_removed, pending.hosts_removed_, pending.hosts_added_);
+  }
+
+  if (!thread_local_flush_scheduled_) {
+    thread_local_flush_scheduled_ = true;
+    dispatcher_.post([this, alive = std::weak_ptr<bool>(alive_)]() -> void {
+      if (!alive.expired()) {
+        flushThreadLocalClusterUpdates();
+      }
+    });
+  }
+}
+
+void ClusterManagerImpl::flushThreadLocalClusterUpdates() {
+  thread_local_flush_scheduled_ = false;
+  if (pending_thread_local_updates_.empty()) {
+    return;
+  }
+
+  auto updates = std::make_shared<std::vector<ThreadLocalClusterUpdate>>();
+  updates->reserve(pending_thread_local_updates_.size());
+  for (PendingThreadLocalClusterUpdate& pending : pending_thread_local_updates_) {
+    const auto& host_set = pending.cluster_->prioritySet().hostSetsPerPriority()[pending.priority_];
+
+    // TODO(htuch): Can we skip these copies by exporting out const shared_ptr from HostSet?
+    PrioritySet::UpdateHostsParams update_hosts_params = HostSetImpl::updateHostsParams(
+        std::make_shared<const HostVector>(host_set->hosts()), host_set->hostsPerLocality().clone(),
+        std::make_shared<const HostVector>(host_set->healthyHosts()),
+        host_set->healthyHostsPerLocality().clone(),
+        std::make_shared<const HostVector>(host_set->degradedHosts()),
+        host_set->degradedHostsPerLocality().clone());
+    updates->push_back({pending.cluster_->info()->name(), pending.priority_,
+                        std::move(update_hosts_params), host_set->localityWeights(),
+                        std::move(pending.hosts_added_), std::move(pending.hosts_removed_)});
+  }
+  ThreadLocalClusterUpdateBatchConstSharedPtr batch = std::move(updates);
+  pending_thread_local_updates_.clear();
+  pending_thread_local_update_index_.clear();
+  cm_stats_.thread_local_update_batches_.inc();
+
+  // The completion callback runs on the main thread once every worker has applied the batch. It
+  // only references objects that outlive the cluster manager.
+  tls_->runOnAllThreads(
+      [this, batch]() -> void {
+        for (const ThreadLocalClusterUpdate& update : *batch) {
+          ThreadLocalClusterManagerImpl::updateClusterMembership(update, *tls_);
+        }
+      },
+      [&time_source = time_source_, &fanout_ms = cm_stats_.thread_local_update_fanout_ms_,
+       posted_at = time_source_.monotonicTime()]() -> void {
+        fanout_ms.recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  time_source.monotonicTime() - posted_at)
+                                  .count());
+      });
 }
 
 void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host) {
@@ -690,16 +795,16 @@ Host::CreateConnectionData ClusterManagerImpl::tcpConnForCluster(
     Network::TransportSocketOptionsSharedPtr transport_socket_options) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry == cluster_manager.thread_local_clusters_.end()) {
+  ThreadLocalClusterManagerImpl::ClusterEntry* entry = cluster_manager.getOrCreateCluster(cluster);
+  if (entry == nullptr) {
     throw EnvoyException(fmt::format("unknown cluster '{}'", cluster));
   }
 
-  HostConstSharedPtr logical_host = entry->second->lb_->chooseHost(context);
+  HostConstSharedPtr logical_host = entry->lb_->chooseHost(context);
   if (logical_host) {
     auto conn_info = logical_host->createConnection(cluster_manager.thread_local_dispatcher_,
                                                     nullptr, transport_socket_options);
-    if ((entry->second->cluster_info_->features() &
+    if ((entry->cluster_info_->features() &
          ClusterInfo::Features::CLOSE_CONNECTIONS_ON_HOST_HEALTH_FAILURE) &&
         conn_info.connection_ != nullptr) {
       auto& conn_map = cluster_manager.host_tcp_conn_map_[logical_host];
@@ -709,16 +814,16 @@ Host::CreateConnectionData ClusterManagerImpl::tcpConnForCluster(
     }
     return conn_info;
   } else {
-    entry->second->cluster_info_->stats().upstream_cx_none_healthy_.inc();
+    entry->cluster_info_->stats().upstream_cx_none_healthy_.inc();
     return {nullptr, nullptr};
   }
 }
 
 Http::AsyncClient& ClusterManagerImpl::httpAsyncClientForCluster(const std::string& cluster) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
-  auto entry = cluster_manager.thread_local_clusters_.find(cluster);
-  if (entry != cluster_manager.thread_local_clusters_.end()) {
-    return entry->second->http_async_client_;
+  ThreadLocalClusterManagerImpl::ClusterEntry* entry = cluster_manager.getOrCreateCluster(cluster);
+  if (entry != nullptr) {
+    return entry->http_async_client_;
   } else {
     throw EnvoyException(fmt::format("unknown cluster '{}'", cluster));
   }
@@ -727,6 +832,15 @@ Http::AsyncClient& ClusterManagerImpl::httpAsyncClientForCluster(const std::stri
 ClusterUpdateCallbacksHandlePtr
 ClusterManagerImpl::addThreadLocalClusterUpdateCallbacks(ClusterUpdateCallbacks& cb) {
   ThreadLocalClusterManagerImpl& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
+  if (cluster_manager.onDemand()) {
+    // Update callbacks may hold on to the clusters they are told about, so every cluster is
+    // instantiated on this worker and none are released while callbacks are registered.
+    for (const auto& snapshot : cluster_manager.cluster_snapshots_) {
+      if (cluster_manager.thread_local_clusters_.count(snapshot.first) == 0) {
+        cluster_manager.createCluster(snapshot.first, snapshot.second);
+      }
+    }
+  }
   return std::make_unique<ClusterUpdateCallbacksHandleImpl>(cb, cluster_manager.update_callbacks_);
 }
 
@@ -776,7 +890,18 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
     ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
     const absl::optional<std::string>& local_cluster_name)
     : parent_(parent), thread_local_dispatcher_(dispatcher) {
-  // If local cluster is defined then we need to initialize it first.
+  if (onDemand()) {
+    for (auto& cluster : parent.active_clusters_) {
+      ClusterSnapshot& snapshot = cluster_snapshots_[cluster.first];
+      snapshot.info_ = cluster.second->cluster_->info();
+      snapshot.lb_factory_ = cluster.second->loadBalancerFactory();
+    }
+    idle_timer_ = dispatcher.createTimer([this]() -> void { reclaimIdleClusters(); });
+    idle_timer_->enableTimer(parent.thread_local_cluster_idle_timeout_.value());
+  }
+
+  // If local cluster is defined then we need to initialize it first. It is always instantiated,
+  // since the load balancers of other clusters may depend on it.
   if (local_cluster_name) {
     ENVOY_LOG(debug, "adding TLS local cluster {}", local_cluster_name.value());
     auto& local_cluster = parent.active_clusters_.at(local_cluster_name.value());
@@ -793,6 +918,12 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
     if (local_cluster_name && local_cluster_name.value() == cluster.first) {
       continue;
     }
+    // The original destination LB needs the main thread cluster, which is only safe to look up
+    // while the cluster manager is updating workers, so such clusters are never instantiated on
+    // demand.
+    if (onDemand() && cluster.second->cluster_->info()->lbType() != LoadBalancerType::OriginalDst) {
+      continue;
+    }
 
     ENVOY_LOG(debug, "adding TLS initial cluster {}", cluster.first);
     ASSERT(thread_local_clusters_.count(cluster.first) == 0);
@@ -930,24 +1061,35 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeTcpConn(
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
-    const std::string& name, uint32_t priority,
-    PrioritySet::UpdateHostsParams&& update_hosts_params,
-    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
-    const HostVector& hosts_removed, ThreadLocal::Slot& tls) {
+    const ThreadLocalClusterUpdate& update, ThreadLocal::Slot& tls) {
 
   ThreadLocalClusterManagerImpl& config = tls.getTyped<ThreadLocalClusterManagerImpl>();
 
-  ASSERT(config.thread_local_clusters_.find(name) != config.thread_local_clusters_.end());
-  const auto& cluster_entry = config.thread_local_clusters_[name];
-  ENVOY_LOG(debug, "membership update for TLS cluster {} added {} removed {}", name,
-            hosts_added.size(), hosts_removed.size());
-  cluster_entry->priority_set_.updateHosts(priority, std::move(update_hosts_params),
-                                           std::move(locality_weights), hosts_added, hosts_removed,
-                                           absl::nullopt);
+  if (config.onDemand()) {
+    auto snapshot = config.cluster_snapshots_.find(update.name_);
+    ASSERT(snapshot != config.cluster_snapshots_.end());
+    snapshot->second.priorities_[update.priority_] = {update.update_hosts_params_,
+                                                      update.locality_weights_};
+  }
+
+  auto cluster_entry_it = config.thread_local_clusters_.find(update.name_);
+  if (cluster_entry_it == config.thread_local_clusters_.end()) {
+    // Not instantiated on this worker. The snapshot is all that needs updating.
+    ASSERT(config.onDemand());
+    return;
+  }
+  const ClusterEntryPtr& cluster_entry = cluster_entry_it->second;
+  ENVOY_LOG(debug, "membership update for TLS cluster {} added {} removed {}", update.name_,
+            update.hosts_added_.size(), update.hosts_removed_.size());
+  // The batch is shared by all workers, so each takes its own copy of the (shared) host lists.
+  PrioritySet::UpdateHostsParams update_hosts_params = update.update_hosts_params_;
+  cluster_entry->priority_set_.updateHosts(update.priority_, std::move(update_hosts_params),
+                                           update.locality_weights_, update.hosts_added_,
+                                           update.hosts_removed_, absl::nullopt);
 
   // If an LB is thread aware, create a new worker local LB on membership changes.
   if (cluster_entry->lb_factory_ != nullptr) {
-    ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
+    ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", update.name_);
     cluster_entry->lb_ = cluster_entry->lb_factory_->create();
   }
 }
@@ -1015,6 +1157,107 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::getHttpConnPoolsContainer(
   return &container_iter->second;
 }
 
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::getOrCreateCluster(const std::string& name) {
+  auto entry = thread_local_clusters_.find(name);
+  if (entry != thread_local_clusters_.end()) {
+    entry->second->used_ = true;
+    return entry->second.get();
+  }
+
+  auto snapshot = cluster_snapshots_.find(name);
+  if (snapshot == cluster_snapshots_.end()) {
+    return nullptr;
+  }
+
+  ENVOY_LOG(debug, "instantiating TLS cluster {} on demand", name);
+  parent_.cm_stats_.thread_local_clusters_created_on_demand_.inc();
+  return &createCluster(name, snapshot->second);
+}
+
+ThreadLocalCluster*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::getCluster(const std::string& name) {
+  auto entry = thread_local_clusters_.find(name);
+  if (entry != thread_local_clusters_.end()) {
+    entry->second->used_ = true;
+    return entry->second.get();
+  }
+
+  if (cluster_snapshots_.count(name) == 0) {
+    return nullptr;
+  }
+
+  LazyClusterPtr& lazy_cluster = lazy_clusters_[name];
+  if (lazy_cluster == nullptr) {
+    lazy_cluster = std::make_unique<LazyCluster>(*this, name);
+  }
+  return lazy_cluster.get();
+}
+
+ClusterInfoConstSharedPtr ClusterManagerImpl::ThreadLocalClusterManagerImpl::LazyCluster::info() {
+  auto entry = parent_.thread_local_clusters_.find(name_);
+  if (entry != parent_.thread_local_clusters_.end()) {
+    return entry->second->info();
+  }
+  return parent_.cluster_snapshots_.at(name_).info_;
+}
+
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry&
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::LazyCluster::instantiate() {
+  ClusterEntry* entry = parent_.getOrCreateCluster(name_);
+  // Lazy clusters are dropped along with the snapshot when the cluster is removed.
+  ASSERT(entry != nullptr);
+  return *entry;
+}
+
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry&
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::createCluster(const std::string& name,
+                                                                 const ClusterSnapshot& snapshot) {
+  ClusterEntryPtr& entry = thread_local_clusters_[name];
+  entry = std::make_unique<ClusterEntry>(*this, snapshot.info_, snapshot.lb_factory_);
+  for (const auto& priority : snapshot.priorities_) {
+    PrioritySet::UpdateHostsParams update_hosts_params = priority.second.update_hosts_params_;
+    entry->priority_set_.updateHosts(priority.first, std::move(update_hosts_params),
+                                     priority.second.locality_weights_,
+                                     *priority.second.update_hosts_params_.hosts, {},
+                                     absl::nullopt);
+  }
+  if (!snapshot.priorities_.empty() && entry->lb_factory_ != nullptr) {
+    entry->lb_ = entry->lb_factory_->create();
+  }
+  return *entry;
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::reclaimIdleClusters() {
+  // Update callbacks may hold on to the clusters they were told about, so nothing is released
+  // while any are registered.
+  if (update_callbacks_.empty()) {
+    std::vector<std::string> idle_clusters;
+    for (auto& cluster : thread_local_clusters_) {
+      ClusterEntry& entry = *cluster.second;
+      if (&entry.priority_set_ == local_priority_set_ ||
+          entry.cluster_info_->lbType() == LoadBalancerType::OriginalDst) {
+        continue;
+      }
+      // A cluster is released once it has gone unused for a whole sweep interval and has no
+      // requests in flight through its async client. Connection pools drain gracefully.
+      if (entry.used_) {
+        entry.used_ = false;
+      } else if (!entry.http_async_client_.hasActiveStreams()) {
+        idle_clusters.push_back(cluster.first);
+      }
+    }
+
+    for (const std::string& name : idle_clusters) {
+      ENVOY_LOG(debug, "releasing idle TLS cluster {}", name);
+      thread_local_clusters_.erase(name);
+    }
+    parent_.cm_stats_.thread_local_clusters_reclaimed_.add(idle_clusters.size());
+  }
+
+  idle_timer_->enableTimer(parent_.thread_local_cluster_idle_timeout_.value());
+}
+
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
     ThreadLocalClusterManagerImpl& parent, ClusterInfoConstSharedPtr cluster,
     const LoadBalancerFactorySharedPtr& lb_factory)
@@ -1056,6 +1299,13 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
                                                      parent.parent_.random_, cluster->lbConfig());
       break;
     }
+    case LoadBalancerType::PeakEwma: {
+      ASSERT(lb_factory_ == nullptr);
+      lb_ = std::make_unique<PeakEwmaLoadBalancer>(
+          priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
+          parent.parent_.random_, cluster->lbConfig(), parent.parent_.time_source_);
+      break;
+    }
     case LoadBalancerType::RingHash:
     case LoadBalancerType::Maglev: {
       ASSERT(lb_factory_ != nullptr);
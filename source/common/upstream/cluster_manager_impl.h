@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -139,7 +140,7 @@ private:
  * All cluster manager stats. @see stats_macros.h
  */
 // clang-format off
-#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE)                                                  \
+#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE, HISTOGRAM)                                       \
   COUNTER(cluster_added)                                                                           \
   COUNTER(cluster_modified)                                                                        \
   COUNTER(cluster_removed)                                                                         \
@@ -147,15 +148,21 @@ private:
   COUNTER(cluster_updated_via_merge)                                                               \
   COUNTER(update_merge_cancelled)                                                                  \
   COUNTER(update_out_of_merge_window)                                                              \
+  COUNTER(thread_local_update_batches)                                                             \
+  COUNTER(thread_local_updates_coalesced)                                                          \
+  COUNTER(thread_local_clusters_created_on_demand)                                                 \
+  COUNTER(thread_local_clusters_reclaimed)                                                         \
   GAUGE  (active_clusters)                                                                         \
-  GAUGE  (warming_clusters)
+  GAUGE  (warming_clusters)                                                                        \
+  HISTOGRAM(thread_local_update_fanout_ms)
 // clang-format on
 
 /**
  * Struct definition for all cluster manager stats. @see stats_macros.h
  */
 struct ClusterManagerStats {
-  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                            GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -204,6 +211,8 @@ public:
   void shutdown() override {
     cds_api_.reset();
     ads_mux_.reset();
+    pending_thread_local_updates_.clear();
+    pending_thread_local_update_index_.clear();
     active_clusters_.clear();
   }
 
@@ -227,6 +236,34 @@ protected:
                                             const HostVector& hosts_removed);
 
 private:
+  /**
+   * Snapshot of one priority of one cluster, delivered to the workers as part of a batch. The host
+   * lists are copied once on the main thread and shared read-only by all workers.
+   */
+  struct ThreadLocalClusterUpdate {
+    std::string name_;
+    uint32_t priority_;
+    PrioritySet::UpdateHostsParams update_hosts_params_;
+    LocalityWeightsConstSharedPtr locality_weights_;
+    HostVector hosts_added_;
+    HostVector hosts_removed_;
+  };
+  using ThreadLocalClusterUpdateBatchConstSharedPtr =
+      std::shared_ptr<const std::vector<ThreadLocalClusterUpdate>>;
+
+  /**
+   * Membership change of one priority of one cluster, waiting to be flushed to the workers. The
+   * host snapshot is only taken when flushing, so coalesced updates don't copy the host lists.
+   * Pending updates are flushed before their cluster is replaced or removed, so cluster_ is valid
+   * until then.
+   */
+  struct PendingThreadLocalClusterUpdate {
+    const Cluster* cluster_;
+    uint32_t priority_;
+    HostVector hosts_added_;
+    HostVector hosts_removed_;
+  };
+
   /**
    * Thread local cached cluster data. Each thread local cluster gets updates from the parent
    * central dynamic cluster (if applicable). It maintains load balancer state and any created
@@ -306,10 +343,50 @@ private:
       LoadBalancerPtr lb_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
+      // Set whenever the cluster is looked up on this worker and cleared by every idle sweep. Only
+      // used when thread local clusters are instantiated on demand.
+      bool used_{true};
     };
 
     typedef std::unique_ptr<ClusterEntry> ClusterEntryPtr;
 
+    /**
+     * Everything needed to instantiate a worker local cluster on demand: the cluster itself and
+     * the latest membership of each of its priorities. Only kept when thread local clusters are
+     * instantiated on demand.
+     */
+    struct ClusterSnapshot {
+      struct PrioritySnapshot {
+        PrioritySet::UpdateHostsParams update_hosts_params_;
+        LocalityWeightsConstSharedPtr locality_weights_;
+      };
+
+      ClusterInfoConstSharedPtr info_;
+      LoadBalancerFactorySharedPtr lb_factory_;
+      std::map<uint32_t, PrioritySnapshot> priorities_;
+    };
+
+    /**
+     * What get() returns for a cluster that is not instantiated on this worker. Looking a cluster
+     * up or reading its info does not instantiate it, using its hosts or load balancer does.
+     */
+    struct LazyCluster : public ThreadLocalCluster {
+      LazyCluster(ThreadLocalClusterManagerImpl& parent, const std::string& name)
+          : parent_(parent), name_(name) {}
+
+      // Upstream::ThreadLocalCluster
+      const PrioritySet& prioritySet() override { return instantiate().prioritySet(); }
+      ClusterInfoConstSharedPtr info() override;
+      LoadBalancer& loadBalancer() override { return instantiate().loadBalancer(); }
+
+      ClusterEntry& instantiate();
+
+      ThreadLocalClusterManagerImpl& parent_;
+      const std::string name_;
+    };
+
+    typedef std::unique_ptr<LazyCluster> LazyClusterPtr;
+
     ThreadLocalClusterManagerImpl(ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
                                   const absl::optional<std::string>& local_cluster_name);
     ~ThreadLocalClusterManagerImpl();
@@ -318,19 +395,29 @@ private:
     void clearContainer(HostSharedPtr old_host, ConnPoolsContainer& container);
     void drainTcpConnPools(HostSharedPtr old_host, TcpConnPoolsContainer& container);
     void removeTcpConn(const HostConstSharedPtr& host, Network::ClientConnection& connection);
-    static void updateClusterMembership(const std::string& name, uint32_t priority,
-                                        PrioritySet::UpdateHostsParams&& update_hosts_params,
-                                        LocalityWeightsConstSharedPtr locality_weights,
-                                        const HostVector& hosts_added,
-                                        const HostVector& hosts_removed, ThreadLocal::Slot& tls);
+    static void updateClusterMembership(const ThreadLocalClusterUpdate& update,
+                                        ThreadLocal::Slot& tls);
     static void onHostHealthFailure(const HostSharedPtr& host, ThreadLocal::Slot& tls);
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
 
+    bool onDemand() const { return parent_.thread_local_cluster_idle_timeout_.has_value(); }
+    // Returns the worker local cluster without instantiating it, or nullptr if the cluster is
+    // unknown.
+    ThreadLocalCluster* getCluster(const std::string& name);
+    // Returns the worker local cluster, instantiating it from its snapshot if needed, or nullptr
+    // if the cluster is unknown.
+    ClusterEntry* getOrCreateCluster(const std::string& name);
+    ClusterEntry& createCluster(const std::string& name, const ClusterSnapshot& snapshot);
+    void reclaimIdleClusters();
+
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
     std::unordered_map<std::string, ClusterEntryPtr> thread_local_clusters_;
+    std::unordered_map<std::string, ClusterSnapshot> cluster_snapshots_;
+    std::unordered_map<std::string, LazyClusterPtr> lazy_clusters_;
+    Event::TimerPtr idle_timer_;
 
     // These maps are owned by the ThreadLocalClusterManagerImpl instead of the ClusterEntry
     // to prevent lifetime/ownership issues when a cluster is dynamically removed.
@@ -422,6 +509,7 @@ private:
   bool scheduleUpdate(const Cluster& cluster, uint32_t priority, bool mergeable,
                       const uint64_t timeout);
   void createOrUpdateThreadLocalCluster(ClusterData& cluster);
+  void flushThreadLocalClusterUpdates();
   ProtobufTypes::MessagePtr dumpClusterConfigs();
   static ClusterManagerStats generateStats(Stats::Scope& scope);
   void loadCluster(const envoy::api::v2::Cluster& cluster, const std::string& version_info,
@@ -455,6 +543,16 @@ private:
   Server::ConfigTracker::EntryOwnerPtr config_tracker_entry_;
   TimeSource& time_source_;
   ClusterUpdatesMap updates_map_;
+  // Membership updates accumulated on the main thread and posted to the workers as a single batch
+  // once per dispatcher iteration. Updates for the same cluster and priority are coalesced.
+  std::vector<PendingThreadLocalClusterUpdate> pending_thread_local_updates_;
+  std::map<std::pair<const Cluster*, uint32_t>, size_t> pending_thread_local_update_index_;
+  bool thread_local_flush_scheduled_{};
+  // Only owned by the cluster manager, so that a flush posted to the dispatcher can tell whether
+  // the cluster manager still exists when it runs.
+  const std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
+  // If set, worker local clusters are instantiated on first use and released after being idle.
+  absl::optional<std::chrono::milliseconds> thread_local_cluster_idle_timeout_;
   Event::Dispatcher& dispatcher_;
   Http::Context& http_context_;
 };
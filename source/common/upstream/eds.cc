@@ -38,7 +38,8 @@ EdsClusterImpl::EdsClusterImpl(
       envoy::api::v2::ClusterLoadAssignment>(
       eds_config, local_info_, dispatcher, cm, random, info_->statsScope(),
       "envoy.api.v2.EndpointDiscoveryService.FetchEndpoints",
-      "envoy.api.v2.EndpointDiscoveryService.StreamEndpoints", factory_context.api());
+      "envoy.api.v2.EndpointDiscoveryService.StreamEndpoints", factory_context.api(),
+      "envoy.api.v2.EndpointDiscoveryService.IncrementalEndpoints");
 }
 
 void EdsClusterImpl::startPreInit() { subscription_->start({cluster_name_}, *this); }
@@ -160,6 +161,20 @@ bool EdsClusterImpl::updateHostsPerLocality(
   return false;
 }
 
+void EdsClusterImpl::onConfigUpdate(
+    const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& added_resources,
+    const Protobuf::RepeatedPtrField<std::string>&, const std::string& system_version_info) {
+  // Each EDS cluster subscribes to exactly one ClusterLoadAssignment, so an incremental update
+  // carries either the whole assignment or nothing. A removed assignment is handled like a state of
+  // the world update without resources: the current hosts are kept.
+  ResourceVector resources;
+  for (const auto& resource : added_resources) {
+    *resources.Add() =
+        MessageUtil::anyConvert<envoy::api::v2::ClusterLoadAssignment>(resource.resource());
+  }
+  onConfigUpdate(resources, system_version_info);
+}
+
 void EdsClusterImpl::onConfigUpdateFailed(const EnvoyException* e) {
   UNREFERENCED_PARAMETER(e);
   // We need to allow server startup to continue, even if we have a bad config.
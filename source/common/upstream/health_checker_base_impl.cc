@@ -9,6 +9,21 @@
 namespace Envoy {
 namespace Upstream {
 
+SharedHealthCheckResults::Entry& SharedHealthCheckResults::acquire(uint64_t config_hash,
+                                                                   const std::string& address) {
+  Entry& entry = entries_[std::make_pair(config_hash, address)];
+  entry.sessions_++;
+  return entry;
+}
+
+void SharedHealthCheckResults::release(uint64_t config_hash, const std::string& address) {
+  auto entry = entries_.find(std::make_pair(config_hash, address));
+  ASSERT(entry != entries_.end() && entry->second.sessions_ > 0);
+  if (--entry->second.sessions_ == 0) {
+    entries_.erase(entry);
+  }
+}
+
 HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
                                              const envoy::api::v2::core::HealthCheck& config,
                                              Event::Dispatcher& dispatcher,
@@ -202,6 +217,12 @@ HealthCheckerImplBase::ActiveHealthCheckSession::ActiveHealthCheckSession(
       interval_timer_(parent.dispatcher_.createTimer([this]() -> void { onIntervalBase(); })),
       timeout_timer_(parent.dispatcher_.createTimer([this]() -> void { onTimeoutBase(); })) {
 
+  if (parent.shared_results_ != nullptr) {
+    shared_address_ = host->healthCheckAddress()->asString();
+    shared_entry_ = &parent.shared_results_->acquire(parent.shared_results_config_hash_,
+                                                     shared_address_);
+  }
+
   if (!host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent.incHealthy();
   }
@@ -212,6 +233,9 @@ HealthCheckerImplBase::ActiveHealthCheckSession::ActiveHealthCheckSession(
 }
 
 HealthCheckerImplBase::ActiveHealthCheckSession::~ActiveHealthCheckSession() {
+  if (shared_entry_ != nullptr) {
+    parent_.shared_results_->release(parent_.shared_results_config_hash_, shared_address_);
+  }
   if (!host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent_.decHealthy();
   }
@@ -221,6 +245,11 @@ HealthCheckerImplBase::ActiveHealthCheckSession::~ActiveHealthCheckSession() {
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degraded) {
+  shareResult(true, degraded, envoy::data::core::v2alpha::HealthCheckFailureType::ACTIVE);
+  applySuccess(degraded);
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::applySuccess(bool degraded) {
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -309,12 +338,51 @@ HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     envoy::data::core::v2alpha::HealthCheckFailureType type) {
+  shareResult(false, false, type);
+  applyFailure(type);
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::applyFailure(
+    envoy::data::core::v2alpha::HealthCheckFailureType type) {
   HealthTransition changed_state = setUnhealthy(type);
   timeout_timer_->disableTimer();
   interval_timer_->enableTimer(parent_.interval(HealthState::Unhealthy, changed_state));
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::shareResult(
+    bool healthy, bool degraded, envoy::data::core::v2alpha::HealthCheckFailureType type) {
+  if (shared_entry_ == nullptr) {
+    return;
+  }
+  last_result_time_ = parent_.dispatcher_.timeSource().monotonicTime();
+  shared_entry_->result_ = SharedHealthCheckResults::Result{last_result_time_, healthy, degraded,
+                                                            type};
+}
+
+bool HealthCheckerImplBase::ActiveHealthCheckSession::adoptSharedResult() {
+  // Only a result produced after this session last learned about the host is new information. This
+  // guarantees that at least one of the sessions sharing an address really checks it every round.
+  if (shared_entry_ == nullptr || !shared_entry_->result_.has_value() ||
+      shared_entry_->result_.value().time_ <= last_result_time_) {
+    return false;
+  }
+
+  const SharedHealthCheckResults::Result result = shared_entry_->result_.value();
+  last_result_time_ = result.time_;
+  parent_.stats_.deduplicated_.inc();
+  if (result.healthy_) {
+    applySuccess(result.degraded_);
+  } else {
+    applyFailure(result.failure_type_);
+  }
+  return true;
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onIntervalBase() {
+  if (adoptSharedResult()) {
+    return;
+  }
+
   onInterval();
   timeout_timer_->enableTimer(parent_.timeout_);
   parent_.stats_.attempt_.inc();
@@ -1,14 +1,22 @@
 #pragma once
 
+#include <map>
+#include <string>
+#include <utility>
+
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/v2/core/health_check.pb.h"
+#include "envoy/common/time.h"
 #include "envoy/event/timer.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/singleton/instance.h"
 #include "envoy/stats/scope.h"
 #include "envoy/upstream/health_checker.h"
 
 #include "common/common/logger.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -23,6 +31,7 @@ namespace Upstream {
   COUNTER(passive_failure)                                                                         \
   COUNTER(network_failure)                                                                         \
   COUNTER(verify_cluster)                                                                          \
+  COUNTER(deduplicated)                                                                            \
   GAUGE  (healthy)                                                                                 \
   GAUGE  (degraded)
 // clang-format on
@@ -34,6 +43,48 @@ struct HealthCheckerStats {
   ALL_HEALTH_CHECKER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
 };
 
+/**
+ * Active health check results shared between health checkers that check the same address with an
+ * equivalent configuration, typically because several clusters contain the same endpoints. A
+ * session due to check its host first looks for a result that another session produced since its
+ * own last check, and adopts it instead of checking the host again. Only used on the main thread.
+ */
+class SharedHealthCheckResults : public Singleton::Instance {
+public:
+  struct Result {
+    MonotonicTime time_;
+    bool healthy_{};
+    bool degraded_{};
+    envoy::data::core::v2alpha::HealthCheckFailureType failure_type_{};
+  };
+
+  struct Entry {
+    uint32_t sessions_{};
+    absl::optional<Result> result_;
+  };
+
+  /**
+   * Register a session checking an address. The returned entry stays valid until the matching
+   * release().
+   * @param config_hash supplies the hash of the health check configuration in use.
+   * @param address supplies the address being checked.
+   * @return Entry& the entry holding the latest shared result for the address.
+   */
+  Entry& acquire(uint64_t config_hash, const std::string& address);
+
+  /**
+   * Unregister a session previously registered with acquire().
+   */
+  void release(uint64_t config_hash, const std::string& address);
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  std::map<std::pair<uint64_t, std::string>, Entry> entries_;
+};
+
+typedef std::shared_ptr<SharedHealthCheckResults> SharedHealthCheckResultsSharedPtr;
+
 /**
  * Base implementation for all health checkers.
  */
@@ -45,6 +96,16 @@ public:
   void addHostCheckCompleteCb(HostStatusCb callback) override { callbacks_.push_back(callback); }
   void start() override;
 
+  /**
+   * Share check results with every other health checker using the same results and configuration
+   * hash. Must be called before start().
+   */
+  void shareResults(const SharedHealthCheckResultsSharedPtr& shared_results,
+                    uint64_t config_hash) {
+    shared_results_ = shared_results;
+    shared_results_config_hash_ = config_hash;
+  }
+
 protected:
   class ActiveHealthCheckSession {
   public:
@@ -66,6 +127,11 @@ protected:
     void onIntervalBase();
     virtual void onTimeout() PURE;
     void onTimeoutBase();
+    bool adoptSharedResult();
+    void applySuccess(bool degraded);
+    void applyFailure(envoy::data::core::v2alpha::HealthCheckFailureType type);
+    void shareResult(bool healthy, bool degraded,
+                     envoy::data::core::v2alpha::HealthCheckFailureType type);
 
     HealthCheckerImplBase& parent_;
     Event::TimerPtr interval_timer_;
@@ -73,6 +139,10 @@ protected:
     uint32_t num_unhealthy_{};
     uint32_t num_healthy_{};
     bool first_check_{true};
+    // Only set when results are shared. The address is kept to release the entry.
+    SharedHealthCheckResults::Entry* shared_entry_{};
+    std::string shared_address_;
+    MonotonicTime last_result_time_;
   };
 
   typedef std::unique_ptr<ActiveHealthCheckSession> ActiveHealthCheckSessionPtr;
@@ -131,6 +201,9 @@ private:
   const std::chrono::milliseconds unhealthy_interval_;
   const std::chrono::milliseconds unhealthy_edge_interval_;
   const std::chrono::milliseconds healthy_edge_interval_;
+  // Declared before the sessions, which release their shared entries when destroyed.
+  SharedHealthCheckResultsSharedPtr shared_results_;
+  uint64_t shared_results_config_hash_{};
   std::unordered_map<HostSharedPtr, ActiveHealthCheckSessionPtr> active_sessions_;
   uint64_t local_process_healthy_{};
   uint64_t local_process_degraded_{};
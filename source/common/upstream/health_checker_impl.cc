@@ -48,27 +48,45 @@ HealthCheckerSharedPtr
 HealthCheckerFactory::create(const envoy::api::v2::core::HealthCheck& health_check_config,
                              Upstream::Cluster& cluster, Runtime::Loader& runtime,
                              Runtime::RandomGenerator& random, Event::Dispatcher& dispatcher,
-                             AccessLog::AccessLogManager& log_manager) {
+                             AccessLog::AccessLogManager& log_manager,
+                             const HealthCheckerSharedState& shared_state) {
   HealthCheckEventLoggerPtr event_logger;
   if (!health_check_config.event_log_path().empty()) {
     event_logger = std::make_unique<HealthCheckEventLoggerImpl>(
         log_manager, dispatcher.timeSource(), health_check_config.event_log_path());
   }
+  std::shared_ptr<HealthCheckerImplBase> health_checker;
   switch (health_check_config.health_checker_case()) {
-  case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kHttpHealthCheck:
-    return std::make_shared<ProdHttpHealthCheckerImpl>(cluster, health_check_config, dispatcher,
-                                                       runtime, random, std::move(event_logger));
+  case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kHttpHealthCheck: {
+    auto http_health_checker = std::make_shared<ProdHttpHealthCheckerImpl>(
+        cluster, health_check_config, dispatcher, runtime, random, std::move(event_logger));
+    if (shared_state.connections_ != nullptr && health_check_config.share_connections()) {
+      http_health_checker->shareConnections(shared_state.connections_,
+                                            shared_state.connection_hash_);
+    }
+    health_checker = http_health_checker;
+    break;
+  }
   case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kTcpHealthCheck:
-    return std::make_shared<TcpHealthCheckerImpl>(cluster, health_check_config, dispatcher, runtime,
-                                                  random, std::move(event_logger));
-  case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kGrpcHealthCheck:
+    health_checker = std::make_shared<TcpHealthCheckerImpl>(
+        cluster, health_check_config, dispatcher, runtime, random, std::move(event_logger));
+    break;
+  case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kGrpcHealthCheck: {
     if (!(cluster.info()->features() & Upstream::ClusterInfo::Features::HTTP2)) {
       throw EnvoyException(fmt::format("{} cluster must support HTTP/2 for gRPC healthchecking",
                                        cluster.info()->name()));
     }
-    return std::make_shared<ProdGrpcHealthCheckerImpl>(cluster, health_check_config, dispatcher,
-                                                       runtime, random, std::move(event_logger));
+    auto grpc_health_checker = std::make_shared<ProdGrpcHealthCheckerImpl>(
+        cluster, health_check_config, dispatcher, runtime, random, std::move(event_logger));
+    if (shared_state.connections_ != nullptr && health_check_config.share_connections()) {
+      grpc_health_checker->shareConnections(shared_state.connections_,
+                                            shared_state.connection_hash_);
+    }
+    health_checker = grpc_health_checker;
+    break;
+  }
   case envoy::api::v2::core::HealthCheck::HealthCheckerCase::kCustomHealthCheck: {
+    // Results and connections of custom health checkers are not shared.
     auto& factory =
         Config::Utility::getAndCheckFactory<Server::Configuration::CustomHealthCheckerFactory>(
             std::string(health_check_config.custom_health_check().name()));
@@ -81,6 +99,65 @@ HealthCheckerFactory::create(const envoy::api::v2::core::HealthCheck& health_che
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
+
+  if (shared_state.results_ != nullptr && health_check_config.share_results()) {
+    health_checker->shareResults(shared_state.results_, MessageUtil::hash(health_check_config));
+  }
+  return health_checker;
+}
+
+SharedHealthCheckConnections::Connection::~Connection() {
+  if (client_) {
+    client_->close();
+  }
+}
+
+Http::CodecClient&
+SharedHealthCheckConnections::Connection::client(const HostSharedPtr& host,
+                                                 const CreateCodecClientCb& create_client) {
+  if (!client_) {
+    Upstream::Host::CreateConnectionData conn = host->createHealthCheckConnection(dispatcher_);
+    client_ = create_client(conn);
+    client_->addConnectionCallbacks(*this);
+    client_->setCodecConnectionCallbacks(*this);
+    id_ = client_->id();
+  }
+  return *client_;
+}
+
+void SharedHealthCheckConnections::Connection::onEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    // The codec client has already reset the streams of any health checks in flight, which report
+    // their failures. The next check reconnects.
+    dispatcher_.deferredDelete(std::move(client_));
+  }
+}
+
+void SharedHealthCheckConnections::Connection::onGoAway() {
+  // Fail the health checks in flight and send the next ones on a new connection.
+  client_->close();
+}
+
+SharedHealthCheckConnections::Connection&
+SharedHealthCheckConnections::acquire(uint64_t connection_hash, const std::string& address,
+                                      Event::Dispatcher& dispatcher) {
+  const Key key{connection_hash, address};
+  std::unique_ptr<Connection>& connection = connections_[key];
+  if (connection == nullptr) {
+    connection = std::make_unique<Connection>(key, dispatcher);
+  }
+  connection->sessions_++;
+  return *connection;
+}
+
+void SharedHealthCheckConnections::release(Connection& connection) {
+  ASSERT(connection.sessions_ > 0);
+  if (--connection.sessions_ == 0) {
+    // Copied as the key is destroyed with the connection.
+    const Key key = connection.key_;
+    connections_.erase(key);
+  }
 }
 
 HttpHealthCheckerImpl::HttpHealthCheckerImpl(const Cluster& cluster,
@@ -102,6 +179,15 @@ HttpHealthCheckerImpl::HttpHealthCheckerImpl(const Cluster& cluster,
   }
 }
 
+void HttpHealthCheckerImpl::shareConnections(
+    const SharedHealthCheckConnectionsSharedPtr& shared_connections, uint64_t connection_hash) {
+  // HTTP/1 connections can only carry a single health check at a time.
+  if (codec_client_type_ == Http::CodecClient::Type::HTTP2) {
+    shared_connections_ = shared_connections;
+    connection_hash_ = connection_hash;
+  }
+}
+
 HttpHealthCheckerImpl::HttpStatusChecker::HttpStatusChecker(
     const Protobuf::RepeatedPtrField<envoy::type::Int64Range>& expected_statuses,
     uint64_t default_expected_status) {
@@ -151,10 +237,23 @@ HttpHealthCheckerImpl::HttpActiveHealthCheckSession::HttpActiveHealthCheckSessio
       protocol_(parent_.codec_client_type_ == Http::CodecClient::Type::HTTP1
                     ? Http::Protocol::Http11
                     : Http::Protocol::Http2),
-      local_address_(std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1")) {}
+      local_address_(std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1")) {
+  if (parent_.shared_connections_ != nullptr) {
+    shared_connections_ = parent_.shared_connections_;
+    shared_connection_ = &shared_connections_->acquire(
+        parent_.connection_hash_, host->healthCheckAddress()->asString(), parent_.dispatcher_);
+  }
+}
 
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::~HttpActiveHealthCheckSession() {
-  if (client_) {
+  if (shared_connection_ != nullptr) {
+    // Other clusters keep using the connection, so only reset our own request.
+    if (request_encoder_) {
+      expect_reset_ = true;
+      request_encoder_->getStream().resetStream(Http::StreamResetReason::LocalReset);
+    }
+    shared_connections_->release(*shared_connection_);
+  } else if (client_) {
     // If there is an active request it will get reset, so make sure we ignore the reset.
     expect_reset_ = true;
     client_->close();
@@ -182,7 +281,12 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onEvent(Network::Conne
 
 // TODO(lilika) : Support connection pooling
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
-  if (!client_) {
+  if (shared_connection_ != nullptr) {
+    shared_connection_->client(host_, [this](Upstream::Host::CreateConnectionData& conn) {
+      return Http::CodecClientPtr{parent_.createCodecClient(conn)};
+    });
+    expect_reset_ = false;
+  } else if (!client_) {
     Upstream::Host::CreateConnectionData conn =
         host_->createHealthCheckConnection(parent_.dispatcher_);
     client_.reset(parent_.createCodecClient(conn));
@@ -190,7 +294,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
     expect_reset_ = false;
   }
 
-  request_encoder_ = &client_->newStream(*this);
+  request_encoder_ = &client().newStream(*this);
   request_encoder_->getStream().addCallbacks(*this);
 
   Http::HeaderMapImpl request_headers{
@@ -205,24 +309,24 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
   stream_info.onUpstreamHostSelected(host_);
   parent_.request_headers_parser_->evaluateHeaders(request_headers, stream_info);
   request_encoder_->encodeHeaders(request_headers, true);
-  request_encoder_ = nullptr;
 }
 
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onResetStream(Http::StreamResetReason) {
+  request_encoder_ = nullptr;
   if (expect_reset_) {
     return;
   }
 
-  ENVOY_CONN_LOG(debug, "connection/stream error health_flags={}", *client_,
-                 HostUtility::healthFlagsToString(*host_));
+  ENVOY_LOG(debug, "[C{}] connection/stream error health_flags={}", connectionId(),
+            HostUtility::healthFlagsToString(*host_));
   handleFailure(envoy::data::core::v2alpha::HealthCheckFailureType::NETWORK);
 }
 
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::HealthCheckResult
 HttpHealthCheckerImpl::HttpActiveHealthCheckSession::healthCheckResult() {
   uint64_t response_code = Http::Utility::getResponseStatus(*response_headers_);
-  ENVOY_CONN_LOG(debug, "hc response={} health_flags={}", *client_, response_code,
-                 HostUtility::healthFlagsToString(*host_));
+  ENVOY_LOG(debug, "[C{}] hc response={} health_flags={}", connectionId(), response_code,
+            HostUtility::healthFlagsToString(*host_));
 
   if (!parent_.http_status_checker_.inRange(response_code)) {
     return HealthCheckResult::Failed;
@@ -249,6 +353,7 @@ HttpHealthCheckerImpl::HttpActiveHealthCheckSession::healthCheckResult() {
 }
 
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onResponseComplete() {
+  request_encoder_ = nullptr;
   switch (healthCheckResult()) {
   case HealthCheckResult::Succeeded:
     handleSuccess(false);
@@ -262,10 +367,12 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onResponseComplete() {
     break;
   }
 
-  if ((response_headers_->Connection() &&
-       absl::EqualsIgnoreCase(response_headers_->Connection()->value().getStringView(),
-                              Http::Headers::get().ConnectionValues.Close)) ||
-      !parent_.reuse_connection_) {
+  // A shared connection stays open for the health checks of other clusters.
+  if (shared_connection_ == nullptr &&
+      ((response_headers_->Connection() &&
+        absl::EqualsIgnoreCase(response_headers_->Connection()->value().getStringView(),
+                               Http::Headers::get().ConnectionValues.Close)) ||
+       !parent_.reuse_connection_)) {
     client_->close();
   }
 
@@ -273,7 +380,15 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onResponseComplete() {
 }
 
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onTimeout() {
-  if (client_) {
+  if (shared_connection_ != nullptr) {
+    if (request_encoder_) {
+      host_->setActiveHealthFailureType(Host::ActiveHealthFailureType::TIMEOUT);
+      ENVOY_LOG(debug, "[C{}] stream timeout health_flags={}", connectionId(),
+                HostUtility::healthFlagsToString(*host_));
+      expect_reset_ = true;
+      request_encoder_->getStream().resetStream(Http::StreamResetReason::LocalReset);
+    }
+  } else if (client_) {
     host_->setActiveHealthFailureType(Host::ActiveHealthFailureType::TIMEOUT);
     ENVOY_CONN_LOG(debug, "connection/stream timeout health_flags={}", *client_,
                    HostUtility::healthFlagsToString(*host_));
@@ -438,12 +553,31 @@ GrpcHealthCheckerImpl::GrpcHealthCheckerImpl(const Cluster& cluster,
   }
 }
 
+void GrpcHealthCheckerImpl::shareConnections(
+    const SharedHealthCheckConnectionsSharedPtr& shared_connections, uint64_t connection_hash) {
+  shared_connections_ = shared_connections;
+  connection_hash_ = connection_hash;
+}
+
 GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::GrpcActiveHealthCheckSession(
     GrpcHealthCheckerImpl& parent, const HostSharedPtr& host)
-    : ActiveHealthCheckSession(parent, host), parent_(parent) {}
+    : ActiveHealthCheckSession(parent, host), parent_(parent) {
+  if (parent_.shared_connections_ != nullptr) {
+    shared_connections_ = parent_.shared_connections_;
+    shared_connection_ = &shared_connections_->acquire(
+        parent_.connection_hash_, host->healthCheckAddress()->asString(), parent_.dispatcher_);
+  }
+}
 
 GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::~GrpcActiveHealthCheckSession() {
-  if (client_) {
+  if (shared_connection_ != nullptr) {
+    // Other clusters keep using the connection, so only reset our own request.
+    if (request_encoder_) {
+      expect_reset_ = true;
+      request_encoder_->getStream().resetStream(Http::StreamResetReason::LocalReset);
+    }
+    shared_connections_->release(*shared_connection_);
+  } else if (client_) {
     // If there is an active request it will get reset, so make sure we ignore the reset.
     expect_reset_ = true;
     client_->close();
@@ -538,7 +672,11 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onEvent(Network::Conne
 }
 
 void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onInterval() {
-  if (!client_) {
+  if (shared_connection_ != nullptr) {
+    shared_connection_->client(host_, [this](Upstream::Host::CreateConnectionData& conn) {
+      return parent_.createCodecClient(conn);
+    });
+  } else if (!client_) {
     Upstream::Host::CreateConnectionData conn =
         host_->createHealthCheckConnection(parent_.dispatcher_);
     client_ = parent_.createCodecClient(conn);
@@ -546,7 +684,7 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onInterval() {
     client_->setCodecConnectionCallbacks(http_connection_callback_impl_);
   }
 
-  request_encoder_ = &client_->newStream(*this);
+  request_encoder_ = &client().newStream(*this);
   request_encoder_->getStream().addCallbacks(*this);
 
   const std::string& authority = parent_.authority_value_.has_value()
@@ -579,8 +717,8 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onResetStream(Http::St
     return;
   }
 
-  ENVOY_CONN_LOG(debug, "connection/stream error health_flags={}", *client_,
-                 HostUtility::healthFlagsToString(*host_));
+  ENVOY_LOG(debug, "[C{}] connection/stream error health_flags={}", connectionId(),
+            HostUtility::healthFlagsToString(*host_));
 
   // TODO(baranov1ch): according to all HTTP standards, we should check if reason is one of
   // Http::StreamResetReason::RemoteRefusedStreamReset (which may mean GOAWAY),
@@ -635,7 +773,8 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onRpcComplete(
     request_encoder_->getStream().resetStream(Http::StreamResetReason::LocalReset);
   }
 
-  if (!parent_.reuse_connection_) {
+  // A shared connection stays open for the health checks of other clusters.
+  if (!parent_.reuse_connection_ && shared_connection_ == nullptr) {
     client_->close();
   }
 }
@@ -648,8 +787,8 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::resetState() {
 }
 
 void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onTimeout() {
-  ENVOY_CONN_LOG(debug, "connection/stream timeout health_flags={}", *client_,
-                 HostUtility::healthFlagsToString(*host_));
+  ENVOY_LOG(debug, "[C{}] connection/stream timeout health_flags={}", connectionId(),
+            HostUtility::healthFlagsToString(*host_));
   expect_reset_ = true;
   request_encoder_->getStream().resetStream(Http::StreamResetReason::LocalReset);
 }
@@ -683,8 +822,8 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::logHealthCheckStatus(
     grpc_status_message = fmt::format("{}", grpc_status);
   }
 
-  ENVOY_CONN_LOG(debug, "hc grpc_status={} service_status={} health_flags={}", *client_,
-                 grpc_status_message, service_status, HostUtility::healthFlagsToString(*host_));
+  ENVOY_LOG(debug, "[C{}] hc grpc_status={} service_status={} health_flags={}", connectionId(),
+            grpc_status_message, service_status, HostUtility::healthFlagsToString(*host_));
 }
 
 Http::CodecClientPtr
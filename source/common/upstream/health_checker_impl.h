@@ -1,5 +1,11 @@
 #pragma once
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/v2/core/health_check.pb.h"
 #include "envoy/grpc/status.h"
@@ -16,6 +22,103 @@
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * HTTP/2 connections to health check addresses that are shared by the HTTP/2 and gRPC health
+ * checkers of all clusters that enable share_connections and connect to their hosts in the same
+ * way. Every health check is a stream on the shared connection, so an address checked by several
+ * clusters needs a single handshake. Only used on the main thread.
+ */
+class SharedHealthCheckConnections : public Singleton::Instance {
+public:
+  typedef std::function<Http::CodecClientPtr(Upstream::Host::CreateConnectionData&)>
+      CreateCodecClientCb;
+
+  typedef std::pair<uint64_t, std::string> Key;
+
+  class Connection : public Network::ConnectionCallbacks, public Http::ConnectionCallbacks {
+  public:
+    Connection(const Key& key, Event::Dispatcher& dispatcher)
+        : key_(key), dispatcher_(dispatcher) {}
+    ~Connection();
+
+    /**
+     * @return the codec client of the connection. If there is currently no connection, a new one
+     *         is made to the health check address of the given host.
+     */
+    Http::CodecClient& client(const HostSharedPtr& host, const CreateCodecClientCb& create_client);
+
+    /**
+     * @return the codec client of the connection, which must exist.
+     */
+    Http::CodecClient& client() {
+      ASSERT(client_ != nullptr);
+      return *client_;
+    }
+
+    /**
+     * @return the id of the latest connection, which may have been closed already. Used for
+     *         logging.
+     */
+    uint64_t id() const { return id_; }
+
+    // Network::ConnectionCallbacks
+    void onEvent(Network::ConnectionEvent event) override;
+    void onAboveWriteBufferHighWatermark() override {}
+    void onBelowWriteBufferLowWatermark() override {}
+
+    // Http::ConnectionCallbacks
+    void onGoAway() override;
+
+  private:
+    friend class SharedHealthCheckConnections;
+
+    const Key key_;
+    Event::Dispatcher& dispatcher_;
+    Http::CodecClientPtr client_;
+    uint64_t id_{};
+    uint32_t sessions_{};
+  };
+
+  /**
+   * Register a health check session with the connection to an address. The connection is made
+   * lazily by the first check sent on it.
+   * @param connection_hash supplies the hash of how the cluster of the session connects to hosts.
+   * @param address supplies the health check address of the host.
+   * @param dispatcher supplies the main thread dispatcher.
+   * @return the connection, which stays valid until the matching release().
+   */
+  Connection& acquire(uint64_t connection_hash, const std::string& address,
+                      Event::Dispatcher& dispatcher);
+
+  /**
+   * Unregister a health check session from a connection returned by acquire(). The connection is
+   * closed when the last session is released.
+   */
+  void release(Connection& connection);
+
+  /**
+   * @return the number of addresses with registered sessions.
+   */
+  size_t size() const { return connections_.size(); }
+
+private:
+  std::map<Key, std::unique_ptr<Connection>> connections_;
+};
+
+typedef std::shared_ptr<SharedHealthCheckConnections> SharedHealthCheckConnectionsSharedPtr;
+
+/**
+ * State shared between the health checkers of different clusters. Members are null when the
+ * corresponding kind of sharing is not in use.
+ */
+struct HealthCheckerSharedState {
+  SharedHealthCheckResultsSharedPtr results_;
+  SharedHealthCheckConnectionsSharedPtr connections_;
+  // Hash of the cluster settings that affect how connections to its hosts are made. Connections
+  // are only shared between clusters with the same hash.
+  uint64_t connection_hash_{};
+};
+
 /**
  * Factory for creating health checker implementations.
  */
@@ -29,13 +132,16 @@ public:
    * @param random supplies the random generator.
    * @param dispatcher supplies the dispatcher.
    * @param event_logger supplies the event_logger.
+   * @param shared_state supplies the results and connections to share with other health checkers
+   *        if the config enables share_results or share_connections.
    * @return a health checker.
    */
   static HealthCheckerSharedPtr create(const envoy::api::v2::core::HealthCheck& health_check_config,
                                        Upstream::Cluster& cluster, Runtime::Loader& runtime,
                                        Runtime::RandomGenerator& random,
                                        Event::Dispatcher& dispatcher,
-                                       AccessLog::AccessLogManager& log_manager);
+                                       AccessLog::AccessLogManager& log_manager,
+                                       const HealthCheckerSharedState& shared_state);
 };
 
 /**
@@ -47,6 +153,15 @@ public:
                         Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
                         Runtime::RandomGenerator& random, HealthCheckEventLoggerPtr&& event_logger);
 
+  /**
+   * Send HTTP/2 health checks on connections shared with other clusters. Must be called before
+   * start(). Has no effect on HTTP/1 health checks.
+   * @param shared_connections supplies the shared connections.
+   * @param connection_hash supplies the hash of how the cluster connects to its hosts.
+   */
+  void shareConnections(const SharedHealthCheckConnectionsSharedPtr& shared_connections,
+                        uint64_t connection_hash);
+
   /**
    * Utility class checking if given http status matches configured expectations.
    */
@@ -106,9 +221,21 @@ private:
       HttpActiveHealthCheckSession& parent_;
     };
 
+    Http::CodecClient& client() {
+      return shared_connection_ != nullptr ? shared_connection_->client() : *client_;
+    }
+    // For logging. A shared connection may have been closed, and its client deferred deleted,
+    // before the health checks that were using it are done.
+    uint64_t connectionId() const {
+      return shared_connection_ != nullptr ? shared_connection_->id() : client_->id();
+    }
+
     ConnectionCallbackImpl connection_callback_impl_{*this};
     HttpHealthCheckerImpl& parent_;
     Http::CodecClientPtr client_;
+    // Set instead of client_ when the connection is shared with other clusters.
+    SharedHealthCheckConnectionsSharedPtr shared_connections_;
+    SharedHealthCheckConnections::Connection* shared_connection_{};
     Http::StreamEncoder* request_encoder_{};
     Http::HeaderMapPtr response_headers_;
     const std::string& hostname_;
@@ -136,6 +263,8 @@ private:
   absl::optional<std::string> service_name_;
   Router::HeaderParserPtr request_headers_parser_;
   const HttpStatusChecker http_status_checker_;
+  SharedHealthCheckConnectionsSharedPtr shared_connections_;
+  uint64_t connection_hash_{};
 
 protected:
   const Http::CodecClient::Type codec_client_type_;
@@ -274,6 +403,14 @@ public:
                         Event::Dispatcher& dispatcher, Runtime::Loader& runtime,
                         Runtime::RandomGenerator& random, HealthCheckEventLoggerPtr&& event_logger);
 
+  /**
+   * Send health checks on connections shared with other clusters. Must be called before start().
+   * @param shared_connections supplies the shared connections.
+   * @param connection_hash supplies the hash of how the cluster connects to its hosts.
+   */
+  void shareConnections(const SharedHealthCheckConnectionsSharedPtr& shared_connections,
+                        uint64_t connection_hash);
+
 private:
   struct GrpcActiveHealthCheckSession : public ActiveHealthCheckSession,
                                         public Http::StreamDecoder,
@@ -329,11 +466,23 @@ private:
       GrpcActiveHealthCheckSession& parent_;
     };
 
+    Http::CodecClient& client() {
+      return shared_connection_ != nullptr ? shared_connection_->client() : *client_;
+    }
+    // For logging. A shared connection may have been closed, and its client deferred deleted,
+    // before the health checks that were using it are done.
+    uint64_t connectionId() const {
+      return shared_connection_ != nullptr ? shared_connection_->id() : client_->id();
+    }
+
     ConnectionCallbackImpl connection_callback_impl_{*this};
     HttpConnectionCallbackImpl http_connection_callback_impl_{*this};
     GrpcHealthCheckerImpl& parent_;
     Http::CodecClientPtr client_;
-    Http::StreamEncoder* request_encoder_;
+    // Set instead of client_ when the connection is shared with other clusters.
+    SharedHealthCheckConnectionsSharedPtr shared_connections_;
+    SharedHealthCheckConnections::Connection* shared_connection_{};
+    Http::StreamEncoder* request_encoder_{};
     Grpc::Decoder decoder_;
     std::unique_ptr<grpc::health::v1::HealthCheckResponse> health_check_response_;
     // If true, stream reset was initiated by us (GrpcActiveHealthCheckSession), not by HTTP stack,
@@ -355,6 +504,8 @@ private:
   const Protobuf::MethodDescriptor& service_method_;
   absl::optional<std::string> service_name_;
   absl::optional<std::string> authority_value_;
+  SharedHealthCheckConnectionsSharedPtr shared_connections_;
+  uint64_t connection_hash_{};
 };
 
 /**
@@ -241,7 +241,7 @@ void HdsCluster::startHealthchecks(AccessLog::AccessLogManager& access_log_manag
 
   for (auto& health_check : cluster_.health_checks()) {
     health_checkers_.push_back(Upstream::HealthCheckerFactory::create(
-        health_check, *this, runtime, random, dispatcher, access_log_manager));
+        health_check, *this, runtime, random, dispatcher, access_log_manager, {}));
     health_checkers_.back()->start();
   }
 }
@@ -725,5 +725,38 @@ HostConstSharedPtr RandomLoadBalancer::chooseHostOnce(LoadBalancerContext* conte
   return hosts_to_use[random_.random() % hosts_to_use.size()];
 }
 
+double PeakEwmaLoadBalancer::hostCost(const Host& host, MonotonicTime now) {
+  // A host that has outstanding requests but no latency history yet is one we know nothing
+  // about; rather than treating it as infinitely fast, push it behind every host with a known
+  // response time until its first response arrives.
+  static constexpr double Penalty = 1e12;
+  const double ewma = host.peakEwmaResponseTime(now);
+  const uint64_t active = host.stats().rq_active_.value();
+  if (ewma == 0 && active > 0) {
+    return Penalty + active;
+  }
+  return ewma * (active + 1);
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
+  const HostVector& hosts_to_use = hostSourceToHosts(hostSourceToUse(context));
+  if (hosts_to_use.empty()) {
+    return nullptr;
+  }
+  if (hosts_to_use.size() == 1) {
+    return hosts_to_use[0];
+  }
+
+  // Pick two distinct hosts uniformly at random.
+  const uint64_t size = hosts_to_use.size();
+  const uint64_t first = random_.random() % size;
+  const uint64_t second = (first + 1 + random_.random() % (size - 1)) % size;
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  const HostSharedPtr& first_host = hosts_to_use[first];
+  const HostSharedPtr& second_host = hosts_to_use[second];
+  return hostCost(*second_host, now) < hostCost(*first_host, now) ? second_host : first_host;
+}
+
 } // namespace Upstream
 } // namespace Envoy
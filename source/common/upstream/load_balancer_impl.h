@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "envoy/api/v2/cds.pb.h"
+#include "envoy/common/time.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
@@ -472,6 +473,37 @@ public:
   HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
 };
 
+/**
+ * Latency aware load balancer based on Finagle's peak EWMA. Two distinct hosts are sampled at
+ * random (P2C) and the one with the lower cost is picked, where the cost of a host is its peak
+ * EWMA response time multiplied by its number of active requests plus one. The response time
+ * estimate is kept on the host (see HostDescription::recordResponseTime()) and is therefore shared
+ * by all workers, in the same way as the active request gauge used by the least request balancer.
+ * Host weights are ignored.
+ */
+class PeakEwmaLoadBalancer : public ZoneAwareLoadBalancerBase {
+public:
+  PeakEwmaLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                       ClusterStats& stats, Runtime::Loader& runtime,
+                       Runtime::RandomGenerator& random,
+                       const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+                       TimeSource& time_source)
+      : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                                  common_config),
+        time_source_(time_source) {}
+
+  // Upstream::LoadBalancerBase
+  HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+
+  /**
+   * @return the cost of sending a request to the host, as used to compare P2C candidates.
+   */
+  static double hostCost(const Host& host, MonotonicTime now);
+
+private:
+  TimeSource& time_source_;
+};
+
 /**
  * Implementation of LoadBalancerSubsetInfo.
  */
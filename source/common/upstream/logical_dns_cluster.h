@@ -111,6 +111,13 @@ private:
     void setHealthCheckAddress(Network::Address::InstanceConstSharedPtr) override {}
     uint32_t priority() const override { return locality_lb_endpoint_.priority(); }
     void priority(uint32_t priority) override { locality_lb_endpoint_.set_priority(priority); }
+    void recordResponseTime(std::chrono::microseconds response_time,
+                            MonotonicTime now) const override {
+      logical_host_->recordResponseTime(response_time, now);
+    }
+    double peakEwmaResponseTime(MonotonicTime now) const override {
+      return logical_host_->peakEwmaResponseTime(now);
+    }
     Network::Address::InstanceConstSharedPtr address_;
     HostConstSharedPtr logical_host_;
     const std::shared_ptr<envoy::api::v2::core::Metadata> metadata_;
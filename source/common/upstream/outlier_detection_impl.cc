@@ -49,8 +49,9 @@ void DetectorHostMonitorImpl::updateCurrentSuccessRateBucket() {
 }
 
 void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
-  success_rate_accumulator_bucket_.load()->total_request_counter_++;
-  if (Http::CodeUtility::is5xx(response_code)) {
+  const bool is_5xx = Http::CodeUtility::is5xx(response_code);
+  success_rate_accumulator_bucket_.load()->recordRequest(!is_5xx);
+  if (is_5xx) {
     std::shared_ptr<DetectorImpl> detector = detector_.lock();
     if (!detector) {
       // It's possible for the cluster/detector to go away while we still have a host in use.
@@ -72,7 +73,6 @@ void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
       detector->onConsecutive5xx(host_.lock());
     }
   } else {
-    success_rate_accumulator_bucket_.load()->success_request_counter_++;
     consecutive_5xx_ = 0;
     consecutive_gateway_failure_ = 0;
   }
@@ -197,8 +197,8 @@ void DetectorImpl::armIntervalTimer() {
       runtime_.snapshot().getInteger("outlier_detection.interval_ms", config_.intervalMs())));
 }
 
-void DetectorImpl::checkHostForUneject(HostSharedPtr host, DetectorHostMonitorImpl* monitor,
-                                       MonotonicTime now) {
+void DetectorImpl::checkHostForUneject(const HostSharedPtr& host,
+                                       DetectorHostMonitorImpl* monitor, MonotonicTime now) {
   if (!host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
     return;
   }
@@ -212,8 +212,8 @@ void DetectorImpl::checkHostForUneject(HostSharedPtr host, DetectorHostMonitorIm
     host->healthFlagClear(Host::HealthFlag::FAILED_OUTLIER_CHECK);
     // Reset the consecutive failure counters to avoid re-ejection on very few new errors due
     // to the non-triggering counter being close to its trigger value.
-    host_monitors_[host]->resetConsecutive5xx();
-    host_monitors_[host]->resetConsecutiveGatewayFailure();
+    monitor->resetConsecutive5xx();
+    monitor->resetConsecutiveGatewayFailure();
     monitor->uneject(now);
     runCallbacks(host);
 
@@ -363,9 +363,10 @@ void DetectorImpl::onConsecutiveErrorWorker(
   }
 }
 
-Utility::EjectionPair Utility::successRateEjectionThreshold(
-    double success_rate_sum, const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
-    double success_rate_stdev_factor) {
+Utility::EjectionPair
+Utility::successRateEjectionThreshold(double success_rate_sum,
+                                      const std::vector<double>& success_rates,
+                                      double success_rate_stdev_factor) {
   // This function is using mean and standard deviation as statistical measures for outlier
   // detection. First the mean is calculated by dividing the sum of success rate data over the
   // number of data points. Then variance is calculated by taking the mean of the
@@ -381,13 +382,13 @@ Utility::EjectionPair Utility::successRateEjectionThreshold(
   // variance = 400
   // stdev = 20
   // threshold returned = 52
-  double mean = success_rate_sum / valid_success_rate_hosts.size();
+  double mean = success_rate_sum / success_rates.size();
   double variance = 0;
-  std::for_each(valid_success_rate_hosts.begin(), valid_success_rate_hosts.end(),
-                [&variance, mean](HostSuccessRatePair v) {
-                  variance += std::pow(v.success_rate_ - mean, 2);
-                });
-  variance /= valid_success_rate_hosts.size();
+  for (const double success_rate : success_rates) {
+    const double diff = success_rate - mean;
+    variance += diff * diff;
+  }
+  variance /= success_rates.size();
   double stdev = std::sqrt(variance);
 
   return {mean, (mean - (success_rate_stdev_factor * stdev))};
@@ -398,7 +399,11 @@ void DetectorImpl::processSuccessRateEjections() {
       "outlier_detection.success_rate_minimum_hosts", config_.successRateMinimumHosts());
   uint64_t success_rate_request_volume = runtime_.snapshot().getInteger(
       "outlier_detection.success_rate_request_volume", config_.successRateRequestVolume());
-  std::vector<HostSuccessRatePair> valid_success_rate_hosts;
+  // The success rates are collected into a flat array so that the statistics below are a tight
+  // loop over doubles. Hosts are referenced through the map rather than copied to avoid touching
+  // every host's reference count on each interval.
+  std::vector<double> success_rates;
+  std::vector<const HostSharedPtr*> success_rate_hosts;
   double success_rate_sum = 0;
 
   // Reset the Detector's success rate mean and stdev.
@@ -411,7 +416,8 @@ void DetectorImpl::processSuccessRateEjections() {
   }
 
   // reserve upper bound of vector size to avoid reallocation.
-  valid_success_rate_hosts.reserve(host_monitors_.size());
+  success_rates.reserve(host_monitors_.size());
+  success_rate_hosts.reserve(host_monitors_.size());
 
   for (const auto& host : host_monitors_) {
     // Don't do work if the host is already ejected.
@@ -420,39 +426,43 @@ void DetectorImpl::processSuccessRateEjections() {
           host.second->successRateAccumulator().getSuccessRate(success_rate_request_volume);
 
       if (host_success_rate) {
-        valid_success_rate_hosts.emplace_back(
-            HostSuccessRatePair(host.first, host_success_rate.value()));
+        success_rates.push_back(host_success_rate.value());
+        success_rate_hosts.push_back(&host.first);
         success_rate_sum += host_success_rate.value();
         host.second->successRate(host_success_rate.value());
       }
     }
   }
 
-  if (!valid_success_rate_hosts.empty() &&
-      valid_success_rate_hosts.size() >= success_rate_minimum_hosts) {
+  if (!success_rates.empty() && success_rates.size() >= success_rate_minimum_hosts) {
     double success_rate_stdev_factor =
         runtime_.snapshot().getInteger("outlier_detection.success_rate_stdev_factor",
                                        config_.successRateStdevFactor()) /
         1000.0;
     Utility::EjectionPair ejection_pair = Utility::successRateEjectionThreshold(
-        success_rate_sum, valid_success_rate_hosts, success_rate_stdev_factor);
+        success_rate_sum, success_rates, success_rate_stdev_factor);
     success_rate_average_ = ejection_pair.success_rate_average_;
     success_rate_ejection_threshold_ = ejection_pair.ejection_threshold_;
-    for (const auto& host_success_rate_pair : valid_success_rate_hosts) {
-      if (host_success_rate_pair.success_rate_ < success_rate_ejection_threshold_) {
-        stats_.ejections_success_rate_.inc(); // Deprecated.
-        stats_.ejections_detected_success_rate_.inc();
-        ejectHost(host_success_rate_pair.host_,
-                  envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE);
+
+    // Copy out the outliers before ejecting any of them, since ejection runs callbacks.
+    HostVector outliers;
+    for (size_t i = 0; i < success_rates.size(); i++) {
+      if (success_rates[i] < success_rate_ejection_threshold_) {
+        outliers.push_back(*success_rate_hosts[i]);
       }
     }
+    for (const HostSharedPtr& host : outliers) {
+      stats_.ejections_success_rate_.inc(); // Deprecated.
+      stats_.ejections_detected_success_rate_.inc();
+      ejectHost(host, envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE);
+    }
   }
 }
 
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
-  for (auto host : host_monitors_) {
+  for (const auto& host : host_monitors_) {
     checkHostForUneject(host.first, host.second, now);
 
     // Need to update the writer bucket to keep the data valid.
@@ -532,22 +542,22 @@ void EventLoggerImpl::setCommonEventParams(
 
 SuccessRateAccumulatorBucket* SuccessRateAccumulator::updateCurrentWriter() {
   // Right now current is being written to and backup is not. Flush the backup and swap.
-  backup_success_rate_bucket_->success_request_counter_ = 0;
-  backup_success_rate_bucket_->total_request_counter_ = 0;
-
-  current_success_rate_bucket_.swap(backup_success_rate_bucket_);
+  current_ ^= 1;
+  buckets_[current_].reset();
 
-  return current_success_rate_bucket_.get();
+  return &buckets_[current_];
 }
 
 absl::optional<double>
 SuccessRateAccumulator::getSuccessRate(uint64_t success_rate_request_volume) {
-  if (backup_success_rate_bucket_->total_request_counter_ < success_rate_request_volume) {
+  const uint64_t counters = buckets_[current_ ^ 1].counters_.load(std::memory_order_relaxed);
+  const uint64_t total_requests = SuccessRateAccumulatorBucket::totalRequests(counters);
+  if (total_requests < success_rate_request_volume) {
     return absl::optional<double>();
   }
 
-  return absl::optional<double>(backup_success_rate_bucket_->success_request_counter_ * 100.0 /
-                                backup_success_rate_bucket_->total_request_counter_);
+  return absl::optional<double>(SuccessRateAccumulatorBucket::successRequests(counters) * 100.0 /
+                                total_requests);
 }
 
 } // namespace Outlier
@@ -53,18 +53,19 @@ public:
 };
 
 /**
- * Thin struct to facilitate calculations for success rate outlier detection.
+ * Request counts for one success rate window. Both counts are packed into a single word so that
+ * recording a request on a worker is one relaxed atomic add: the total is kept in the upper 32
+ * bits and successes in the lower 32 bits. Reading the word also yields a consistent pair.
  */
-struct HostSuccessRatePair {
-  HostSuccessRatePair(HostSharedPtr host, double success_rate)
-      : host_(host), success_rate_(success_rate) {}
-  HostSharedPtr host_;
-  double success_rate_;
-};
-
 struct SuccessRateAccumulatorBucket {
-  std::atomic<uint64_t> success_request_counter_;
-  std::atomic<uint64_t> total_request_counter_;
+  void recordRequest(bool success) {
+    counters_.fetch_add((1ULL << 32) | (success ? 1 : 0), std::memory_order_relaxed);
+  }
+  void reset() { counters_.store(0, std::memory_order_relaxed); }
+  static uint64_t successRequests(uint64_t counters) { return counters & 0xFFFFFFFF; }
+  static uint64_t totalRequests(uint64_t counters) { return counters >> 32; }
+
+  std::atomic<uint64_t> counters_{0};
 };
 
 /**
@@ -74,10 +75,6 @@ struct SuccessRateAccumulatorBucket {
  */
 class SuccessRateAccumulator {
 public:
-  SuccessRateAccumulator()
-      : current_success_rate_bucket_(new SuccessRateAccumulatorBucket()),
-        backup_success_rate_bucket_(new SuccessRateAccumulatorBucket()) {}
-
   /**
    * This function updates the bucket to write data to.
    * @return a pointer to the SuccessRateAccumulatorBucket.
@@ -95,8 +92,10 @@ public:
   absl::optional<double> getSuccessRate(uint64_t success_rate_request_volume);
 
 private:
-  std::unique_ptr<SuccessRateAccumulatorBucket> current_success_rate_bucket_;
-  std::unique_ptr<SuccessRateAccumulatorBucket> backup_success_rate_bucket_;
+  // The buckets live inline so that the interval pass over many hosts does not chase pointers.
+  // buckets_[current_] is written to by workers and the other bucket is read by the main thread.
+  SuccessRateAccumulatorBucket buckets_[2];
+  uint32_t current_{0};
 };
 
 class DetectorImpl;
@@ -234,7 +233,8 @@ private:
 
   void addHostMonitor(HostSharedPtr host);
   void armIntervalTimer();
-  void checkHostForUneject(HostSharedPtr host, DetectorHostMonitorImpl* monitor, MonotonicTime now);
+  void checkHostForUneject(const HostSharedPtr& host, DetectorHostMonitorImpl* monitor,
+                           MonotonicTime now);
   void ejectHost(HostSharedPtr host, envoy::data::cluster::v2alpha::OutlierEjectionType type);
   static DetectionStats generateStats(Stats::Scope& scope);
   void initialize(const Cluster& cluster);
@@ -296,15 +296,13 @@ public:
    * This function returns an EjectionPair for success rate outlier detection. The pair contains
    * the average success rate of all valid hosts in the cluster and the ejection threshold.
    * If a host's success rate is under this threshold, the host is an outlier.
-   * @param success_rate_sum is the sum of the data in the success_rate_data vector.
-   * @param valid_success_rate_hosts is the vector containing the individual success rate data
-   *        points.
+   * @param success_rate_sum is the sum of the data in the success_rates vector.
+   * @param success_rates is the vector containing the individual success rate data points.
    * @return EjectionPair.
    */
-  static EjectionPair
-  successRateEjectionThreshold(double success_rate_sum,
-                               const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
-                               double success_rate_stdev_factor);
+  static EjectionPair successRateEjectionThreshold(double success_rate_sum,
+                                                   const std::vector<double>& success_rates,
+                                                   double success_rate_stdev_factor);
 };
 
 } // namespace Outlier
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -22,40 +23,40 @@ RingHashLoadBalancer::RingHashLoadBalancer(
       config_(config) {}
 
 HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
-  if (ring_.empty()) {
+  if (hosts_.empty()) {
     return nullptr;
   }
 
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
-  // I've generally kept the variable names to make the code easier to compare.
-  // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
-  //       change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  while (true) {
-    int64_t midp = (lowp + highp) / 2;
-
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      return ring_[0].host_;
-    }
-
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
-
-    if (h <= midval && h > midval1) {
-      return ring_[midp].host_;
-    }
+  // Find the first entry whose hash is >= h (the ketama successor) by descending the implicit
+  // Eytzinger tree. Each step goes left or right without a data dependent branch. Once we fall off
+  // the bottom, the answer is the last node where we went left, which is recovered by stripping
+  // the trailing one bits (right turns) plus one more bit from k. A result of zero means every
+  // entry is < h, in which case we wrap around to the smallest entry on the ring.
+  const uint64_t ring_size = hashes_.size() - 1;
+  uint64_t k = 1;
+  while (k <= ring_size) {
+    k = 2 * k + (hashes_[k] < h);
+  }
+  k >>= __builtin_ffsll(static_cast<long long>(~k));
+  if (k == 0) {
+    k = first_index_;
+  }
 
-    if (midval < h) {
-      lowp = midp + 1;
-    } else {
-      highp = midp - 1;
-    }
+  return hosts_[host_indices_[k]];
+}
 
-    if (lowp > highp) {
-      return ring_[0].host_;
-    }
+uint64_t RingHashLoadBalancer::Ring::buildEytzinger(const std::vector<RingEntry>& sorted_ring,
+                                                    uint64_t i, uint64_t k) {
+  // In-order traversal of the implicit tree. The recursion depth is log2 of the ring size, which is
+  // bounded by the 8M maximum ring size.
+  if (k < hashes_.size()) {
+    i = buildEytzinger(sorted_ring, i, 2 * k);
+    hashes_[k] = sorted_ring[i].hash_;
+    host_indices_[k] = sorted_ring[i].host_index_;
+    i++;
+    i = buildEytzinger(sorted_ring, i, 2 * k + 1);
   }
+  return i;
 }
 
 using HashFunction = envoy::api::v2::Cluster_RingHashLbConfig_HashFunction;
@@ -87,7 +88,10 @@ RingHashLoadBalancer::Ring::Ring(
   }
 
   ENVOY_LOG(info, "ring hash: min_ring_size={} hashes_per_host={}", min_ring_size, hashes_per_host);
-  ring_.reserve(hosts.size() * hashes_per_host);
+  RELEASE_ASSERT(hosts.size() <= std::numeric_limits<uint32_t>::max(), "");
+  hosts_ = hosts;
+  std::vector<RingEntry> ring;
+  ring.reserve(hosts.size() * hashes_per_host);
 
   const bool use_std_hash =
       config ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value().deprecated_v1(), use_std_hash, false)
@@ -98,8 +102,8 @@ RingHashLoadBalancer::Ring::Ring(
              : HashFunction::Cluster_RingHashLbConfig_HashFunction_XX_HASH;
 
   char hash_key_buffer[196];
-  for (const auto& host : hosts) {
-    const std::string& address_string = host->address()->asString();
+  for (uint32_t host_index = 0; host_index < hosts.size(); host_index++) {
+    const std::string& address_string = hosts[host_index]->address()->asString();
     uint64_t offset_start = address_string.size();
 
     // Currently, we support both IP and UDS addresses. The UDS max path length is ~108 on all Unix
@@ -129,19 +133,29 @@ RingHashLoadBalancer::Ring::Ring(
                     : HashUtil::xxHash64(hash_key);
 
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
+      ring.push_back({hash, host_index});
     }
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+  std::sort(ring.begin(), ring.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
     return lhs.hash_ < rhs.hash_;
   });
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (const auto& entry : ring_) {
-      ENVOY_LOG(trace, "ring hash: host={} hash={}", entry.host_->address()->asString(),
-                entry.hash_);
+    for (const auto& entry : ring) {
+      ENVOY_LOG(trace, "ring hash: host={} hash={}",
+                hosts_[entry.host_index_]->address()->asString(), entry.hash_);
     }
   }
+
+  hashes_.resize(ring.size() + 1);
+  host_indices_.resize(ring.size() + 1);
+  buildEytzinger(ring, 0, 1);
+
+  // The smallest entry is the leftmost node of the implicit tree.
+  first_index_ = 1;
+  while (2 * first_index_ < hashes_.size()) {
+    first_index_ *= 2;
+  }
 }
 
 } // namespace Upstream
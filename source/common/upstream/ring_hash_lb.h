@@ -28,9 +28,12 @@ public:
                        const envoy::api::v2::Cluster::CommonLbConfig& common_config);
 
 private:
+  // Ring entries refer to hosts by index into Ring::hosts_ rather than by HostConstSharedPtr. This
+  // keeps each entry a small POD, which halves the memory used by large rings and avoids reference
+  // count traffic while building and sorting them.
   struct RingEntry {
     uint64_t hash_;
-    HostConstSharedPtr host_;
+    uint32_t host_index_;
   };
 
   struct Ring : public HashingLoadBalancer {
@@ -40,7 +43,24 @@ private:
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash) const override;
 
-    std::vector<RingEntry> ring_;
+    /**
+     * Lay out the sorted ring in Eytzinger (breadth first) order starting at node k.
+     * @param sorted_ring supplies the ring sorted by hash.
+     * @param i supplies the index of the next unplaced entry in sorted_ring.
+     * @param k supplies the 1-based Eytzinger node index to fill.
+     * @return the index of the next unplaced entry in sorted_ring.
+     */
+    uint64_t buildEytzinger(const std::vector<RingEntry>& sorted_ring, uint64_t i, uint64_t k);
+
+    HostVector hosts_;
+    // The ring is stored as two parallel arrays in Eytzinger order, 1-indexed with slot 0 unused.
+    // The search only touches hashes_, and the top levels of the implicit tree share cache lines,
+    // so a lookup is a short branch free descent rather than a binary search over scattered
+    // entries. host_indices_ is only read once the position has been found.
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> host_indices_;
+    // Eytzinger index of the entry with the smallest hash, used when a hash wraps the ring.
+    uint64_t first_index_{};
   };
   typedef std::shared_ptr<const Ring> RingConstSharedPtr;
 
@@ -7,6 +7,7 @@
 #include "envoy/runtime/runtime.h"
 
 #include "common/common/assert.h"
+#include "common/common/hash.h"
 #include "common/config/metadata.h"
 #include "common/config/well_known_names.h"
 #include "common/protobuf/utility.h"
@@ -124,45 +125,58 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   return entry->priority_subset_->lb_->chooseHost(context);
 }
 
-// Iterates over the given metadata match criteria (which must be lexically sorted by key) and find
-// a matching LbSubsetEntryPtr, if any.
+// Hashes the given metadata match criteria (which must be lexically sorted by key) and finds a
+// matching LbSubsetEntryPtr in the subset index, if any.
 SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
     const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria) {
-  const LbSubsetMap* subsets = &subsets_;
+  if (match_criteria.empty()) {
+    return nullptr;
+  }
 
   // Because the match_criteria and the host metadata used to populate subsets_ are sorted in the
-  // same order, we can iterate over the criteria and perform a lookup for each key and value,
-  // starting with the root LbSubsetMap and using the previous iteration's LbSubsetMap thereafter
-  // (tracked in subsets). If ever a criterion's key or value is not found, there is no subset for
-  // this criteria. If we reach the last criterion, we've found the LbSubsetEntry for the criteria,
-  // which may or may not have a subset attached to it.
-  for (uint32_t i = 0; i < match_criteria.size(); i++) {
-    const Router::MetadataMatchCriterion& match_criterion = *match_criteria[i];
-    const auto& subset_it = subsets->find(match_criterion.name());
-    if (subset_it == subsets->end()) {
-      // No subsets with this key (at this level in the hierarchy).
-      break;
+  // same order, hashing the criteria yields the same hash as was used to index the LbSubsetEntry
+  // for the same key-values, which may or may not have a subset attached to it. Hash collisions
+  // are resolved by comparing the key-values themselves.
+  uint64_t hash = 0;
+  for (const auto& match_criterion : match_criteria) {
+    hash = subsetIndexHash(hash, match_criterion->name(), match_criterion->value().hash());
+  }
+
+  const auto index_it = subset_index_.find(hash);
+  if (index_it == subset_index_.end()) {
+    return nullptr;
+  }
+
+  for (const LbSubsetEntryPtr& entry : index_it->second) {
+    if (entry->kvs_.size() != match_criteria.size()) {
+      continue;
     }
 
-    const ValueSubsetMap& vs_map = subset_it->second;
-    const auto& vs_it = vs_map.find(match_criterion.value());
-    if (vs_it == vs_map.end()) {
-      // No subsets with this value.
-      break;
+    bool matches = true;
+    for (uint32_t i = 0; i < match_criteria.size(); i++) {
+      const Router::MetadataMatchCriterion& match_criterion = *match_criteria[i];
+      if (entry->kvs_[i].first != match_criterion.name() ||
+          !ValueUtil::equal(entry->kvs_[i].second, match_criterion.value().value())) {
+        matches = false;
+        break;
+      }
     }
 
-    const LbSubsetEntryPtr& entry = vs_it->second;
-    if (i + 1 == match_criteria.size()) {
-      // We've reached the end of the criteria, and they all matched.
+    if (matches) {
       return entry;
     }
-
-    subsets = &entry->children_;
   }
 
   return nullptr;
 }
 
+uint64_t SubsetLoadBalancer::subsetIndexHash(uint64_t hash, const std::string& name,
+                                             uint64_t value_hash) {
+  hash = HashUtil::xxHash64(name, hash);
+  return HashUtil::xxHash64(
+      absl::string_view(reinterpret_cast<const char*>(&value_hash), sizeof(value_hash)), hash);
+}
+
 void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
                                               const HostVector& hosts_removed) {
   if (fallback_policy_ == envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK) {
@@ -212,27 +226,26 @@ void SubsetLoadBalancer::processSubsets(
     const bool adding_hosts = step.second;
 
     for (const auto& host : hosts) {
-      for (const auto& keys : subset_keys_) {
-        // For each host, for each subset key, attempt to extract the metadata corresponding to the
-        // key from the host.
-        SubsetMetadata kvs = extractSubsetMetadata(keys, *host);
-        if (!kvs.empty()) {
-          // The host has metadata for each key, find or create its subset.
-          LbSubsetEntryPtr entry = findOrCreateSubset(subsets_, kvs, 0);
-          if (subsets_modified.find(entry) != subsets_modified.end()) {
-            // We've already invoked the callback for this entry.
-            continue;
-          }
-          subsets_modified.emplace(entry);
-
-          if (entry->initialized()) {
-            update_cb(entry);
-          } else {
-            HostPredicate predicate =
-                std::bind(&SubsetLoadBalancer::hostMatches, this, kvs, std::placeholders::_1);
-
-            new_cb(entry, predicate, kvs, adding_hosts);
-          }
+      // For each host, visit the subset for each subset key the host has metadata for. The
+      // subsets are found or created when the host's membership is computed. The entries are
+      // copied since creating a subset below evaluates (and may recompute) memberships.
+      const std::vector<LbSubsetEntryPtr> entries = hostMembership(*host).entries_;
+      for (const LbSubsetEntryPtr& entry : entries) {
+        if (subsets_modified.find(entry) != subsets_modified.end()) {
+          // We've already invoked the callback for this entry.
+          continue;
+        }
+        subsets_modified.emplace(entry);
+
+        if (entry->initialized()) {
+          update_cb(entry);
+        } else {
+          const uint32_t subset_index = entry->index_;
+          HostPredicate predicate = [this, subset_index](const Host& host) -> bool {
+            return hostInSubset(host, subset_index);
+          };
+
+          new_cb(entry, predicate, entry->kvs_, adding_hosts);
         }
       }
     }
@@ -285,6 +298,12 @@ void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added
                      stats_.lb_subsets_created_.inc();
                    }
                  });
+
+  // Removed hosts no longer need their membership. If a removed host is still present at another
+  // priority, its membership is recomputed the next time it is needed.
+  for (const auto& host : hosts_removed) {
+    host_membership_.erase(host.get());
+  }
 }
 
 bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host) {
@@ -313,6 +332,41 @@ bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host
   return true;
 }
 
+bool SubsetLoadBalancer::hostInSubset(const Host& host, uint32_t subset_index) {
+  const std::vector<bool>& subsets = hostMembership(host).subsets_;
+  return subset_index < subsets.size() && subsets[subset_index];
+}
+
+// Returns the subsets the host belongs to, (re)computing them if the host is new or its metadata
+// has changed since they were last computed. Any subsets that do not exist yet are created.
+const SubsetLoadBalancer::HostSubsetMembership&
+SubsetLoadBalancer::hostMembership(const Host& host) {
+  const auto metadata = host.metadata();
+  HostSubsetMembership& membership = host_membership_[&host];
+  if (membership.metadata_ != nullptr && membership.metadata_ == metadata) {
+    return membership;
+  }
+
+  membership.metadata_ = metadata;
+  membership.entries_.clear();
+  membership.subsets_.clear();
+  for (const auto& keys : subset_keys_) {
+    // For each subset key, attempt to extract the metadata corresponding to the key from the host.
+    SubsetMetadata kvs = extractSubsetMetadata(keys, host);
+    if (!kvs.empty()) {
+      // The host has metadata for each key, find or create its subset.
+      LbSubsetEntryPtr entry = findOrCreateSubset(subsets_, kvs, 0);
+      if (entry->index_ >= membership.subsets_.size()) {
+        membership.subsets_.resize(entry->index_ + 1);
+      }
+      membership.subsets_[entry->index_] = true;
+      membership.entries_.emplace_back(std::move(entry));
+    }
+  }
+
+  return membership;
+}
+
 // Iterates over subset_keys looking up values from the given host's metadata. Each key-value pair
 // is appended to kvs. Returns a non-empty value if the host has a value for each key.
 SubsetLoadBalancer::SubsetMetadata
@@ -363,15 +417,16 @@ std::string SubsetLoadBalancer::describeMetadata(const SubsetLoadBalancer::Subse
 }
 
 // Given a vector of key-values (from extractSubsetMetadata), recursively finds the matching
-// LbSubsetEntryPtr.
+// LbSubsetEntryPtr. New entries are also added to the subset index.
 SubsetLoadBalancer::LbSubsetEntryPtr
 SubsetLoadBalancer::findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs,
-                                       uint32_t idx) {
+                                       uint32_t idx, uint64_t hash) {
   ASSERT(idx < kvs.size());
 
   const std::string& name = kvs[idx].first;
   const ProtobufWkt::Value& pb_value = kvs[idx].second;
   const HashedValue value(pb_value);
+  hash = subsetIndexHash(hash, name, value.hash());
   LbSubsetEntryPtr entry;
 
   const auto& kv_it = subsets.find(name);
@@ -385,7 +440,9 @@ SubsetLoadBalancer::findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadat
 
   if (!entry) {
     // Not found. Create an uninitialized entry.
-    entry.reset(new LbSubsetEntry());
+    entry.reset(new LbSubsetEntry(next_subset_index_++,
+                                  SubsetMetadata(kvs.begin(), kvs.begin() + idx + 1)));
+    subset_index_[hash].emplace_back(entry);
     if (kv_it != subsets.end()) {
       ValueSubsetMap& value_subset_map = kv_it->second;
       value_subset_map.emplace(value, entry);
@@ -401,7 +458,7 @@ SubsetLoadBalancer::findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadat
     return entry;
   }
 
-  return findOrCreateSubset(entry->children_, kvs, idx);
+  return findOrCreateSubset(entry->children_, kvs, idx, hash);
 }
 
 // Invokes cb for each LbSubsetEntryPtr in subsets.
@@ -475,6 +532,7 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
     break;
 
   case LoadBalancerType::OriginalDst:
+  case LoadBalancerType::PeakEwma:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
@@ -14,6 +14,7 @@
 #include "common/protobuf/utility.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -114,16 +115,34 @@ private:
   typedef std::unordered_map<HashedValue, LbSubsetEntryPtr> ValueSubsetMap;
   typedef std::unordered_map<std::string, ValueSubsetMap> LbSubsetMap;
 
+  // The subsets a host belongs to, computed from its metadata. Host metadata is replaced rather
+  // than modified in place, so the metadata pointer identifies the version the membership was
+  // computed from.
+  struct HostSubsetMembership {
+    std::shared_ptr<envoy::api::v2::core::Metadata> metadata_;
+    // One entry per subset key set the host has values for.
+    std::vector<LbSubsetEntryPtr> entries_;
+    // Bitset over LbSubsetEntry::index_ of the entries in entries_.
+    std::vector<bool> subsets_;
+  };
+
   // Entry in the subset hierarchy.
   class LbSubsetEntry {
   public:
     LbSubsetEntry() {}
+    LbSubsetEntry(uint32_t index, const SubsetMetadata& kvs) : index_(index), kvs_(kvs) {}
 
     bool initialized() const { return priority_subset_ != nullptr; }
     bool active() const { return initialized() && !priority_subset_->empty(); }
 
     LbSubsetMap children_;
 
+    // Dense index of the entry, used to address it in HostSubsetMembership::subsets_.
+    const uint32_t index_{};
+
+    // The key-values leading to this entry from the root of the hierarchy.
+    const SubsetMetadata kvs_;
+
     // Only initialized if a match exists at this level.
     PrioritySubsetImplPtr priority_subset_;
   };
@@ -145,12 +164,15 @@ private:
   HostConstSharedPtr tryChooseHostFromContext(LoadBalancerContext* context, bool& host_chosen);
 
   bool hostMatches(const SubsetMetadata& kvs, const Host& host);
+  bool hostInSubset(const Host& host, uint32_t subset_index);
+  const HostSubsetMembership& hostMembership(const Host& host);
 
   LbSubsetEntryPtr
   findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
+  static uint64_t subsetIndexHash(uint64_t hash, const std::string& name, uint64_t value_hash);
 
   LbSubsetEntryPtr findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs,
-                                      uint32_t idx);
+                                      uint32_t idx, uint64_t hash = 0);
   void forEachSubset(LbSubsetMap& subsets, std::function<void(LbSubsetEntryPtr)> cb);
 
   SubsetMetadata extractSubsetMetadata(const std::set<std::string>& subset_keys, const Host& host);
@@ -177,6 +199,17 @@ private:
   // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
 
+  // Flattened index over every entry in subsets_, keyed by the hash of the key-values leading to
+  // the entry (see subsetIndexHash()). This lets findSubset() do a single lookup rather than one
+  // per criterion. Entries are never removed from subsets_, so the index only grows.
+  absl::flat_hash_map<uint64_t, std::vector<LbSubsetEntryPtr>> subset_index_;
+  uint32_t next_subset_index_{};
+
+  // Cached subset membership of every known host. This avoids re-evaluating each host's metadata
+  // against each subset whenever the host set changes. A node based map is used so references to
+  // memberships remain valid while other hosts are inserted.
+  std::unordered_map<const Host*, HostSubsetMembership> host_membership_;
+
   const bool locality_weight_aware_;
   const bool scale_locality_weight_;
 
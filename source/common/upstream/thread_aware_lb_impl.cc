@@ -2,6 +2,8 @@
 
 #include <memory>
 
+#include "common/common/hash.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -33,6 +35,11 @@ void ThreadAwareLoadBalancerBase::refresh() {
     // Copy panic flag from LoadBalancerBase. It is calculated when there is a change
     // in hosts set or hosts' health.
     per_priority_state->global_panic_ = per_priority_panic_[priority];
+    per_priority_state->hosts_ =
+        per_priority_state->global_panic_ ? host_set->hosts() : host_set->healthyHosts();
+    for (const auto& host : per_priority_state->hosts_) {
+      per_priority_state->total_weight_ += host->weight();
+    }
     per_priority_state->current_lb_ =
         createLoadBalancer(*host_set, per_priority_state->global_panic_);
   }
@@ -64,15 +71,65 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   const uint32_t priority =
       LoadBalancerBase::choosePriority(h, *healthy_per_priority_load_, *degraded_per_priority_load_)
           .first;
+  const uint32_t priority_load = healthy_per_priority_load_->get()[priority] +
+                                 degraded_per_priority_load_->get()[priority];
   const auto& per_priority_state = (*per_priority_state_)[priority];
   if (per_priority_state->global_panic_) {
     stats_.lb_healthy_panic_.inc();
   }
-  return per_priority_state->current_lb_->chooseHost(h);
+
+  HostConstSharedPtr host = per_priority_state->current_lb_->chooseHost(h);
+  if (host == nullptr || hash_balance_factor_ == 0 || per_priority_state->hosts_.size() <= 1) {
+    return host;
+  }
+
+  return chooseHostWithBoundedLoad(*per_priority_state, priority_load, h, std::move(host));
+}
+
+HostConstSharedPtr ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHostWithBoundedLoad(
+    const PerPriorityState& per_priority_state, uint32_t priority_load, uint64_t hash,
+    HostConstSharedPtr host) {
+  // The bound of a host is hash_balance_factor_ percent of its weighted share of the active
+  // requests of the priority, counting the request being placed, rounded up so that it is always
+  // at least 1. The active requests of the priority are estimated from the cluster wide count,
+  // which the connection pools maintain alongside the host counts, scaled by the share of the load
+  // sent to the priority. This keeps the pick independent of the number of hosts. The counts are
+  // read from the shared gauges without synchronization, so the loads are approximate when several
+  // workers pick hosts concurrently. This is fine as the bound only needs to hold approximately to
+  // flatten hot spots.
+  const uint64_t active_requests = 1 + stats_.upstream_rq_active_.value() * priority_load / 100;
+  const uint64_t scaled_total_weight = 100ULL * per_priority_state.total_weight_;
+  const auto under_bound = [&](const Host& candidate) -> bool {
+    const uint64_t max_load =
+        (active_requests * hash_balance_factor_ * candidate.weight() + scaled_total_weight - 1) /
+        scaled_total_weight;
+    return candidate.stats().rq_active_.value() < max_load;
+  };
+  if (under_bound(*host)) {
+    return host;
+  }
+
+  // Derive further candidates by rehashing the original hash with the attempt number as the seed.
+  // The candidate order only depends on the hash, so a given key consistently spills over onto the
+  // same hosts.
+  for (uint32_t attempt = 1; attempt <= MaxBoundedLoadAttempts; attempt++) {
+    const uint64_t rehash =
+        HashUtil::xxHash64(absl::string_view(reinterpret_cast<const char*>(&hash), sizeof(hash)),
+                           attempt);
+    HostConstSharedPtr candidate = per_priority_state.current_lb_->chooseHost(rehash);
+    if (candidate != nullptr && under_bound(*candidate)) {
+      stats_.lb_hash_bounded_load_spillover_.inc();
+      return candidate;
+    }
+  }
+
+  // Every candidate is above the bound, which is only possible when the load counts are moving
+  // quickly. Fall back to the host chosen by hash.
+  return host;
 }
 
 LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
-  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_);
+  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_, hash_balance_factor_);
 
   // We must protect current_lb_ via a RW lock since it is accessed and written to by multiple
   // threads. All complex processing has already been precalculated however.
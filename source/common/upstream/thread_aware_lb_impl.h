@@ -38,38 +38,67 @@ protected:
                               Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                               const envoy::api::v2::Cluster::CommonLbConfig& common_config)
       : LoadBalancerBase(priority_set, stats, runtime, random, common_config),
-        factory_(new LoadBalancerFactoryImpl(stats, random)) {}
+        factory_(new LoadBalancerFactoryImpl(
+            stats, random,
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(common_config.consistent_hashing_lb_config(),
+                                            hash_balance_factor, 0))) {}
 
 private:
   struct PerPriorityState {
     std::shared_ptr<HashingLoadBalancer> current_lb_;
+    // The hosts current_lb_ was built from and their total weight, used to compute the load bound
+    // of each host.
+    HostVector hosts_;
+    uint64_t total_weight_{};
     bool global_panic_{};
   };
   typedef std::unique_ptr<PerPriorityState> PerPriorityStatePtr;
 
   struct LoadBalancerImpl : public LoadBalancer {
-    LoadBalancerImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerImpl(ClusterStats& stats, Runtime::RandomGenerator& random,
+                     uint32_t hash_balance_factor)
+        : stats_(stats), random_(random), hash_balance_factor_(hash_balance_factor) {}
 
     // Upstream::LoadBalancer
     HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
 
+    /**
+     * Implements consistent hashing with bounded loads. If the host chosen by hash is above the
+     * configured load bound, further candidates are chosen by rehashing the original hash until
+     * one is found below the bound.
+     * @param per_priority_state supplies the state of the chosen priority.
+     * @param priority_load supplies the percentage of the load sent to the chosen priority.
+     * @param hash supplies the request hash.
+     * @param host supplies the host originally chosen for hash.
+     * @return the host to use. This is the original host if no candidate under the bound is found.
+     */
+    HostConstSharedPtr chooseHostWithBoundedLoad(const PerPriorityState& per_priority_state,
+                                                 uint32_t priority_load, uint64_t hash,
+                                                 HostConstSharedPtr host);
+
+    // The maximum number of additional candidates probed when the hashed host is overloaded.
+    static const uint32_t MaxBoundedLoadAttempts = 32;
+
     ClusterStats& stats_;
     Runtime::RandomGenerator& random_;
+    // Percentage of the average host load that a host may reach. Zero disables bounded loads.
+    const uint32_t hash_balance_factor_;
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
     std::shared_ptr<HealthyLoad> healthy_per_priority_load_;
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_;
   };
 
   struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
-    LoadBalancerFactoryImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerFactoryImpl(ClusterStats& stats, Runtime::RandomGenerator& random,
+                            uint32_t hash_balance_factor)
+        : stats_(stats), random_(random), hash_balance_factor_(hash_balance_factor) {}
 
     // Upstream::LoadBalancerFactory
     LoadBalancerPtr create() override;
 
     ClusterStats& stats_;
     Runtime::RandomGenerator& random_;
+    const uint32_t hash_balance_factor_;
     absl::Mutex mutex_;
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_ GUARDED_BY(mutex_);
     // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriority can be reused.
@@ -1,6 +1,7 @@
 #include "common/upstream/upstream_impl.h"
 
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -14,6 +15,7 @@
 #include "envoy/secret/secret_manager.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/transport_socket_config.h"
+#include "envoy/singleton/manager.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/scope.h"
 #include "envoy/upstream/health_checker.h"
@@ -194,8 +196,40 @@ bool updateHealthFlag(const Host& updated_host, Host& existing_host, Host::Healt
   return false;
 }
 
+// Decay time constant of the peak EWMA response time estimate. A host that stops receiving
+// requests forgets its latency history after a few multiples of this.
+constexpr double PeakEwmaDecayTimeNs = 10e9;
+
+double peakEwmaDecay(int64_t last_update_ns, int64_t now_ns) {
+  const int64_t elapsed_ns = std::max<int64_t>(0, now_ns - last_update_ns);
+  return std::exp(-static_cast<double>(elapsed_ns) / PeakEwmaDecayTimeNs);
+}
+
 } // namespace
 
+void HostDescriptionImpl::recordResponseTime(std::chrono::microseconds response_time,
+                                             MonotonicTime now) const {
+  const int64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  const double sample = response_time.count();
+  const double ewma = response_time_ewma_us_.load();
+  if (sample > ewma) {
+    // Latency spikes are adopted immediately so that a slowing host is penalized right away.
+    response_time_ewma_us_ = sample;
+  } else {
+    const double w = peakEwmaDecay(response_time_ewma_updated_ns_.load(), now_ns);
+    response_time_ewma_us_ = ewma * w + sample * (1 - w);
+  }
+  response_time_ewma_updated_ns_ = now_ns;
+}
+
+double HostDescriptionImpl::peakEwmaResponseTime(MonotonicTime now) const {
+  const int64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  return response_time_ewma_us_.load() *
+         peakEwmaDecay(response_time_ewma_updated_ns_.load(), now_ns);
+}
+
 Host::CreateConnectionData HostImpl::createConnection(
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
     Network::TransportSocketOptionsSharedPtr transport_socket_options) const {
@@ -515,6 +549,13 @@ ClusterInfoImpl::ClusterInfoImpl(const envoy::api::v2::Cluster& config,
   case envoy::api::v2::Cluster::MAGLEV:
     lb_type_ = LoadBalancerType::Maglev;
     break;
+  case envoy::api::v2::Cluster::PEAK_EWMA:
+    if (config.lb_subset_config().subset_selectors_size() > 0) {
+      throw EnvoyException(
+          fmt::format("cluster: LB type 'peak_ewma' may not be used with subset load balancing"));
+    }
+    lb_type_ = LoadBalancerType::PeakEwma;
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -557,6 +598,9 @@ ClusterInfoImpl::extensionProtocolOptions(const std::string& name) const {
 
 namespace {
 
+SINGLETON_MANAGER_REGISTRATION(shared_health_check_results);
+SINGLETON_MANAGER_REGISTRATION(shared_health_check_connections);
+
 Stats::ScopePtr generateStatsScope(const envoy::api::v2::Cluster& config, Stats::Store& stats) {
   return stats.createScope(fmt::format(
       "cluster.{}.", config.alt_stat_name().empty() ? config.name() : config.alt_stat_name()));
@@ -665,8 +709,31 @@ ClusterSharedPtr ClusterImplBase::create(
     if (cluster.health_checks().size() != 1) {
       throw EnvoyException("Multiple health checks not supported");
     } else {
-      new_cluster->setHealthChecker(HealthCheckerFactory::create(
-          cluster.health_checks()[0], *new_cluster, runtime, random, dispatcher, log_manager));
+      HealthCheckerSharedState shared_state;
+      if (cluster.health_checks()[0].share_results()) {
+        shared_state.results_ = singleton_manager.getTyped<SharedHealthCheckResults>(
+            SINGLETON_MANAGER_REGISTERED_NAME(shared_health_check_results),
+            [] { return std::make_shared<SharedHealthCheckResults>(); });
+      }
+      if (cluster.health_checks()[0].share_connections()) {
+        shared_state.connections_ = singleton_manager.getTyped<SharedHealthCheckConnections>(
+            SINGLETON_MANAGER_REGISTERED_NAME(shared_health_check_connections),
+            [] { return std::make_shared<SharedHealthCheckConnections>(); });
+        // Only the settings that affect how health check connections are made matter.
+        envoy::api::v2::Cluster connection_config;
+        connection_config.mutable_transport_socket()->CopyFrom(cluster.transport_socket());
+        connection_config.mutable_tls_context()->CopyFrom(cluster.tls_context());
+        connection_config.mutable_upstream_bind_config()->CopyFrom(cluster.upstream_bind_config());
+        connection_config.mutable_upstream_connection_options()->CopyFrom(
+            cluster.upstream_connection_options());
+        connection_config.mutable_http2_protocol_options()->CopyFrom(
+            cluster.http2_protocol_options());
+        shared_state.connection_hash_ = MessageUtil::hash(connection_config);
+      }
+      new_cluster->setHealthChecker(HealthCheckerFactory::create(cluster.health_checks()[0],
+                                                                 *new_cluster, runtime, random,
+                                                                 dispatcher, log_manager,
+                                                                 shared_state));
     }
   }
 
@@ -133,6 +133,9 @@ public:
   const envoy::api::v2::core::Locality& locality() const override { return locality_; }
   uint32_t priority() const override { return priority_; }
   void priority(uint32_t priority) override { priority_ = priority; }
+  void recordResponseTime(std::chrono::microseconds response_time,
+                          MonotonicTime now) const override;
+  double peakEwmaResponseTime(MonotonicTime now) const override;
 
 protected:
   ClusterInfoConstSharedPtr cluster_;
@@ -148,6 +151,10 @@ protected:
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
   std::atomic<uint32_t> priority_;
+  // Peak EWMA response time state. Updates may race across workers; the estimate only needs to be
+  // approximately right so a lost update is acceptable.
+  mutable std::atomic<double> response_time_ewma_us_{0};
+  mutable std::atomic<int64_t> response_time_ewma_updated_ns_{0};
 };
 
 /**
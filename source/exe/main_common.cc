@@ -142,15 +142,17 @@ MainCommon::MainCommon(int argc, const char* const* argv)
             std::make_unique<Runtime::RandomGeneratorImpl>(), platform_impl_.threadFactory()) {}
 
 std::string MainCommon::hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len,
-                                          bool hot_restart_enabled) {
+                                          bool hot_restart_enabled, bool growable_stats) {
 #ifdef ENVOY_HOT_RESTART
   if (hot_restart_enabled) {
-    return Server::HotRestartImpl::hotRestartVersion(max_num_stats, max_stat_name_len);
+    return Server::HotRestartImpl::hotRestartVersion(max_num_stats, max_stat_name_len,
+                                                     growable_stats);
   }
 #else
   UNREFERENCED_PARAMETER(hot_restart_enabled);
   UNREFERENCED_PARAMETER(max_num_stats);
   UNREFERENCED_PARAMETER(max_stat_name_len);
+  UNREFERENCED_PARAMETER(growable_stats);
 #endif
   return "disabled";
 }
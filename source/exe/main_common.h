@@ -100,7 +100,7 @@ public:
   }
 
   static std::string hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len,
-                                       bool hot_restart_enabled);
+                                       bool hot_restart_enabled, bool growable_stats);
 
 private:
 #ifdef ENVOY_HANDLE_SIGNALS
@@ -59,8 +59,13 @@ FaultSettings::FaultSettings(const envoy::config::filter::http::fault::v2::HTTPF
 FaultFilterConfig::FaultFilterConfig(const envoy::config::filter::http::fault::v2::HTTPFault& fault,
                                      Runtime::Loader& runtime, const std::string& stats_prefix,
                                      Stats::Scope& scope, Runtime::RandomGenerator& generator)
-    : settings_(fault), runtime_(runtime), stats_(generateStats(stats_prefix, scope)),
-      stats_prefix_(stats_prefix), scope_(scope), generator_(generator) {}
+    : settings_(fault), runtime_(runtime),
+      delay_percent_key_(runtime.internKey(FaultFilter::DELAY_PERCENT_KEY)),
+      abort_percent_key_(runtime.internKey(FaultFilter::ABORT_PERCENT_KEY)),
+      delay_duration_key_(runtime.internKey(FaultFilter::DELAY_DURATION_KEY)),
+      abort_http_status_key_(runtime.internKey(FaultFilter::ABORT_HTTP_STATUS_KEY)),
+      stats_(generateStats(stats_prefix, scope)), stats_prefix_(stats_prefix), scope_(scope),
+      generator_(generator) {}
 
 FaultFilter::FaultFilter(FaultFilterConfigSharedPtr config) : config_(config) {}
 
@@ -131,7 +136,7 @@ Http::FilterHeadersStatus FaultFilter::decodeHeaders(Http::HeaderMap& headers, b
 
 bool FaultFilter::isDelayEnabled() {
   bool enabled = config_->runtime().snapshot().featureEnabled(
-      DELAY_PERCENT_KEY, fault_settings_->delayPercentage().numerator(),
+      config_->delayPercentKey(), fault_settings_->delayPercentage().numerator(),
       config_->randomGenerator().random(),
       ProtobufPercentHelper::fractionalPercentDenominatorToInt(
           fault_settings_->delayPercentage().denominator()));
@@ -147,7 +152,7 @@ bool FaultFilter::isDelayEnabled() {
 
 bool FaultFilter::isAbortEnabled() {
   bool enabled = config_->runtime().snapshot().featureEnabled(
-      ABORT_PERCENT_KEY, fault_settings_->abortPercentage().numerator(),
+      config_->abortPercentKey(), fault_settings_->abortPercentage().numerator(),
       config_->randomGenerator().random(),
       ProtobufPercentHelper::fractionalPercentDenominatorToInt(
           fault_settings_->abortPercentage().denominator()));
@@ -168,7 +173,7 @@ absl::optional<uint64_t> FaultFilter::delayDuration() {
     return ret;
   }
 
-  uint64_t duration = config_->runtime().snapshot().getInteger(DELAY_DURATION_KEY,
+  uint64_t duration = config_->runtime().snapshot().getInteger(config_->delayDurationKey(),
                                                                fault_settings_->delayDuration());
   if (!downstream_cluster_delay_duration_key_.empty()) {
     duration =
@@ -185,8 +190,8 @@ absl::optional<uint64_t> FaultFilter::delayDuration() {
 
 uint64_t FaultFilter::abortHttpStatus() {
   // TODO(mattklein123): check http status codes obtained from runtime.
-  uint64_t http_status =
-      config_->runtime().snapshot().getInteger(ABORT_HTTP_STATUS_KEY, fault_settings_->abortCode());
+  uint64_t http_status = config_->runtime().snapshot().getInteger(config_->abortHttpStatusKey(),
+                                                                  fault_settings_->abortCode());
 
   if (!downstream_cluster_abort_http_status_key_.empty()) {
     http_status = config_->runtime().snapshot().getInteger(
@@ -78,12 +78,21 @@ public:
   Stats::Scope& scope() { return scope_; }
   const FaultSettings* settings() { return &settings_; }
   Runtime::RandomGenerator& randomGenerator() { return generator_; }
+  const Runtime::InternedKey& delayPercentKey() const { return delay_percent_key_; }
+  const Runtime::InternedKey& abortPercentKey() const { return abort_percent_key_; }
+  const Runtime::InternedKey& delayDurationKey() const { return delay_duration_key_; }
+  const Runtime::InternedKey& abortHttpStatusKey() const { return abort_http_status_key_; }
 
 private:
   static FaultFilterStats generateStats(const std::string& prefix, Stats::Scope& scope);
 
   const FaultSettings settings_;
   Runtime::Loader& runtime_;
+  // The runtime keys looked up by every request.
+  const Runtime::InternedKey delay_percent_key_;
+  const Runtime::InternedKey abort_percent_key_;
+  const Runtime::InternedKey delay_duration_key_;
+  const Runtime::InternedKey abort_http_status_key_;
   FaultFilterStats stats_;
   const std::string stats_prefix_;
   Stats::Scope& scope_;
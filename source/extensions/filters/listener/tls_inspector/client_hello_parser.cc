@@ -0,0 +1,168 @@
+#include "extensions/filters/listener/tls_inspector/client_hello_parser.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+
+ClientHelloParser::Result ClientHelloParser::parse(const uint8_t* data, size_t len) {
+  server_name_ = absl::string_view();
+  application_protocols_.clear();
+  fragments_.clear();
+
+  CBS records, handshake;
+  CBS_init(&records, data, len);
+  bool first_record = true;
+  while (CBS_len(&records) > 0) {
+    // The record header is checked as far as it was received, so that other protocols are told
+    // apart from their first bytes.
+    uint8_t type, major_version;
+    uint16_t length;
+    if (!CBS_get_u8(&records, &type) || type != SSL3_RT_HANDSHAKE) {
+      return Result::NotClientHello;
+    }
+    if (!CBS_get_u8(&records, &major_version)) {
+      return Result::NeedMoreData;
+    }
+    if (major_version != SSL3_VERSION_MAJOR) {
+      return Result::NotClientHello;
+    }
+    if (!CBS_skip(&records, 1) || !CBS_get_u16(&records, &length)) {
+      return Result::NeedMoreData;
+    }
+    if (length > SSL3_RT_MAX_PLAIN_LENGTH) {
+      return Result::NotClientHello;
+    }
+
+    CBS fragment;
+    if (!CBS_get_bytes(&records, &fragment, length)) {
+      // Parse what was received of the record, the ClientHello may already be complete.
+      CBS_get_bytes(&records, &fragment, CBS_len(&records));
+    }
+
+    // The ClientHello is parsed in place, unless it spans several records.
+    if (first_record) {
+      handshake = fragment;
+      first_record = false;
+    } else {
+      if (fragments_.empty()) {
+        fragments_.assign(CBS_data(&handshake), CBS_data(&handshake) + CBS_len(&handshake));
+      }
+      fragments_.insert(fragments_.end(), CBS_data(&fragment),
+                        CBS_data(&fragment) + CBS_len(&fragment));
+      CBS_init(&handshake, fragments_.data(), fragments_.size());
+    }
+
+    const Result result = parseHandshake(handshake);
+    if (result != Result::NeedMoreData) {
+      return result;
+    }
+  }
+  return Result::NeedMoreData;
+}
+
+ClientHelloParser::Result ClientHelloParser::parseHandshake(CBS handshake) {
+  uint8_t type;
+  uint32_t length;
+  if (!CBS_get_u8(&handshake, &type)) {
+    return Result::NeedMoreData;
+  }
+  if (type != SSL3_MT_CLIENT_HELLO) {
+    return Result::NotClientHello;
+  }
+  CBS client_hello;
+  if (!CBS_get_u24(&handshake, &length) || !CBS_get_bytes(&handshake, &client_hello, length)) {
+    return Result::NeedMoreData;
+  }
+  return parseClientHello(client_hello);
+}
+
+ClientHelloParser::Result ClientHelloParser::parseClientHello(CBS client_hello) {
+  uint16_t version;
+  CBS session_id, cipher_suites, compression_methods, extensions;
+  if (!CBS_get_u16(&client_hello, &version) || !CBS_skip(&client_hello, SSL3_RANDOM_SIZE) ||
+      !CBS_get_u8_length_prefixed(&client_hello, &session_id) ||
+      CBS_len(&session_id) > SSL_MAX_SSL_SESSION_ID_LENGTH ||
+      !CBS_get_u16_length_prefixed(&client_hello, &cipher_suites) ||
+      CBS_len(&cipher_suites) < 2 || CBS_len(&cipher_suites) % 2 != 0 ||
+      !CBS_get_u8_length_prefixed(&client_hello, &compression_methods) ||
+      CBS_len(&compression_methods) < 1) {
+    return Result::NotClientHello;
+  }
+
+  // Extensions are optional.
+  if (CBS_len(&client_hello) == 0) {
+    return Result::ClientHello;
+  }
+  if (!CBS_get_u16_length_prefixed(&client_hello, &extensions) || CBS_len(&client_hello) != 0) {
+    return Result::NotClientHello;
+  }
+
+  bool server_name_found = false;
+  bool application_protocols_found = false;
+  while (CBS_len(&extensions) > 0) {
+    uint16_t type;
+    CBS extension;
+    if (!CBS_get_u16(&extensions, &type) ||
+        !CBS_get_u16_length_prefixed(&extensions, &extension)) {
+      return Result::NotClientHello;
+    }
+
+    // Like the TLS stack, reject repeated extensions, so that both see the same values.
+    if (type == TLSEXT_TYPE_server_name) {
+      if (server_name_found || !parseServerName(extension)) {
+        return Result::NotClientHello;
+      }
+      server_name_found = true;
+    } else if (type == TLSEXT_TYPE_application_layer_protocol_negotiation) {
+      if (application_protocols_found) {
+        return Result::NotClientHello;
+      }
+      parseApplicationProtocols(extension);
+      application_protocols_found = true;
+    }
+  }
+  return Result::ClientHello;
+}
+
+bool ClientHelloParser::parseServerName(CBS extension) {
+  // The TLS stack fails the handshake unless the list has a single valid host name.
+  CBS server_name_list, host_name;
+  uint8_t name_type;
+  if (!CBS_get_u16_length_prefixed(&extension, &server_name_list) ||
+      !CBS_get_u8(&server_name_list, &name_type) ||
+      !CBS_get_u16_length_prefixed(&server_name_list, &host_name) ||
+      CBS_len(&server_name_list) != 0 || CBS_len(&extension) != 0 ||
+      name_type != TLSEXT_NAMETYPE_host_name || CBS_len(&host_name) == 0 ||
+      CBS_len(&host_name) > TLSEXT_MAXLEN_host_name || CBS_contains_zero_byte(&host_name)) {
+    return false;
+  }
+  server_name_ =
+      absl::string_view(reinterpret_cast<const char*>(CBS_data(&host_name)), CBS_len(&host_name));
+  return true;
+}
+
+void ClientHelloParser::parseApplicationProtocols(CBS extension) {
+  CBS list, name;
+  if (!CBS_get_u16_length_prefixed(&extension, &list) || CBS_len(&extension) != 0 ||
+      CBS_len(&list) < 2) {
+    // Don't produce errors, let the real TLS stack do it.
+    return;
+  }
+  std::vector<absl::string_view> protocols;
+  while (CBS_len(&list) > 0) {
+    if (!CBS_get_u8_length_prefixed(&list, &name) || CBS_len(&name) == 0) {
+      // Don't produce errors, let the real TLS stack do it.
+      return;
+    }
+    protocols.emplace_back(reinterpret_cast<const char*>(CBS_data(&name)), CBS_len(&name));
+  }
+  application_protocols_ = std::move(protocols);
+}
+
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "openssl/bytestring.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+
+/**
+ * Extracts the server name and the application protocols from the ClientHello starting a TLS
+ * connection, in a single bounds-checked pass over the received bytes and without a TLS session.
+ * Only the parts of the ClientHello leading to these extensions are checked, validating the rest
+ * of it is left to the TLS stack of the connection.
+ */
+class ClientHelloParser {
+public:
+  enum class Result {
+    // The data received so far is a valid start of a ClientHello.
+    NeedMoreData,
+    // The data starts with a complete ClientHello.
+    ClientHello,
+    // The data doesn't start with a ClientHello.
+    NotClientHello,
+  };
+
+  /**
+   * Parses the data received from the start of a connection. The parser keeps no state between
+   * calls, so when more data is received, all of it is parsed again.
+   * @param data supplies the data received from the start of the connection.
+   * @param len supplies the length of the data.
+   * @return Result whether the data starts with a complete ClientHello.
+   */
+  Result parse(const uint8_t* data, size_t len);
+
+  /**
+   * @return absl::string_view the server name of the parsed ClientHello, or an empty view if it
+   *         has none. It refers to the data passed to parse(), and is valid until the next call.
+   */
+  absl::string_view serverName() const { return server_name_; }
+
+  /**
+   * @return the application protocols of the parsed ClientHello, or an empty list if it has none.
+   *         They refer to the data passed to parse(), and are valid until the next call.
+   */
+  const std::vector<absl::string_view>& applicationProtocols() const {
+    return application_protocols_;
+  }
+
+private:
+  Result parseHandshake(CBS handshake);
+  Result parseClientHello(CBS client_hello);
+  bool parseServerName(CBS extension);
+  void parseApplicationProtocols(CBS extension);
+
+  absl::string_view server_name_;
+  std::vector<absl::string_view> application_protocols_;
+  // A ClientHello fragmented over several records, reassembled.
+  std::vector<uint8_t> fragments_;
+};
+
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -8,8 +8,7 @@
 
 #include "common/common/logger.h"
 
-#include "openssl/bytestring.h"
-#include "openssl/ssl.h"
+#include "extensions/filters/listener/tls_inspector/client_hello_parser.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -45,14 +44,12 @@ public:
   Config(Stats::Scope& scope, uint32_t max_client_hello_size = TLS_MAX_CLIENT_HELLO);
 
   const TlsInspectorStats& stats() const { return stats_; }
-  bssl::UniquePtr<SSL> newSsl();
   uint32_t maxClientHelloSize() const { return max_client_hello_size_; }
 
   static constexpr size_t TLS_MAX_CLIENT_HELLO = 64 * 1024;
 
 private:
   TlsInspectorStats stats_;
-  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
   const uint32_t max_client_hello_size_;
 };
 
@@ -69,25 +66,18 @@ public:
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
-  void parseClientHello(const void* data, size_t len);
+  void parseClientHello(const uint8_t* data, size_t len);
   void onRead();
   void done(bool success);
-  void onALPN(const unsigned char* data, unsigned int len);
-  void onServername(absl::string_view name);
 
   ConfigSharedPtr config_;
   Network::ListenerFilterCallbacks* cb_;
   Event::FileEventPtr file_event_;
 
-  bssl::UniquePtr<SSL> ssl_;
+  ClientHelloParser parser_;
   uint64_t read_{0};
-  bool alpn_found_{false};
-  bool clienthello_success_{false};
 
   static thread_local uint8_t buf_[Config::TLS_MAX_CLIENT_HELLO];
-
-  // Allows callbacks on the SSL_CTX to set fields in this class.
-  friend class Config;
 };
 
 } // namespace TlsInspector
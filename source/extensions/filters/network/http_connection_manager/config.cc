@@ -30,7 +30,6 @@ namespace NetworkFilters {
 namespace HttpConnectionManager {
 namespace {
 
-typedef std::list<Http::FilterFactoryCb> FilterFactoriesList;
 typedef std::map<std::string, HttpConnectionManagerConfig::FilterConfig> FilterFactoryMap;
 
 HttpConnectionManagerConfig::UpgradeMap::const_iterator
@@ -258,6 +257,15 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
+  if (config.has_filter_timing()) {
+    const auto& filter_timing = config.filter_timing();
+    filter_timing_ = std::make_unique<Http::FilterTiming>(
+        stats_prefix_, context_.scope(), context_.runtime(), context_.random(),
+        context_.timeSource(),
+        PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(filter_timing, sampling, 10000, 100),
+        filter_timing.record_in_dynamic_metadata());
+  }
+
   const auto& filters = config.http_filters();
   for (int32_t i = 0; i < filters.size(); i++) {
     processFilter(filters[i], i, "http", filter_factories_);
@@ -288,7 +296,7 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
 
 void HttpConnectionManagerConfig::processFilter(
     const envoy::config::filter::network::http_connection_manager::v2::HttpFilter& proto_config,
-    int i, absl::string_view prefix, std::list<Http::FilterFactoryCb>& filter_factories) {
+    int i, absl::string_view prefix, FilterFactoriesList& filter_factories) {
   const ProtobufTypes::String& string_name = proto_config.name();
 
   ENVOY_LOG(debug, "    {} filter #{}", prefix, i);
@@ -311,7 +319,9 @@ void HttpConnectionManagerConfig::processFilter(
         Config::Utility::translateToFactoryConfig(proto_config, factory);
     callback = factory.createFilterFactoryFromProto(*message, stats_prefix_, context_);
   }
-  filter_factories.push_back(callback);
+  filter_factories.push_back(
+      {callback,
+       filter_timing_ != nullptr ? &filter_timing_->addFilter(prefix, i, string_name) : nullptr});
 }
 
 Http::ServerConnectionPtr
@@ -335,9 +345,7 @@ HttpConnectionManagerConfig::createCodec(Network::Connection& connection,
 }
 
 void HttpConnectionManagerConfig::createFilterChain(Http::FilterChainFactoryCallbacks& callbacks) {
-  for (const Http::FilterFactoryCb& factory : filter_factories_) {
-    factory(callbacks);
-  }
+  addFilters(filter_factories_, callbacks);
 }
 
 bool HttpConnectionManagerConfig::createUpgradeFilterChain(
@@ -368,12 +376,26 @@ bool HttpConnectionManagerConfig::createUpgradeFilterChain(
     filters_to_use = it->second.filter_factories.get();
   }
 
-  for (const Http::FilterFactoryCb& factory : *filters_to_use) {
-    factory(callbacks);
-  }
+  addFilters(*filters_to_use, callbacks);
   return true;
 }
 
+void HttpConnectionManagerConfig::addFilters(const FilterFactoriesList& filter_factories,
+                                             Http::FilterChainFactoryCallbacks& callbacks) {
+  if (filter_timing_ == nullptr || !filter_timing_->sampled()) {
+    for (const FilterFactory& factory : filter_factories) {
+      factory.factory_(callbacks);
+    }
+    return;
+  }
+
+  Http::TimedFilterChainFactoryCallbacks timed_callbacks(callbacks, *filter_timing_);
+  for (const FilterFactory& factory : filter_factories) {
+    timed_callbacks.setFilter(*factory.timing_filter_);
+    factory.factory_(timed_callbacks);
+  }
+}
+
 const Network::Address::Instance& HttpConnectionManagerConfig::localAddress() {
   return *context_.localInfo().address();
 }
@@ -13,6 +13,7 @@
 
 #include "common/common/logger.h"
 #include "common/http/conn_manager_impl.h"
+#include "common/http/filter_timing.h"
 #include "common/json/json_loader.h"
 
 #include "extensions/filters/network/common/factory_base.h"
@@ -82,7 +83,12 @@ public:
 
   // Http::FilterChainFactory
   void createFilterChain(Http::FilterChainFactoryCallbacks& callbacks) override;
-  typedef std::list<Http::FilterFactoryCb> FilterFactoriesList;
+  struct FilterFactory {
+    Http::FilterFactoryCb factory_;
+    // What the filters created by the factory are timed as, when filter timing is configured.
+    Http::FilterTiming::Filter* timing_filter_;
+  };
+  typedef std::list<FilterFactory> FilterFactoriesList;
   struct FilterConfig {
     std::unique_ptr<FilterFactoriesList> filter_factories;
     bool allow_upgrade;
@@ -134,8 +140,11 @@ private:
   void processFilter(
       const envoy::config::filter::network::http_connection_manager::v2::HttpFilter& proto_config,
       int i, absl::string_view prefix, FilterFactoriesList& filter_factories);
+  void addFilters(const FilterFactoriesList& filter_factories,
+                  Http::FilterChainFactoryCallbacks& callbacks);
 
   Server::Configuration::FactoryContext& context_;
+  Http::FilterTimingPtr filter_timing_;
   FilterFactoriesList filter_factories_;
   std::map<std::string, FilterConfig> upgrade_filter_factories_;
   std::list<AccessLog::InstanceSharedPtr> access_logs_;
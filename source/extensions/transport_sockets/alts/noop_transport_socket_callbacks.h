@@ -23,10 +23,11 @@ public:
   Network::Connection& connection() override { return parent_.connection(); }
   bool shouldDrainReadBuffer() override { return false; }
   /*
-   * No-op for these two methods to hold back the callbacks.
+   * No-op for these three methods to hold back the callbacks.
    */
   void setReadBufferReady() override {}
   void raiseEvent(Network::ConnectionEvent) override {}
+  void flushWriteBuffer() override {}
 
 private:
   Network::TransportSocketCallbacks& parent_;
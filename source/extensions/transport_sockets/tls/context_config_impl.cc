@@ -104,6 +104,30 @@ getCertificateValidationContextConfigProvider(
   }
 }
 
+ThreadPoolPrivateKeyMethodProvidersSharedPtr
+getPrivateKeyMethodProviders(
+    const envoy::api::v2::auth::CommonTlsContext& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  if (!config.has_private_key_offload()) {
+    return nullptr;
+  }
+  return ThreadPoolPrivateKeyMethodProviders::getSingleton(factory_context.singletonManager(),
+                                                           factory_context.api().threadFactory());
+}
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+getPrivateKeyMethodProvider(const envoy::api::v2::auth::CommonTlsContext& config,
+                            ThreadPoolPrivateKeyMethodProviders* providers) {
+  if (providers == nullptr) {
+    return nullptr;
+  }
+  // Contexts with the same settings share a pool, so that the number of threads doesn't grow
+  // with the number of listeners and clusters.
+  const auto& offload = config.private_key_offload();
+  return providers->get(PROTOBUF_GET_WRAPPED_OR_DEFAULT(offload, threads, 1),
+                        PROTOBUF_GET_WRAPPED_OR_DEFAULT(offload, max_batch_size, 16));
+}
+
 } // namespace
 
 ContextConfigImpl::ContextConfigImpl(
@@ -123,7 +147,11 @@ ContextConfigImpl::ContextConfigImpl(
       min_protocol_version_(tlsVersionFromProto(config.tls_params().tls_minimum_protocol_version(),
                                                 default_min_protocol_version)),
       max_protocol_version_(tlsVersionFromProto(config.tls_params().tls_maximum_protocol_version(),
-                                                default_max_protocol_version)) {
+                                                default_max_protocol_version)),
+      kernel_tls_offload_(config.kernel_tls_offload()),
+      private_key_method_providers_(getPrivateKeyMethodProviders(config, factory_context)),
+      private_key_method_provider_(
+          getPrivateKeyMethodProvider(config, private_key_method_providers_.get())) {
   if (default_cvc_ && certificate_validation_context_provider_ != nullptr) {
     // We need to validate combined certificate validation context.
     // The default certificate validation context and dynamic certificate validation
@@ -286,6 +314,10 @@ ClientContextConfigImpl::ClientContextConfigImpl(
        config.common_tls_context().tls_certificate_sds_secret_configs().size()) > 1) {
     throw EnvoyException("Multiple TLS certificates are not supported for client contexts");
   }
+  // Renegotiation would have BoringSSL write records with keys the kernel has taken over.
+  if (allow_renegotiation_ && config.common_tls_context().kernel_tls_offload()) {
+    throw EnvoyException("Kernel TLS offload can't be used with renegotiation");
+  }
 }
 
 ClientContextConfigImpl::ClientContextConfigImpl(
@@ -359,7 +391,8 @@ ServerContextConfigImpl::ServerContextConfigImpl(
         }
 
         return ret;
-      }()) {
+      }()),
+      shared_session_cache_(!config.disable_shared_session_cache()) {
   if ((config.common_tls_context().tls_certificates().size() +
        config.common_tls_context().tls_certificate_sds_secret_configs().size()) == 0) {
     throw EnvoyException("No TLS certificates found for server context");
@@ -13,6 +13,8 @@
 #include "common/json/json_loader.h"
 #include "common/ssl/tls_certificate_config_impl.h"
 
+#include "extensions/transport_sockets/tls/thread_pool_private_key_method.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -43,6 +45,10 @@ public:
   }
   unsigned minProtocolVersion() const override { return min_protocol_version_; };
   unsigned maxProtocolVersion() const override { return max_protocol_version_; };
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
+  Ssl::PrivateKeyMethodProviderSharedPtr privateKeyMethodProvider() const override {
+    return private_key_method_provider_;
+  }
 
   bool isReady() const override {
     const bool tls_is_ready =
@@ -92,6 +98,10 @@ private:
   Common::CallbackHandle* cvc_validation_callback_handle_{};
   const unsigned min_protocol_version_;
   const unsigned max_protocol_version_;
+  const bool kernel_tls_offload_;
+  // Held so that the providers shared with other contexts outlive this one.
+  const ThreadPoolPrivateKeyMethodProvidersSharedPtr private_key_method_providers_;
+  const Ssl::PrivateKeyMethodProviderSharedPtr private_key_method_provider_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
@@ -139,6 +149,7 @@ public:
   const std::vector<SessionTicketKey>& sessionTicketKeys() const override {
     return session_ticket_keys_;
   }
+  bool sharedSessionCache() const override { return shared_session_cache_; }
 
 private:
   static const unsigned DEFAULT_MIN_VERSION;
@@ -148,6 +159,7 @@ private:
 
   const bool require_client_certificate_;
   const std::vector<SessionTicketKey> session_ticket_keys_;
+  const bool shared_session_cache_;
 
   static void validateAndAppendKey(std::vector<ServerContextConfig::SessionTicketKey>& keys,
                                    const std::string& key_data);
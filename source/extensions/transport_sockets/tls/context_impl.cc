@@ -43,12 +43,27 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
   return false;
 }
 
+// The largest number of verified peer certificate chains kept by a context.
+constexpr uint64_t MaxCachedVerifications = 1024;
+
+ClientSessionCacheSharedPtr clientSessionCache(size_t max_session_keys,
+                                               ClientSessionCacheSharedPtr session_cache) {
+  if (max_session_keys == 0) {
+    return nullptr;
+  }
+  return session_cache != nullptr ? session_cache
+                                  : std::make_shared<ClientSessionCache>(max_session_keys);
+}
+
 } // namespace
 
 ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
                          TimeSource& time_source)
     : scope_(scope), stats_(generateStats(scope)), time_source_(time_source),
-      tls_max_version_(config.maxProtocolVersion()) {
+      tls_max_version_(config.maxProtocolVersion()),
+      kernel_tls_offload_(config.kernelTlsOffload()),
+      private_key_method_provider_(config.privateKeyMethodProvider()),
+      verification_cache_(MaxCachedVerifications) {
   const auto tls_certificates = config.tlsCertificates();
   tls_contexts_.resize(std::max(1UL, tls_certificates.size()));
 
@@ -113,6 +128,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
         }
         if (item->crl) {
           X509_STORE_add_crl(store, item->crl);
+          updateCrlNextUpdate(*item->crl);
           has_crl = true;
         }
       }
@@ -158,6 +174,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       for (const X509_INFO* item : list.get()) {
         if (item->crl) {
           X509_STORE_add_crl(store, item->crl);
+          updateCrlNextUpdate(*item->crl);
         }
       }
 
@@ -336,6 +353,13 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
     } break;
     }
 #endif
+
+    // The key stays loaded, for the provider to use it, but BoringSSL hands the operations on it
+    // over to the provider.
+    if (private_key_method_provider_ != nullptr) {
+      SSL_CTX_set_private_key_method(ctx.ssl_ctx_.get(),
+                                     &private_key_method_provider_->boringSslPrivateKeyMethod());
+    }
   }
 
   // use the server's cipher list preferences
@@ -407,19 +431,49 @@ int ContextImpl::ignoreCertificateExpirationCallback(int ok, X509_STORE_CTX* ctx
 
 int ContextImpl::verifyCallback(X509_STORE_CTX* store_ctx, void* arg) {
   ContextImpl* impl = reinterpret_cast<ContextImpl*>(arg);
+  SSL* ssl = reinterpret_cast<SSL*>(
+      X509_STORE_CTX_get_ex_data(store_ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
+  bssl::UniquePtr<X509> cert(SSL_get_peer_certificate(ssl));
 
+  // Verifying the same chain with the same validation context has the same outcome until a
+  // certificate of the chain or a CRL expires, so only the first verification is done in full.
+  const std::string cache_key =
+      CertificateVerificationCache::key(*cert, SSL_get_peer_cert_chain(ssl));
+  const SystemTime now = impl->time_source_.systemTime();
+  if (impl->verification_cache_.lookup(cache_key, now)) {
+    impl->stats_.cert_verify_cache_hit_.inc();
+    return 1;
+  }
+  impl->stats_.cert_verify_cache_miss_.inc();
+
+  SystemTime expiration = impl->crl_next_update_;
   if (impl->verify_trusted_ca_) {
     int ret = X509_verify_cert(store_ctx);
     if (ret <= 0) {
       impl->stats_.fail_verify_error_.inc();
       return ret;
     }
+    for (X509* chain_cert : X509_STORE_CTX_get_chain(store_ctx)) {
+      expiration = std::min(expiration, Utility::getExpirationTime(*chain_cert));
+    }
+  } else {
+    expiration = std::min(expiration, Utility::getExpirationTime(*cert));
   }
 
-  SSL* ssl = reinterpret_cast<SSL*>(
-      X509_STORE_CTX_get_ex_data(store_ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
-  bssl::UniquePtr<X509> cert(SSL_get_peer_certificate(ssl));
-  return impl->verifyCertificate(cert.get());
+  const int ret = impl->verifyCertificate(cert.get());
+  // Chains accepted in spite of having expired, when that is allowed, are not cached.
+  if (ret == 1 && expiration > now) {
+    impl->stats_.cert_verify_cache_eviction_.add(
+        impl->verification_cache_.insert(cache_key, std::move(cert), expiration));
+  }
+  return ret;
+}
+
+void ContextImpl::updateCrlNextUpdate(X509_CRL& crl) {
+  const absl::optional<SystemTime> next_update = Utility::getNextUpdate(crl);
+  if (next_update.has_value()) {
+    crl_next_update_ = std::min(crl_next_update_, next_update.value());
+  }
 }
 
 int ContextImpl::verifyCertificate(X509* cert) {
@@ -598,6 +652,19 @@ std::vector<Envoy::Ssl::CertificateDetailsPtr> ContextImpl::getCertChainInformat
   return cert_details;
 }
 
+std::vector<Envoy::Ssl::CertificateVerificationPtr>
+ContextImpl::getVerificationCacheInformation() const {
+  std::vector<Envoy::Ssl::CertificateVerificationPtr> verifications;
+  verification_cache_.iterate([&](X509& cert, SystemTime expiration) -> void {
+    Envoy::Ssl::CertificateVerificationPtr verification =
+        std::make_unique<envoy::admin::v2alpha::CertificateVerification>();
+    *verification->mutable_peer_cert() = *certificateDetails(&cert, "");
+    TimestampUtil::systemClockToTimestamp(expiration, *verification->mutable_expiration_time());
+    verifications.emplace_back(std::move(verification));
+  });
+  return verifications;
+}
+
 Envoy::Ssl::CertificateDetailsPtr ContextImpl::certificateDetails(X509* cert,
                                                                   const std::string& path) const {
   Envoy::Ssl::CertificateDetailsPtr certificate_details =
@@ -626,11 +693,14 @@ Envoy::Ssl::CertificateDetailsPtr ContextImpl::certificateDetails(X509* cert,
 
 ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ClientContextConfig& config,
-                                     TimeSource& time_source)
+                                     TimeSource& time_source,
+                                     ClientSessionCacheSharedPtr session_cache)
     : ContextImpl(scope, config, time_source),
       server_name_indication_(config.serverNameIndication()),
       allow_renegotiation_(config.allowRenegotiation()),
-      max_session_keys_(config.maxSessionKeys()) {
+      max_session_keys_(config.maxSessionKeys()),
+      session_cache_key_(generateSessionCacheKey(config)),
+      session_cache_(clientSessionCache(max_session_keys_, std::move(session_cache))) {
   // This should be guaranteed during configuration ingestion for client contexts.
   ASSERT(tls_contexts_.size() == 1);
   if (!parsed_alpn_protocols_.empty()) {
@@ -651,7 +721,7 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
     }
   }
 
-  if (max_session_keys_ > 0) {
+  if (session_cache_ != nullptr) {
     SSL_CTX_set_session_cache_mode(tls_contexts_[0].ssl_ctx_.get(), SSL_SESS_CACHE_CLIENT);
     SSL_CTX_sess_set_new_cb(
         tls_contexts_[0].ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
@@ -659,7 +729,7 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
               static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
           ClientContextImpl* client_context_impl = dynamic_cast<ClientContextImpl*>(context_impl);
           RELEASE_ASSERT(client_context_impl != nullptr, ""); // for Coverity
-          return client_context_impl->newSessionKey(session);
+          return client_context_impl->newSessionKey(ssl, session);
         });
   }
 }
@@ -679,49 +749,84 @@ bssl::UniquePtr<SSL> ClientContextImpl::newSsl(absl::optional<std::string> overr
     SSL_set_renegotiate_mode(ssl_con.get(), ssl_renegotiate_freely);
   }
 
-  if (max_session_keys_ > 0) {
-    if (session_keys_single_use_) {
-      // Stored single-use session keys, use write/write locks.
-      absl::WriterMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-        // Remove single-use session key (TLS 1.3) after first use.
-        if (SSL_SESSION_should_be_single_use(session)) {
-          session_keys_.pop_front();
-        }
-      }
+  if (session_cache_ != nullptr) {
+    // Sessions are only offered to the server name they were established with, as other servers
+    // behind the same cluster may not share its session ticket keys.
+    bssl::UniquePtr<SSL_SESSION> session = session_cache_->lookup(server_name_indication);
+    if (session != nullptr) {
+      stats_.session_cache_hit_.inc();
+      SSL_set_session(ssl_con.get(), session.get());
     } else {
-      // Never stored single-use session keys, use read/write locks.
-      absl::ReaderMutexLock l(&session_keys_mu_);
-      if (!session_keys_.empty()) {
-        // Use the most recently stored session key, since it has the highest
-        // probability of still being recognized/accepted by the server.
-        SSL_SESSION* session = session_keys_.front().get();
-        SSL_set_session(ssl_con.get(), session);
-      }
+      stats_.session_cache_miss_.inc();
     }
   }
 
   return ssl_con;
 }
 
-int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
-  // In case we ever store single-use session key (TLS 1.3),
-  // we need to switch to using write/write locks.
-  if (SSL_SESSION_should_be_single_use(session)) {
-    session_keys_single_use_ = true;
+int ClientContextImpl::newSessionKey(SSL* ssl, SSL_SESSION* session) {
+  const char* server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+  stats_.session_cache_eviction_.add(session_cache_->insert(
+      server_name != nullptr ? server_name : "", bssl::UniquePtr<SSL_SESSION>(session)));
+  return 1; // Tell BoringSSL that we took ownership of the session.
+}
+
+std::string
+ClientContextImpl::generateSessionCacheKey(const Envoy::Ssl::ClientContextConfig& config) {
+  // Hash everything that decides which servers we connect to and how we validate them, so that a
+  // session is only handed to a context that would have been willing to establish it. Fields are
+  // prefixed with their length so that different configurations can't hash the same.
+  std::string fields;
+  const auto add_field = [&fields](const std::string& field) {
+    fields.append(std::to_string(field.size()));
+    fields.push_back(':');
+    fields.append(field);
+  };
+  add_field(config.serverNameIndication());
+  add_field(config.alpnProtocols());
+  add_field(config.cipherSuites());
+  add_field(config.ecdhCurves());
+  add_field(std::to_string(config.minProtocolVersion()));
+  add_field(std::to_string(config.maxProtocolVersion()));
+  for (const auto& tls_certificate : config.tlsCertificates()) {
+    add_field(tls_certificate.get().certificateChain());
+  }
+  const Envoy::Ssl::CertificateValidationContextConfig* validation_config =
+      config.certificateValidationContext();
+  if (validation_config != nullptr) {
+    add_field(validation_config->caCert());
+    add_field(validation_config->certificateRevocationList());
+    for (const std::string& name : validation_config->verifySubjectAltNameList()) {
+      add_field(name);
+    }
+    for (const std::string& hash : validation_config->verifyCertificateHashList()) {
+      add_field(hash);
+    }
+    for (const std::string& hash : validation_config->verifyCertificateSpkiList()) {
+      add_field(hash);
+    }
+    add_field(validation_config->allowExpiredCertificate() ? "1" : "0");
   }
-  absl::WriterMutexLock l(&session_keys_mu_);
-  // Evict oldest entries.
-  while (session_keys_.size() >= max_session_keys_) {
-    session_keys_.pop_back();
+
+  std::vector<uint8_t> digest(SHA256_DIGEST_LENGTH);
+  SHA256(reinterpret_cast<const uint8_t*>(fields.data()), fields.size(), digest.data());
+  return Hex::encode(digest);
+}
+
+void ClientContextImpl::importSessions(
+    const std::vector<std::pair<std::string, std::string>>& sessions) {
+  if (session_cache_ == nullptr) {
+    return;
+  }
+  // Store the oldest session first, so that the most recent one ends up at the front of the queue.
+  for (auto it = sessions.rbegin(); it != sessions.rend(); ++it) {
+    bssl::UniquePtr<SSL_SESSION> session(
+        SSL_SESSION_from_bytes(reinterpret_cast<const uint8_t*>(it->second.data()),
+                               it->second.size(), tls_contexts_[0].ssl_ctx_.get()));
+    if (session != nullptr) {
+      session_cache_->insert(it->first, std::move(session));
+    }
   }
-  // Add new session key at the front of the queue, so that it's used first.
-  session_keys_.push_front(bssl::UniquePtr<SSL_SESSION>(session));
-  return 1; // Tell BoringSSL that we took ownership of the session.
 }
 
 uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sigalgs) {
@@ -738,8 +843,10 @@ uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sig
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()) {
+                                     TimeSource& time_source,
+                                     ServerSessionCacheSharedPtr session_cache)
+    : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()),
+      session_cache_(std::move(session_cache)) {
   if (config.tlsCertificates().empty()) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
@@ -758,7 +865,9 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
   // is used.
   uint8_t session_context_buf[EVP_MAX_MD_SIZE] = {};
   unsigned session_context_len = 0;
-  generateHashForSessionContexId(server_names, session_context_buf, session_context_len);
+  generateHashForSessionContexId(config, server_names, session_context_buf, session_context_len);
+  session_id_context_.assign(reinterpret_cast<const char*>(session_context_buf),
+                             session_context_len);
   for (auto& ctx : tls_contexts_) {
     if (config.certificateValidationContext() != nullptr &&
         !config.certificateValidationContext()->caCert().empty()) {
@@ -793,12 +902,54 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
     int rc = SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_context_buf,
                                             session_context_len);
     RELEASE_ASSERT(rc == 1, "");
+
+    if (session_cache_ != nullptr) {
+      // Sessions are stored in the shared cache only, so that any context with the same session ID
+      // context, on any worker, can resume them.
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+            ->newSession(session);
+      });
+      SSL_CTX_sess_set_get_cb(ctx.ssl_ctx_.get(),
+                              [](SSL* ssl, const uint8_t* session_id, int session_id_len,
+                                 int* out_copy) -> SSL_SESSION* {
+                                // The returned session carries a reference for BoringSSL.
+                                *out_copy = 0;
+                                return static_cast<ServerContextImpl*>(
+                                           SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+                                    ->getSession(session_id, session_id_len);
+                              });
+    }
   }
 }
 
-void ServerContextImpl::generateHashForSessionContexId(const std::vector<std::string>& server_names,
-                                                       uint8_t* session_context_buf,
-                                                       unsigned& session_context_len) {
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  // TLS 1.3 sessions are only resumed with tickets, never by session ID.
+  if (SSL_SESSION_get_protocol_version(session) >= TLS1_3_VERSION) {
+    return 0;
+  }
+  stats_.session_cache_eviction_.add(
+      session_cache_->insert(session_id_context_, bssl::UniquePtr<SSL_SESSION>(session)));
+  return 1; // Tell BoringSSL that we took ownership of the session.
+}
+
+SSL_SESSION* ServerContextImpl::getSession(const uint8_t* session_id, int session_id_len) {
+  bssl::UniquePtr<SSL_SESSION> session = session_cache_->lookup(
+      session_id_context_,
+      absl::string_view(reinterpret_cast<const char*>(session_id), session_id_len));
+  if (session == nullptr) {
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.session_cache_hit_.inc();
+  return session.release();
+}
+
+void ServerContextImpl::generateHashForSessionContexId(
+    const Envoy::Ssl::ServerContextConfig& config, const std::vector<std::string>& server_names,
+    uint8_t* session_context_buf, unsigned& session_context_len) {
   EVP_MD_CTX md;
   int rc = EVP_DigestInit(&md, EVP_sha256());
   RELEASE_ASSERT(rc == 1, "");
@@ -863,6 +1014,25 @@ void ServerContextImpl::generateHashForSessionContexId(const std::vector<std::st
     }
   }
 
+  // A session established without a client certificate, or with one accepted under other
+  // revocation lists or expiration rules, must not be resumed where these settings differ, since
+  // BoringSSL doesn't check a resumed session against them. The whole CA bundle is hashed, as it
+  // may carry revocation lists too.
+  const Envoy::Ssl::CertificateValidationContextConfig* validation_config =
+      config.certificateValidationContext();
+  if (validation_config != nullptr) {
+    for (const std::string* data :
+         {&validation_config->caCert(), &validation_config->certificateRevocationList()}) {
+      rc = EVP_DigestUpdate(&md, data->data(), data->size());
+      RELEASE_ASSERT(rc == 1, "");
+    }
+  }
+  const uint8_t validation_flags[] = {
+      config.requireClientCertificate(),
+      validation_config != nullptr && validation_config->allowExpiredCertificate()};
+  rc = EVP_DigestUpdate(&md, validation_flags, sizeof(validation_flags));
+  RELEASE_ASSERT(rc == 1, "");
+
   for (const auto& hash : verify_certificate_hash_list_) {
     rc = EVP_DigestUpdate(&md, hash.data(),
                           hash.size() *
@@ -938,12 +1108,16 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
         }
 
         // If our current encryption was not the decryption key, renew
+        if (!is_enc_key) {
+          stats_.session_ticket_renewed_.inc();
+        }
         return is_enc_key ? 1  // success; do not renew
                           : 2; // success: renew key
       }
       is_enc_key = false;
     }
 
+    stats_.session_ticket_unknown_key_.inc();
     return 0; // decryption failed
   }
 }
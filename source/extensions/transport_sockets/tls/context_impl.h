@@ -1,8 +1,8 @@
 #pragma once
 
-#include <deque>
 #include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "envoy/ssl/context.h"
@@ -11,8 +11,9 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
+#include "extensions/transport_sockets/tls/session_cache.h"
+#include "extensions/transport_sockets/tls/verification_cache.h"
 
-#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "openssl/ssl.h"
 
@@ -34,7 +35,19 @@ namespace Tls {
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
-  COUNTER(fail_verify_cert_hash)
+  COUNTER(fail_verify_cert_hash)                                                                   \
+  COUNTER(write_bytes_copied)                                                                      \
+  COUNTER(kernel_tls_tx_offload)                                                                   \
+  COUNTER(kernel_tls_rx_offload)                                                                   \
+  COUNTER(kernel_tls_fallback)                                                                     \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)                                                                      \
+  COUNTER(session_cache_eviction)                                                                  \
+  COUNTER(session_ticket_renewed)                                                                  \
+  COUNTER(session_ticket_unknown_key)                                                              \
+  COUNTER(cert_verify_cache_hit)                                                                   \
+  COUNTER(cert_verify_cache_miss)                                                                  \
+  COUNTER(cert_verify_cache_eviction)
 // clang-format on
 
 /**
@@ -73,10 +86,26 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return whether connections using this context hand record protection over to the kernel after
+   *         the handshake, where supported.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
+  /**
+   * @return the provider performing the private key operations of connections using this context,
+   *         or nullptr if they are performed by BoringSSL during the handshake.
+   */
+  const Envoy::Ssl::PrivateKeyMethodProviderSharedPtr& privateKeyMethodProvider() const {
+    return private_key_method_provider_;
+  }
+
   // Ssl::Context
   size_t daysUntilFirstCertExpires() const override;
   Envoy::Ssl::CertificateDetailsPtr getCaCertInformation() const override;
   std::vector<Envoy::Ssl::CertificateDetailsPtr> getCertChainInformation() const override;
+  std::vector<Envoy::Ssl::CertificateVerificationPtr>
+  getVerificationCacheInformation() const override;
 
 protected:
   ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
@@ -96,6 +125,9 @@ protected:
 
   int verifyCertificate(X509* cert);
 
+  // Shortens the reuse of cached verification outcomes to the next update of a loaded CRL.
+  void updateCrlNextUpdate(X509_CRL& crl);
+
   /**
    * Verifies certificate hash for pinning. The hash is a hex-encoded SHA-256 of the DER-encoded
    * certificate.
@@ -159,47 +191,89 @@ protected:
   std::string cert_chain_file_path_;
   TimeSource& time_source_;
   const unsigned tls_max_version_;
+  const bool kernel_tls_offload_;
+  const Envoy::Ssl::PrivateKeyMethodProviderSharedPtr private_key_method_provider_;
+  // Peer certificate chains that passed verifyCallback(), reused until they or the loaded CRLs
+  // expire.
+  CertificateVerificationCache verification_cache_;
+  SystemTime crl_next_update_{SystemTime::max()};
 };
 
 typedef std::shared_ptr<ContextImpl> ContextImplSharedPtr;
 
 class ClientContextImpl : public ContextImpl, public Envoy::Ssl::ClientContext {
 public:
+  /**
+   * @param session_cache supplies the cache to store sessions in, which may be shared with other
+   *        contexts with the same session cache key. If nullptr, the context has a cache of its
+   *        own. Unused if the configuration disables session resumption.
+   */
   ClientContextImpl(Stats::Scope& scope, const Envoy::Ssl::ClientContextConfig& config,
-                    TimeSource& time_source);
+                    TimeSource& time_source, ClientSessionCacheSharedPtr session_cache = nullptr);
 
   bssl::UniquePtr<SSL> newSsl(absl::optional<std::string> override_server_name) override;
 
+  /**
+   * @return const std::string& a digest of the configuration that stored sessions are tied to.
+   *         Sessions of this context can be resumed by any context with the same key.
+   */
+  const std::string& sessionCacheKey() const { return session_cache_key_; }
+
+  /**
+   * @return ClientSessionCacheSharedPtr the cache sessions are stored in, or nullptr if the
+   *         configuration disables session resumption.
+   */
+  const ClientSessionCacheSharedPtr& sessionCache() const { return session_cache_; }
+
+  /**
+   * Stores sessions exported by ClientSessionCache::exportSessions() of a cache for the same
+   * session cache key. Sessions that can't be parsed are skipped.
+   * @param sessions supplies the (server name, serialized session) pairs, each server's most
+   *        recently stored first.
+   */
+  void importSessions(const std::vector<std::pair<std::string, std::string>>& sessions);
+
+  static std::string generateSessionCacheKey(const Envoy::Ssl::ClientContextConfig& config);
+
 private:
-  int newSessionKey(SSL_SESSION* session);
+  int newSessionKey(SSL* ssl, SSL_SESSION* session);
   uint16_t parseSigningAlgorithmsForTest(const std::string& sigalgs);
 
   const std::string server_name_indication_;
   const bool allow_renegotiation_;
   const size_t max_session_keys_;
-  absl::Mutex session_keys_mu_;
-  std::deque<bssl::UniquePtr<SSL_SESSION>> session_keys_ GUARDED_BY(session_keys_mu_);
-  bool session_keys_single_use_{false};
+  const std::string session_cache_key_;
+  const ClientSessionCacheSharedPtr session_cache_;
 };
 
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
 public:
+  /**
+   * @param session_cache supplies the cache to store sessions resumable by session ID in, shared
+   *        with other contexts. If nullptr, BoringSSL's cache of the context is used.
+   */
   ServerContextImpl(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
-                    const std::vector<std::string>& server_names, TimeSource& time_source);
+                    const std::vector<std::string>& server_names, TimeSource& time_source,
+                    ServerSessionCacheSharedPtr session_cache = nullptr);
 
 private:
   int alpnSelectCallback(const unsigned char** out, unsigned char* outlen, const unsigned char* in,
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
+  int newSession(SSL_SESSION* session);
+  SSL_SESSION* getSession(const uint8_t* session_id, int session_id_len);
   bool isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   // Select the TLS certificate context in SSL_CTX_set_select_certificate_cb() callback with
   // ClientHello details.
   enum ssl_select_cert_result_t selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello);
-  void generateHashForSessionContexId(const std::vector<std::string>& server_names,
+  void generateHashForSessionContexId(const Envoy::Ssl::ServerContextConfig& config,
+                                      const std::vector<std::string>& server_names,
                                       uint8_t* session_context_buf, unsigned& session_context_len);
 
   const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  const ServerSessionCacheSharedPtr session_cache_;
+  std::string session_id_context_;
 };
 
 } // namespace Tls
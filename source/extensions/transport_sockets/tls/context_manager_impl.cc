@@ -1,5 +1,6 @@
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 
+#include <cstring>
 #include <functional>
 
 #include "envoy/stats/scope.h"
@@ -8,11 +9,56 @@
 
 #include "extensions/transport_sockets/tls/context_impl.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
+namespace {
+
+// Exported sessions are laid out as a sequence of (session cache key, session count, sessions)
+// entries, where each session is a (server name, serialized session) pair and every string is
+// prefixed with its 32 bit length. They only ever go to another process on the same host, so
+// native byte order is used.
+void appendLength(std::string& out, uint32_t length) {
+  out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+}
+
+void appendString(std::string& out, const std::string& value) {
+  appendLength(out, value.size());
+  out.append(value);
+}
+
+bool readLength(absl::string_view& in, uint32_t& length) {
+  if (in.size() < sizeof(length)) {
+    return false;
+  }
+  memcpy(&length, in.data(), sizeof(length));
+  in.remove_prefix(sizeof(length));
+  return true;
+}
+
+bool readString(absl::string_view& in, std::string& value) {
+  uint32_t length;
+  if (!readLength(in, length) || in.size() < length) {
+    return false;
+  }
+  value = std::string(in.substr(0, length));
+  in.remove_prefix(length);
+  return true;
+}
+
+} // namespace
+
+// As many sessions as BoringSSL keeps in the internal cache of a single context by default.
+const uint64_t ContextManagerImpl::MaxServerSessions = 20480;
+
+ContextManagerImpl::ContextManagerImpl(TimeSource& time_source)
+    : time_source_(time_source),
+      server_session_cache_(std::make_shared<ServerSessionCache>(MaxServerSessions)) {}
+
 ContextManagerImpl::~ContextManagerImpl() {
   removeEmptyContexts();
   ASSERT(contexts_.empty());
@@ -20,6 +66,13 @@ ContextManagerImpl::~ContextManagerImpl() {
 
 void ContextManagerImpl::removeEmptyContexts() {
   contexts_.remove_if([](const std::weak_ptr<Envoy::Ssl::Context>& n) { return n.expired(); });
+  for (auto it = client_session_caches_.begin(); it != client_session_caches_.end();) {
+    if (it->second.expired()) {
+      it = client_session_caches_.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 Envoy::Ssl::ClientContextSharedPtr
@@ -29,9 +82,19 @@ ContextManagerImpl::createSslClientContext(Stats::Scope& scope,
     return nullptr;
   }
 
-  Envoy::Ssl::ClientContextSharedPtr context =
-      std::make_shared<ClientContextImpl>(scope, config, time_source_);
   removeEmptyContexts();
+  const std::string session_cache_key = ClientContextImpl::generateSessionCacheKey(config);
+  std::weak_ptr<ClientSessionCache>& session_cache = client_session_caches_[session_cache_key];
+  std::shared_ptr<ClientContextImpl> context =
+      std::make_shared<ClientContextImpl>(scope, config, time_source_, session_cache.lock());
+  if (context->sessionCache() != nullptr && session_cache.expired()) {
+    session_cache = context->sessionCache();
+    // Imported sessions are only stored in a new cache, so that they aren't stored twice.
+    auto it = imported_client_sessions_.find(session_cache_key);
+    if (it != imported_client_sessions_.end()) {
+      context->importSessions(it->second);
+    }
+  }
   contexts_.emplace_back(context);
   return context;
 }
@@ -44,8 +107,9 @@ ContextManagerImpl::createSslServerContext(Stats::Scope& scope,
     return nullptr;
   }
 
-  Envoy::Ssl::ServerContextSharedPtr context =
-      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
+  Envoy::Ssl::ServerContextSharedPtr context = std::make_shared<ServerContextImpl>(
+      scope, config, server_names, time_source_,
+      config.sharedSessionCache() ? server_session_cache_ : nullptr);
   removeEmptyContexts();
   contexts_.emplace_back(context);
   return context;
@@ -71,6 +135,53 @@ void ContextManagerImpl::iterateContexts(std::function<void(const Envoy::Ssl::Co
   }
 }
 
+std::string ContextManagerImpl::exportClientSessions() {
+  std::string out;
+  for (const auto& entry : client_session_caches_) {
+    ClientSessionCacheSharedPtr session_cache = entry.second.lock();
+    if (session_cache == nullptr) {
+      continue;
+    }
+    const std::vector<std::pair<std::string, std::string>> sessions =
+        session_cache->exportSessions();
+    if (sessions.empty()) {
+      continue;
+    }
+    appendString(out, entry.first);
+    appendLength(out, sessions.size());
+    for (const auto& session : sessions) {
+      appendString(out, session.first);
+      appendString(out, session.second);
+    }
+  }
+  return out;
+}
+
+void ContextManagerImpl::importClientSessions(const std::string& sessions) {
+  std::unordered_map<std::string, std::vector<std::pair<std::string, std::string>>> imported;
+  absl::string_view in(sessions);
+  while (!in.empty()) {
+    std::string key;
+    uint32_t count;
+    if (!readString(in, key) || !readLength(in, count)) {
+      ENVOY_LOG(warn, "ignoring malformed imported TLS sessions");
+      return;
+    }
+    std::vector<std::pair<std::string, std::string>>& key_sessions = imported[key];
+    for (uint32_t i = 0; i < count; i++) {
+      std::string server_name;
+      std::string session;
+      if (!readString(in, server_name) || !readString(in, session)) {
+        ENVOY_LOG(warn, "ignoring malformed imported TLS sessions");
+        return;
+      }
+      key_sessions.emplace_back(std::move(server_name), std::move(session));
+    }
+  }
+  ENVOY_LOG(debug, "imported TLS sessions for {} client configurations", imported.size());
+  imported_client_sessions_ = std::move(imported);
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -2,11 +2,19 @@
 
 #include <functional>
 #include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "envoy/common/time.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/scope.h"
 
+#include "common/common/logger.h"
+
+#include "extensions/transport_sockets/tls/session_cache.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -19,9 +27,10 @@ namespace Tls {
  * be released from any thread). Context allocation/free is a very uncommon thing so we just do a
  * global lock to protect it all.
  */
-class ContextManagerImpl final : public Envoy::Ssl::ContextManager {
+class ContextManagerImpl final : public Envoy::Ssl::ContextManager,
+                                 Logger::Loggable<Logger::Id::connection> {
 public:
-  ContextManagerImpl(TimeSource& time_source) : time_source_(time_source) {}
+  ContextManagerImpl(TimeSource& time_source);
   ~ContextManagerImpl();
 
   // Ssl::ContextManager
@@ -33,11 +42,27 @@ public:
                          const std::vector<std::string>& server_names) override;
   size_t daysUntilFirstCertExpires() const override;
   void iterateContexts(std::function<void(const Envoy::Ssl::Context&)> callback) override;
+  std::string exportClientSessions() override;
+  void importClientSessions(const std::string& sessions) override;
+
+  /**
+   * The largest number of sessions kept in the server session cache shared by all server contexts.
+   */
+  static const uint64_t MaxServerSessions;
 
 private:
   void removeEmptyContexts();
   TimeSource& time_source_;
   std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
+  const ServerSessionCacheSharedPtr server_session_cache_;
+  // The session caches of live client contexts, by session cache key. A context created with the
+  // key of a live context, e.g. when a cluster is updated, shares its sessions.
+  std::unordered_map<std::string, std::weak_ptr<ClientSessionCache>> client_session_caches_;
+  // Sessions handed over by another process, by session cache key, as (server name, session)
+  // pairs. They are kept for the life of the manager, since the first context created with a key
+  // may be replaced before connecting.
+  std::unordered_map<std::string, std::vector<std::pair<std::string, std::string>>>
+      imported_client_sessions_;
 };
 
 } // namespace Tls
@@ -0,0 +1,231 @@
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "openssl/err.h"
+#include "openssl/mem.h"
+#include "openssl/nid.h"
+
+// The kernel headers of older distributions predate kTLS, in which case connections are never
+// offloaded.
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/tls.h>)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#define ENVOY_KERNEL_TLS
+#endif
+#endif
+
+#ifdef ENVOY_KERNEL_TLS
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+namespace {
+
+#ifdef ENVOY_KERNEL_TLS
+// The size of the implicit part of the AES-GCM nonce, which TLS 1.2 derives with the keys.
+constexpr size_t SaltSize = 4;
+
+template <class CryptoInfo>
+bool setCryptoInfo(int fd, int direction, uint16_t cipher_type, const uint8_t* key,
+                   const uint8_t* salt, uint64_t sequence) {
+  CryptoInfo info{};
+  info.info.version = TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key, sizeof(info.key));
+  static_assert(sizeof(info.salt) == SaltSize, "unexpected salt size");
+  memcpy(info.salt, salt, sizeof(info.salt));
+  // The record sequence number is big endian. BoringSSL uses it as the explicit part of the nonce
+  // too, and so does the kernel once it is handed the current one.
+  static_assert(sizeof(info.rec_seq) == sizeof(sequence) && sizeof(info.iv) == sizeof(sequence),
+                "unexpected sequence number size");
+  for (size_t i = 0; i < sizeof(sequence); i++) {
+    info.rec_seq[i] = info.iv[i] = static_cast<uint8_t>(sequence >> (8 * (7 - i)));
+  }
+  const bool ok = ::setsockopt(fd, SOL_TLS, direction, &info, sizeof(info)) == 0;
+  OPENSSL_cleanse(&info, sizeof(info));
+  return ok;
+}
+
+bool setCryptoInfo(int fd, int direction, size_t key_size, const uint8_t* key,
+                   const uint8_t* salt, uint64_t sequence) {
+  if (key_size == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_128>(fd, direction, TLS_CIPHER_AES_GCM_128, key,
+                                                        salt, sequence);
+  }
+#ifdef TLS_CIPHER_AES_GCM_256
+  if (key_size == TLS_CIPHER_AES_GCM_256_KEY_SIZE) {
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_256>(fd, direction, TLS_CIPHER_AES_GCM_256, key,
+                                                        salt, sequence);
+  }
+#endif
+  return false;
+}
+#endif
+
+} // namespace
+
+Offload enable(SSL* ssl, int fd) {
+  Offload offload;
+#ifdef ENVOY_KERNEL_TLS
+  // Data BoringSSL has already read from the socket can't be handed to the kernel.
+  if (SSL_version(ssl) != TLS1_2_VERSION || SSL_has_pending(ssl)) {
+    return offload;
+  }
+  size_t key_size;
+  switch (SSL_CIPHER_get_cipher_nid(SSL_get_current_cipher(ssl))) {
+  case NID_aes_128_gcm:
+    key_size = 16;
+    break;
+  case NID_aes_256_gcm:
+    key_size = 32;
+    break;
+  default:
+    return offload;
+  }
+
+  // For AEAD cipher suites the key block is made of the client and server write keys followed by
+  // their salts, with no MAC keys.
+  std::vector<uint8_t> key_block(SSL_get_key_block_len(ssl));
+  if (key_block.size() != 2 * (key_size + SaltSize) ||
+      !SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    ERR_clear_error();
+    return offload;
+  }
+  const uint8_t* client_key = key_block.data();
+  const uint8_t* server_key = client_key + key_size;
+  const uint8_t* client_salt = server_key + key_size;
+  const uint8_t* server_salt = client_salt + SaltSize;
+  const bool is_server = SSL_is_server(ssl);
+
+  if (::setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0) {
+    offload.tx_ = setCryptoInfo(fd, TLS_TX, key_size, is_server ? server_key : client_key,
+                                is_server ? server_salt : client_salt,
+                                SSL_get_write_sequence(ssl));
+#ifdef TLS_RX
+    offload.rx_ = setCryptoInfo(fd, TLS_RX, key_size, is_server ? client_key : server_key,
+                                is_server ? client_salt : server_salt, SSL_get_read_sequence(ssl));
+#endif
+  }
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+#else
+  UNREFERENCED_PARAMETER(ssl);
+  UNREFERENCED_PARAMETER(fd);
+#endif
+  return offload;
+}
+
+Api::SysCallIntResult read(Buffer::Instance& buffer, int fd, uint64_t max_length) {
+#if defined(ENVOY_KERNEL_TLS) && defined(TLS_RX)
+  constexpr uint64_t MaxSlices = 2;
+  Buffer::RawSlice slices[MaxSlices];
+  const uint64_t num_slices = buffer.reserve(max_length, slices, MaxSlices);
+  iovec iov[MaxSlices];
+  uint64_t num_bytes_to_read = 0;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(max_length - num_bytes_to_read));
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+    num_bytes_to_read += slices[i].len_;
+  }
+
+  // The kernel reports the type of records other than application data in a control message, and
+  // never returns data from records of different types in a single call.
+  uint8_t control[CMSG_SPACE(sizeof(uint8_t))];
+  msghdr msg{};
+  msg.msg_iov = iov;
+  msg.msg_iovlen = num_slices;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  const ssize_t rc = ::recvmsg(fd, &msg, 0);
+  if (rc < 0) {
+    return {-1, errno};
+  }
+
+  const cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg != nullptr && cmsg->cmsg_level == SOL_TLS && cmsg->cmsg_type == TLS_GET_RECORD_TYPE &&
+      *CMSG_DATA(cmsg) != SSL3_RT_APPLICATION_DATA) {
+    // TLS 1.2 has no post handshake messages, and renegotiation isn't supported, so an alert is
+    // the only other record expected. The data isn't committed, so it is read from the slices.
+    uint8_t alert[2];
+    if (*CMSG_DATA(cmsg) == SSL3_RT_ALERT && rc == sizeof(alert)) {
+      for (size_t i = 0, copied = 0; copied < sizeof(alert); i++) {
+        const size_t length = std::min(slices[i].len_, sizeof(alert) - copied);
+        memcpy(alert + copied, slices[i].mem_, length);
+        copied += length;
+      }
+      if (alert[1] == SSL_AD_CLOSE_NOTIFY) {
+        return {0, 0};
+      }
+    }
+    return {-1, EPROTO};
+  }
+
+  uint64_t bytes_to_commit = rc;
+  uint64_t num_slices_to_commit = 0;
+  while (bytes_to_commit != 0) {
+    slices[num_slices_to_commit].len_ =
+        std::min(slices[num_slices_to_commit].len_, static_cast<size_t>(bytes_to_commit));
+    bytes_to_commit -= slices[num_slices_to_commit].len_;
+    num_slices_to_commit++;
+  }
+  buffer.commit(slices, num_slices_to_commit);
+  return {static_cast<int>(rc), 0};
+#else
+  UNREFERENCED_PARAMETER(buffer);
+  UNREFERENCED_PARAMETER(fd);
+  UNREFERENCED_PARAMETER(max_length);
+  NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
+}
+
+Api::SysCallIntResult sendCloseNotify(int fd) {
+#ifdef ENVOY_KERNEL_TLS
+  uint8_t alert[2] = {SSL3_AL_WARNING, SSL_AD_CLOSE_NOTIFY};
+  iovec iov;
+  iov.iov_base = alert;
+  iov.iov_len = sizeof(alert);
+  uint8_t control[CMSG_SPACE(sizeof(uint8_t))] = {};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = SSL3_RT_ALERT;
+  const ssize_t rc = ::sendmsg(fd, &msg, 0);
+  return {static_cast<int>(rc), rc < 0 ? errno : 0};
+#else
+  UNREFERENCED_PARAMETER(fd);
+  NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
+}
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
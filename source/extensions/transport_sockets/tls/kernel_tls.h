@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/buffer/buffer.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+/**
+ * The directions of a connection whose record protection was handed over to the kernel.
+ */
+struct Offload {
+  bool tx_{};
+  bool rx_{};
+};
+
+/**
+ * Hands the record protection of an established connection over to the kernel (Linux kTLS). Only
+ * TLS 1.2 connections using an AES-GCM cipher suite can be offloaded, as BoringSSL doesn't expose
+ * the traffic keys of TLS 1.3 connections. Each direction is offloaded if the kernel supports it.
+ * A direction that isn't offloaded is left to BoringSSL, whose state is unaffected by this call.
+ * @param ssl supplies the connection, which must have completed its handshake.
+ * @param fd supplies the socket of the connection.
+ * @return Offload the directions that were offloaded.
+ */
+Offload enable(SSL* ssl, int fd);
+
+/**
+ * Reads application data from a socket whose receive direction was offloaded.
+ * @param buffer supplies the buffer to read into.
+ * @param fd supplies the socket to read from.
+ * @param max_length supplies the maximum number of bytes to read.
+ * @return Api::SysCallIntResult the number of bytes read, 0 if the peer sent a close_notify alert
+ *         or closed the socket, or -1 with EPROTO if the peer sent any other non application data
+ *         record.
+ */
+Api::SysCallIntResult read(Buffer::Instance& buffer, int fd, uint64_t max_length);
+
+/**
+ * Sends a close_notify alert on a socket whose transmit direction was offloaded.
+ * @param fd supplies the socket to send the alert on.
+ * @return Api::SysCallIntResult the result of sending the alert.
+ */
+Api::SysCallIntResult sendCloseNotify(int fd);
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,157 @@
+#include "extensions/transport_sockets/tls/session_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "common/common/assert.h"
+
+#include "openssl/mem.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+constexpr size_t ServerSessionCache::NumShards;
+
+ServerSessionCache::ServerSessionCache(uint64_t max_sessions)
+    : max_sessions_per_shard_(std::max<uint64_t>(1, max_sessions / NumShards)) {}
+
+std::string ServerSessionCache::key(absl::string_view id_context, absl::string_view session_id) {
+  // Session ID contexts all have the same length, so this can't be ambiguous.
+  std::string key(id_context);
+  key.append(session_id.data(), session_id.size());
+  return key;
+}
+
+ServerSessionCache::Shard& ServerSessionCache::shard(const std::string& key) {
+  return shards_[std::hash<std::string>()(key) % NumShards];
+}
+
+uint64_t ServerSessionCache::insert(absl::string_view id_context,
+                                    bssl::UniquePtr<SSL_SESSION> session) {
+  unsigned session_id_length;
+  const uint8_t* session_id = SSL_SESSION_get_id(session.get(), &session_id_length);
+  std::string session_key =
+      key(id_context,
+          absl::string_view(reinterpret_cast<const char*>(session_id), session_id_length));
+  Shard& session_shard = shard(session_key);
+
+  uint64_t evicted = 0;
+  absl::MutexLock lock(&session_shard.mutex_);
+  auto it = session_shard.index_.find(session_key);
+  if (it != session_shard.index_.end()) {
+    session_shard.sessions_.erase(it->second);
+    session_shard.index_.erase(it);
+  }
+  while (session_shard.sessions_.size() >= max_sessions_per_shard_) {
+    session_shard.index_.erase(session_shard.sessions_.back().first);
+    session_shard.sessions_.pop_back();
+    evicted++;
+  }
+  session_shard.sessions_.emplace_front(session_key, std::move(session));
+  session_shard.index_.emplace(std::move(session_key), session_shard.sessions_.begin());
+  return evicted;
+}
+
+bssl::UniquePtr<SSL_SESSION> ServerSessionCache::lookup(absl::string_view id_context,
+                                                        absl::string_view session_id) {
+  const std::string session_key = key(id_context, session_id);
+  Shard& session_shard = shard(session_key);
+
+  absl::MutexLock lock(&session_shard.mutex_);
+  auto it = session_shard.index_.find(session_key);
+  if (it == session_shard.index_.end()) {
+    return nullptr;
+  }
+  session_shard.sessions_.splice(session_shard.sessions_.begin(), session_shard.sessions_,
+                                 it->second);
+  SSL_SESSION* session = it->second->second.get();
+  SSL_SESSION_up_ref(session);
+  return bssl::UniquePtr<SSL_SESSION>(session);
+}
+
+uint64_t ServerSessionCache::size() {
+  uint64_t size = 0;
+  for (Shard& session_shard : shards_) {
+    absl::MutexLock lock(&session_shard.mutex_);
+    size += session_shard.sessions_.size();
+  }
+  return size;
+}
+
+ClientSessionCache::ClientSessionCache(uint64_t max_sessions_per_server)
+    : max_sessions_per_server_(max_sessions_per_server) {
+  ASSERT(max_sessions_per_server_ > 0);
+}
+
+uint64_t ClientSessionCache::insert(const std::string& server_name,
+                                    bssl::UniquePtr<SSL_SESSION> session) {
+  // Once a single-use session is stored, lookups have to take the lock exclusively.
+  if (SSL_SESSION_should_be_single_use(session.get())) {
+    single_use_ = true;
+  }
+  uint64_t evicted = 0;
+  absl::WriterMutexLock lock(&mutex_);
+  std::deque<bssl::UniquePtr<SSL_SESSION>>& server_sessions = sessions_[server_name];
+  while (server_sessions.size() >= max_sessions_per_server_) {
+    server_sessions.pop_back();
+    evicted++;
+  }
+  server_sessions.push_front(std::move(session));
+  return evicted;
+}
+
+bssl::UniquePtr<SSL_SESSION> ClientSessionCache::lookup(const std::string& server_name) {
+  SSL_SESSION* session = nullptr;
+  if (single_use_) {
+    absl::WriterMutexLock lock(&mutex_);
+    auto it = sessions_.find(server_name);
+    if (it == sessions_.end()) {
+      return nullptr;
+    }
+    // Use the most recently stored session, since it has the highest probability of still being
+    // recognized/accepted by the server.
+    if (SSL_SESSION_should_be_single_use(it->second.front().get())) {
+      session = it->second.front().release();
+      it->second.pop_front();
+      if (it->second.empty()) {
+        sessions_.erase(it);
+      }
+      return bssl::UniquePtr<SSL_SESSION>(session);
+    }
+    session = it->second.front().get();
+    SSL_SESSION_up_ref(session);
+  } else {
+    absl::ReaderMutexLock lock(&mutex_);
+    auto it = sessions_.find(server_name);
+    if (it == sessions_.end()) {
+      return nullptr;
+    }
+    session = it->second.front().get();
+    SSL_SESSION_up_ref(session);
+  }
+  return bssl::UniquePtr<SSL_SESSION>(session);
+}
+
+std::vector<std::pair<std::string, std::string>> ClientSessionCache::exportSessions() {
+  std::vector<std::pair<std::string, std::string>> sessions;
+  absl::ReaderMutexLock lock(&mutex_);
+  for (const auto& server_sessions : sessions_) {
+    for (const auto& session : server_sessions.second) {
+      uint8_t* data;
+      size_t len;
+      if (SSL_SESSION_to_bytes(session.get(), &data, &len)) {
+        sessions.emplace_back(server_sessions.first,
+                              std::string(reinterpret_cast<const char*>(data), len));
+        OPENSSL_free(data);
+      }
+    }
+  }
+  return sessions;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
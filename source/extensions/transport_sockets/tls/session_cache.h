@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/common/thread_annotations.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A bounded cache of server sessions resumable by session ID, shared by all the server contexts of
+ * a context manager and therefore by all workers. Sessions are keyed by their session ID context,
+ * so a session is only resumed by a context for the same server names and client validation
+ * settings. The cache is split into shards with their own lock and least recently used order, so
+ * that handshakes on different workers rarely contend.
+ */
+class ServerSessionCache {
+public:
+  /**
+   * @param max_sessions supplies the largest number of sessions kept across all shards.
+   */
+  explicit ServerSessionCache(uint64_t max_sessions);
+
+  /**
+   * Stores a session, evicting the least recently used sessions of its shard if it is full.
+   * @param id_context supplies the session ID context of the context that established the session.
+   * @param session supplies the session.
+   * @return uint64_t the number of sessions evicted.
+   */
+  uint64_t insert(absl::string_view id_context, bssl::UniquePtr<SSL_SESSION> session);
+
+  /**
+   * @param id_context supplies the session ID context of the context resuming the session.
+   * @param session_id supplies the session ID offered by the client.
+   * @return bssl::UniquePtr<SSL_SESSION> a new reference to the session, or nullptr if there is
+   *         none.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::string_view id_context, absl::string_view session_id);
+
+  /**
+   * @return uint64_t the number of stored sessions.
+   */
+  uint64_t size();
+
+  static constexpr size_t NumShards = 16;
+
+private:
+  struct Shard {
+    absl::Mutex mutex_;
+    // Most recently used first.
+    std::list<std::pair<std::string, bssl::UniquePtr<SSL_SESSION>>> sessions_ GUARDED_BY(mutex_);
+    std::unordered_map<std::string, decltype(sessions_)::iterator> index_ GUARDED_BY(mutex_);
+  };
+
+  static std::string key(absl::string_view id_context, absl::string_view session_id);
+  Shard& shard(const std::string& key);
+
+  const uint64_t max_sessions_per_shard_;
+  std::array<Shard, NumShards> shards_;
+};
+
+typedef std::shared_ptr<ServerSessionCache> ServerSessionCacheSharedPtr;
+
+/**
+ * The sessions of client contexts with the same session cache key, kept by the server name they
+ * were established with. A context manager hands the same cache to every context created with the
+ * key, so sessions outlive a context that is replaced, e.g. when a cluster is updated.
+ */
+class ClientSessionCache {
+public:
+  /**
+   * @param max_sessions_per_server supplies the largest number of sessions kept for each server
+   *        name.
+   */
+  explicit ClientSessionCache(uint64_t max_sessions_per_server);
+
+  /**
+   * Stores a session as the first to offer to its server, evicting the oldest session of the
+   * server if it has too many.
+   * @param server_name supplies the server name the session was established with.
+   * @param session supplies the session.
+   * @return uint64_t the number of sessions evicted.
+   */
+  uint64_t insert(const std::string& server_name, bssl::UniquePtr<SSL_SESSION> session);
+
+  /**
+   * Finds the most recently stored session of a server. A session that must only be used once
+   * (TLS 1.3) is removed from the cache.
+   * @param server_name supplies the server name to connect with.
+   * @return bssl::UniquePtr<SSL_SESSION> a new reference to the session, or nullptr if there is
+   *         none.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(const std::string& server_name);
+
+  /**
+   * @return std::vector<std::pair<std::string, std::string>> the stored sessions as (server name,
+   *         serialized session) pairs, each server's most recently stored first.
+   */
+  std::vector<std::pair<std::string, std::string>> exportSessions();
+
+private:
+  const uint64_t max_sessions_per_server_;
+  absl::Mutex mutex_;
+  // Most recently stored first.
+  std::unordered_map<std::string, std::deque<bssl::UniquePtr<SSL_SESSION>>>
+      sessions_ GUARDED_BY(mutex_);
+  // Whether a single-use session was ever stored. Until then, lookups share the lock.
+  std::atomic<bool> single_use_{false};
+};
+
+typedef std::shared_ptr<ClientSessionCache> ClientSessionCacheSharedPtr;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
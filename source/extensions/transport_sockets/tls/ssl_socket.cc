@@ -7,6 +7,7 @@
 #include "common/common/hex.h"
 #include "common/http/headers.h"
 
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/strings/str_replace.h"
@@ -36,6 +37,14 @@ public:
   void onConnected() override {}
   const Ssl::Connection* ssl() const override { return nullptr; }
 };
+
+// The largest amount of data SSL_write() seals into a single record.
+constexpr uint64_t MaxRecordSize = 16384;
+
+// Records are sealed straight from the first slice of the write buffer when it holds at least this
+// much data. Smaller slices are coalesced with linearize() first, as sealing them one by one would
+// waste both record overhead and write() calls.
+constexpr uint64_t MinInPlaceWriteSize = 4096;
 } // namespace
 
 SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
@@ -52,12 +61,19 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
   }
 }
 
+SslSocket::~SslSocket() { unregisterPrivateKeyMethod(); }
+
 void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& callbacks) {
   ASSERT(!callbacks_);
   callbacks_ = &callbacks;
 
   BIO* bio = BIO_new_socket(callbacks_->ioHandle().fd(), 0);
   SSL_set_bio(ssl_.get(), bio, bio);
+
+  if (ctx_->privateKeyMethodProvider() != nullptr) {
+    ctx_->privateKeyMethodProvider()->registerPrivateKeyMethod(
+        ssl_.get(), *this, callbacks_->connection().dispatcher());
+  }
 }
 
 Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
@@ -70,6 +86,10 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
     }
   }
 
+  if (kernel_tls_rx_) {
+    return doKernelTlsRead(read_buffer);
+  }
+
   bool keep_reading = true;
   bool end_stream = false;
   PostIoAction action = PostIoAction::KeepOpen;
@@ -127,6 +147,9 @@ PostIoAction SslSocket::doHandshake() {
     ENVOY_CONN_LOG(debug, "handshake complete", callbacks_->connection());
     handshake_complete_ = true;
     ctx_->logHandshake(ssl_.get());
+    if (ctx_->kernelTlsOffload()) {
+      enableKernelTls();
+    }
     callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 
     // It's possible that we closed during the handshake callback.
@@ -139,6 +162,8 @@ PostIoAction SslSocket::doHandshake() {
     switch (err) {
     case SSL_ERROR_WANT_READ:
     case SSL_ERROR_WANT_WRITE:
+    // The handshake resumes from onPrivateKeyMethodComplete().
+    case SSL_ERROR_WANT_PRIVATE_KEY_OPERATION:
       return PostIoAction::KeepOpen;
     default:
       drainErrorQueue();
@@ -147,6 +172,93 @@ PostIoAction SslSocket::doHandshake() {
   }
 }
 
+void SslSocket::onPrivateKeyMethodComplete() {
+  // The result may have been collected already by a handshake driven by a socket event.
+  if (handshake_complete_ || callbacks_->connection().state() != Network::Connection::State::Open) {
+    return;
+  }
+  if (doHandshake() == PostIoAction::Close) {
+    callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
+  } else if (handshake_complete_) {
+    // Socket events that arrived while the handshake was suspended were consumed without making
+    // progress, so data that is already waiting in either direction is handled now.
+    callbacks_->setReadBufferReady();
+    callbacks_->flushWriteBuffer();
+  }
+}
+
+void SslSocket::enableKernelTls() {
+  const KernelTls::Offload offload = KernelTls::enable(ssl_.get(), callbacks_->ioHandle().fd());
+  kernel_tls_tx_ = offload.tx_;
+  kernel_tls_rx_ = offload.rx_;
+  ENVOY_CONN_LOG(debug, "kernel TLS offload: tx={} rx={}", callbacks_->connection(), kernel_tls_tx_,
+                 kernel_tls_rx_);
+  if (kernel_tls_tx_) {
+    ctx_->stats().kernel_tls_tx_offload_.inc();
+  }
+  if (kernel_tls_rx_) {
+    ctx_->stats().kernel_tls_rx_offload_.inc();
+  }
+  if (!kernel_tls_tx_ && !kernel_tls_rx_) {
+    ctx_->stats().kernel_tls_fallback_.inc();
+  }
+}
+
+Network::IoResult SslSocket::doKernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  do {
+    Api::SysCallIntResult result = KernelTls::read(read_buffer, callbacks_->ioHandle().fd(), 16384);
+    ENVOY_CONN_LOG(trace, "kernel TLS read returns: {}", callbacks_->connection(), result.rc_);
+
+    if (result.rc_ == 0) {
+      // Remote close, either with a close_notify alert or without one.
+      end_stream = true;
+      break;
+    } else if (result.rc_ == -1) {
+      // Remote error (might be no data).
+      ENVOY_CONN_LOG(trace, "kernel TLS read error: {}", callbacks_->connection(), result.errno_);
+      if (result.errno_ != EAGAIN) {
+        ctx_->stats().connection_error_.inc();
+        action = PostIoAction::Close;
+      }
+      break;
+    } else {
+      bytes_read += result.rc_;
+      if (callbacks_->shouldDrainReadBuffer()) {
+        callbacks_->setReadBufferReady();
+        break;
+      }
+    }
+  } while (true);
+
+  return {action, bytes_read, end_stream};
+}
+
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    // The kernel seals the data into records as it is written, straight from the buffer slices.
+    Api::SysCallIntResult result = write_buffer.write(callbacks_->ioHandle().fd());
+    ENVOY_CONN_LOG(trace, "kernel TLS write returns: {}", callbacks_->connection(), result.rc_);
+    if (result.rc_ == -1) {
+      ENVOY_CONN_LOG(trace, "kernel TLS write error: {}", callbacks_->connection(), result.errno_);
+      if (result.errno_ == EAGAIN) {
+        return {PostIoAction::KeepOpen, total_bytes_written, false};
+      }
+      ctx_->stats().connection_error_.inc();
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+    total_bytes_written += result.rc_;
+  }
+
+  if (end_stream) {
+    shutdownSsl();
+  }
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
 void SslSocket::drainErrorQueue() {
   bool saw_error = false;
   bool saw_counted_error = false;
@@ -179,12 +291,16 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_tx_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = nextWriteSize(write_buffer);
   }
 
   uint64_t total_bytes_written = 0;
@@ -194,15 +310,15 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
 
     // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
     // it again with the same parameters. This is done by tracking last write size, but not write
-    // data, since linearize() will return the same undrained data anyway.
+    // data, since writeData() will return the same undrained data anyway.
     ASSERT(bytes_to_write <= write_buffer.length());
-    int rc = SSL_write(ssl_.get(), write_buffer.linearize(bytes_to_write), bytes_to_write);
+    int rc = SSL_write(ssl_.get(), writeData(write_buffer, bytes_to_write), bytes_to_write);
     ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
     if (rc > 0) {
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      bytes_to_write = nextWriteSize(write_buffer);
     } else {
       int err = SSL_get_error(ssl_.get(), rc);
       switch (err) {
@@ -227,18 +343,55 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+uint64_t SslSocket::nextWriteSize(const Buffer::Instance& write_buffer) const {
+  const uint64_t max_size = std::min(write_buffer.length(), MaxRecordSize);
+  Buffer::RawSlice slice;
+  if (write_buffer.getRawSlices(&slice, 1) == 0) {
+    return 0;
+  }
+  // Stop the record at the end of the first slice if it can be sealed in place. Splitting the
+  // data into more records costs less than copying it.
+  if (slice.len_ >= std::min(max_size, MinInPlaceWriteSize)) {
+    return std::min(max_size, slice.len_);
+  }
+  return max_size;
+}
+
+const void* SslSocket::writeData(Buffer::Instance& write_buffer, uint64_t size) {
+  Buffer::RawSlice slice;
+  write_buffer.getRawSlices(&slice, 1);
+  if (slice.len_ >= size) {
+    return slice.mem_;
+  }
+  ctx_->stats().write_bytes_copied_.add(size);
+  return write_buffer.linearize(size);
+}
+
 void SslSocket::onConnected() { ASSERT(!handshake_complete_); }
 
 void SslSocket::shutdownSsl() {
   ASSERT(handshake_complete_);
   if (!shutdown_sent_ && callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(ssl_.get());
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
-    drainErrorQueue();
+    if (kernel_tls_tx_) {
+      // BoringSSL no longer holds the write keys, so the alert is sealed by the kernel. As with
+      // SSL_shutdown(), a failure to send it is ignored.
+      const Api::SysCallIntResult result = KernelTls::sendCloseNotify(callbacks_->ioHandle().fd());
+      ENVOY_CONN_LOG(debug, "kernel TLS shutdown: rc={}", callbacks_->connection(), result.rc_);
+    } else {
+      int rc = SSL_shutdown(ssl_.get());
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
+      drainErrorQueue();
+    }
     shutdown_sent_ = true;
   }
 }
 
+void SslSocket::unregisterPrivateKeyMethod() {
+  if (ctx_->privateKeyMethodProvider() != nullptr) {
+    ctx_->privateKeyMethodProvider()->unregisterPrivateKeyMethod(ssl_.get());
+  }
+}
+
 bool SslSocket::peerCertificatePresented() const {
   bssl::UniquePtr<X509> cert(SSL_get_peer_certificate(ssl_.get()));
   return cert != nullptr;
@@ -322,6 +475,9 @@ std::vector<std::string> SslSocket::dnsSansPeerCertificate() const {
 }
 
 void SslSocket::closeSocket(Network::ConnectionEvent) {
+  // A private key operation that is still running must not resume the handshake.
+  unregisterPrivateKeyMethod();
+
   // Attempt to send a shutdown before closing the socket. It's possible this won't go out if
   // there is no room on the socket. We can extend the state machine to handle this at some point
   // if needed.
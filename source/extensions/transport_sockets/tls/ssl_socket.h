@@ -41,10 +41,12 @@ enum class InitialState { Client, Server };
 
 class SslSocket : public Network::TransportSocket,
                   public Envoy::Ssl::Connection,
+                  public Envoy::Ssl::PrivateKeyConnectionCallbacks,
                   protected Logger::Loggable<Logger::Id::connection> {
 public:
   SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
             Network::TransportSocketOptionsSharedPtr transport_socket_options);
+  ~SslSocket();
 
   // Ssl::Connection
   bool peerCertificatePresented() const override;
@@ -70,12 +72,30 @@ public:
   void onConnected() override;
   const Ssl::Connection* ssl() const override { return this; }
 
+  // Ssl::PrivateKeyConnectionCallbacks
+  void onPrivateKeyMethodComplete() override;
+
   SSL* rawSslForTest() const { return ssl_.get(); }
 
 private:
   Network::PostIoAction doHandshake();
+  void enableKernelTls();
+  Network::IoResult doKernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
   void drainErrorQueue();
+  /**
+   * @return uint64_t the number of bytes to seal into the next record, which is never more than
+   *         fits in a record and stops at the end of the first slice of the buffer if that slice is
+   *         large enough to be written in place.
+   */
+  uint64_t nextWriteSize(const Buffer::Instance& write_buffer) const;
+  /**
+   * @return const void* a pointer to the first size bytes of the buffer, which are only copied
+   *         into a contiguous region if they span multiple slices.
+   */
+  const void* writeData(Buffer::Instance& write_buffer, uint64_t size);
   void shutdownSsl();
+  void unregisterPrivateKeyMethod();
 
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImplSharedPtr ctx_;
@@ -83,6 +103,10 @@ private:
   bool handshake_complete_{};
   bool shutdown_sent_{};
   uint64_t bytes_to_retry_{};
+  // Whether record protection in each direction was handed over to the kernel, in which case
+  // plaintext is written to or read from the socket directly.
+  bool kernel_tls_tx_{};
+  bool kernel_tls_rx_{};
   mutable std::string cached_sha_256_peer_certificate_digest_;
   mutable std::string cached_url_encoded_pem_encoded_peer_certificate_;
 };
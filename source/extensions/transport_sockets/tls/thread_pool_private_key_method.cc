@@ -0,0 +1,263 @@
+#include "extensions/transport_sockets/tls/thread_pool_private_key_method.h"
+
+#include <string.h>
+
+#include <unordered_map>
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+
+#include "openssl/digest.h"
+#include "openssl/err.h"
+#include "openssl/evp.h"
+#include "openssl/rsa.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+ThreadPoolPrivateKeyMethodProvider::ThreadPoolPrivateKeyMethodProvider(
+    Thread::ThreadFactory& thread_factory, uint32_t threads, uint32_t max_batch_size)
+    : max_batch_size_(max_batch_size) {
+  ASSERT(threads > 0 && max_batch_size > 0);
+  method_.sign = sign;
+  method_.decrypt = decrypt;
+  method_.complete = complete;
+  for (uint32_t i = 0; i < threads; i++) {
+    threads_.emplace_back(thread_factory.createThread([this]() -> void { threadRoutine(); }));
+  }
+}
+
+ThreadPoolPrivateKeyMethodProvider::~ThreadPoolPrivateKeyMethodProvider() {
+  {
+    Thread::LockGuard lock(mutex_);
+    shutdown_ = true;
+  }
+  queue_event_.notifyAll();
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+void ThreadPoolPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  ASSERT(connectionState(ssl) == nullptr);
+  auto state = std::make_unique<ConnectionState>(*this, cb, dispatcher);
+  const int rc = SSL_set_ex_data(ssl, connectionStateIndex(), state.get());
+  RELEASE_ASSERT(rc == 1, "");
+  state.release();
+}
+
+void ThreadPoolPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  std::unique_ptr<ConnectionState> state(connectionState(ssl));
+  if (state == nullptr) {
+    return;
+  }
+  SSL_set_ex_data(ssl, connectionStateIndex(), nullptr);
+  if (state->operation_ != nullptr) {
+    // A thread of the pool may be about to post the result of the operation, so the callbacks
+    // are cleared with the mutex held. No post for the connection happens after this.
+    Thread::LockGuard lock(mutex_);
+    state->operation_->callbacks_ = nullptr;
+  }
+}
+
+int ThreadPoolPrivateKeyMethodProvider::connectionStateIndex() {
+  static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+  RELEASE_ASSERT(index >= 0, "");
+  return index;
+}
+
+ThreadPoolPrivateKeyMethodProvider::ConnectionState*
+ThreadPoolPrivateKeyMethodProvider::connectionState(SSL* ssl) {
+  return static_cast<ConnectionState*>(SSL_get_ex_data(ssl, connectionStateIndex()));
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyMethodProvider::sign(SSL* ssl, uint8_t*, size_t*,
+                                                                  size_t,
+                                                                  uint16_t signature_algorithm,
+                                                                  const uint8_t* in,
+                                                                  size_t in_len) {
+  return start(ssl, false, signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyMethodProvider::decrypt(SSL* ssl, uint8_t*, size_t*,
+                                                                     size_t, const uint8_t* in,
+                                                                     size_t in_len) {
+  return start(ssl, true, 0, in, in_len);
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyMethodProvider::start(SSL* ssl, bool decrypt,
+                                                                   uint16_t signature_algorithm,
+                                                                   const uint8_t* in,
+                                                                   size_t in_len) {
+  ConnectionState* state = connectionState(ssl);
+  EVP_PKEY* key = SSL_get_privatekey(ssl);
+  if (state == nullptr || state->operation_ != nullptr || key == nullptr) {
+    return ssl_private_key_failure;
+  }
+
+  auto operation = std::make_shared<Operation>(state->dispatcher_, state->callbacks_);
+  EVP_PKEY_up_ref(key);
+  operation->key_.reset(key);
+  operation->decrypt_ = decrypt;
+  operation->signature_algorithm_ = signature_algorithm;
+  operation->input_.assign(in, in + in_len);
+  state->operation_ = operation;
+  state->parent_.queue(operation);
+  return ssl_private_key_retry;
+}
+
+ssl_private_key_result_t ThreadPoolPrivateKeyMethodProvider::complete(SSL* ssl, uint8_t* out,
+                                                                      size_t* out_len,
+                                                                      size_t max_out) {
+  ConnectionState* state = connectionState(ssl);
+  if (state == nullptr || state->operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  {
+    // The handshake can be driven by socket events before the result is posted.
+    Thread::LockGuard lock(state->parent_.mutex_);
+    if (!state->operation_->done_) {
+      return ssl_private_key_retry;
+    }
+    // The result is collected now, and the connection may be gone by the time the completion
+    // posted for it runs.
+    state->operation_->callbacks_ = nullptr;
+  }
+
+  const OperationSharedPtr operation = std::move(state->operation_);
+  if (!operation->success_ || operation->output_.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  memcpy(out, operation->output_.data(), operation->output_.size());
+  *out_len = operation->output_.size();
+  return ssl_private_key_success;
+}
+
+void ThreadPoolPrivateKeyMethodProvider::run(Operation& operation) {
+  EVP_PKEY* key = operation.key_.get();
+  std::vector<uint8_t>& output = operation.output_;
+  size_t length;
+  if (operation.decrypt_) {
+    // Decryption is only used for RSA key exchange, where BoringSSL removes the padding itself.
+    RSA* rsa = EVP_PKEY_get0_RSA(key);
+    if (rsa != nullptr) {
+      output.resize(RSA_size(rsa));
+      operation.success_ = RSA_decrypt(rsa, &length, output.data(), output.size(),
+                                       operation.input_.data(), operation.input_.size(),
+                                       RSA_NO_PADDING);
+    }
+  } else {
+    const uint16_t signature_algorithm = operation.signature_algorithm_;
+    bssl::ScopedEVP_MD_CTX ctx;
+    EVP_PKEY_CTX* pctx;
+    operation.success_ =
+        SSL_get_signature_algorithm_key_type(signature_algorithm) == EVP_PKEY_id(key) &&
+        EVP_DigestSignInit(ctx.get(), &pctx,
+                           SSL_get_signature_algorithm_digest(signature_algorithm), nullptr,
+                           key) &&
+        (!SSL_is_signature_algorithm_rsa_pss(signature_algorithm) ||
+         (EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_PKCS1_PSS_PADDING) &&
+          EVP_PKEY_CTX_set_rsa_pss_saltlen(pctx, -1 /* salt length is digest length */))) &&
+        EVP_DigestSign(ctx.get(), nullptr, &length, operation.input_.data(),
+                       operation.input_.size());
+    if (operation.success_) {
+      output.resize(length);
+      operation.success_ = EVP_DigestSign(ctx.get(), output.data(), &length,
+                                          operation.input_.data(), operation.input_.size());
+    }
+  }
+
+  if (operation.success_) {
+    output.resize(length);
+  } else {
+    output.clear();
+    // The error queue is per thread, so nothing else would clear it.
+    ENVOY_LOG(debug, "private key operation failed: {}", ERR_reason_error_string(ERR_peek_error()));
+    ERR_clear_error();
+  }
+}
+
+void ThreadPoolPrivateKeyMethodProvider::queue(OperationSharedPtr operation) {
+  {
+    Thread::LockGuard lock(mutex_);
+    queue_.push_back(std::move(operation));
+  }
+  queue_event_.notifyOne();
+}
+
+void ThreadPoolPrivateKeyMethodProvider::threadRoutine() {
+  while (true) {
+    std::vector<OperationSharedPtr> batch;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (queue_.empty() && !shutdown_) {
+        queue_event_.wait(mutex_);
+      }
+      if (shutdown_) {
+        return;
+      }
+      while (!queue_.empty() && batch.size() < max_batch_size_) {
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+
+    for (const OperationSharedPtr& operation : batch) {
+      run(*operation);
+    }
+
+    // The results are posted with the mutex held, so that a connection can't be unregistered,
+    // and its dispatcher go away, between checking its callbacks and posting to the dispatcher.
+    Thread::LockGuard lock(mutex_);
+    std::unordered_map<Event::Dispatcher*, std::vector<OperationSharedPtr>> results;
+    for (OperationSharedPtr& operation : batch) {
+      operation->done_ = true;
+      if (operation->callbacks_ != nullptr) {
+        results[&operation->dispatcher_].push_back(std::move(operation));
+      }
+    }
+    for (auto& result : results) {
+      result.first->post([operations = std::move(result.second)]() -> void {
+        for (const OperationSharedPtr& operation : operations) {
+          if (operation->callbacks_ != nullptr) {
+            operation->callbacks_->onPrivateKeyMethodComplete();
+          }
+        }
+      });
+    }
+  }
+}
+
+// Singleton registration via macro defined in envoy/singleton/manager.h
+SINGLETON_MANAGER_REGISTRATION(thread_pool_private_key_method_providers);
+
+ThreadPoolPrivateKeyMethodProvidersSharedPtr
+ThreadPoolPrivateKeyMethodProviders::getSingleton(Singleton::Manager& singleton_manager,
+                                                  Thread::ThreadFactory& thread_factory) {
+  return singleton_manager.getTyped<ThreadPoolPrivateKeyMethodProviders>(
+      SINGLETON_MANAGER_REGISTERED_NAME(thread_pool_private_key_method_providers),
+      [&thread_factory] {
+        return std::make_shared<ThreadPoolPrivateKeyMethodProviders>(thread_factory);
+      });
+}
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+ThreadPoolPrivateKeyMethodProviders::get(uint32_t threads, uint32_t max_batch_size) {
+  std::weak_ptr<ThreadPoolPrivateKeyMethodProvider>& entry =
+      providers_[{threads, max_batch_size}];
+  std::shared_ptr<ThreadPoolPrivateKeyMethodProvider> provider = entry.lock();
+  if (provider == nullptr) {
+    provider = std::make_shared<ThreadPoolPrivateKeyMethodProvider>(thread_factory_, threads,
+                                                                    max_batch_size);
+    entry = provider;
+  }
+  return provider;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
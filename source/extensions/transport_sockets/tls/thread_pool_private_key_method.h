@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/ssl/private_key_method.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/common/thread_annotations.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * PrivateKeyMethodProvider that performs private key operations with the connection's own key on
+ * a dedicated pool of threads. Each thread takes up to a batch of queued operations at once, and
+ * hands the results of a batch back with a single post to each dispatcher they belong to.
+ */
+class ThreadPoolPrivateKeyMethodProvider : public Ssl::PrivateKeyMethodProvider,
+                                           Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param thread_factory supplies the factory used to create the threads of the pool.
+   * @param threads supplies the number of threads in the pool.
+   * @param max_batch_size supplies the largest number of operations a thread takes at once.
+   */
+  ThreadPoolPrivateKeyMethodProvider(Thread::ThreadFactory& thread_factory, uint32_t threads,
+                                     uint32_t max_batch_size);
+  ~ThreadPoolPrivateKeyMethodProvider();
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  const SSL_PRIVATE_KEY_METHOD& boringSslPrivateKeyMethod() const override { return method_; }
+
+private:
+  /**
+   * A signing or decryption started by a connection.
+   */
+  struct Operation {
+    Operation(Event::Dispatcher& dispatcher, Ssl::PrivateKeyConnectionCallbacks& callbacks)
+        : dispatcher_(dispatcher), callbacks_(&callbacks) {}
+
+    Event::Dispatcher& dispatcher_;
+    bssl::UniquePtr<EVP_PKEY> key_;
+    bool decrypt_{};
+    uint16_t signature_algorithm_{};
+    std::vector<uint8_t> input_;
+    // Written by a thread of the pool, and only read once done_ is set.
+    std::vector<uint8_t> output_;
+    bool success_{};
+    // Set with the mutex of the provider held.
+    bool done_{};
+    // Cleared with the mutex of the provider held, on the dispatcher, when the result is collected
+    // or the connection is unregistered. It can therefore be read on the dispatcher without the
+    // mutex.
+    Ssl::PrivateKeyConnectionCallbacks* callbacks_;
+  };
+
+  typedef std::shared_ptr<Operation> OperationSharedPtr;
+
+  /**
+   * The state of a connection bound to the provider, kept in the ex data of its SSL.
+   */
+  struct ConnectionState {
+    ConnectionState(ThreadPoolPrivateKeyMethodProvider& parent,
+                    Ssl::PrivateKeyConnectionCallbacks& callbacks, Event::Dispatcher& dispatcher)
+        : parent_(parent), callbacks_(callbacks), dispatcher_(dispatcher) {}
+
+    ThreadPoolPrivateKeyMethodProvider& parent_;
+    Ssl::PrivateKeyConnectionCallbacks& callbacks_;
+    Event::Dispatcher& dispatcher_;
+    // The pending or completed operation whose result hasn't been collected yet.
+    OperationSharedPtr operation_;
+  };
+
+  static int connectionStateIndex();
+  static ConnectionState* connectionState(SSL* ssl);
+  static ssl_private_key_result_t sign(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                       uint16_t signature_algorithm, const uint8_t* in,
+                                       size_t in_len);
+  static ssl_private_key_result_t decrypt(SSL* ssl, uint8_t* out, size_t* out_len, size_t max_out,
+                                          const uint8_t* in, size_t in_len);
+  static ssl_private_key_result_t complete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                           size_t max_out);
+  static ssl_private_key_result_t start(SSL* ssl, bool decrypt, uint16_t signature_algorithm,
+                                       const uint8_t* in, size_t in_len);
+  static void run(Operation& operation);
+
+  void queue(OperationSharedPtr operation);
+  void threadRoutine();
+
+  const uint32_t max_batch_size_;
+  SSL_PRIVATE_KEY_METHOD method_{};
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar queue_event_;
+  std::list<OperationSharedPtr> queue_ GUARDED_BY(mutex_);
+  bool shutdown_ GUARDED_BY(mutex_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+/**
+ * The thread pool providers of the process, keyed by their settings, so that all the TLS contexts
+ * offloading private key operations with the same settings share a pool. A pool is stopped once
+ * no context uses it. Only used on the main thread.
+ */
+class ThreadPoolPrivateKeyMethodProviders : public Singleton::Instance {
+public:
+  explicit ThreadPoolPrivateKeyMethodProviders(Thread::ThreadFactory& thread_factory)
+      : thread_factory_(thread_factory) {}
+
+  static std::shared_ptr<ThreadPoolPrivateKeyMethodProviders>
+  getSingleton(Singleton::Manager& singleton_manager, Thread::ThreadFactory& thread_factory);
+
+  /**
+   * @param threads supplies the number of threads in the pool.
+   * @param max_batch_size supplies the largest number of operations a thread takes at once.
+   * @return the provider with the given settings, which is started if no context uses it yet.
+   */
+  Ssl::PrivateKeyMethodProviderSharedPtr get(uint32_t threads, uint32_t max_batch_size);
+
+private:
+  Thread::ThreadFactory& thread_factory_;
+  std::map<std::pair<uint32_t, uint32_t>, std::weak_ptr<ThreadPoolPrivateKeyMethodProvider>>
+      providers_;
+};
+
+typedef std::shared_ptr<ThreadPoolPrivateKeyMethodProviders>
+    ThreadPoolPrivateKeyMethodProvidersSharedPtr;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
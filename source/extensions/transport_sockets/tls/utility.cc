@@ -103,6 +103,17 @@ SystemTime Utility::getExpirationTime(const X509& cert) {
   return std::chrono::system_clock::from_time_t(days * 24 * 60 * 60 + seconds);
 }
 
+absl::optional<SystemTime> Utility::getNextUpdate(X509_CRL& crl) {
+  const ASN1_TIME* next_update = X509_CRL_get_nextUpdate(&crl);
+  if (next_update == nullptr) {
+    return absl::nullopt;
+  }
+  int days, seconds;
+  int rc = ASN1_TIME_diff(&days, &seconds, &epochASN1_Time(), next_update);
+  ASSERT(rc == 1);
+  return std::chrono::system_clock::from_time_t(days * 24 * 60 * 60 + seconds);
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -5,6 +5,7 @@
 
 #include "common/common/utility.h"
 
+#include "absl/types/optional.h"
 #include "openssl/ssl.h"
 
 namespace Envoy {
@@ -58,6 +59,13 @@ SystemTime getValidFrom(const X509& cert);
  */
 SystemTime getExpirationTime(const X509& cert);
 
+/**
+ * Returns the time by which the issuer publishes the next version of this CRL.
+ * @param crl the CRL.
+ * @return time after which the CRL is stale, if it has one.
+ */
+absl::optional<SystemTime> getNextUpdate(X509_CRL& crl);
+
 } // namespace Utility
 } // namespace Tls
 } // namespace TransportSockets
@@ -0,0 +1,83 @@
+#include "extensions/transport_sockets/tls/verification_cache.h"
+
+#include "common/common/assert.h"
+
+#include "openssl/digest.h"
+#include "openssl/sha.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+CertificateVerificationCache::CertificateVerificationCache(uint64_t max_entries)
+    : max_entries_(max_entries) {
+  ASSERT(max_entries_ > 0);
+}
+
+std::string CertificateVerificationCache::key(X509& cert, STACK_OF(X509) * chain) {
+  std::string key;
+  auto append_digest = [&key](X509* chain_cert) -> void {
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    unsigned int digest_length;
+    const int rc = X509_digest(chain_cert, EVP_sha256(), digest, &digest_length);
+    RELEASE_ASSERT(rc == 1 && digest_length == SHA256_DIGEST_LENGTH, "");
+    key.append(reinterpret_cast<const char*>(digest), digest_length);
+  };
+
+  append_digest(&cert);
+  if (chain != nullptr) {
+    for (X509* chain_cert : chain) {
+      append_digest(chain_cert);
+    }
+  }
+  return key;
+}
+
+bool CertificateVerificationCache::lookup(const std::string& key, SystemTime now) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+  if (it->second->expiration_ <= now) {
+    entries_.erase(it->second);
+    index_.erase(it);
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return true;
+}
+
+uint64_t CertificateVerificationCache::insert(const std::string& key, bssl::UniquePtr<X509> cert,
+                                              SystemTime expiration) {
+  uint64_t evicted = 0;
+  absl::MutexLock lock(&mutex_);
+  // Another worker may have verified the same chain meanwhile.
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+  while (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+    evicted++;
+  }
+  entries_.push_front({key, std::move(cert), expiration});
+  index_.emplace(key, entries_.begin());
+  return evicted;
+}
+
+void CertificateVerificationCache::iterate(
+    std::function<void(X509& cert, SystemTime expiration)> callback) const {
+  absl::MutexLock lock(&mutex_);
+  for (const Entry& entry : entries_) {
+    callback(*entry.cert_, entry.expiration_);
+  }
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
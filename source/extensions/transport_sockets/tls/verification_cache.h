@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "envoy/common/time.h"
+
+#include "common/common/thread_annotations.h"
+
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A bounded cache of the peer certificate chains a context has successfully verified, so that a
+ * peer presenting the same chain again skips the verification. The cache belongs to a single
+ * context, and therefore to a single validation context: when the validation context changes,
+ * e.g. a new CRL is delivered, a new context with an empty cache replaces it. Each outcome is only
+ * reused until the first certificate of the verified chain, or the CRLs it was checked against,
+ * expire. Entries are evicted in least recently used order.
+ */
+class CertificateVerificationCache {
+public:
+  /**
+   * @param max_entries supplies the largest number of verified chains kept.
+   */
+  explicit CertificateVerificationCache(uint64_t max_entries);
+
+  /**
+   * @param cert supplies the leaf certificate presented by the peer.
+   * @param chain supplies the certificate chain presented by the peer, or nullptr if there is none.
+   * @return std::string the key of the chain, made of the SHA-256 digests of its certificates.
+   */
+  static std::string key(X509& cert, STACK_OF(X509) * chain);
+
+  /**
+   * @param key supplies the key of the presented chain.
+   * @param now supplies the current time.
+   * @return bool whether the chain was verified before and its outcome is still valid.
+   */
+  bool lookup(const std::string& key, SystemTime now);
+
+  /**
+   * Stores a successfully verified chain, evicting the least recently used chain if the cache is
+   * full.
+   * @param key supplies the key of the chain.
+   * @param cert supplies the leaf certificate of the chain.
+   * @param expiration supplies the time until which the outcome can be reused.
+   * @return uint64_t the number of chains evicted.
+   */
+  uint64_t insert(const std::string& key, bssl::UniquePtr<X509> cert, SystemTime expiration);
+
+  /**
+   * Calls a callback with the leaf certificate and expiration of each stored chain, most recently
+   * used first.
+   */
+  void iterate(std::function<void(X509& cert, SystemTime expiration)> callback) const;
+
+private:
+  struct Entry {
+    std::string key_;
+    bssl::UniquePtr<X509> cert_;
+    SystemTime expiration_;
+  };
+
+  const uint64_t max_entries_;
+  mutable absl::Mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> entries_ GUARDED_BY(mutex_);
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_ GUARDED_BY(mutex_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
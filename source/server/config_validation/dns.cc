@@ -9,5 +9,11 @@ ActiveDnsQuery* ValidationDnsResolver::resolve(const std::string&, DnsLookupFami
   return nullptr;
 }
 
+ActiveDnsQuery* ValidationDnsResolver::resolveWithTtl(const std::string&, DnsLookupFamily,
+                                                      ResolveWithTtlCb callback) {
+  callback({}, std::chrono::seconds(0));
+  return nullptr;
+}
+
 } // namespace Network
 } // namespace Envoy
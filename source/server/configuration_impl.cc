@@ -46,15 +46,26 @@ bool FilterChainUtility::buildFilterChain(
 void MainImpl::initialize(const envoy::config::bootstrap::v2::Bootstrap& bootstrap,
                           Instance& server,
                           Upstream::ClusterManagerFactory& cluster_manager_factory) {
+  // Records the time since the previous phase ended as the given phase.
+  MonotonicTime phase_start = server.timeSource().monotonicTime();
+  const auto end_phase = [&server, &phase_start](const std::string& name) {
+    const MonotonicTime now = server.timeSource().monotonicTime();
+    server.recordStartupPhase(
+        name, std::chrono::duration_cast<std::chrono::microseconds>(now - phase_start));
+    phase_start = now;
+  };
+
   const auto& secrets = bootstrap.static_resources().secrets();
   ENVOY_LOG(info, "loading {} static secret(s)", secrets.size());
   for (ssize_t i = 0; i < secrets.size(); i++) {
     ENVOY_LOG(debug, "static secret #{}: {}", i, secrets[i].name());
     server.secretManager().addStaticSecret(secrets[i]);
   }
+  end_phase("static_secrets");
 
   ENVOY_LOG(info, "loading {} cluster(s)", bootstrap.static_resources().clusters().size());
   cluster_manager_ = cluster_manager_factory.clusterManagerFromProto(bootstrap);
+  end_phase("static_clusters");
 
   // TODO(ramaraochavali): remove this dependency on extension when rate limit service config is
   // deprecated and removed from bootstrap. For now, just call in to extensions to register the rate
@@ -67,6 +78,7 @@ void MainImpl::initialize(const envoy::config::bootstrap::v2::Bootstrap& bootstr
     ENVOY_LOG(debug, "listener #{}:", i);
     server.listenerManager().addOrUpdateListener(listeners[i], "", false);
   }
+  end_phase("static_listeners");
 
   stats_flush_interval_ =
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(bootstrap, stats_flush_interval, 5000));
@@ -1,10 +1,12 @@
 #include "server/hot_restart_impl.h"
 
 #include <signal.h>
+#include <sys/mman.h>
 #include <sys/prctl.h>
 #include <sys/types.h>
 #include <sys/un.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -29,7 +31,9 @@ namespace Server {
 
 // Increment this whenever there is a shared memory / RPC change that will prevent a hot restart
 // from working. Operations code can then cope with this and do a full restart.
-const uint64_t SharedMemory::VERSION = 10;
+const uint64_t SharedMemory::VERSION = 11;
+
+const uint64_t HotRestartImpl::STATS_REGION_RESERVED_SIZE = 8ULL * 1024 * 1024 * 1024;
 
 static BlockMemoryHashSetOptions blockMemHashOptions(uint64_t max_stats) {
   BlockMemoryHashSetOptions hash_set_options;
@@ -40,14 +44,12 @@ static BlockMemoryHashSetOptions blockMemHashOptions(uint64_t max_stats) {
   return hash_set_options;
 }
 
-SharedMemory& SharedMemory::initialize(uint64_t stats_set_size, const Options& options) {
+// Opens the shared memory object with the given name, creating it if we are the first running
+// envoy.
+static int openSharedMemory(const std::string& shmem_name, const Options& options) {
   Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
 
-  const uint64_t entry_size = Stats::RawStatData::structSizeWithOptions(options.statsOptions());
-  const uint64_t total_size = sizeof(SharedMemory) + stats_set_size;
-
   int flags = O_RDWR;
-  const std::string shmem_name = fmt::format("/envoy_shared_memory_{}", options.baseId());
   if (options.restartEpoch() == 0) {
     flags |= O_CREAT | O_EXCL;
 
@@ -62,14 +64,26 @@ SharedMemory& SharedMemory::initialize(uint64_t stats_set_size, const Options& o
     PANIC(fmt::format("cannot open shared memory region {} check user permissions. Error: {}",
                       shmem_name, strerror(result.errno_)));
   }
+  return result.rc_;
+}
+
+SharedMemory& SharedMemory::initialize(uint64_t stats_set_size, const Options& options) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+
+  const uint64_t entry_size = Stats::RawStatData::structSizeWithOptions(options.statsOptions());
+  const uint64_t total_size = sizeof(SharedMemory) + stats_set_size;
+  // The number of stats is not fixed with --growable-hot-restart-stats.
+  const uint64_t max_stats = options.growableHotRestartStats() ? 0 : options.maxStats();
 
+  const int fd =
+      openSharedMemory(fmt::format("/envoy_shared_memory_{}", options.baseId()), options);
   if (options.restartEpoch() == 0) {
-    const Api::SysCallIntResult truncateRes = os_sys_calls.ftruncate(result.rc_, total_size);
+    const Api::SysCallIntResult truncateRes = os_sys_calls.ftruncate(fd, total_size);
     RELEASE_ASSERT(truncateRes.rc_ != -1, "");
   }
 
   const Api::SysCallPtrResult mmapRes =
-      os_sys_calls.mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, result.rc_, 0);
+      os_sys_calls.mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
   SharedMemory* shmem = reinterpret_cast<SharedMemory*>(mmapRes.rc_);
   RELEASE_ASSERT(shmem != MAP_FAILED, "");
   RELEASE_ASSERT((reinterpret_cast<uintptr_t>(shmem) % alignof(decltype(shmem))) == 0, "");
@@ -77,7 +91,7 @@ SharedMemory& SharedMemory::initialize(uint64_t stats_set_size, const Options& o
   if (options.restartEpoch() == 0) {
     shmem->size_ = total_size;
     shmem->version_ = VERSION;
-    shmem->max_stats_ = options.maxStats();
+    shmem->max_stats_ = max_stats;
     shmem->entry_size_ = entry_size;
     shmem->initializeMutex(shmem->log_lock_);
     shmem->initializeMutex(shmem->access_log_lock_);
@@ -86,7 +100,7 @@ SharedMemory& SharedMemory::initialize(uint64_t stats_set_size, const Options& o
   } else {
     RELEASE_ASSERT(shmem->size_ == total_size, "");
     RELEASE_ASSERT(shmem->version_ == VERSION, "");
-    RELEASE_ASSERT(shmem->max_stats_ == options.maxStats(), "");
+    RELEASE_ASSERT(shmem->max_stats_ == max_stats, "");
     RELEASE_ASSERT(shmem->entry_size_ == entry_size, "");
   }
 
@@ -122,22 +136,40 @@ std::string SharedMemory::version(uint64_t max_num_stats,
                      stats_options.maxNameLength());
 }
 
+std::string SharedMemory::growableStatsVersion() {
+  return fmt::format("{}.{}.{}", VERSION, sizeof(SharedMemory),
+                     Stats::GrowableRawStatDataAllocator::version());
+}
+
 HotRestartImpl::HotRestartImpl(const Options& options)
     : options_(options), stats_set_options_(blockMemHashOptions(options.maxStats())),
       shmem_(SharedMemory::initialize(
-          Stats::RawStatDataSet::numBytes(stats_set_options_, options_.statsOptions()), options_)),
+          options.growableHotRestartStats()
+              ? 0
+              : Stats::RawStatDataSet::numBytes(stats_set_options_, options_.statsOptions()),
+          options_)),
       log_lock_(shmem_.log_lock_), access_log_lock_(shmem_.access_log_lock_),
       stat_lock_(shmem_.stat_lock_), init_lock_(shmem_.init_lock_) {
-  {
-    // We must hold the stat lock when attaching to an existing memory segment
-    // because it might be actively written to while we sanityCheck it.
-    Thread::LockGuard lock(stat_lock_);
-    stats_set_ =
-        std::make_unique<Stats::RawStatDataSet>(stats_set_options_, options.restartEpoch() == 0,
-                                                shmem_.stats_set_data_, options_.statsOptions());
+  if (options.growableHotRestartStats()) {
+    // Stats live in a separate region so that it can grow without moving the shared memory
+    // segment, which holds the process shared mutexes.
+    stats_allocator_ = std::make_unique<Stats::GrowableRawStatDataAllocator>(
+        stat_lock_, mapStatsRegion(), STATS_REGION_RESERVED_SIZE, options.restartEpoch() == 0,
+        [this](uint64_t size) -> bool {
+          return Api::OsSysCallsSingleton::get().ftruncate(stats_region_fd_, size).rc_ != -1;
+        });
+  } else {
+    {
+      // We must hold the stat lock when attaching to an existing memory segment
+      // because it might be actively written to while we sanityCheck it.
+      Thread::LockGuard lock(stat_lock_);
+      stats_set_ =
+          std::make_unique<Stats::RawStatDataSet>(stats_set_options_, options.restartEpoch() == 0,
+                                                  shmem_.stats_set_data_, options_.statsOptions());
+    }
+    stats_allocator_ = std::make_unique<Stats::RawStatDataAllocator>(stat_lock_, *stats_set_,
+                                                                     options_.statsOptions());
   }
-  stats_allocator_ = std::make_unique<Stats::RawStatDataAllocator>(stat_lock_, *stats_set_,
-                                                                   options_.statsOptions());
   my_domain_socket_ = bindDomainSocket(options.restartEpoch());
   child_address_ = createDomainSocketAddress((options.restartEpoch() + 1));
   initDomainSocketAddress(&parent_address_);
@@ -151,6 +183,25 @@ HotRestartImpl::HotRestartImpl(const Options& options)
   RELEASE_ASSERT(rc != -1, "");
 }
 
+HotRestartImpl::~HotRestartImpl() {
+  // The stats region stays mapped, as stats may be used until the process exits.
+  if (stats_region_fd_ != -1) {
+    Api::OsSysCallsSingleton::get().close(stats_region_fd_);
+  }
+}
+
+uint8_t* HotRestartImpl::mapStatsRegion() {
+  // The whole reservation is mapped up front so that stats never move. Pages past the current size
+  // of the shared memory object are only backed once the allocator grows the object over them.
+  stats_region_fd_ =
+      openSharedMemory(fmt::format("/envoy_stats_memory_{}", options_.baseId()), options_);
+  const Api::SysCallPtrResult result = Api::OsSysCallsSingleton::get().mmap(
+      nullptr, STATS_REGION_RESERVED_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE,
+      stats_region_fd_, 0);
+  RELEASE_ASSERT(result.rc_ != MAP_FAILED, "");
+  return static_cast<uint8_t*>(result.rc_);
+}
+
 int HotRestartImpl::bindDomainSocket(uint64_t id) {
   Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
   // This actually creates the socket and binds it. We use the socket in datagram mode so we can
@@ -245,6 +296,31 @@ void HotRestartImpl::getParentStats(GetParentStatsInfo& info) {
   info.num_connections_ = reply->num_connections_;
 }
 
+std::string HotRestartImpl::getParentTlsSessions() {
+  if (options_.restartEpoch() == 0 || parent_terminated_) {
+    return "";
+  }
+
+  std::string sessions;
+  uint64_t total_length = 0;
+  RpcGetTlsSessionsRequest rpc;
+  do {
+    rpc.offset_ = sessions.size();
+    sendMessage(parent_address_, rpc);
+    RpcGetTlsSessionsReply* reply =
+        receiveTypedRpc<RpcGetTlsSessionsReply, RpcMessageType::GetTlsSessionsReply>();
+    RELEASE_ASSERT(reply->chunk_length_ <= sizeof(reply->chunk_), "");
+    total_length = reply->total_length_;
+    if (reply->chunk_length_ == 0) {
+      // Either the parent has no sessions, or it lost its snapshot of them, e.g. because another
+      // child raced with this one. Resuming sessions is only an optimization, so go without.
+      return "";
+    }
+    sessions.append(reinterpret_cast<const char*>(reply->chunk_), reply->chunk_length_);
+  } while (sessions.size() < total_length);
+  return sessions;
+}
+
 void HotRestartImpl::initialize(Event::Dispatcher& dispatcher, Server::Instance& server) {
   socket_event_ =
       dispatcher.createFileEvent(my_domain_socket_,
@@ -373,6 +449,25 @@ void HotRestartImpl::onGetListenSocket(RpcGetListenSocketRequest& rpc) {
   }
 }
 
+void HotRestartImpl::onGetTlsSessions(RpcGetTlsSessionsRequest& rpc) {
+  if (rpc.offset_ == 0) {
+    tls_sessions_ = server_->sslContextManager().exportClientSessions();
+  }
+
+  RpcGetTlsSessionsReply reply;
+  reply.total_length_ = tls_sessions_.size();
+  if (rpc.offset_ < tls_sessions_.size()) {
+    reply.chunk_length_ =
+        std::min<uint64_t>(sizeof(reply.chunk_), tls_sessions_.size() - rpc.offset_);
+    memcpy(reply.chunk_, tls_sessions_.data() + rpc.offset_, reply.chunk_length_);
+  }
+  if (rpc.offset_ + reply.chunk_length_ >= tls_sessions_.size()) {
+    // That was the last chunk, so the snapshot is no longer needed.
+    tls_sessions_.clear();
+  }
+  sendMessage(child_address_, reply);
+}
+
 void HotRestartImpl::onSocketEvent() {
   while (true) {
     RpcBase* base_message = receiveRpc(false);
@@ -406,6 +501,13 @@ void HotRestartImpl::onSocketEvent() {
       break;
     }
 
+    case RpcMessageType::GetTlsSessionsRequest: {
+      RpcGetTlsSessionsRequest* message =
+          reinterpret_cast<RpcGetTlsSessionsRequest*>(base_message);
+      onGetTlsSessions(*message);
+      break;
+    }
+
     case RpcMessageType::DrainListenersRequest: {
       server_->drainListeners();
       break;
@@ -453,13 +555,20 @@ void HotRestartImpl::terminateParent() {
 void HotRestartImpl::shutdown() { socket_event_.reset(); }
 
 std::string HotRestartImpl::version() {
+  if (options_.growableHotRestartStats()) {
+    return SharedMemory::growableStatsVersion();
+  }
   Thread::LockGuard lock(stat_lock_);
   return versionHelper(shmem_.maxStats(), options_.statsOptions(), *stats_set_);
 }
 
 // Called from envoy --hot-restart-version -- needs to instantiate a RawStatDataSet so it
 // can generate the version string.
-std::string HotRestartImpl::hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len) {
+std::string HotRestartImpl::hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len,
+                                              bool growable_stats) {
+  if (growable_stats) {
+    return SharedMemory::growableStatsVersion();
+  }
   Stats::StatsOptionsImpl stats_options;
   stats_options.max_obj_name_length_ = max_stat_name_len - stats_options.maxStatSuffixLength();
 
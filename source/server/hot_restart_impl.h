@@ -14,6 +14,7 @@
 #include "envoy/stats/stats_options.h"
 
 #include "common/common/assert.h"
+#include "common/stats/growable_raw_stat_data_allocator.h"
 #include "common/stats/raw_stat_data.h"
 
 namespace Envoy {
@@ -27,6 +28,7 @@ class SharedMemory {
 public:
   static void configure(uint64_t max_num_stats, uint64_t max_stat_name_len);
   static std::string version(uint64_t max_num_stats, const Stats::StatsOptions& stats_options);
+  static std::string growableStatsVersion();
 
   // Made public for testing.
   static const uint64_t VERSION;
@@ -115,11 +117,13 @@ private:
 class HotRestartImpl : public HotRestart, Logger::Loggable<Logger::Id::main> {
 public:
   HotRestartImpl(const Options& options);
+  ~HotRestartImpl();
 
   // Server::HotRestart
   void drainParentListeners() override;
   int duplicateParentListenSocket(const std::string& address) override;
   void getParentStats(GetParentStatsInfo& info) override;
+  std::string getParentTlsSessions() override;
   void initialize(Event::Dispatcher& dispatcher, Server::Instance& server) override;
   void shutdownParentAdmin(ShutdownParentAdminInfo& info) override;
   void terminateParent() override;
@@ -127,13 +131,20 @@ public:
   std::string version() override;
   Thread::BasicLockable& logLock() override { return log_lock_; }
   Thread::BasicLockable& accessLogLock() override { return access_log_lock_; }
-  Stats::RawStatDataAllocator& statsAllocator() override { return *stats_allocator_; }
+  Stats::StatDataAllocatorImpl<Stats::RawStatData>& statsAllocator() override {
+    return *stats_allocator_;
+  }
 
   /**
    * envoy --hot_restart_version doesn't initialize Envoy, but computes the version string
    * based on the configured options.
    */
-  static std::string hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len);
+  static std::string hotRestartVersion(uint64_t max_num_stats, uint64_t max_stat_name_len,
+                                       bool growable_stats);
+
+  // The address space reserved for the stats region with --growable-hot-restart-stats. Only the
+  // part of it that stats have grown into is backed by memory.
+  static const uint64_t STATS_REGION_RESERVED_SIZE;
 
 private:
   enum class RpcMessageType {
@@ -145,7 +156,9 @@ private:
     TerminateRequest = 6,
     UnknownRequestReply = 7,
     GetStatsRequest = 8,
-    GetStatsReply = 9
+    GetStatsReply = 9,
+    GetTlsSessionsRequest = 10,
+    GetTlsSessionsReply = 11
   };
 
   PACKED_STRUCT(struct RpcBase {
@@ -189,6 +202,26 @@ private:
                   uint64_t unused_[16]{0};
                 });
 
+  // The serialized TLS sessions can be larger than a single message, so the child fetches them in
+  // chunks, asking for one at a time so that the parent never has more than one reply in flight.
+  PACKED_STRUCT(struct RpcGetTlsSessionsRequest
+                : public RpcBase {
+                  RpcGetTlsSessionsRequest()
+                      : RpcBase(RpcMessageType::GetTlsSessionsRequest, sizeof(*this)) {}
+
+                  uint64_t offset_{0};
+                });
+
+  PACKED_STRUCT(struct RpcGetTlsSessionsReply
+                : public RpcBase {
+                  RpcGetTlsSessionsReply()
+                      : RpcBase(RpcMessageType::GetTlsSessionsReply, sizeof(*this)) {}
+
+                  uint64_t total_length_{0};
+                  uint64_t chunk_length_{0};
+                  uint8_t chunk_[4000]{0};
+                });
+
   template <class rpc_class, RpcMessageType rpc_type> rpc_class* receiveTypedRpc() {
     RpcBase* base_message = receiveRpc(true);
     RELEASE_ASSERT(base_message->length_ == sizeof(rpc_class), "");
@@ -196,10 +229,12 @@ private:
     return reinterpret_cast<rpc_class*>(base_message);
   }
 
+  uint8_t* mapStatsRegion();
   int bindDomainSocket(uint64_t id);
   void initDomainSocketAddress(sockaddr_un* address);
   sockaddr_un createDomainSocketAddress(uint64_t id);
   void onGetListenSocket(RpcGetListenSocketRequest& rpc);
+  void onGetTlsSessions(RpcGetTlsSessionsRequest& rpc);
   void onSocketEvent();
   RpcBase* receiveRpc(bool block);
   void sendMessage(sockaddr_un& address, RpcBase& rpc);
@@ -210,7 +245,8 @@ private:
   BlockMemoryHashSetOptions stats_set_options_;
   SharedMemory& shmem_;
   std::unique_ptr<Stats::RawStatDataSet> stats_set_ GUARDED_BY(stat_lock_);
-  std::unique_ptr<Stats::RawStatDataAllocator> stats_allocator_;
+  int stats_region_fd_{-1};
+  std::unique_ptr<Stats::StatDataAllocatorImpl<Stats::RawStatData>> stats_allocator_;
   ProcessSharedMutex log_lock_;
   ProcessSharedMutex access_log_lock_;
   ProcessSharedMutex stat_lock_;
@@ -222,6 +258,9 @@ private:
   std::array<uint8_t, 4096> rpc_buffer_;
   Server::Instance* server_{};
   bool parent_terminated_{};
+  // The TLS sessions being sent to the child, captured when it asks for the first chunk so that
+  // all chunks come from the same snapshot.
+  std::string tls_sessions_;
 };
 
 } // namespace Server
@@ -21,6 +21,7 @@ public:
   void drainParentListeners() override {}
   int duplicateParentListenSocket(const std::string&) override { return -1; }
   void getParentStats(GetParentStatsInfo& info) override { memset(&info, 0, sizeof(info)); }
+  std::string getParentTlsSessions() override { return ""; }
   void initialize(Event::Dispatcher&, Server::Instance&) override {}
   void shutdownParentAdmin(ShutdownParentAdminInfo&) override {}
   void terminateParent() override {}
@@ -609,6 +609,12 @@ Http::Code AdminImpl::handlerServerInfo(absl::string_view, Http::HeaderMap& head
   envoy::admin::v2alpha::CommandLineOptions* command_line_options =
       server_info.mutable_command_line_options();
   *command_line_options = *server_.options().toCommandLineOptions();
+  for (const StartupPhase& phase : server_.startupPhases()) {
+    envoy::admin::v2alpha::StartupPhase& startup_phase = *server_info.add_startup_phases();
+    startup_phase.set_name(phase.name_);
+    *startup_phase.mutable_duration() =
+        Protobuf::util::TimeUtil::MicrosecondsToDuration(phase.duration_.count());
+  }
   response.add(MessageUtil::getJsonStringFromMessage(server_info, true, true));
   headers.insertContentType().value().setReference(Http::Headers::get().ContentTypeValues.Json);
   return Http::Code::OK;
@@ -906,6 +912,9 @@ Http::Code AdminImpl::handlerCerts(absl::string_view, Http::HeaderMap& response_
       envoy::admin::v2alpha::CertificateDetails* cert_chain = certificate.add_cert_chain();
       *cert_chain = *cert_details;
     }
+    for (const auto& verification : context.getVerificationCacheInformation()) {
+      *certificate.add_verification_cache() = *verification;
+    }
   });
   response.add(MessageUtil::getJsonStringFromMessage(certificates, true, true));
   return Http::Code::OK;
@@ -27,6 +27,7 @@
 
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 
 namespace Envoy {
 namespace Server {
@@ -261,6 +262,18 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
                         "\"server_names\"",
                         address_->asString()));
       }
+      // A wildcard needs a domain, and the labels of server names are never empty. "*." would
+      // otherwise match every server name.
+      if (isWildcardServerName(server_name)) {
+        const std::vector<absl::string_view> labels =
+            absl::StrSplit(absl::string_view(server_name).substr(2), '.');
+        if (std::find(labels.begin(), labels.end(), "") != labels.end()) {
+          throw EnvoyException(
+              fmt::format("error adding listener '{}': wildcard server name '{}' has an empty "
+                          "domain label in \"server_names\"",
+                          address_->asString(), server_name));
+        }
+      }
     }
 
     std::vector<std::string> application_protocols(
@@ -375,24 +388,21 @@ void ListenerImpl::addFilterChainForDestinationIPs(
 }
 
 void ListenerImpl::addFilterChainForServerNames(
-    ServerNamesMap& server_names_map, const std::vector<std::string>& server_names,
+    ServerNamesTrieSharedPtr& server_names_trie, const std::vector<std::string>& server_names,
     const std::string& transport_protocol, const std::vector<std::string>& application_protocols,
     const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
     const Network::FilterChainSharedPtr& filter_chain) {
+  if (server_names_trie == nullptr) {
+    server_names_trie = std::make_shared<ServerNamesTrie>();
+  }
   if (server_names.empty()) {
-    addFilterChainForApplicationProtocols(server_names_map[EMPTY_STRING][transport_protocol],
+    addFilterChainForApplicationProtocols(server_names_trie->add(EMPTY_STRING)[transport_protocol],
                                           application_protocols, source_type, filter_chain);
   } else {
     for (const auto& server_name : server_names) {
-      if (isWildcardServerName(server_name)) {
-        // Add mapping for the wildcard domain, i.e. ".example.com" for "*.example.com".
-        addFilterChainForApplicationProtocols(
-            server_names_map[server_name.substr(1)][transport_protocol], application_protocols,
-            source_type, filter_chain);
-      } else {
-        addFilterChainForApplicationProtocols(server_names_map[server_name][transport_protocol],
-                                              application_protocols, source_type, filter_chain);
-      }
+      // Wildcard domains, i.e. "*.example.com", are recognized by the trie.
+      addFilterChainForApplicationProtocols(server_names_trie->add(server_name)[transport_protocol],
+                                            application_protocols, source_type, filter_chain);
     }
   }
 }
@@ -424,7 +434,8 @@ void ListenerImpl::convertDestinationIPsMapToTrie() {
   for (auto& port : destination_ports_map_) {
     auto& destination_ips_pair = port.second;
     auto& destination_ips_map = destination_ips_pair.first;
-    std::vector<std::pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>> list;
+    std::vector<std::pair<ServerNamesTrieSharedPtr, std::vector<Network::Address::CidrRange>>>
+        list;
     for (const auto& entry : destination_ips_map) {
       std::vector<Network::Address::CidrRange> subnets;
       if (entry.first == EMPTY_STRING) {
@@ -437,10 +448,7 @@ void ListenerImpl::convertDestinationIPsMapToTrie() {
       } else {
         subnets.push_back(Network::Address::CidrRange::create(entry.first));
       }
-      list.push_back(
-          std::make_pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>(
-              std::make_shared<ServerNamesMap>(entry.second),
-              std::vector<Network::Address::CidrRange>(subnets)));
+      list.emplace_back(entry.second, std::move(subnets));
     }
     destination_ips_pair.second = std::make_unique<DestinationIPsTrie>(list, true);
   }
@@ -489,31 +497,15 @@ ListenerImpl::findFilterChainForDestinationIP(const DestinationIPsTrie& destinat
 }
 
 const Network::FilterChain*
-ListenerImpl::findFilterChainForServerName(const ServerNamesMap& server_names_map,
+ListenerImpl::findFilterChainForServerName(const ServerNamesTrie& server_names_trie,
                                            const Network::ConnectionSocket& socket) const {
-  const std::string server_name(socket.requestedServerName());
-
-  // Match on exact server name, i.e. "www.example.com" for "www.example.com".
-  const auto server_name_exact_match = server_names_map.find(server_name);
-  if (server_name_exact_match != server_names_map.end()) {
-    return findFilterChainForTransportProtocol(server_name_exact_match->second, socket);
-  }
-
-  // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
-  size_t pos = server_name.find('.', 1);
-  while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
-    const auto server_name_wildcard_match = server_names_map.find(wildcard);
-    if (server_name_wildcard_match != server_names_map.end()) {
-      return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
-    }
-    pos = server_name.find('.', pos + 1);
-  }
-
-  // Match on a filter chain without server name requirements.
-  const auto server_name_catchall_match = server_names_map.find(EMPTY_STRING);
-  if (server_name_catchall_match != server_names_map.end()) {
-    return findFilterChainForTransportProtocol(server_name_catchall_match->second, socket);
+  // Match on exact server name, i.e. "www.example.com" for "www.example.com", then on the longest
+  // wildcard domain, i.e. "*.example.com" before "*.com" for "www.example.com", and finally on a
+  // filter chain without server name requirements.
+  const TransportProtocolsMap* transport_protocols_map =
+      server_names_trie.find(socket.requestedServerName());
+  if (transport_protocols_map != nullptr) {
+    return findFilterChainForTransportProtocol(*transport_protocols_map, socket);
   }
 
   return nullptr;
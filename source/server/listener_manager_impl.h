@@ -14,6 +14,7 @@
 #include "common/common/logger.h"
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
+#include "common/network/server_name_trie.h"
 
 #include "server/init_manager_impl.h"
 #include "server/lds_api.h"
@@ -313,16 +314,22 @@ public:
   SystemTime last_updated_;
 
 private:
+  // Filter chains are matched one criterion at a time, and the most specific match of a criterion
+  // is kept even when the criteria after it then match nothing, e.g. a connection to an exact
+  // destination port never falls back to the catch-all port. Flattening the levels into a single
+  // lookup would therefore need every combination of fallbacks expanded when the listener is
+  // built. Only server names are numerous enough for their level to be worth more than a hash
+  // lookup, see test/server/filter_chain_speed_test.cc.
   typedef std::array<Network::FilterChainSharedPtr, 3> SourceTypesArray;
   typedef std::unordered_map<std::string, SourceTypesArray> ApplicationProtocolsMap;
   typedef std::unordered_map<std::string, ApplicationProtocolsMap> TransportProtocolsMap;
-  // Both exact server names and wildcard domains are part of the same map, in which wildcard
-  // domains are prefixed with "." (i.e. ".example.com" for "*.example.com") to differentiate
-  // between exact and wildcard entries.
-  typedef std::unordered_map<std::string, TransportProtocolsMap> ServerNamesMap;
-  typedef std::unordered_map<std::string, ServerNamesMap> DestinationIPsMap;
-  typedef std::shared_ptr<ServerNamesMap> ServerNamesMapSharedPtr;
-  typedef Network::LcTrie::LcTrie<ServerNamesMapSharedPtr> DestinationIPsTrie;
+  // Exact server names, wildcard domains and filter chains without server names (the empty name)
+  // are all part of the same trie, which finds the best match of a name in a single walk.
+  typedef Network::ServerNameTrie<TransportProtocolsMap> ServerNamesTrie;
+  typedef std::shared_ptr<ServerNamesTrie> ServerNamesTrieSharedPtr;
+  // The tries are shared with DestinationIPsTrie once it is built, rather than copied.
+  typedef std::unordered_map<std::string, ServerNamesTrieSharedPtr> DestinationIPsMap;
+  typedef Network::LcTrie::LcTrie<ServerNamesTrieSharedPtr> DestinationIPsTrie;
   typedef std::unique_ptr<DestinationIPsTrie> DestinationIPsTriePtr;
   typedef std::unordered_map<uint16_t, std::pair<DestinationIPsMap, DestinationIPsTriePtr>>
       DestinationPortsMap;
@@ -348,7 +355,7 @@ private:
       const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
       const Network::FilterChainSharedPtr& filter_chain);
   void addFilterChainForServerNames(
-      ServerNamesMap& server_names_map, const std::vector<std::string>& server_names,
+      ServerNamesTrieSharedPtr& server_names_trie, const std::vector<std::string>& server_names,
       const std::string& transport_protocol, const std::vector<std::string>& application_protocols,
       const envoy::api::v2::listener::FilterChainMatch_ConnectionSourceType source_type,
       const Network::FilterChainSharedPtr& filter_chain);
@@ -368,7 +375,7 @@ private:
   findFilterChainForDestinationIP(const DestinationIPsTrie& destination_ips_trie,
                                   const Network::ConnectionSocket& socket) const;
   const Network::FilterChain*
-  findFilterChainForServerName(const ServerNamesMap& server_names_map,
+  findFilterChainForServerName(const ServerNamesTrie& server_names_trie,
                                const Network::ConnectionSocket& socket) const;
   const Network::FilterChain*
   findFilterChainForTransportProtocol(const TransportProtocolsMap& transport_protocols_map,
@@ -115,6 +115,11 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
                                              cmd);
   TCLAP::SwitchArg disable_hot_restart("", "disable-hot-restart",
                                        "Disable hot restart functionality", cmd, false);
+  TCLAP::SwitchArg growable_hot_restart_stats(
+      "", "growable-hot-restart-stats",
+      "Keep hot restart stats in a shared memory region that grows as stats are added, "
+      "ignoring max-stats and not truncating stat names",
+      cmd, false);
   TCLAP::SwitchArg enable_mutex_tracing(
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
 
@@ -151,6 +156,7 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
   // TODO(jmarantz): should we also multiply these to bound the total amount of memory?
 
   hot_restart_disabled_ = disable_hot_restart.getValue();
+  growable_hot_restart_stats_ = growable_hot_restart_stats.getValue();
 
   mutex_tracing_enabled_ = enable_mutex_tracing.getValue();
 
@@ -209,7 +215,7 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
 
   if (hot_restart_version_option.getValue()) {
     std::cerr << hot_restart_version_cb(max_stats.getValue(), stats_options_.maxNameLength(),
-                                        !hot_restart_disabled_);
+                                        !hot_restart_disabled_, growable_hot_restart_stats_);
     throw NoServingException();
   }
 }
@@ -290,6 +296,7 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_max_stats(maxStats());
   command_line_options->set_max_obj_name_len(statsOptions().maxObjNameLength());
   command_line_options->set_disable_hot_restart(hotRestartDisabled());
+  command_line_options->set_growable_hot_restart_stats(growableHotRestartStats());
   command_line_options->set_enable_mutex_tracing(mutexTracingEnabled());
   command_line_options->set_restart_epoch(restartEpoch());
   return command_line_options;
@@ -303,6 +310,7 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       service_cluster_(service_cluster), service_node_(service_node), service_zone_(service_zone),
       file_flush_interval_msec_(10000), drain_time_(600), parent_shutdown_time_(900),
       mode_(Server::Mode::Serve), max_stats_(ENVOY_DEFAULT_MAX_STATS), hot_restart_disabled_(false),
-      signal_handling_enabled_(true), mutex_tracing_enabled_(false) {}
+      growable_hot_restart_stats_(false), signal_handling_enabled_(true),
+      mutex_tracing_enabled_(false) {}
 
 } // namespace Envoy
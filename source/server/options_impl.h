@@ -21,7 +21,7 @@ public:
   /**
    * Parameters are max_num_stats, max_stat_name_len, hot_restart_enabled
    */
-  typedef std::function<std::string(uint64_t, uint64_t, bool)> HotRestartVersionCb;
+  typedef std::function<std::string(uint64_t, uint64_t, bool, bool)> HotRestartVersionCb;
 
   /**
    * @throw NoServingException if Envoy has already done everything specified by the argv (e.g.
@@ -70,6 +70,9 @@ public:
   void setHotRestartDisabled(bool hot_restart_disabled) {
     hot_restart_disabled_ = hot_restart_disabled;
   }
+  void setGrowableHotRestartStats(bool growable_hot_restart_stats) {
+    growable_hot_restart_stats_ = growable_hot_restart_stats;
+  }
   void setSignalHandling(bool signal_handling_enabled) {
     signal_handling_enabled_ = signal_handling_enabled;
   }
@@ -103,6 +106,7 @@ public:
   uint64_t maxStats() const override { return max_stats_; }
   const Stats::StatsOptions& statsOptions() const override { return stats_options_; }
   bool hotRestartDisabled() const override { return hot_restart_disabled_; }
+  bool growableHotRestartStats() const override { return growable_hot_restart_stats_; }
   bool signalHandlingEnabled() const override { return signal_handling_enabled_; }
   bool mutexTracingEnabled() const override { return mutex_tracing_enabled_; }
   virtual Server::CommandLineOptionsPtr toCommandLineOptions() const override;
@@ -135,6 +139,7 @@ private:
   uint64_t max_stats_;
   Stats::StatsOptionsImpl stats_options_;
   bool hot_restart_disabled_;
+  bool growable_hot_restart_stats_;
   bool signal_handling_enabled_;
   bool mutex_tracing_enabled_;
   uint32_t count_;
@@ -2,6 +2,7 @@
 
 #include <signal.h>
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -9,6 +10,8 @@
 #include <unordered_set>
 
 #include "envoy/admin/v2alpha/config_dump.pb.h"
+#include "envoy/api/v2/cds.pb.validate.h"
+#include "envoy/api/v2/lds.pb.validate.h"
 #include "envoy/config/bootstrap/v2//bootstrap.pb.validate.h"
 #include "envoy/config/bootstrap/v2/bootstrap.pb.h"
 #include "envoy/event/dispatcher.h"
@@ -30,6 +33,7 @@
 #include "common/local_info/local_info_impl.h"
 #include "common/memory/stats.h"
 #include "common/network/address_impl.h"
+#include "common/network/caching_dns_resolver_impl.h"
 #include "common/protobuf/utility.h"
 #include "common/router/rds_impl.h"
 #include "common/runtime/runtime_impl.h"
@@ -190,10 +194,79 @@ InstanceUtil::loadBootstrapConfig(envoy::config::bootstrap::v2::Bootstrap& boots
     MessageUtil::loadFromYaml(config_yaml, bootstrap_override);
     bootstrap.MergeFrom(bootstrap_override);
   }
-  MessageUtil::validate(bootstrap);
+  validateBootstrap(bootstrap, options.concurrency(), api.threadFactory());
   return BootstrapVersion::V2;
 }
 
+namespace {
+
+// With fewer static listeners and clusters than this per thread, starting the threads takes about
+// as long as validating them on a single thread.
+constexpr size_t MinStaticResourcesPerValidationThread = 64;
+
+} // namespace
+
+void InstanceUtil::validateBootstrap(envoy::config::bootstrap::v2::Bootstrap& bootstrap,
+                                     uint32_t concurrency, Thread::ThreadFactory& thread_factory) {
+  const size_t num_listeners = bootstrap.static_resources().listeners_size();
+  const size_t num_resources = num_listeners + bootstrap.static_resources().clusters_size();
+  const size_t num_threads =
+      std::min<size_t>(concurrency, num_resources / MinStaticResourcesPerValidationThread);
+  if (num_threads <= 1) {
+    MessageUtil::validate(bootstrap);
+    return;
+  }
+
+  // Deprecated fields are checked for on this thread, since that may consult the runtime. The
+  // rest of the bootstrap is validated with the static listeners and clusters moved out of it, so
+  // that they are only validated once, by the validation threads. Constraint validation has no side
+  // effects, so it is safe to run concurrently.
+  MessageUtil::checkForDeprecation(bootstrap);
+  auto& static_resources = *bootstrap.mutable_static_resources();
+  Protobuf::RepeatedPtrField<envoy::api::v2::Listener> listeners;
+  Protobuf::RepeatedPtrField<envoy::api::v2::Cluster> clusters;
+  listeners.Swap(static_resources.mutable_listeners());
+  clusters.Swap(static_resources.mutable_clusters());
+  std::string error;
+  const bool valid = Validate(bootstrap, &error);
+  listeners.Swap(static_resources.mutable_listeners());
+  clusters.Swap(static_resources.mutable_clusters());
+  if (!valid) {
+    throw ProtoValidationException(error, bootstrap);
+  }
+
+  // Threads take resources one at a time. Errors are kept by resource, so that the one reported is
+  // that of the first invalid resource however the work was split.
+  std::atomic<size_t> next_resource{0};
+  std::vector<std::string> errors(num_resources);
+  std::vector<Thread::ThreadPtr> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.push_back(thread_factory.createThread([&]() {
+      for (size_t j = next_resource++; j < num_resources; j = next_resource++) {
+        if (j < num_listeners) {
+          Validate(static_resources.listeners(j), &errors[j]);
+        } else {
+          Validate(static_resources.clusters(j - num_listeners), &errors[j]);
+        }
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  for (size_t j = 0; j < num_listeners; j++) {
+    if (!errors[j].empty()) {
+      throw ProtoValidationException(errors[j], static_resources.listeners(j));
+    }
+  }
+  for (size_t j = num_listeners; j < num_resources; j++) {
+    if (!errors[j].empty()) {
+      throw ProtoValidationException(errors[j], static_resources.clusters(j - num_listeners));
+    }
+  }
+}
+
 void InstanceImpl::initialize(const Options& options,
                               Network::Address::InstanceConstSharedPtr local_address,
                               ComponentFactory& component_factory) {
@@ -223,9 +296,19 @@ void InstanceImpl::initialize(const Options& options,
             Registry::FactoryRegistry<
                 Configuration::UpstreamTransportSocketConfigFactory>::allFactoryNames());
 
+  // Records the time since the previous phase ended as the given phase.
+  MonotonicTime phase_start = time_source_.monotonicTime();
+  const auto end_phase = [this, &phase_start](const std::string& name) {
+    const MonotonicTime now = time_source_.monotonicTime();
+    recordStartupPhase(name,
+                       std::chrono::duration_cast<std::chrono::microseconds>(now - phase_start));
+    phase_start = now;
+  };
+
   // Handle configuration that needs to take place prior to the main configuration load.
   InstanceUtil::loadBootstrapConfig(bootstrap_, options, api());
   bootstrap_config_update_time_ = time_source_.systemTime();
+  end_phase("bootstrap");
 
   // Needs to happen as early as possible in the instantiation to preempt the objects that require
   // stats.
@@ -308,16 +391,31 @@ void InstanceImpl::initialize(const Options& options,
   // Once we have runtime we can initialize the SSL context manager.
   ssl_context_manager_ =
       std::make_unique<Extensions::TransportSockets::Tls::ContextManagerImpl>(time_source_);
+  // Take over the upstream TLS sessions of our parent before any clusters are created, so that
+  // their first connections after a hot restart can resume sessions rather than do full
+  // handshakes with every upstream at once.
+  ssl_context_manager_->importClientSessions(restarter_.getParentTlsSessions());
+
+  if (bootstrap_.cluster_manager().has_dns_cache()) {
+    const auto& dns_cache = bootstrap_.cluster_manager().dns_cache();
+    dns_resolver_ = std::make_shared<Network::CachingDnsResolverImpl>(
+        dns_resolver_, time_source_, stats_store_,
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(dns_cache, min_ttl, 0)),
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(dns_cache, max_ttl, 300000)),
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(dns_cache, negative_ttl, 5000)));
+  }
 
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       admin(), runtime(), stats(), threadLocal(), random(), dnsResolver(), sslContextManager(),
       dispatcher(), localInfo(), secretManager(), api(), http_context_, accessLogManager(),
       singletonManager());
 
+  end_phase("server_setup");
+
   // Now the configuration gets parsed. The configuration may start setting
   // thread local data per above. See MainImpl::initialize() for why ConfigImpl
   // is constructed as part of the InstanceImpl and then populated once
-  // cluster_manager_factory_ is available.
+  // cluster_manager_factory_ is available. It records its own startup phases.
   config_.initialize(bootstrap_, *this, *cluster_manager_factory_);
   http_context_.setTracer(config_.httpTracer());
 
@@ -352,9 +450,22 @@ void InstanceImpl::initialize(const Options& options,
   // GuardDog (deadlock detection) object and thread setup before workers are
   // started and before our own run() loop runs.
   guard_dog_ = std::make_unique<Server::GuardDogImpl>(stats_store_, config_, api());
+
+  initialize_end_time_ = time_source_.monotonicTime();
+}
+
+void InstanceImpl::recordStartupPhase(const std::string& name,
+                                      std::chrono::microseconds duration) {
+  ENVOY_LOG(info, "startup phase {} took {}ms", name,
+            std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+  startup_phases_.push_back({name, duration});
 }
 
 void InstanceImpl::startWorkers() {
+  // Warming covers the initialization of clusters and listeners after the configuration is loaded,
+  // e.g. DNS resolution and fetching EDS and RDS.
+  recordStartupPhase("warming", std::chrono::duration_cast<std::chrono::microseconds>(
+                                    time_source_.monotonicTime() - initialize_end_time_));
   listener_manager_->startWorkers(*guard_dog_);
 
   // At this point we are ready to take traffic and all listening ports are up. Notify our parent
@@ -6,6 +6,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/event/timer.h"
 #include "envoy/server/drain_manager.h"
@@ -113,6 +114,17 @@ public:
    */
   static BootstrapVersion loadBootstrapConfig(envoy::config::bootstrap::v2::Bootstrap& bootstrap,
                                               const Options& options, Api::Api& api);
+
+  /**
+   * Validate a bootstrap config. The static listeners and clusters of large configs are validated
+   * on several threads.
+   * @param bootstrap supplies the bootstrap to validate. It is left unchanged.
+   * @param concurrency supplies the maximum number of threads to validate on.
+   * @param thread_factory supplies the factory to create the threads with.
+   * @throw ProtoValidationException if the bootstrap is invalid.
+   */
+  static void validateBootstrap(envoy::config::bootstrap::v2::Bootstrap& bootstrap,
+                                uint32_t concurrency, Thread::ThreadFactory& thread_factory);
 };
 
 /**
@@ -180,6 +192,8 @@ public:
   const Options& options() override { return options_; }
   time_t startTimeCurrentEpoch() override { return start_time_; }
   time_t startTimeFirstEpoch() override { return original_start_time_; }
+  void recordStartupPhase(const std::string& name, std::chrono::microseconds duration) override;
+  const std::vector<StartupPhase>& startupPhases() override { return startup_phases_; }
   Stats::Store& stats() override { return stats_store_; }
   Http::Context& httpContext() override { return http_context_; }
   ThreadLocal::Instance& threadLocal() override { return thread_local_; }
@@ -246,6 +260,9 @@ private:
   Envoy::MutexTracer* mutex_tracer_;
   Http::ContextImpl http_context_;
   std::unique_ptr<Memory::HeapShrinker> heap_shrinker_;
+  std::vector<StartupPhase> startup_phases_;
+  // When initialize() returned, from which the warming phase runs until the workers start.
+  MonotonicTime initialize_end_time_;
 };
 
 } // namespace Server
@@ -60,6 +60,10 @@ public:
 
     ConfigSubscriptionInstanceBase::onConfigUpdate();
   }
+  void onConfigUpdate(const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>&,
+                      const Protobuf::RepeatedPtrField<std::string>&, const std::string&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
 
   // Envoy::Config::SubscriptionCallbacks
   void onConfigUpdateFailed(const EnvoyException*) override {}
@@ -0,0 +1,246 @@
+#include <map>
+#include <memory>
+
+#include "envoy/api/v2/cds.pb.h"
+#include "envoy/api/v2/eds.pb.h"
+
+#include "common/common/hash.h"
+#include "common/config/incremental_subscription_impl.h"
+#include "common/config/resources.h"
+
+#include "test/common/config/subscription_test_harness.h"
+#include "test/mocks/config/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/grpc/mocks.h"
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+typedef IncrementalSubscriptionImpl<envoy::api::v2::ClusterLoadAssignment>
+    IncrementalEdsSubscriptionImpl;
+
+class IncrementalSubscriptionImplTest : public testing::Test, public SubscriptionTestHarness {
+public:
+  IncrementalSubscriptionImplTest()
+      : method_descriptor_(Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
+            "envoy.api.v2.EndpointDiscoveryService.IncrementalEndpoints")),
+        async_client_(new Grpc::MockAsyncClient()), timer_(new Event::MockTimer()) {
+    node_.set_id("fo0");
+    ON_CALL(local_info_, node()).WillByDefault(ReturnRef(node_));
+    EXPECT_CALL(dispatcher_, createTimer_(_)).WillOnce(Invoke([this](Event::TimerCb timer_cb) {
+      timer_cb_ = timer_cb;
+      return timer_;
+    }));
+    subscription_ = std::make_unique<IncrementalEdsSubscriptionImpl>(
+        local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_, random_,
+        *method_descriptor_, stats_, stats_store_, rate_limit_settings_);
+  }
+
+  // SubscriptionTestHarness
+  void startSubscription(const std::vector<std::string>& cluster_names) override {
+    EXPECT_CALL(*async_client_, start(_, _)).WillOnce(Return(&async_stream_));
+    expectInitialRequest(cluster_names, {});
+    subscription_->start(cluster_names, callbacks_);
+  }
+
+  void updateResources(const std::vector<std::string>& cluster_names) override {
+    subscription_->updateResources(cluster_names);
+  }
+
+  void expectSendMessage(const std::vector<std::string>& cluster_names,
+                         const std::string&) override {
+    expectIncrementalRequest(cluster_names, {}, "");
+  }
+
+  void deliverConfigUpdate(const std::vector<std::string>& cluster_names,
+                           const std::string& version, bool accept) override {
+    deliverIncrementalUpdate(cluster_names, {}, version, accept);
+  }
+
+  void expectInitialRequest(const std::vector<std::string>& subscribe,
+                            const std::map<std::string, std::string>& initial_versions) {
+    envoy::api::v2::IncrementalDiscoveryRequest expected_request;
+    expected_request.mutable_node()->CopyFrom(node_);
+    expected_request.set_type_url(Config::TypeUrl::get().ClusterLoadAssignment);
+    for (const auto& name : subscribe) {
+      expected_request.add_resource_names_subscribe(name);
+    }
+    for (const auto& initial_version : initial_versions) {
+      (*expected_request.mutable_initial_resource_versions())[initial_version.first] =
+          initial_version.second;
+    }
+    EXPECT_CALL(async_stream_, sendMessage(ProtoEq(expected_request), false));
+  }
+
+  void expectIncrementalRequest(const std::vector<std::string>& subscribe,
+                                const std::vector<std::string>& unsubscribe,
+                                const std::string& nonce,
+                                const Protobuf::int32 error_code = Grpc::Status::GrpcStatus::Ok,
+                                const std::string& error_message = "") {
+    envoy::api::v2::IncrementalDiscoveryRequest expected_request;
+    expected_request.set_type_url(Config::TypeUrl::get().ClusterLoadAssignment);
+    for (const auto& name : subscribe) {
+      expected_request.add_resource_names_subscribe(name);
+    }
+    for (const auto& name : unsubscribe) {
+      expected_request.add_resource_names_unsubscribe(name);
+    }
+    expected_request.set_response_nonce(nonce);
+    if (error_code != Grpc::Status::GrpcStatus::Ok) {
+      ::google::rpc::Status* error_detail = expected_request.mutable_error_detail();
+      error_detail->set_code(error_code);
+      error_detail->set_message(error_message);
+    }
+    EXPECT_CALL(async_stream_, sendMessage(ProtoEq(expected_request), false));
+  }
+
+  void deliverIncrementalUpdate(const std::vector<std::string>& added,
+                                const std::vector<std::string>& removed,
+                                const std::string& version, bool accept) {
+    auto response = std::make_unique<envoy::api::v2::IncrementalDiscoveryResponse>();
+    response->set_system_version_info(version);
+    const std::string nonce = std::to_string(HashUtil::xxHash64(version));
+    response->set_nonce(nonce);
+    for (const auto& cluster : added) {
+      envoy::api::v2::ClusterLoadAssignment load_assignment;
+      load_assignment.set_cluster_name(cluster);
+      auto* resource = response->add_resources();
+      resource->set_version(version);
+      resource->mutable_resource()->PackFrom(load_assignment);
+    }
+    for (const auto& cluster : removed) {
+      response->add_removed_resources(cluster);
+    }
+    EXPECT_CALL(callbacks_, onConfigUpdate(_, _, version))
+        .WillOnce(Invoke([added, removed, accept](
+                             const Protobuf::RepeatedPtrField<envoy::api::v2::Resource>& resources,
+                             const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                             const std::string&) {
+          EXPECT_EQ(added.size(), static_cast<size_t>(resources.size()));
+          EXPECT_EQ(removed, std::vector<std::string>(removed_resources.begin(),
+                                                      removed_resources.end()));
+          if (!accept) {
+            throw EnvoyException("bad config");
+          }
+        }));
+    if (accept) {
+      expectIncrementalRequest({}, {}, nonce);
+    } else {
+      EXPECT_CALL(callbacks_, onConfigUpdateFailed(_));
+      expectIncrementalRequest({}, {}, nonce, Grpc::Status::GrpcStatus::Internal, "bad config");
+    }
+    subscription_->onReceiveMessage(std::move(response));
+  }
+
+  const Protobuf::MethodDescriptor* method_descriptor_;
+  Grpc::MockAsyncClient* async_client_;
+  Event::MockDispatcher dispatcher_;
+  Runtime::MockRandomGenerator random_;
+  Event::MockTimer* timer_;
+  Event::TimerCb timer_cb_;
+  envoy::api::v2::core::Node node_;
+  NiceMock<Config::MockSubscriptionCallbacks<envoy::api::v2::ClusterLoadAssignment>> callbacks_;
+  Grpc::MockAsyncStream async_stream_;
+  NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  Envoy::Config::RateLimitSettings rate_limit_settings_;
+  std::unique_ptr<IncrementalEdsSubscriptionImpl> subscription_;
+};
+
+// Validate that stream creation results in a timer based retry and can recover.
+TEST_F(IncrementalSubscriptionImplTest, StreamCreationFailure) {
+  InSequence s;
+  EXPECT_CALL(*async_client_, start(_, _)).WillOnce(Return(nullptr));
+  EXPECT_CALL(callbacks_, onConfigUpdateFailed(_));
+  EXPECT_CALL(random_, random());
+  EXPECT_CALL(*timer_, enableTimer(_));
+  subscription_->start({"cluster0", "cluster1"}, callbacks_);
+  verifyStats(2, 0, 0, 1, 0);
+
+  // Retry and succeed.
+  EXPECT_CALL(*async_client_, start(_, _)).WillOnce(Return(&async_stream_));
+  expectInitialRequest({"cluster0", "cluster1"}, {});
+  timer_cb_();
+  verifyControlPlaneStats(1);
+}
+
+// Validate that only the added and removed resources are delivered, and that updates are ACKed
+// with just the nonce.
+TEST_F(IncrementalSubscriptionImplTest, DeltaUpdates) {
+  InSequence s;
+  startSubscription({});
+  deliverIncrementalUpdate({"cluster0", "cluster1"}, {}, "v1", true);
+  verifyStats(2, 1, 0, 0, HashUtil::xxHash64("v1"));
+  deliverIncrementalUpdate({"cluster2"}, {"cluster0"}, "v2", true);
+  verifyStats(3, 2, 0, 0, HashUtil::xxHash64("v2"));
+}
+
+// Validate that a rejected update is NACKed with the error detail.
+TEST_F(IncrementalSubscriptionImplTest, RejectedUpdate) {
+  InSequence s;
+  startSubscription({"cluster0"});
+  deliverIncrementalUpdate({"cluster0"}, {}, "v1", false);
+  verifyStats(2, 0, 1, 0, 0);
+}
+
+// Validate that resources of the wrong type are rejected before reaching the callbacks.
+TEST_F(IncrementalSubscriptionImplTest, WrongTypeUrl) {
+  InSequence s;
+  startSubscription({});
+  auto response = std::make_unique<envoy::api::v2::IncrementalDiscoveryResponse>();
+  response->set_nonce("nonce");
+  response->add_resources()->mutable_resource()->PackFrom(envoy::api::v2::Cluster());
+  EXPECT_CALL(callbacks_, onConfigUpdateFailed(_));
+  expectIncrementalRequest(
+      {}, {}, "nonce", Grpc::Status::GrpcStatus::Internal,
+      fmt::format("{} does not match {} type URL in incremental response",
+                  Config::TypeUrl::get().Cluster, Config::TypeUrl::get().ClusterLoadAssignment));
+  subscription_->onReceiveMessage(std::move(response));
+  verifyStats(2, 0, 1, 0, 0);
+}
+
+// Validate that changing the set of resources only sends the difference.
+TEST_F(IncrementalSubscriptionImplTest, UpdateResources) {
+  InSequence s;
+  startSubscription({"cluster0", "cluster1"});
+  expectIncrementalRequest({"cluster2"}, {"cluster0"}, "");
+  updateResources({"cluster1", "cluster2"});
+  // No request is sent when nothing changed.
+  updateResources({"cluster2", "cluster1"});
+}
+
+// Validate that after a reconnect the versions of held resources are reported, so the management
+// server need not resend them.
+TEST_F(IncrementalSubscriptionImplTest, ReconnectReportsVersions) {
+  InSequence s;
+  startSubscription({"cluster0", "cluster1"});
+  deliverIncrementalUpdate({"cluster0", "cluster1"}, {}, "v1", true);
+  deliverIncrementalUpdate({}, {"cluster1"}, "v2", true);
+
+  EXPECT_CALL(callbacks_, onConfigUpdateFailed(_));
+  EXPECT_CALL(random_, random());
+  EXPECT_CALL(*timer_, enableTimer(_));
+  subscription_->onRemoteClose(Grpc::Status::GrpcStatus::Canceled, "");
+  verifyControlPlaneStats(0);
+
+  EXPECT_CALL(*async_client_, start(_, _)).WillOnce(Return(&async_stream_));
+  expectInitialRequest({"cluster0", "cluster1"}, {{"cluster0", "v1"}});
+  timer_cb_();
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
@@ -36,7 +36,8 @@ public:
     return SubscriptionFactory::subscriptionFromConfigSource<envoy::api::v2::ClusterLoadAssignment>(
         config, local_info_, dispatcher_, cm_, random_, stats_store_,
         "envoy.api.v2.EndpointDiscoveryService.FetchEndpoints",
-        "envoy.api.v2.EndpointDiscoveryService.StreamEndpoints", *api_);
+        "envoy.api.v2.EndpointDiscoveryService.StreamEndpoints", *api_,
+        "envoy.api.v2.EndpointDiscoveryService.IncrementalEndpoints");
   }
 
   Upstream::MockClusterManager cm_;
@@ -304,6 +305,50 @@ TEST_F(SubscriptionFactoryTest, GrpcSubscription) {
   subscriptionFromConfigSource(config)->start({"static_cluster"}, callbacks_);
 }
 
+TEST_F(SubscriptionFactoryTest, IncrementalGrpcSubscription) {
+  envoy::api::v2::core::ConfigSource config;
+  auto* api_config_source = config.mutable_api_config_source();
+  api_config_source->set_api_type(envoy::api::v2::core::ApiConfigSource::INCREMENTAL_GRPC);
+  api_config_source->add_grpc_services()->mutable_envoy_grpc()->set_cluster_name("static_cluster");
+  envoy::api::v2::core::GrpcService expected_grpc_service;
+  expected_grpc_service.mutable_envoy_grpc()->set_cluster_name("static_cluster");
+  Upstream::ClusterManager::ClusterInfoMap cluster_map;
+  NiceMock<Upstream::MockClusterMockPrioritySet> cluster;
+  cluster_map.emplace("static_cluster", cluster);
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(cluster_map));
+  EXPECT_CALL(cm_, grpcAsyncClientManager()).WillOnce(ReturnRef(cm_.async_client_manager_));
+  EXPECT_CALL(cm_.async_client_manager_,
+              factoryForGrpcService(ProtoEq(expected_grpc_service), _, _))
+      .WillOnce(Invoke([](const envoy::api::v2::core::GrpcService&, Stats::Scope&, bool) {
+        auto async_client_factory = std::make_unique<Grpc::MockAsyncClientFactory>();
+        EXPECT_CALL(*async_client_factory, create()).WillOnce(Invoke([] {
+          return std::make_unique<NiceMock<Grpc::MockAsyncClient>>();
+        }));
+        return async_client_factory;
+      }));
+  EXPECT_CALL(random_, random());
+  EXPECT_CALL(dispatcher_, createTimer_(_));
+  EXPECT_CALL(callbacks_, onConfigUpdateFailed(_));
+  subscriptionFromConfigSource(config)->start({"static_cluster"}, callbacks_);
+}
+
+TEST_F(SubscriptionFactoryTest, IncrementalGrpcUnsupported) {
+  envoy::api::v2::core::ConfigSource config;
+  auto* api_config_source = config.mutable_api_config_source();
+  api_config_source->set_api_type(envoy::api::v2::core::ApiConfigSource::INCREMENTAL_GRPC);
+  api_config_source->add_grpc_services()->mutable_envoy_grpc()->set_cluster_name("static_cluster");
+  Upstream::ClusterManager::ClusterInfoMap cluster_map;
+  NiceMock<Upstream::MockClusterMockPrioritySet> cluster;
+  cluster_map.emplace("static_cluster", cluster);
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(cluster_map));
+  EXPECT_THROW_WITH_REGEX(
+      SubscriptionFactory::subscriptionFromConfigSource<envoy::api::v2::ClusterLoadAssignment>(
+          config, local_info_, dispatcher_, cm_, random_, stats_store_,
+          "envoy.api.v2.EndpointDiscoveryService.FetchEndpoints",
+          "envoy.api.v2.EndpointDiscoveryService.StreamEndpoints", *api_),
+      EnvoyException, "INCREMENTAL_GRPC is not supported for this xDS API");
+}
+
 INSTANTIATE_TEST_SUITE_P(SubscriptionFactoryTestApiConfigSource,
                          SubscriptionFactoryTestApiConfigSource,
                          ::testing::Values(envoy::api::v2::core::ApiConfigSource::REST,
@@ -0,0 +1,150 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <cstdint>
+#include <memory>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+
+#include "extensions/filters/http/common/pass_through_filter.h"
+
+#include "test/common/http/conn_manager_speed_test_base.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/router/mocks.h"
+#include "test/test_common/allocation_counter.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+
+// Responds to every request, in place of the router ending the filter chain.
+class ResponderFilter : public PassThroughDecoderFilter {
+public:
+  FilterHeadersStatus decodeHeaders(HeaderMap&, bool) override {
+    decoder_callbacks_->encodeHeaders(
+        HeaderMapPtr{new HeaderMapImpl{{Headers::get().Status, "200"}}}, true);
+    return FilterHeadersStatus::StopIteration;
+  }
+};
+
+// Creates a chain of pass-through filters ended by the responder.
+class PassThroughFilterChainFactory : public FilterChainFactory {
+public:
+  explicit PassThroughFilterChainFactory(uint32_t filters) : filters_(filters) {}
+
+  // Http::FilterChainFactory
+  void createFilterChain(FilterChainFactoryCallbacks& callbacks) override {
+    for (uint32_t i = 1; i < filters_; i++) {
+      callbacks.addStreamFilter(std::make_shared<PassThroughFilter>());
+    }
+    callbacks.addStreamDecoderFilter(std::make_shared<ResponderFilter>());
+  }
+  bool createUpgradeFilterChain(absl::string_view, const UpgradeMap*,
+                                FilterChainFactoryCallbacks&) override {
+    return false;
+  }
+
+private:
+  const uint32_t filters_;
+};
+
+// The codec stream of the requests, without the cost of a mock on every request.
+class NullStream : public Stream {
+public:
+  // Http::Stream
+  void addCallbacks(StreamCallbacks&) override {}
+  void removeCallbacks(StreamCallbacks&) override {}
+  void resetStream(StreamResetReason) override {}
+  void readDisable(bool) override {}
+  uint32_t bufferLimit() override { return 0; }
+};
+
+class NullStreamEncoder : public StreamEncoder {
+public:
+  // Http::StreamEncoder
+  void encode100ContinueHeaders(const HeaderMap&) override {}
+  void encodeHeaders(const HeaderMap&, bool) override {}
+  void encodeData(Buffer::Instance&, bool) override {}
+  void encodeTrailers(const HeaderMap&) override {}
+  void encodeMetadata(const MetadataMapVector&) override {}
+  Stream& getStream() override { return stream_; }
+
+private:
+  NullStream stream_;
+};
+
+/**
+ * Sends header-only requests through a connection manager, with a filter chain of a given length
+ * answering them. The codec is a mock.
+ */
+class ConnectionManagerSpeedTest : public ConnectionManagerSpeedTestBase {
+public:
+  explicit ConnectionManagerSpeedTest(uint32_t filters)
+      : codec_(new NiceMock<MockServerConnection>()), filter_factory_(filters) {
+    initialize(filter_factory_, std::make_shared<NiceMock<Router::MockConfig>>(),
+               [this](Network::Connection&, ServerConnectionCallbacks&) {
+                 return ServerConnectionPtr{codec_};
+               },
+               false);
+
+    ON_CALL(*codec_, dispatch(_)).WillByDefault(Invoke([this](Buffer::Instance&) -> void {
+      StreamDecoder& decoder = conn_manager_->newStream(response_encoder_);
+      decoder.decodeHeaders(HeaderMapPtr{new HeaderMapImpl{{Headers::get().Host, "host"},
+                                                           {Headers::get().Path, "/"},
+                                                           {Headers::get().Method, "GET"}}},
+                            true);
+    }));
+  }
+
+  ~ConnectionManagerSpeedTest() { filter_callbacks_.connection_.dispatcher_.to_delete_.clear(); }
+
+  // Sends a request, which is answered by the end of the filter chain.
+  void request() {
+    conn_manager_->onData(input_, false);
+    // Destroy the stream, as the dispatcher would at the end of the event loop iteration.
+    filter_callbacks_.connection_.dispatcher_.to_delete_.clear();
+  }
+
+private:
+  MockServerConnection* codec_;
+  PassThroughFilterChainFactory filter_factory_;
+  NullStreamEncoder response_encoder_;
+  Buffer::OwnedImpl input_;
+};
+
+} // namespace Http
+} // namespace Envoy
+
+// Measures header-only requests through a chain of state.range(0) filters. The allocations of a
+// request are reported when they can be counted, and include those of the mocks.
+static void BM_HeaderOnlyRequest(benchmark::State& state) {
+  Envoy::Http::ConnectionManagerSpeedTest context(state.range(0));
+  // The first request creates the codec, and sizes the filter chain of the following ones.
+  context.request();
+
+  Envoy::Memory::TestUtil::AllocationCounter allocation_counter;
+  for (auto _ : state) {
+    context.request();
+  }
+  if (Envoy::Memory::TestUtil::AllocationCounter::supported()) {
+    state.counters["allocations_per_request"] =
+        static_cast<double>(allocation_counter.allocations()) / state.iterations();
+  }
+}
+BENCHMARK(BM_HeaderOnlyRequest)->Arg(1)->Arg(10);
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,414 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/config/filter/network/http_connection_manager/v2/http_connection_manager.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/filter_timing.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/http/http2/codec_impl.h"
+#include "common/protobuf/utility.h"
+#include "common/router/config_impl.h"
+
+#include "extensions/filters/network/http_connection_manager/config.h"
+
+#include "test/common/http/conn_manager_speed_test_base.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/router/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/allocation_counter.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// Makes the data written to a connection available to the codec at the other end, in a buffer.
+void writeTo(Network::MockConnection& connection, Buffer::Instance& buffer) {
+  ON_CALL(connection, write(_, _))
+      .WillByDefault(
+          Invoke([&buffer](Buffer::Instance& data, bool) -> void { buffer.move(data); }));
+}
+
+ClientConnectionPtr createClientCodec(Protocol protocol, Network::Connection& connection,
+                                      ConnectionCallbacks& callbacks, Stats::Scope& scope) {
+  if (protocol == Protocol::Http2) {
+    return std::make_unique<Http2::ClientConnectionImpl>(connection, callbacks, scope,
+                                                         Http2Settings(),
+                                                         DEFAULT_MAX_REQUEST_HEADERS_KB);
+  }
+  return std::make_unique<Http1::ClientConnectionImpl>(connection, callbacks);
+}
+
+ServerConnectionPtr createServerCodec(Protocol protocol, Network::Connection& connection,
+                                      ServerConnectionCallbacks& callbacks, Stats::Scope& scope) {
+  if (protocol == Protocol::Http2) {
+    return std::make_unique<Http2::ServerConnectionImpl>(connection, callbacks, scope,
+                                                         Http2Settings(),
+                                                         DEFAULT_MAX_REQUEST_HEADERS_KB);
+  }
+  return std::make_unique<Http1::ServerConnectionImpl>(connection, callbacks, Http1Settings());
+}
+
+} // namespace
+
+// Counts the complete responses received by the downstream client.
+class ResponseCounter : public StreamDecoder, public ConnectionCallbacks {
+public:
+  // Http::StreamDecoder
+  void decode100ContinueHeaders(HeaderMapPtr&&) override {}
+  void decodeHeaders(HeaderMapPtr&&, bool end_stream) override { onDecoded(end_stream); }
+  void decodeData(Buffer::Instance&, bool end_stream) override { onDecoded(end_stream); }
+  void decodeTrailers(HeaderMapPtr&&) override { onDecoded(true); }
+  void decodeMetadata(MetadataMapPtr&&) override {}
+
+  // Http::ConnectionCallbacks
+  void onGoAway() override {}
+
+  uint64_t responses_{};
+
+private:
+  void onDecoded(bool end_stream) {
+    if (end_stream) {
+      responses_++;
+    }
+  }
+};
+
+// Answers every complete request with a header-only response. Requests are sent one at a time, so
+// a single decoder serves all the streams of the upstream connection.
+class UpstreamResponder : public ServerConnectionCallbacks, public StreamDecoder {
+public:
+  // Http::ServerConnectionCallbacks
+  StreamDecoder& newStream(StreamEncoder& response_encoder, bool) override {
+    response_encoder_ = &response_encoder;
+    return *this;
+  }
+  void onGoAway() override {}
+
+  // Http::StreamDecoder
+  void decode100ContinueHeaders(HeaderMapPtr&&) override {}
+  void decodeHeaders(HeaderMapPtr&&, bool end_stream) override { onDecoded(end_stream); }
+  void decodeData(Buffer::Instance&, bool end_stream) override { onDecoded(end_stream); }
+  void decodeTrailers(HeaderMapPtr&&) override { onDecoded(true); }
+  void decodeMetadata(MetadataMapPtr&&) override {}
+
+private:
+  void onDecoded(bool end_stream) {
+    if (end_stream) {
+      response_encoder_->encodeHeaders(response_headers_, true);
+    }
+  }
+
+  StreamEncoder* response_encoder_{};
+  const HeaderMapImpl response_headers_{{Headers::get().Status, "200"}};
+};
+
+/**
+ * The connection pool of the upstream cluster, in place of a real one. Its single connection is a
+ * client codec connected in memory to the server codec of the upstream, which answers requests.
+ */
+class FakeUpstream : public ConnectionPool::Instance, public ConnectionCallbacks {
+public:
+  FakeUpstream(Protocol protocol, Stats::Scope& scope) : protocol_(protocol) {
+    writeTo(client_connection_, to_server_);
+    writeTo(server_connection_, to_client_);
+    client_ = createClientCodec(protocol, client_connection_, *this, scope);
+    server_ = createServerCodec(protocol, server_connection_, responder_, scope);
+  }
+
+  /**
+   * Delivers the data written by each codec to the other one.
+   * @return bool whether there was data to deliver.
+   */
+  bool dispatch() {
+    bool dispatched = false;
+    if (to_server_.length() > 0) {
+      server_->dispatch(to_server_);
+      dispatched = true;
+    }
+    if (to_client_.length() > 0) {
+      client_->dispatch(to_client_);
+      dispatched = true;
+    }
+    return dispatched;
+  }
+
+  void clearDeferredDeleteList() {
+    client_connection_.dispatcher_.to_delete_.clear();
+    server_connection_.dispatcher_.to_delete_.clear();
+  }
+
+  // Http::ConnectionPool::Instance
+  Protocol protocol() const override { return protocol_; }
+  void addDrainedCallback(DrainedCb) override {}
+  void drainConnections() override {}
+  bool hasActiveConnections() const override { return true; }
+  ConnectionPool::Cancellable* newStream(StreamDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) override {
+    callbacks.onPoolReady(client_->newStream(response_decoder), host_);
+    return nullptr;
+  }
+
+  // Http::ConnectionCallbacks
+  void onGoAway() override {}
+
+private:
+  const Protocol protocol_;
+  NiceMock<Network::MockConnection> client_connection_;
+  NiceMock<Network::MockConnection> server_connection_;
+  Buffer::OwnedImpl to_server_;
+  Buffer::OwnedImpl to_client_;
+  UpstreamResponder responder_;
+  ClientConnectionPtr client_;
+  ServerConnectionPtr server_;
+  std::shared_ptr<NiceMock<Upstream::MockHostDescription>> host_{
+      new NiceMock<Upstream::MockHostDescription>()};
+};
+
+// Sums the time spent in each filter by the requests, from the dynamic metadata of their streams.
+class FilterTimeCounter : public AccessLog::Instance {
+public:
+  // AccessLog::Instance
+  void log(const HeaderMap*, const HeaderMap*, const HeaderMap*,
+           const StreamInfo::StreamInfo& stream_info) override {
+    const auto& filter_metadata = stream_info.dynamicMetadata().filter_metadata();
+    const auto filter_timing = filter_metadata.find(FilterTiming::dynamicMetadataNamespace());
+    if (filter_timing == filter_metadata.end()) {
+      return;
+    }
+    for (const auto& filter : filter_timing->second.fields()) {
+      for (const auto& time : filter.second.struct_value().fields()) {
+        filter_times_us_[filter.first] += time.second.number_value();
+      }
+    }
+  }
+
+  // The total time spent in each filter, keyed by <chain>.<index>.<filter_name>.
+  std::map<std::string, double> filter_times_us_;
+};
+
+/**
+ * Proxies header-only requests from a downstream client to a fake upstream, through a connection
+ * manager with the HTTP filters of an HttpConnectionManager configuration. The filter chains are
+ * created by the production HttpConnectionManagerConfig, with every request timed by filter
+ * timing so that the time spent in each filter can be reported. The codecs, the connection
+ * manager and the route table are the production ones, and the connections between the codecs
+ * are buffers. The cluster manager and the network connections are mocks, so their costs are
+ * included in the results.
+ */
+class ConnectionManagerRouterSpeedTest : public ConnectionManagerSpeedTestBase {
+public:
+  /**
+   * @param protocol supplies the protocol of the downstream and upstream connections.
+   * @param http_filters supplies the http_filters of the HttpConnectionManager configuration, in
+   *        YAML.
+   */
+  ConnectionManagerRouterSpeedTest(Protocol protocol, const std::string& http_filters)
+      : filter_time_counter_(std::make_shared<FilterTimeCounter>()),
+        filter_factory_(createConnectionManagerConfig(http_filters, factory_context_,
+                                                      date_provider_,
+                                                      route_config_provider_manager_)),
+        upstream_(protocol, fake_stats_),
+        request_headers_{{Headers::get().Method, "GET"},
+                         {Headers::get().Path, "/"},
+                         {Headers::get().Host, "host"},
+                         {Headers::get().Scheme, "http"}} {
+    ON_CALL(factory_context_.cluster_manager_, httpConnPoolForCluster(_, _, _, _))
+        .WillByDefault(Return(&upstream_));
+    ON_CALL(factory_context_.runtime_loader_.snapshot_,
+            featureEnabled("http_connection_manager.filter_timing_sampling", _, _, _))
+        .WillByDefault(Return(true));
+    access_logs_.push_back(filter_time_counter_);
+
+    writeTo(client_connection_, to_server_);
+    writeTo(filter_callbacks_.connection_, to_client_);
+    initialize(*filter_factory_, createRouteConfig(factory_context_),
+               [this, protocol](Network::Connection& connection,
+                                ServerConnectionCallbacks& callbacks) {
+                 return createServerCodec(protocol, connection, callbacks, fake_stats_);
+               },
+               true);
+    client_ = createClientCodec(protocol, client_connection_, response_counter_, fake_stats_);
+  }
+
+  ~ConnectionManagerRouterSpeedTest() { clearDeferredDeleteList(); }
+
+  /**
+   * Sends a request and delivers the data between the codecs until nothing is left to deliver.
+   * @return bool whether the response to the request was received.
+   */
+  bool request() {
+    const uint64_t responses = response_counter_.responses_;
+    client_->newStream(response_counter_).encodeHeaders(request_headers_, true);
+    while (dispatch()) {
+    }
+    // Destroy the streams, as the dispatchers would at the end of the event loop iteration.
+    clearDeferredDeleteList();
+    return response_counter_.responses_ == responses + 1;
+  }
+
+  // The total time spent in each filter by the requests, in microseconds.
+  std::map<std::string, double>& filterTimesUs() { return filter_time_counter_->filter_times_us_; }
+
+private:
+  static std::unique_ptr<Extensions::NetworkFilters::HttpConnectionManager::
+                             HttpConnectionManagerConfig>
+  createConnectionManagerConfig(const std::string& http_filters,
+                                Server::Configuration::FactoryContext& factory_context,
+                                DateProvider& date_provider,
+                                Router::RouteConfigProviderManager& route_config_provider_manager) {
+    const std::string yaml = absl::StrCat(R"EOF(
+stat_prefix: speed_test
+route_config:
+  name: speed_test
+filter_timing:
+  sampling:
+    value: 100
+  record_in_dynamic_metadata: true
+http_filters:
+)EOF",
+                                          http_filters);
+    envoy::config::filter::network::http_connection_manager::v2::HttpConnectionManager config;
+    MessageUtil::loadFromYaml(yaml, config);
+    return std::make_unique<
+        Extensions::NetworkFilters::HttpConnectionManager::HttpConnectionManagerConfig>(
+        config, factory_context, date_provider, route_config_provider_manager);
+  }
+
+  static Router::ConfigConstSharedPtr
+  createRouteConfig(Server::Configuration::FactoryContext& factory_context) {
+    const std::string yaml = R"EOF(
+virtual_hosts:
+- name: speed_test
+  domains: ["*"]
+  routes:
+  - match: { prefix: "/" }
+    route: { cluster: speed_test }
+)EOF";
+    envoy::api::v2::RouteConfiguration route_config;
+    MessageUtil::loadFromYaml(yaml, route_config);
+    return std::make_shared<Router::ConfigImpl>(route_config, factory_context, false);
+  }
+
+  // Delivers the data written by each codec to the other end of its connection.
+  bool dispatch() {
+    bool dispatched = false;
+    if (to_server_.length() > 0) {
+      conn_manager_->onData(to_server_, false);
+      dispatched = true;
+    }
+    if (upstream_.dispatch()) {
+      dispatched = true;
+    }
+    if (to_client_.length() > 0) {
+      client_->dispatch(to_client_);
+      dispatched = true;
+    }
+    return dispatched;
+  }
+
+  void clearDeferredDeleteList() {
+    filter_callbacks_.connection_.dispatcher_.to_delete_.clear();
+    client_connection_.dispatcher_.to_delete_.clear();
+    upstream_.clearDeferredDeleteList();
+  }
+
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context_;
+  NiceMock<Router::MockRouteConfigProviderManager> route_config_provider_manager_;
+  const std::shared_ptr<FilterTimeCounter> filter_time_counter_;
+  std::unique_ptr<FilterChainFactory> filter_factory_;
+  FakeUpstream upstream_;
+  const HeaderMapImpl request_headers_;
+  // The client end of the downstream connection, whose other end is filter_callbacks_.
+  NiceMock<Network::MockConnection> client_connection_;
+  Buffer::OwnedImpl to_server_;
+  Buffer::OwnedImpl to_client_;
+  ResponseCounter response_counter_;
+  ClientConnectionPtr client_;
+};
+
+// The http_filters of the benchmarked filter chains: the router alone, and filters common in
+// front of it, which a header-only request without CORS, gRPC-Web or compression passes through.
+const char* const FilterChains[] = {R"EOF(
+- name: envoy.router
+)EOF",
+                                    R"EOF(
+- name: envoy.cors
+- name: envoy.grpc_web
+- name: envoy.buffer
+  config: { max_request_bytes: 1048576 }
+- name: envoy.gzip
+- name: envoy.router
+)EOF"};
+
+} // namespace Http
+} // namespace Envoy
+
+// Measures header-only requests proxied with protocol state.range(0) through the filter chain
+// state.range(1) of FilterChains. Reports the request rate, the allocations of a request when
+// they can be counted, and the time a request spends in each filter in nanoseconds. Every request
+// is timed by filter timing, whose cost is included in the request rate and the allocations.
+static void BM_ProxyHeaderOnlyRequest(benchmark::State& state) {
+  const Envoy::Http::Protocol protocol = state.range(0) == 2 ? Envoy::Http::Protocol::Http2
+                                                             : Envoy::Http::Protocol::Http11;
+  Envoy::Http::ConnectionManagerRouterSpeedTest context(protocol,
+                                                        Envoy::Http::FilterChains[state.range(1)]);
+  // The first request sets up the codecs and sizes the filter chain of the following ones.
+  if (!context.request()) {
+    state.SkipWithError("no response received");
+    return;
+  }
+  context.filterTimesUs().clear();
+
+  Envoy::Memory::TestUtil::AllocationCounter allocation_counter;
+  for (auto _ : state) {
+    if (!context.request()) {
+      state.SkipWithError("no response received");
+      return;
+    }
+  }
+  const uint64_t allocations = allocation_counter.allocations();
+
+  state.counters["requests_per_second"] =
+      benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+  if (Envoy::Memory::TestUtil::AllocationCounter::supported()) {
+    state.counters["allocations_per_request"] =
+        static_cast<double>(allocations) / state.iterations();
+  }
+  for (const auto& filter_time : context.filterTimesUs()) {
+    state.counters[absl::StrCat(filter_time.first, ".ns")] =
+        filter_time.second * 1000 / state.iterations();
+  }
+}
+BENCHMARK(BM_ProxyHeaderOnlyRequest)
+    ->ArgNames({"http", "filter_chain"})
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({2, 0})
+    ->Args({2, 1});
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,36 @@
+#include "test/common/http/conn_manager_speed_test_base.h"
+
+namespace Envoy {
+namespace Http {
+
+ConnectionManagerSpeedTestBase::ConnectionManagerSpeedTestBase()
+    : route_config_provider_(test_time_.timeSystem()),
+      stats_{{ALL_HTTP_CONN_MAN_STATS(POOL_COUNTER(fake_stats_), POOL_GAUGE(fake_stats_),
+                                      POOL_HISTOGRAM(fake_stats_))},
+             "",
+             fake_stats_},
+      tracing_stats_{CONN_MAN_TRACING_STATS(POOL_COUNTER(fake_stats_))},
+      listener_stats_{CONN_MAN_LISTENER_STATS(POOL_COUNTER(fake_listener_stats_))} {
+  http_context_.setTracer(tracer_);
+  filter_callbacks_.connection_.local_address_ =
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1");
+  filter_callbacks_.connection_.remote_address_ =
+      std::make_shared<Network::Address::Ipv4Instance>("0.0.0.0");
+}
+
+void ConnectionManagerSpeedTestBase::initialize(FilterChainFactory& filter_factory,
+                                                Router::ConfigConstSharedPtr route_config,
+                                                CodecFactory codec_factory,
+                                                bool generate_request_id) {
+  filter_factory_ = &filter_factory;
+  route_config_provider_.route_config_ = std::move(route_config);
+  codec_factory_ = std::move(codec_factory);
+  generate_request_id_ = generate_request_id;
+  conn_manager_ = std::make_unique<ConnectionManagerImpl>(
+      *this, drain_close_, random_, http_context_, runtime_, local_info_, cluster_manager_,
+      &overload_manager_, test_time_.timeSystem());
+  conn_manager_->initializeReadFilterCallbacks(filter_callbacks_);
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/empty_string.h"
+#include "common/http/conn_manager_impl.h"
+#include "common/http/context_impl.h"
+#include "common/http/date_provider_impl.h"
+#include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/tracing/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/test_time.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * The configuration and the dependencies of a connection manager under benchmark. The benchmark
+ * supplies the filter chains, the routes and the codec of the downstream connection, and the rest
+ * of the configuration is the default one. The network connection and the cluster manager are
+ * mocks.
+ */
+class ConnectionManagerSpeedTestBase : public ConnectionManagerConfig {
+public:
+  // Creates the codec of the downstream connection.
+  using CodecFactory =
+      std::function<ServerConnectionPtr(Network::Connection&, ServerConnectionCallbacks&)>;
+
+  // Http::ConnectionManagerConfig
+  const std::list<AccessLog::InstanceSharedPtr>& accessLogs() override { return access_logs_; }
+  ServerConnectionPtr createCodec(Network::Connection& connection, const Buffer::Instance&,
+                                  ServerConnectionCallbacks& callbacks) override {
+    return codec_factory_(connection, callbacks);
+  }
+  DateProvider& dateProvider() override { return date_provider_; }
+  std::chrono::milliseconds drainTimeout() override { return std::chrono::milliseconds(100); }
+  FilterChainFactory& filterFactory() override { return *filter_factory_; }
+  bool generateRequestId() override { return generate_request_id_; }
+  uint32_t maxRequestHeadersKb() const override { return DEFAULT_MAX_REQUEST_HEADERS_KB; }
+  absl::optional<std::chrono::milliseconds> idleTimeout() const override { return {}; }
+  std::chrono::milliseconds streamIdleTimeout() const override { return {}; }
+  std::chrono::milliseconds requestTimeout() const override { return {}; }
+  std::chrono::milliseconds delayedCloseTimeout() const override { return {}; }
+  Router::RouteConfigProvider& routeConfigProvider() override { return route_config_provider_; }
+  const std::string& serverName() override { return server_name_; }
+  ConnectionManagerStats& stats() override { return stats_; }
+  ConnectionManagerTracingStats& tracingStats() override { return tracing_stats_; }
+  bool useRemoteAddress() override { return true; }
+  const InternalAddressConfig& internalAddressConfig() const override {
+    return internal_address_config_;
+  }
+  uint32_t xffNumTrustedHops() const override { return 0; }
+  bool skipXffAppend() const override { return false; }
+  const std::string& via() const override { return EMPTY_STRING; }
+  ForwardClientCertType forwardClientCert() override { return ForwardClientCertType::Sanitize; }
+  const std::vector<ClientCertDetailsType>& setCurrentClientCertDetails() const override {
+    return set_current_client_cert_details_;
+  }
+  const Network::Address::Instance& localAddress() override { return local_address_; }
+  const absl::optional<std::string>& userAgent() override { return user_agent_; }
+  const TracingConnectionManagerConfig* tracingConfig() override { return nullptr; }
+  ConnectionManagerListenerStats& listenerStats() override { return listener_stats_; }
+  bool proxy100Continue() const override { return false; }
+  const Http1Settings& http1Settings() const override { return http1_settings_; }
+
+protected:
+  struct RouteConfigProvider : public Router::RouteConfigProvider {
+    RouteConfigProvider(TimeSource& time_source) : time_source_(time_source) {}
+
+    // Router::RouteConfigProvider
+    Router::ConfigConstSharedPtr config() override { return route_config_; }
+    absl::optional<ConfigInfo> configInfo() const override { return {}; }
+    SystemTime lastUpdated() const override { return time_source_.systemTime(); }
+
+    TimeSource& time_source_;
+    Router::ConfigConstSharedPtr route_config_;
+  };
+
+  ConnectionManagerSpeedTestBase();
+
+  /**
+   * Creates the connection manager, reading from the downstream connection of filter_callbacks_.
+   * Called by the benchmark once the filter chain factory is constructed.
+   * @param filter_factory supplies the filter chains of the streams.
+   * @param route_config supplies the routes of the streams.
+   * @param codec_factory creates the codec of the downstream connection.
+   * @param generate_request_id whether the connection manager generates request IDs.
+   */
+  void initialize(FilterChainFactory& filter_factory, Router::ConfigConstSharedPtr route_config,
+                  CodecFactory codec_factory, bool generate_request_id);
+
+  DangerousDeprecatedTestTime test_time_;
+  RouteConfigProvider route_config_provider_;
+  testing::NiceMock<Tracing::MockHttpTracer> tracer_;
+  ContextImpl http_context_;
+  testing::NiceMock<Runtime::MockLoader> runtime_;
+  testing::NiceMock<Runtime::MockRandomGenerator> random_;
+  testing::NiceMock<LocalInfo::MockLocalInfo> local_info_;
+  testing::NiceMock<Upstream::MockClusterManager> cluster_manager_;
+  testing::NiceMock<Server::MockOverloadManager> overload_manager_;
+  testing::NiceMock<Network::MockDrainDecision> drain_close_;
+  Stats::IsolatedStoreImpl fake_stats_;
+  // The downstream connection of the connection manager.
+  testing::NiceMock<Network::MockReadFilterCallbacks> filter_callbacks_;
+  FilterChainFactory* filter_factory_{};
+  CodecFactory codec_factory_;
+  bool generate_request_id_{};
+  std::list<AccessLog::InstanceSharedPtr> access_logs_;
+  ConnectionManagerStats stats_;
+  ConnectionManagerTracingStats tracing_stats_;
+  Stats::IsolatedStoreImpl fake_listener_stats_;
+  ConnectionManagerListenerStats listener_stats_;
+  SlowDateProviderImpl date_provider_{test_time_.timeSystem()};
+  std::string server_name_{"envoy"};
+  Network::Address::Ipv4Instance local_address_{"127.0.0.1"};
+  DefaultInternalAddressConfig internal_address_config_;
+  std::vector<ClientCertDetailsType> set_current_client_cert_details_;
+  absl::optional<std::string> user_agent_;
+  Http1Settings http1_settings_;
+  std::unique_ptr<ConnectionManagerImpl> conn_manager_;
+};
+
+} // namespace Http
+} // namespace Envoy
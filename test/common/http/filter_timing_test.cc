@@ -0,0 +1,277 @@
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "common/http/filter_timing.h"
+#include "common/http/header_map_impl.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::InvokeWithoutArgs;
+using testing::NiceMock;
+using testing::Property;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class FilterTimingTest : public testing::Test {
+public:
+  FilterTimingTest()
+      : timing_("http.test.", stats_, runtime_, random_, time_system_, 100, true),
+        lua_(timing_.addFilter("http", 0, "envoy.lua")),
+        router_(timing_.addFilter("http", 1, "envoy.router")),
+        timed_callbacks_(callbacks_, timing_) {
+    ON_CALL(callbacks_, addStreamDecoderFilter(_)).WillByDefault(SaveArg<0>(&decoder_filter_));
+    ON_CALL(callbacks_, addStreamEncoderFilter(_)).WillByDefault(SaveArg<0>(&encoder_filter_));
+    ON_CALL(callbacks_, addStreamFilter(_)).WillByDefault(SaveArg<0>(&stream_filter_));
+  }
+
+  // Returns an action advancing the time by the given number of microseconds.
+  auto sleep(uint64_t us) {
+    return InvokeWithoutArgs([this, us]() { time_system_.sleep(std::chrono::microseconds(us)); });
+  }
+
+  NiceMock<Stats::MockStore> stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  Event::SimulatedTimeSystem time_system_;
+  FilterTiming timing_;
+  FilterTiming::Filter& lua_;
+  FilterTiming::Filter& router_;
+  NiceMock<MockFilterChainFactoryCallbacks> callbacks_;
+  TimedFilterChainFactoryCallbacks timed_callbacks_;
+  StreamDecoderFilterSharedPtr decoder_filter_;
+  StreamEncoderFilterSharedPtr encoder_filter_;
+  StreamFilterSharedPtr stream_filter_;
+  NiceMock<MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+  NiceMock<MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  TestHeaderMapImpl headers_;
+};
+
+// Test that the sampling decision follows the runtime key and the configured sampling.
+TEST_F(FilterTimingTest, Sampled) {
+  EXPECT_CALL(random_, random()).WillOnce(Return(42));
+  EXPECT_CALL(runtime_.snapshot_,
+              featureEnabled("http_connection_manager.filter_timing_sampling", 100, 42, 10000))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(timing_.sampled());
+
+  EXPECT_CALL(runtime_.snapshot_,
+              featureEnabled("http_connection_manager.filter_timing_sampling", 100, _, 10000))
+      .WillOnce(Return(false));
+  EXPECT_FALSE(timing_.sampled());
+}
+
+// Test that the time spent in the callbacks of a filter that is both a decoder and an encoder
+// filter is recorded in its histograms and in the dynamic metadata of the stream.
+TEST_F(FilterTimingTest, StreamFilter) {
+  auto filter = std::make_shared<NiceMock<MockStreamFilter>>();
+  timed_callbacks_.setFilter(lua_);
+  timed_callbacks_.addStreamFilter(filter);
+  ASSERT_NE(nullptr, stream_filter_);
+  EXPECT_NE(filter, stream_filter_);
+
+  EXPECT_CALL(*filter, setDecoderFilterCallbacks(_));
+  stream_filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  EXPECT_CALL(*filter, setEncoderFilterCallbacks(_));
+  stream_filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+
+  EXPECT_CALL(*filter, decodeHeaders(_, false))
+      .WillOnce(DoAll(sleep(3), Return(FilterHeadersStatus::Continue)));
+  EXPECT_EQ(FilterHeadersStatus::Continue, stream_filter_->decodeHeaders(headers_, false));
+  EXPECT_CALL(*filter, decodeTrailers(_))
+      .WillOnce(DoAll(sleep(4), Return(FilterTrailersStatus::Continue)));
+  EXPECT_EQ(FilterTrailersStatus::Continue, stream_filter_->decodeTrailers(headers_));
+  EXPECT_CALL(*filter, encodeHeaders(_, true))
+      .WillOnce(DoAll(sleep(5), Return(FilterHeadersStatus::Continue)));
+  EXPECT_EQ(FilterHeadersStatus::Continue, stream_filter_->encodeHeaders(headers_, true));
+
+  EXPECT_CALL(*filter, onDestroy());
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.0.envoy.lua.decode_time_us"),
+                          7));
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.0.envoy.lua.encode_time_us"),
+                          5));
+  ProtobufWkt::Struct metadata;
+  EXPECT_CALL(encoder_callbacks_.stream_info_,
+              setDynamicMetadata(FilterTiming::dynamicMetadataNamespace(), _))
+      .WillOnce(SaveArg<1>(&metadata));
+  stream_filter_->onDestroy();
+
+  const auto& times = metadata.fields().at("http.0.envoy.lua").struct_value().fields();
+  EXPECT_DOUBLE_EQ(7, times.at("decode_time_us").number_value());
+  EXPECT_DOUBLE_EQ(5, times.at("encode_time_us").number_value());
+}
+
+// Test that a decoder filter and an encoder filter only record their own histogram, and that a
+// callback running the callbacks of another filter is not charged for their time.
+TEST_F(FilterTimingTest, NestedCallbacks) {
+  auto decoder_filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  timed_callbacks_.setFilter(router_);
+  timed_callbacks_.addStreamDecoderFilter(decoder_filter);
+  auto encoder_filter = std::make_shared<NiceMock<MockStreamEncoderFilter>>();
+  timed_callbacks_.setFilter(lua_);
+  timed_callbacks_.addStreamEncoderFilter(encoder_filter);
+  ASSERT_NE(nullptr, decoder_filter_);
+  ASSERT_NE(nullptr, encoder_filter_);
+  decoder_filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  encoder_filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+
+  // The decoder filter sends a local reply, which runs the encoder filter.
+  EXPECT_CALL(*encoder_filter, encodeHeaders(_, true))
+      .WillOnce(DoAll(sleep(10), Return(FilterHeadersStatus::Continue)));
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, true))
+      .WillOnce(Invoke([&](HeaderMap&, bool) -> FilterHeadersStatus {
+        time_system_.sleep(std::chrono::microseconds(2));
+        encoder_filter_->encodeHeaders(headers_, true);
+        time_system_.sleep(std::chrono::microseconds(1));
+        return FilterHeadersStatus::StopIteration;
+      }));
+  EXPECT_EQ(FilterHeadersStatus::StopIteration, decoder_filter_->decodeHeaders(headers_, true));
+
+  EXPECT_CALL(*decoder_filter, onDestroy());
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.1.envoy.router.decode_time_us"),
+                          3));
+  decoder_filter_->onDestroy();
+
+  EXPECT_CALL(*encoder_filter, onDestroy());
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.0.envoy.lua.encode_time_us"),
+                          10));
+  encoder_filter_->onDestroy();
+}
+
+// Test that nothing is recorded in the dynamic metadata unless configured.
+TEST_F(FilterTimingTest, NoDynamicMetadata) {
+  FilterTiming timing("http.test.", stats_, runtime_, random_, time_system_, 100, false);
+  TimedFilterChainFactoryCallbacks timed_callbacks(callbacks_, timing);
+  timed_callbacks.setFilter(timing.addFilter("http", 0, "envoy.buffer"));
+  auto filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  timed_callbacks.addStreamDecoderFilter(filter);
+  ASSERT_NE(nullptr, decoder_filter_);
+  decoder_filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+
+  EXPECT_CALL(*filter, decodeHeaders(_, true))
+      .WillOnce(DoAll(sleep(2), Return(FilterHeadersStatus::Continue)));
+  EXPECT_EQ(FilterHeadersStatus::Continue, decoder_filter_->decodeHeaders(headers_, true));
+
+  EXPECT_CALL(decoder_callbacks_.stream_info_, setDynamicMetadata(_, _)).Times(0);
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.0.envoy.buffer.decode_time_us"),
+                          2));
+  decoder_filter_->onDestroy();
+}
+
+// Test that only the directions whose callbacks ran are recorded, e.g. when the stream is reset
+// before the response.
+TEST_F(FilterTimingTest, DirectionNotInvoked) {
+  auto filter = std::make_shared<NiceMock<MockStreamFilter>>();
+  timed_callbacks_.setFilter(lua_);
+  timed_callbacks_.addStreamFilter(filter);
+  ASSERT_NE(nullptr, stream_filter_);
+  stream_filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  stream_filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+
+  EXPECT_CALL(*filter, decodeHeaders(_, false))
+      .WillOnce(DoAll(sleep(3), Return(FilterHeadersStatus::Continue)));
+  EXPECT_EQ(FilterHeadersStatus::Continue, stream_filter_->decodeHeaders(headers_, false));
+
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.0.envoy.lua.decode_time_us"),
+                          3));
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.0.envoy.lua.encode_time_us"),
+                          _))
+      .Times(0);
+  ProtobufWkt::Struct metadata;
+  EXPECT_CALL(encoder_callbacks_.stream_info_,
+              setDynamicMetadata(FilterTiming::dynamicMetadataNamespace(), _))
+      .WillOnce(SaveArg<1>(&metadata));
+  stream_filter_->onDestroy();
+
+  const auto& times = metadata.fields().at("http.0.envoy.lua").struct_value().fields();
+  EXPECT_EQ(1, times.size());
+  EXPECT_DOUBLE_EQ(3, times.at("decode_time_us").number_value());
+
+  // A filter none of whose callbacks ran records nothing.
+  auto idle_filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  timed_callbacks_.setFilter(router_);
+  timed_callbacks_.addStreamDecoderFilter(idle_filter);
+  ASSERT_NE(nullptr, decoder_filter_);
+  decoder_filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.1.envoy.router.decode_time_us"),
+                          _))
+      .Times(0);
+  EXPECT_CALL(decoder_callbacks_.stream_info_, setDynamicMetadata(_, _)).Times(0);
+  decoder_filter_->onDestroy();
+}
+
+// Test that filters configured with the same name are told apart by their position in the chain.
+TEST_F(FilterTimingTest, SameName) {
+  FilterTiming::Filter& second_lua = timing_.addFilter("http", 2, "envoy.lua");
+  auto filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  timed_callbacks_.setFilter(second_lua);
+  timed_callbacks_.addStreamDecoderFilter(filter);
+  ASSERT_NE(nullptr, decoder_filter_);
+  decoder_filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+
+  EXPECT_CALL(*filter, decodeHeaders(_, true))
+      .WillOnce(DoAll(sleep(6), Return(FilterHeadersStatus::Continue)));
+  EXPECT_EQ(FilterHeadersStatus::Continue, decoder_filter_->decodeHeaders(headers_, true));
+
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.0.envoy.lua.decode_time_us"),
+                          _))
+      .Times(0);
+  EXPECT_CALL(stats_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name,
+                                   "http.test.filter_timing.http.2.envoy.lua.decode_time_us"),
+                          6));
+  ProtobufWkt::Struct metadata;
+  EXPECT_CALL(decoder_callbacks_.stream_info_,
+              setDynamicMetadata(FilterTiming::dynamicMetadataNamespace(), _))
+      .WillOnce(SaveArg<1>(&metadata));
+  decoder_filter_->onDestroy();
+
+  EXPECT_EQ(1, metadata.fields().size());
+  const auto& times = metadata.fields().at("http.2.envoy.lua").struct_value().fields();
+  EXPECT_DOUBLE_EQ(6, times.at("decode_time_us").number_value());
+}
+
+// Test that access log handlers are added unchanged.
+TEST_F(FilterTimingTest, AccessLogHandler) {
+  AccessLog::InstanceSharedPtr handler = std::make_shared<NiceMock<AccessLog::MockInstance>>();
+  EXPECT_CALL(callbacks_, addAccessLogHandler(handler));
+  timed_callbacks_.addAccessLogHandler(handler);
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,195 @@
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "common/network/caching_dns_resolver_impl.h"
+#include "common/network/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class CachingDnsResolverImplTest : public testing::Test {
+public:
+  CachingDnsResolverImplTest()
+      : resolver_(std::make_shared<MockDnsResolver>()),
+        cache_(resolver_, time_system_, stats_store_, std::chrono::seconds(1),
+               std::chrono::seconds(60), std::chrono::seconds(5)) {}
+
+  // Resolve through the cache, expecting a query of the wrapped resolver.
+  ActiveDnsQuery* resolveMiss(const std::string& name) {
+    EXPECT_CALL(*resolver_, resolveWithTtl(name, DnsLookupFamily::V4Only, _))
+        .WillOnce(DoAll(SaveArg<2>(&upstream_callback_), Return(&resolver_->active_query_)));
+    return resolve(name);
+  }
+
+  ActiveDnsQuery* resolve(const std::string& name) {
+    return cache_.resolveWithTtl(
+        name, DnsLookupFamily::V4Only,
+        [this](const std::list<Address::InstanceConstSharedPtr>&& address_list,
+               std::chrono::seconds ttl) {
+          results_.push_back(address_list);
+          ttls_.push_back(ttl);
+        });
+  }
+
+  uint64_t counter(const std::string& name) {
+    return stats_store_.counter("dns_cache." + name).value();
+  }
+
+  const std::list<Address::InstanceConstSharedPtr> addresses_{
+      Utility::parseInternetAddress("10.0.0.1"), Utility::parseInternetAddress("10.0.0.2")};
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl stats_store_;
+  std::shared_ptr<MockDnsResolver> resolver_;
+  CachingDnsResolverImpl cache_;
+  DnsResolver::ResolveWithTtlCb upstream_callback_;
+  std::vector<std::list<Address::InstanceConstSharedPtr>> results_;
+  std::vector<std::chrono::seconds> ttls_;
+};
+
+// Resolutions are served from the cache until the TTL of the records expires.
+TEST_F(CachingDnsResolverImplTest, HitUntilExpiry) {
+  EXPECT_NE(nullptr, resolveMiss("foo.com"));
+  upstream_callback_(std::list<Address::InstanceConstSharedPtr>(addresses_),
+                     std::chrono::seconds(30));
+  ASSERT_EQ(1UL, results_.size());
+  EXPECT_EQ(addresses_, results_[0]);
+  EXPECT_EQ(std::chrono::seconds(30), ttls_[0]);
+  EXPECT_EQ(1UL, cache_.size());
+  EXPECT_EQ(1UL, stats_store_.gauge("dns_cache.entries").value());
+
+  time_system_.sleep(std::chrono::seconds(10));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  ASSERT_EQ(2UL, results_.size());
+  EXPECT_EQ(addresses_, results_[1]);
+  EXPECT_EQ(std::chrono::seconds(20), ttls_[1]);
+
+  time_system_.sleep(std::chrono::seconds(20));
+  EXPECT_NE(nullptr, resolveMiss("foo.com"));
+  EXPECT_EQ(0UL, cache_.size());
+  EXPECT_EQ(1UL, counter("hit"));
+  EXPECT_EQ(2UL, counter("miss"));
+}
+
+// Record TTLs are clamped to the configured bounds.
+TEST_F(CachingDnsResolverImplTest, TtlBounds) {
+  resolveMiss("short.com");
+  upstream_callback_(std::list<Address::InstanceConstSharedPtr>(addresses_),
+                     std::chrono::seconds(0));
+  resolveMiss("long.com");
+  upstream_callback_(std::list<Address::InstanceConstSharedPtr>(addresses_),
+                     std::chrono::seconds(3600));
+
+  time_system_.sleep(std::chrono::milliseconds(500));
+  EXPECT_EQ(nullptr, resolve("short.com"));
+  time_system_.sleep(std::chrono::seconds(1));
+  resolveMiss("short.com");
+
+  time_system_.sleep(std::chrono::seconds(58));
+  EXPECT_EQ(nullptr, resolve("long.com"));
+  time_system_.sleep(std::chrono::seconds(1));
+  resolveMiss("long.com");
+}
+
+// Failed resolutions are cached for the negative TTL and reported with a TTL of 0.
+TEST_F(CachingDnsResolverImplTest, NegativeCaching) {
+  resolveMiss("foo.com");
+  upstream_callback_({}, std::chrono::seconds(0));
+
+  time_system_.sleep(std::chrono::seconds(4));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  ASSERT_EQ(2UL, results_.size());
+  EXPECT_TRUE(results_[1].empty());
+  EXPECT_EQ(std::chrono::seconds(0), ttls_[1]);
+  EXPECT_EQ(1UL, counter("negative_hit"));
+
+  time_system_.sleep(std::chrono::seconds(1));
+  resolveMiss("foo.com");
+}
+
+// Concurrent resolutions of a name share a single query, and each caller can cancel its own.
+TEST_F(CachingDnsResolverImplTest, Coalescing) {
+  ActiveDnsQuery* first = resolveMiss("foo.com");
+  ActiveDnsQuery* second = resolve("foo.com");
+  ActiveDnsQuery* third = resolve("foo.com");
+  EXPECT_NE(nullptr, second);
+  EXPECT_NE(first, second);
+  EXPECT_NE(nullptr, third);
+  EXPECT_EQ(2UL, counter("coalesced"));
+
+  EXPECT_CALL(resolver_->active_query_, cancel()).Times(0);
+  second->cancel();
+  upstream_callback_(std::list<Address::InstanceConstSharedPtr>(addresses_),
+                     std::chrono::seconds(30));
+  ASSERT_EQ(2UL, results_.size());
+  EXPECT_EQ(addresses_, results_[0]);
+  EXPECT_EQ(addresses_, results_[1]);
+}
+
+// A cancelled resolution still populates the cache.
+TEST_F(CachingDnsResolverImplTest, CancelStillCaches) {
+  resolveMiss("foo.com")->cancel();
+  upstream_callback_(std::list<Address::InstanceConstSharedPtr>(addresses_),
+                     std::chrono::seconds(30));
+  EXPECT_TRUE(results_.empty());
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(1UL, results_.size());
+}
+
+// Names are cached per lookup family.
+TEST_F(CachingDnsResolverImplTest, PerFamily) {
+  resolveMiss("foo.com");
+  upstream_callback_(std::list<Address::InstanceConstSharedPtr>(addresses_),
+                     std::chrono::seconds(30));
+  EXPECT_CALL(*resolver_, resolveWithTtl("foo.com", DnsLookupFamily::V6Only, _));
+  EXPECT_NE(nullptr, cache_.resolve("foo.com", DnsLookupFamily::V6Only,
+                                    [](const std::list<Address::InstanceConstSharedPtr>&&) {}));
+}
+
+// Resolutions completed synchronously by the wrapped resolver are cached too.
+TEST_F(CachingDnsResolverImplTest, SynchronousResolution) {
+  EXPECT_CALL(*resolver_, resolveWithTtl("foo.com", DnsLookupFamily::V4Only, _))
+      .WillOnce(Invoke([this](const std::string&, DnsLookupFamily,
+                              DnsResolver::ResolveWithTtlCb callback) -> ActiveDnsQuery* {
+        callback(std::list<Address::InstanceConstSharedPtr>(addresses_), std::chrono::seconds(30));
+        return nullptr;
+      }));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(2UL, results_.size());
+  EXPECT_EQ(1UL, counter("hit"));
+}
+
+// In flight queries are cancelled when the cache is destroyed.
+TEST(CachingDnsResolverImplDestroyTest, CancelsInFlight) {
+  Event::SimulatedTimeSystem time_system;
+  Stats::IsolatedStoreImpl stats_store;
+  auto resolver = std::make_shared<MockDnsResolver>();
+  auto cache = std::make_unique<CachingDnsResolverImpl>(
+      resolver, time_system, stats_store, std::chrono::seconds(0), std::chrono::seconds(60),
+      std::chrono::seconds(5));
+  EXPECT_CALL(*resolver, resolveWithTtl("foo.com", DnsLookupFamily::Auto, _));
+  cache->resolve("foo.com", DnsLookupFamily::Auto,
+                 [](const std::list<Address::InstanceConstSharedPtr>&&) {});
+  EXPECT_CALL(resolver->active_query_, cancel());
+  cache.reset();
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -56,9 +56,9 @@ enum record_type { A, AAAA };
 class TestDnsServerQuery {
 public:
   TestDnsServerQuery(ConnectionPtr connection, const HostMap& hosts_A, const HostMap& hosts_AAAA,
-                     const CNameMap& cnames)
+                     const CNameMap& cnames, const std::chrono::seconds& record_ttl)
       : connection_(std::move(connection)), hosts_A_(hosts_A), hosts_AAAA_(hosts_AAAA),
-        cnames_(cnames) {
+        cnames_(cnames), record_ttl_(record_ttl) {
     connection_->addReadFilter(Network::ReadFilterSharedPtr{new ReadFilter(*this)});
   }
 
@@ -216,7 +216,7 @@ private:
           DNS_RR_SET_LEN(response_rr_fixed, sizeof(in6_addr));
         }
         DNS_RR_SET_CLASS(response_rr_fixed, C_IN);
-        DNS_RR_SET_TTL(response_rr_fixed, 0);
+        DNS_RR_SET_TTL(response_rr_fixed, parent_.record_ttl_.count());
         if (ips != nullptr) {
           for (const auto& it : *ips) {
             write_buffer.add(ip_question, ip_name_len);
@@ -254,6 +254,7 @@ private:
   const HostMap& hosts_A_;
   const HostMap& hosts_AAAA_;
   const CNameMap& cnames_;
+  const std::chrono::seconds& record_ttl_;
 };
 
 class TestDnsServer : public ListenerCallbacks {
@@ -267,8 +268,8 @@ public:
   }
 
   void onNewConnection(ConnectionPtr&& new_connection) override {
-    TestDnsServerQuery* query =
-        new TestDnsServerQuery(std::move(new_connection), hosts_A_, hosts_AAAA_, cnames_);
+    TestDnsServerQuery* query = new TestDnsServerQuery(std::move(new_connection), hosts_A_,
+                                                       hosts_AAAA_, cnames_, record_ttl_);
     queries_.emplace_back(query);
   }
 
@@ -284,12 +285,15 @@ public:
     cnames_[hostname] = cname;
   }
 
+  void setRecordTtl(const std::chrono::seconds& ttl) { record_ttl_ = ttl; }
+
 private:
   Event::Dispatcher& dispatcher_;
 
   HostMap hosts_A_;
   HostMap hosts_AAAA_;
   CNameMap cnames_;
+  std::chrono::seconds record_ttl_{0};
   // All queries are tracked so we can do resource reclamation when the test is
   // over.
   std::vector<std::unique_ptr<TestDnsServerQuery>> queries_;
@@ -637,6 +641,41 @@ TEST_P(DnsImplTest, RemoteAsyncLookup) {
   EXPECT_TRUE(hasAddress(address_list, "201.134.56.7"));
 }
 
+// Validate that the shortest TTL of the address records is passed to the callback, and that
+// failures are reported with a TTL of 0.
+TEST_P(DnsImplTest, RemoteLookupWithTtl) {
+  server_->addHosts("some.good.domain", {"201.134.56.7", "123.4.5.6"}, A);
+  server_->setRecordTtl(std::chrono::seconds(300));
+  std::list<Address::InstanceConstSharedPtr> address_list;
+  std::chrono::seconds ttl{};
+  EXPECT_NE(nullptr, resolver_->resolveWithTtl(
+                         "some.good.domain", DnsLookupFamily::V4Only,
+                         [&](const std::list<Address::InstanceConstSharedPtr>&& results,
+                             std::chrono::seconds result_ttl) -> void {
+                           address_list = results;
+                           ttl = result_ttl;
+                           dispatcher_->exit();
+                         }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(hasAddress(address_list, "201.134.56.7"));
+  EXPECT_TRUE(hasAddress(address_list, "123.4.5.6"));
+  EXPECT_EQ(std::chrono::seconds(300), ttl);
+
+  EXPECT_NE(nullptr, resolver_->resolveWithTtl(
+                         "some.bad.domain", DnsLookupFamily::V4Only,
+                         [&](const std::list<Address::InstanceConstSharedPtr>&& results,
+                             std::chrono::seconds result_ttl) -> void {
+                           address_list = results;
+                           ttl = result_ttl;
+                           dispatcher_->exit();
+                         }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_TRUE(address_list.empty());
+  EXPECT_EQ(std::chrono::seconds(0), ttl);
+}
+
 // Validate that multiple A records are correctly passed to the callback.
 TEST_P(DnsImplTest, MultiARecordLookup) {
   server_->addHosts("some.good.domain", {"201.134.56.7", "123.4.5.6", "6.5.4.3"}, A);
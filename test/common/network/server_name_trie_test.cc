@@ -0,0 +1,88 @@
+#include <string>
+
+#include "common/network/server_name_trie.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+
+class ServerNameTrieTest : public testing::Test {
+public:
+  void add(const std::string& server_name) { trie_.add(server_name) = server_name; }
+
+  std::string find(const std::string& server_name) const {
+    const std::string* data = trie_.find(server_name);
+    return data != nullptr ? *data : "(none)";
+  }
+
+  ServerNameTrie<std::string> trie_;
+};
+
+TEST_F(ServerNameTrieTest, Empty) {
+  EXPECT_EQ("(none)", find("www.example.com"));
+  EXPECT_EQ("(none)", find(""));
+}
+
+TEST_F(ServerNameTrieTest, ExactNames) {
+  add("www.example.com");
+  add("example.com");
+
+  EXPECT_EQ("www.example.com", find("www.example.com"));
+  EXPECT_EQ("example.com", find("example.com"));
+  EXPECT_EQ("(none)", find("com"));
+  EXPECT_EQ("(none)", find("a.www.example.com"));
+  EXPECT_EQ("(none)", find("www.example.org"));
+  EXPECT_EQ("(none)", find("WWW.EXAMPLE.COM"));
+  EXPECT_EQ("(none)", find(""));
+}
+
+TEST_F(ServerNameTrieTest, WildcardNames) {
+  add("*.example.com");
+  add("*.b.example.com");
+  add("*.com");
+
+  EXPECT_EQ("*.example.com", find("www.example.com"));
+  EXPECT_EQ("*.example.com", find("a.c.example.com"));
+  // The longest wildcard wins.
+  EXPECT_EQ("*.b.example.com", find("a.b.example.com"));
+  EXPECT_EQ("*.example.com", find("b.example.com"));
+  // A wildcard only matches names with more labels.
+  EXPECT_EQ("*.com", find("example.com"));
+  EXPECT_EQ("(none)", find("com"));
+  EXPECT_EQ("(none)", find("www.example.org"));
+}
+
+TEST_F(ServerNameTrieTest, ExactNameBeforeWildcard) {
+  add("*.example.com");
+  add("www.example.com");
+  add("");
+
+  EXPECT_EQ("www.example.com", find("www.example.com"));
+  EXPECT_EQ("*.example.com", find("www2.example.com"));
+  EXPECT_EQ("*.example.com", find("a.www.example.com"));
+  EXPECT_EQ("", find("example.com"));
+  EXPECT_EQ("", find("www.example.org"));
+  EXPECT_EQ("", find(""));
+}
+
+// Empty labels aren't mistaken for the end of the name.
+TEST_F(ServerNameTrieTest, EmptyLabels) {
+  add("example.com");
+  add("*.example.org");
+
+  EXPECT_EQ("(none)", find(".example.com"));
+  EXPECT_EQ("(none)", find("example.com."));
+  EXPECT_EQ("*.example.org", find(".example.org"));
+  EXPECT_EQ("*.example.org", find("a..example.org"));
+}
+
+TEST_F(ServerNameTrieTest, AddExistingName) {
+  trie_.add("*.example.com") = "first";
+  EXPECT_EQ("first", trie_.add("*.example.com"));
+  EXPECT_EQ("", trie_.add("example.com"));
+  EXPECT_EQ("first", find("www.example.com"));
+}
+
+} // namespace Network
+} // namespace Envoy
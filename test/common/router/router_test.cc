@@ -35,6 +35,7 @@ using testing::AssertionFailure;
 using testing::AssertionResult;
 using testing::AssertionSuccess;
 using testing::AtLeast;
+using testing::Ge;
 using testing::InSequence;
 using testing::Invoke;
 using testing::Matcher;
@@ -1170,6 +1171,92 @@ TEST_F(RouterTest, UpstreamPerTryTimeout) {
   EXPECT_TRUE(verifyHostUpstreamStats(0, 1));
 }
 
+// A request timing out on a peak EWMA cluster is charged at least the 10ms route timeout.
+TEST_F(RouterTest, PeakEwmaUpstreamTimeout) {
+  cm_.thread_local_cluster_.cluster_.info_->lb_type_ = Upstream::LoadBalancerType::PeakEwma;
+  NiceMock<Http::MockStreamEncoder> encoder;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(*cm_.conn_pool_.host_, recordResponseTime(Ge(std::chrono::microseconds(10000)), _));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  response_timeout_->callback_();
+}
+
+// A request timing out on a peak EWMA cluster is charged at least the 5ms per try timeout.
+TEST_F(RouterTest, PeakEwmaUpstreamPerTryTimeout) {
+  cm_.thread_local_cluster_.cluster_.info_->lb_type_ = Upstream::LoadBalancerType::PeakEwma;
+  NiceMock<Http::MockStreamEncoder> encoder;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+  expectPerTryTimerCreate();
+
+  Http::TestHeaderMapImpl headers{{"x-envoy-internal", "true"},
+                                  {"x-envoy-upstream-rq-per-try-timeout-ms", "5"}};
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(*cm_.conn_pool_.host_, recordResponseTime(Ge(std::chrono::microseconds(5000)), _));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  per_try_timeout_->callback_();
+}
+
+// A request reset by a peak EWMA cluster host is charged at least the route timeout, even though
+// the reset comes before it.
+TEST_F(RouterTest, PeakEwmaUpstreamReset) {
+  cm_.thread_local_cluster_.cluster_.info_->lb_type_ = Upstream::LoadBalancerType::PeakEwma;
+  NiceMock<Http::MockStreamEncoder> encoder;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(*cm_.conn_pool_.host_, recordResponseTime(Ge(std::chrono::microseconds(10000)), _));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  encoder.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+}
+
+// Upstream resets are not charged to hosts of clusters using other load balancers.
+TEST_F(RouterTest, UpstreamResetWithoutPeakEwma) {
+  NiceMock<Http::MockStreamEncoder> encoder;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(*cm_.conn_pool_.host_, recordResponseTime(_, _)).Times(0);
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  encoder.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+}
+
 // Ensures that the per try callback is not set until the stream becomes available.
 TEST_F(RouterTest, UpstreamPerTryTimeoutExcludesNewStream) {
   InSequence s;
@@ -0,0 +1,85 @@
+// Usage: bazel run //test/common/runtime:runtime_impl_benchmark
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "common/common/fmt.h"
+#include "common/runtime/runtime_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/thread_local/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Runtime {
+namespace {
+
+class LoaderTester {
+public:
+  LoaderTester() : loader_(generator_, store_, tls_) {
+    // Roughly the number of keys of a large deployment's runtime.
+    std::unordered_map<std::string, std::string> values;
+    for (uint32_t i = 0; i < 10000; i++) {
+      values.emplace(fmt::format("some.feature.number_{}.enabled", i), "50");
+    }
+    values.emplace(SetKey, "50");
+    loader_.mergeValues(values);
+    set_key_ = std::make_unique<InternedKey>(loader_.internKey(SetKey));
+    unset_key_ = std::make_unique<InternedKey>(loader_.internKey(UnsetKey));
+  }
+
+  static constexpr const char* SetKey = "fault.http.abort.abort_percent";
+  static constexpr const char* UnsetKey = "fault.http.delay.fixed_delay_percent";
+
+  RandomGeneratorImpl generator_;
+  Stats::IsolatedStoreImpl store_;
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  LoaderImpl loader_;
+  std::unique_ptr<InternedKey> set_key_;
+  std::unique_ptr<InternedKey> unset_key_;
+};
+
+constexpr const char* LoaderTester::SetKey;
+constexpr const char* LoaderTester::UnsetKey;
+
+// featureEnabled() with a key given by name, which is hashed on every call. The state argument
+// selects a key with a value (1) or without one (0).
+void BM_FeatureEnabledByName(benchmark::State& state) {
+  LoaderTester tester;
+  const std::string key = state.range(0) ? LoaderTester::SetKey : LoaderTester::UnsetKey;
+  uint64_t random_value = 0;
+  uint64_t enabled = 0;
+  for (auto _ : state) {
+    enabled += tester.loader_.snapshot().featureEnabled(key, 10, random_value++, 100);
+  }
+  benchmark::DoNotOptimize(enabled);
+}
+BENCHMARK(BM_FeatureEnabledByName)->Arg(0)->Arg(1);
+
+// featureEnabled() with an interned key, which is an indexed lookup.
+void BM_FeatureEnabledInterned(benchmark::State& state) {
+  LoaderTester tester;
+  const InternedKey& key = state.range(0) ? *tester.set_key_ : *tester.unset_key_;
+  uint64_t random_value = 0;
+  uint64_t enabled = 0;
+  for (auto _ : state) {
+    enabled += tester.loader_.snapshot().featureEnabled(key, 10, random_value++, 100);
+  }
+  benchmark::DoNotOptimize(enabled);
+}
+BENCHMARK(BM_FeatureEnabledInterned)->Arg(0)->Arg(1);
+
+} // namespace
+} // namespace Runtime
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -315,6 +315,44 @@ TEST(LoaderImplTest, All) {
   testNewOverrides(loader, store);
 }
 
+// Validate that interned keys see the same values as lookups by name, including values set after
+// the key was interned and keys interned after the current snapshot was created.
+TEST(LoaderImplTest, InternedKeys) {
+  MockRandomGenerator generator;
+  NiceMock<ThreadLocal::MockInstance> tls;
+  Stats::IsolatedStoreImpl store;
+  LoaderImpl loader(generator, store, tls);
+  loader.mergeValues({{"foo", "20"}, {"pi", "3.14"}});
+
+  const InternedKey foo = loader.internKey("foo");
+  const InternedKey bar = loader.internKey("bar");
+  EXPECT_EQ(foo.index(), loader.internKey("foo").index());
+  EXPECT_NE(foo.index(), bar.index());
+  EXPECT_EQ(20UL, loader.snapshot().getInteger(foo, 1));
+  EXPECT_EQ(1UL, loader.snapshot().getInteger(bar, 1));
+  EXPECT_TRUE(loader.snapshot().featureEnabled(foo, 0, 19, 100));
+  EXPECT_FALSE(loader.snapshot().featureEnabled(foo, 0, 20, 100));
+  EXPECT_CALL(generator, random()).WillOnce(Return(19));
+  EXPECT_TRUE(loader.snapshot().featureEnabled(foo, 0));
+  envoy::type::FractionalPercent default_value;
+  default_value.set_numerator(100);
+  EXPECT_FALSE(loader.snapshot().featureEnabled(foo, default_value, 20));
+  EXPECT_TRUE(loader.snapshot().featureEnabled(bar, default_value, 20));
+
+  // Values set after interning.
+  loader.mergeValues({{"bar", "42"}, {"foo", ""}});
+  EXPECT_EQ(42UL, loader.snapshot().getInteger(bar, 1));
+  EXPECT_EQ(1UL, loader.snapshot().getInteger(foo, 1));
+
+  // A key with a value interned after the snapshot was created.
+  const InternedKey pi = loader.internKey("pi");
+  EXPECT_DOUBLE_EQ(3.14, loader.snapshot().getDouble(pi, 1.0));
+  EXPECT_DOUBLE_EQ(3.14, loader.snapshot().getDouble("pi", 1.0));
+  EXPECT_DOUBLE_EQ(42.0, loader.snapshot().getDouble(bar, 1.0));
+  EXPECT_EQ(1UL, loader.snapshot().getInteger(pi, 1));
+  EXPECT_DOUBLE_EQ(1.0, loader.snapshot().getDouble(loader.internKey("baz"), 1.0));
+}
+
 class DiskLayerTest : public testing::Test {
 protected:
   DiskLayerTest() : api_(Api::createApiForTest()) {}
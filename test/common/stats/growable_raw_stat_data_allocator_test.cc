@@ -0,0 +1,152 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/fmt.h"
+#include "common/common/thread.h"
+#include "common/stats/growable_raw_stat_data_allocator.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class GrowableRawStatDataAllocatorTest : public testing::Test {
+public:
+  GrowableRawStatDataAllocatorTest() {
+    initialize(4 * GrowableRawStatDataAllocator::MinRegionSize);
+  }
+
+  void initialize(uint64_t reserved_size) {
+    reserved_size_ = reserved_size;
+    region_.reset(new uint8_t[reserved_size_]());
+    allocator_ = makeAllocator(true);
+  }
+
+  std::unique_ptr<GrowableRawStatDataAllocator> makeAllocator(bool initialize) {
+    return std::make_unique<GrowableRawStatDataAllocator>(
+        mutex_, region_.get(), reserved_size_, initialize, [this](uint64_t size) {
+          EXPECT_LE(size, reserved_size_);
+          EXPECT_GE(size, grown_size_);
+          grown_size_ = size;
+          return true;
+        });
+  }
+
+  Thread::MutexBasicLockable mutex_;
+  uint64_t reserved_size_;
+  uint64_t grown_size_{};
+  std::unique_ptr<uint8_t[]> region_;
+  std::unique_ptr<GrowableRawStatDataAllocator> allocator_;
+};
+
+TEST_F(GrowableRawStatDataAllocatorTest, Alloc) {
+  RawStatData* stat_1 = allocator_->alloc("ref_name");
+  ASSERT_NE(stat_1, nullptr);
+  RawStatData* stat_2 = allocator_->alloc("ref_name");
+  RawStatData* stat_3 = allocator_->alloc("not_ref_name");
+  ASSERT_NE(stat_3, nullptr);
+  EXPECT_EQ(stat_1, stat_2);
+  EXPECT_NE(stat_1, stat_3);
+  EXPECT_EQ("ref_name", stat_1->key());
+  EXPECT_EQ("not_ref_name", stat_3->key());
+  EXPECT_EQ(2, stat_1->ref_count_);
+  EXPECT_EQ(0, stat_1->value_);
+  EXPECT_EQ(2U, allocator_->numStats());
+
+  allocator_->free(*stat_1);
+  EXPECT_EQ(2U, allocator_->numStats());
+  allocator_->free(*stat_2);
+  allocator_->free(*stat_3);
+  EXPECT_EQ(0U, allocator_->numStats());
+}
+
+// Names are stored in full, however long.
+TEST_F(GrowableRawStatDataAllocatorTest, LongName) {
+  EXPECT_FALSE(allocator_->requiresBoundedStatNameSize());
+  const std::string long_name(10000, 'A');
+  RawStatData* stat = allocator_->alloc(long_name);
+  ASSERT_NE(stat, nullptr);
+  EXPECT_EQ(long_name, stat->key());
+  EXPECT_EQ(stat, allocator_->alloc(long_name));
+  EXPECT_NE(stat, allocator_->alloc(long_name + "B"));
+}
+
+// The memory of freed stats is zeroed and reused for stats with names of a similar length.
+TEST_F(GrowableRawStatDataAllocatorTest, FreedStatReused) {
+  RawStatData* stat_1 = allocator_->alloc("stat_1");
+  stat_1->value_ = 1;
+  allocator_->free(*stat_1);
+  RawStatData* stat_2 = allocator_->alloc("stat_2");
+  EXPECT_EQ(stat_1, stat_2);
+  EXPECT_EQ("stat_2", stat_2->key());
+  EXPECT_EQ(0, stat_2->value_);
+  EXPECT_EQ(1, stat_2->ref_count_);
+}
+
+// The index and the region grow as stats are added, and stats don't move.
+TEST_F(GrowableRawStatDataAllocatorTest, Grow) {
+  const uint64_t num_stats = 20000;
+  std::vector<RawStatData*> stats;
+  for (uint64_t i = 0; i < num_stats; i++) {
+    stats.push_back(allocator_->alloc(fmt::format("cluster.cluster_{}.upstream_rq_total", i)));
+    ASSERT_NE(stats.back(), nullptr);
+    stats.back()->value_ = i;
+  }
+  EXPECT_EQ(num_stats, allocator_->numStats());
+  EXPECT_GT(allocator_->regionSize(), GrowableRawStatDataAllocator::MinRegionSize);
+  EXPECT_EQ(grown_size_, allocator_->regionSize());
+
+  for (uint64_t i = 0; i < num_stats; i++) {
+    EXPECT_EQ(stats[i], allocator_->alloc(fmt::format("cluster.cluster_{}.upstream_rq_total", i)));
+    EXPECT_EQ(i, stats[i]->value_);
+  }
+}
+
+// Adding and removing stats over and over doesn't grow the region, as freed index slots are
+// dropped by rebuilding the index in place.
+TEST_F(GrowableRawStatDataAllocatorTest, Churn) {
+  for (uint64_t i = 0; i < 100000; i++) {
+    RawStatData* stat = allocator_->alloc(fmt::format("stat_{}", i));
+    ASSERT_NE(stat, nullptr);
+    allocator_->free(*stat);
+  }
+  EXPECT_EQ(0U, allocator_->numStats());
+  EXPECT_EQ(GrowableRawStatDataAllocator::MinRegionSize, allocator_->regionSize());
+}
+
+// Allocation fails once the reserved size is used up, and recovers once stats are freed.
+TEST_F(GrowableRawStatDataAllocatorTest, Exhausted) {
+  initialize(GrowableRawStatDataAllocator::MinRegionSize);
+  std::vector<RawStatData*> stats;
+  RawStatData* stat;
+  while ((stat = allocator_->alloc(fmt::format("stat_{}", stats.size()))) != nullptr) {
+    stats.push_back(stat);
+  }
+  EXPECT_GT(stats.size(), 1000U);
+  EXPECT_EQ(stats.size(), allocator_->numStats());
+  EXPECT_EQ(nullptr, allocator_->alloc("another_stat"));
+
+  const std::string name(stats.back()->key());
+  allocator_->free(*stats.back());
+  EXPECT_EQ(stats.back(), allocator_->alloc(name));
+}
+
+// A second allocator attached to the region, as in a hot restarted process, shares its stats.
+TEST_F(GrowableRawStatDataAllocatorTest, Attach) {
+  RawStatData* stat_1 = allocator_->alloc("stat_1");
+  RawStatData* stat_2 = allocator_->alloc("stat_2");
+  allocator_->free(*stat_2);
+
+  std::unique_ptr<GrowableRawStatDataAllocator> allocator_2 = makeAllocator(false);
+  EXPECT_EQ(1U, allocator_2->numStats());
+  EXPECT_EQ(stat_1, allocator_2->alloc("stat_1"));
+  EXPECT_EQ(2, stat_1->ref_count_);
+  EXPECT_EQ(stat_2, allocator_2->alloc("stat_3"));
+  EXPECT_EQ(stat_2, allocator_->alloc("stat_3"));
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -272,6 +272,43 @@ TEST_F(CdsApiImplTest, ConfigUpdateAddsSecondClusterEvenIfFirstThrows) {
                             EnvoyException, "An exception\nAnother exception");
 }
 
+// Validate that an incremental update only adds the delivered clusters, each with its own version,
+// and removes only the clusters named as removed.
+TEST_F(CdsApiImplTest, IncrementalConfigUpdate) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  EXPECT_CALL(cm_, clusters()).Times(0);
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(request_, cancel());
+
+  Protobuf::RepeatedPtrField<envoy::api::v2::Resource> added_resources;
+  {
+    envoy::api::v2::Cluster cluster;
+    cluster.set_name("cluster_1");
+    auto* resource = added_resources.Add();
+    resource->set_version("v1");
+    resource->mutable_resource()->PackFrom(cluster);
+    cm_.expectAdd("cluster_1", "v1");
+  }
+  {
+    envoy::api::v2::Cluster cluster;
+    cluster.set_name("cluster_2");
+    auto* resource = added_resources.Add();
+    resource->set_version("v2");
+    resource->mutable_resource()->PackFrom(cluster);
+    cm_.expectAdd("cluster_2", "v2");
+  }
+  Protobuf::RepeatedPtrField<std::string> removed_resources;
+  *removed_resources.Add() = "cluster_3";
+  EXPECT_CALL(cm_, removeCluster("cluster_3")).WillOnce(Return(true));
+
+  dynamic_cast<CdsApiImpl*>(cds_.get())->onConfigUpdate(added_resources, removed_resources, "v3");
+  EXPECT_EQ("v3", cds_->versionInfo());
+}
+
 TEST_F(CdsApiImplTest, InvalidOptions) {
   const std::string config_json = R"EOF(
   {
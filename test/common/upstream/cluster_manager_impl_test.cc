@@ -1046,6 +1046,145 @@ TEST_F(ClusterManagerImplTest, DynamicRemoveWithLocalCluster) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+// Validate that membership updates made within one dispatcher iteration are coalesced and posted to
+// the workers as a single batch carrying the net host change.
+TEST_F(ClusterManagerImplTest, BatchedThreadLocalClusterUpdates) {
+  const std::string json = fmt::sprintf("{%s}", clustersJson({defaultStaticClusterJson("fake")}));
+  std::shared_ptr<MockClusterMockPrioritySet> foo(new NiceMock<MockClusterMockPrioritySet>());
+  foo->info_->name_ = "foo";
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, false)).WillOnce(Return(foo));
+  ON_CALL(*foo, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  EXPECT_CALL(*foo, initialize(_));
+  create(parseBootstrapFromJson(json));
+  foo->initialize_callback_();
+
+  HostVector tls_hosts_added;
+  HostVector tls_hosts_removed;
+  uint32_t tls_updates = 0;
+  cluster_manager_->get("foo")->prioritySet().addPriorityUpdateCb(
+      [&](uint32_t, const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
+        tls_hosts_added = hosts_added;
+        tls_hosts_removed = hosts_removed;
+        tls_updates++;
+      });
+
+  // Defer the flush to the end of the "dispatcher iteration".
+  Event::PostCb flush;
+  EXPECT_CALL(factory_.dispatcher_, post(_)).WillOnce(SaveArg<0>(&flush));
+
+  HostSharedPtr host1 = makeTestHost(foo->info_, "tcp://127.0.0.1:80");
+  HostSharedPtr host2 = makeTestHost(foo->info_, "tcp://127.0.0.1:81");
+  MockHostSet& host_set = *foo->prioritySet().getMockHostSet(0);
+  host_set.hosts_ = {host1};
+  host_set.runCallbacks({host1}, {});
+  host_set.hosts_ = {host1, host2};
+  host_set.runCallbacks({host2}, {});
+  host_set.hosts_ = {host1};
+  host_set.runCallbacks({}, {host2});
+
+  // Nothing has reached the workers yet.
+  EXPECT_EQ(0, tls_updates);
+  EXPECT_EQ(0, factory_.stats_.counter("cluster_manager.thread_local_update_batches").value());
+  EXPECT_EQ(2, factory_.stats_.counter("cluster_manager.thread_local_updates_coalesced").value());
+
+  flush();
+  EXPECT_EQ(1, tls_updates);
+  EXPECT_EQ(HostVector{host1}, tls_hosts_added);
+  EXPECT_TRUE(tls_hosts_removed.empty());
+  EXPECT_EQ(1,
+            cluster_manager_->get("foo")->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.thread_local_update_batches").value());
+
+  factory_.tls_.shutdownThread();
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(foo.get()));
+}
+
+// Validate that with a thread local cluster idle timeout, worker local clusters are instantiated
+// on first use from the latest membership and are released again once idle.
+TEST_F(ClusterManagerImplTest, OnDemandThreadLocalClusters) {
+  const std::string json = fmt::sprintf("{%s}", clustersJson({defaultStaticClusterJson("fake")}));
+  envoy::config::bootstrap::v2::Bootstrap bootstrap = parseBootstrapFromJson(json);
+  bootstrap.mutable_cluster_manager()->mutable_thread_local_cluster_idle_timeout()->set_seconds(1);
+  std::shared_ptr<MockClusterMockPrioritySet> foo(new NiceMock<MockClusterMockPrioritySet>());
+  foo->info_->name_ = "foo";
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, false)).WillOnce(Return(foo));
+  ON_CALL(*foo, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  EXPECT_CALL(*foo, initialize(_));
+  NiceMock<Event::MockTimer>* idle_timer =
+      new NiceMock<Event::MockTimer>(&factory_.tls_.dispatcher_);
+  create(bootstrap);
+
+  HostSharedPtr host1 = makeTestHost(foo->info_, "tcp://127.0.0.1:80");
+  MockHostSet& host_set = *foo->prioritySet().getMockHostSet(0);
+  host_set.hosts_ = {host1};
+  foo->initialize_callback_();
+  Stats::Counter& created_on_demand =
+      factory_.stats_.counter("cluster_manager.thread_local_clusters_created_on_demand");
+  Stats::Counter& reclaimed =
+      factory_.stats_.counter("cluster_manager.thread_local_clusters_reclaimed");
+  EXPECT_EQ(0, created_on_demand.value());
+
+  // Looking the cluster up or reading its info does not instantiate it.
+  ThreadLocalCluster* cluster = cluster_manager_->get("foo");
+  ASSERT_NE(nullptr, cluster);
+  EXPECT_EQ(foo->info_, cluster->info());
+  EXPECT_EQ(nullptr, cluster_manager_->get("bar"));
+  EXPECT_EQ(0, created_on_demand.value());
+
+  // First use instantiates the cluster with its current hosts.
+  EXPECT_EQ(HostVector{host1}, cluster->prioritySet().hostSetsPerPriority()[0]->hosts());
+  EXPECT_EQ(1, created_on_demand.value());
+  EXPECT_EQ(HostVector{host1},
+            cluster_manager_->get("foo")->prioritySet().hostSetsPerPriority()[0]->hosts());
+  EXPECT_EQ(1, created_on_demand.value());
+
+  // The cluster was used since the last sweep, so it survives this one but not the next.
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000)));
+  idle_timer->callback_();
+  EXPECT_EQ(0, reclaimed.value());
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000)));
+  idle_timer->callback_();
+  EXPECT_EQ(1, reclaimed.value());
+
+  // Membership changes while released are still tracked and applied on the next use.
+  HostSharedPtr host2 = makeTestHost(foo->info_, "tcp://127.0.0.1:81");
+  host_set.hosts_ = {host1, host2};
+  host_set.runCallbacks({host2}, {});
+  cluster = cluster_manager_->get("foo");
+  ASSERT_NE(nullptr, cluster);
+  EXPECT_EQ(1, created_on_demand.value());
+  EXPECT_EQ(2, cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(2, created_on_demand.value());
+
+  factory_.tls_.shutdownThread();
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(foo.get()));
+}
+
+// Validate that a flush of membership updates still posted when the cluster manager is destroyed
+// does nothing.
+TEST_F(ClusterManagerImplTest, ThreadLocalClusterUpdateFlushAfterDestruction) {
+  const std::string json = fmt::sprintf("{%s}", clustersJson({defaultStaticClusterJson("fake")}));
+  std::shared_ptr<MockClusterMockPrioritySet> foo(new NiceMock<MockClusterMockPrioritySet>());
+  foo->info_->name_ = "foo";
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, false)).WillOnce(Return(foo));
+  ON_CALL(*foo, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  EXPECT_CALL(*foo, initialize(_));
+  create(parseBootstrapFromJson(json));
+  foo->initialize_callback_();
+
+  Event::PostCb flush;
+  EXPECT_CALL(factory_.dispatcher_, post(_)).WillOnce(SaveArg<0>(&flush));
+  HostSharedPtr host = makeTestHost(foo->info_, "tcp://127.0.0.1:80");
+  MockHostSet& host_set = *foo->prioritySet().getMockHostSet(0);
+  host_set.hosts_ = {host};
+  host_set.runCallbacks({host}, {});
+
+  factory_.tls_.shutdownThread();
+  cluster_manager_.reset();
+  flush();
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(foo.get()));
+}
+
 TEST_F(ClusterManagerImplTest, RemoveWarmingCluster) {
   time_system_.setSystemTime(std::chrono::milliseconds(1234567891234));
 
@@ -65,7 +65,8 @@ TEST(HealthCheckerFactoryTest, GrpcHealthCheckHTTP2NotConfiguredException) {
   AccessLog::MockAccessLogManager log_manager;
 
   EXPECT_THROW_WITH_MESSAGE(HealthCheckerFactory::create(createGrpcHealthCheckConfig(), cluster,
-                                                         runtime, random, dispatcher, log_manager),
+                                                         runtime, random, dispatcher, log_manager,
+                                                         {}),
                             EnvoyException,
                             "fake_cluster cluster must support HTTP/2 for gRPC healthchecking");
 }
@@ -83,7 +84,8 @@ TEST(HealthCheckerFactoryTest, createGrpc) {
 
   EXPECT_NE(nullptr, dynamic_cast<GrpcHealthCheckerImpl*>(
                          HealthCheckerFactory::create(createGrpcHealthCheckConfig(), cluster,
-                                                      runtime, random, dispatcher, log_manager)
+                                                      runtime, random, dispatcher, log_manager,
+                                                      {})
                              .get()));
 }
 
@@ -2440,6 +2442,72 @@ TEST_F(TcpHealthCheckerImplTest, NoData) {
   interval_timer_->callback_();
 }
 
+// Validate that a health checker sharing results adopts a result another cluster produced for the
+// same address since its last check, and otherwise checks the host itself.
+TEST_F(TcpHealthCheckerImplTest, SharedResults) {
+  InSequence s;
+  Event::SimulatedTimeSystem time_system;
+
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    tcp_health_check: {}
+    share_results: true
+    )EOF";
+  const envoy::api::v2::core::HealthCheck config = parseHealthCheckFromV2Yaml(yaml);
+  SharedHealthCheckResultsSharedPtr shared_results = std::make_shared<SharedHealthCheckResults>();
+  health_checker_.reset(new TcpHealthCheckerImpl(*cluster_, config, dispatcher_, runtime_, random_,
+                                                 HealthCheckEventLoggerPtr(event_logger_)));
+  health_checker_->shareResults(shared_results, MessageUtil::hash(config));
+  std::shared_ptr<MockClusterMockPrioritySet> other_cluster(
+      new NiceMock<MockClusterMockPrioritySet>());
+  std::shared_ptr<TcpHealthCheckerImpl> other_health_checker(
+      new TcpHealthCheckerImpl(*other_cluster, config, dispatcher_, runtime_, random_, nullptr));
+  other_health_checker->shareResults(shared_results, MessageUtil::hash(config));
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+  other_cluster->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(other_cluster->info_, "tcp://127.0.0.1:80")};
+
+  expectSessionCreate();
+  expectClientCreate();
+  EXPECT_CALL(*timeout_timer_, enableTimer(_));
+  health_checker_->start();
+
+  EXPECT_CALL(*connection_, close(_));
+  EXPECT_CALL(*timeout_timer_, disableTimer());
+  EXPECT_CALL(*interval_timer_, enableTimer(_));
+  connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(1UL, shared_results->size());
+
+  // The other cluster's first check adopts the result without connecting to the host.
+  time_system.sleep(std::chrono::milliseconds(1));
+  Event::MockTimer* other_interval_timer = new Event::MockTimer(&dispatcher_);
+  Event::MockTimer* other_timeout_timer = new Event::MockTimer(&dispatcher_);
+  EXPECT_CALL(*other_timeout_timer, disableTimer());
+  EXPECT_CALL(*other_interval_timer, enableTimer(_));
+  other_health_checker->start();
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.deduplicated").value());
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.success").value());
+  EXPECT_EQ(0UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+
+  // There is no newer result on its next interval, so it checks the host itself.
+  expectClientCreate();
+  EXPECT_CALL(*other_timeout_timer, enableTimer(_));
+  other_interval_timer->callback_();
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.deduplicated").value());
+
+  // The shared entry goes away with the last session checking the address.
+  health_checker_.reset();
+  EXPECT_EQ(1UL, shared_results->size());
+  other_health_checker.reset();
+  EXPECT_EQ(0UL, shared_results->size());
+}
+
 TEST_F(TcpHealthCheckerImplTest, PassiveFailure) {
   InSequence s;
 
@@ -3467,6 +3535,92 @@ TEST_F(GrpcHealthCheckerImplTest, DontReuseConnectionBetweenChecks) {
   expectHostHealthy(true);
 }
 
+// Validate that health checkers sharing connections send their checks of an address as streams on
+// a single connection, and that a timed out check only resets its own stream.
+TEST_F(GrpcHealthCheckerImplTest, SharedConnection) {
+  setupHC();
+  SharedHealthCheckConnectionsSharedPtr shared_connections =
+      std::make_shared<SharedHealthCheckConnections>();
+  health_checker_->shareConnections(shared_connections, 0);
+  std::shared_ptr<MockClusterMockPrioritySet> other_cluster(
+      new NiceMock<MockClusterMockPrioritySet>());
+  std::shared_ptr<TestGrpcHealthCheckerImpl> other_health_checker(new TestGrpcHealthCheckerImpl(
+      *other_cluster, createGrpcHealthCheckConfig(), dispatcher_, runtime_, random_, nullptr));
+  other_health_checker->shareConnections(shared_connections, 0);
+
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+  other_cluster->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(other_cluster->info_, "tcp://127.0.0.1:80")};
+
+  expectSessionCreate();
+  expectHealthcheckStart(0);
+  health_checker_->start();
+  EXPECT_EQ(1UL, shared_connections->size());
+
+  // The other cluster's check is a second stream on the same connection.
+  Event::MockTimer* other_timeout_timer = new Event::MockTimer(&dispatcher_);
+  Event::MockTimer* other_interval_timer = new Event::MockTimer(&dispatcher_);
+  NiceMock<Http::MockStreamEncoder> other_request_encoder;
+  Http::StreamDecoder* other_stream_response_callbacks{};
+  EXPECT_CALL(*other_health_checker, createCodecClient_(_)).Times(0);
+  EXPECT_CALL(*test_sessions_[0]->codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&other_stream_response_callbacks),
+                      ReturnRef(other_request_encoder)));
+  EXPECT_CALL(*other_timeout_timer, enableTimer(_));
+  other_health_checker->start();
+  EXPECT_EQ(1UL, shared_connections->size());
+
+  // A timeout only resets the timed out stream, not the shared connection.
+  EXPECT_CALL(*test_sessions_[0]->client_connection_, close(_)).Times(0);
+  EXPECT_CALL(other_request_encoder.stream_, resetStream(Http::StreamResetReason::LocalReset));
+  EXPECT_CALL(*other_interval_timer, enableTimer(_));
+  EXPECT_CALL(*other_timeout_timer, disableTimer());
+  other_timeout_timer->callback_();
+  EXPECT_EQ(1UL, other_cluster->info_->stats_store_.counter("health_check.failure").value());
+
+  expectHealthcheckStop(0);
+  EXPECT_CALL(*this, onHostStatus(_, HealthTransition::Unchanged));
+  respondServiceStatus(0, grpc::health::v1::HealthCheckResponse::SERVING);
+  expectHostHealthy(true);
+
+  // The connection is closed when the last session using it goes away.
+  health_checker_.reset();
+  EXPECT_EQ(1UL, shared_connections->size());
+  EXPECT_CALL(*test_sessions_[0]->client_connection_, close(_));
+  other_health_checker.reset();
+  EXPECT_EQ(0UL, shared_connections->size());
+}
+
+// Validate that a shared connection closing with a check in flight fails the check, and that the
+// next check reconnects.
+TEST_F(GrpcHealthCheckerImplTest, SharedConnectionDisconnect) {
+  setupHC();
+  health_checker_->shareConnections(std::make_shared<SharedHealthCheckConnections>(), 0);
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80")};
+
+  expectSessionCreate();
+  expectHealthcheckStart(0);
+  EXPECT_CALL(*event_logger_, logUnhealthy(_, _, _, true));
+  health_checker_->start();
+
+  expectHealthcheckStop(0);
+  EXPECT_CALL(*this, onHostStatus(_, HealthTransition::ChangePending));
+  test_sessions_[0]->client_connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  expectHostHealthy(true);
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.network_failure").value());
+
+  expectClientCreate(0);
+  expectHealthcheckStart(0);
+  test_sessions_[0]->interval_timer_->callback_();
+
+  expectHealthcheckStop(0);
+  EXPECT_CALL(*this, onHostStatus(_, HealthTransition::Unchanged));
+  respondServiceStatus(0, grpc::health::v1::HealthCheckResponse::SERVING);
+  expectHostHealthy(true);
+}
+
 // Test UNKNOWN health status is considered unhealthy.
 TEST_F(GrpcHealthCheckerImplTest, GrpcFailUnknown) {
   setupHC();
@@ -2,9 +2,13 @@
 
 #include <memory>
 
+#include "common/config/metadata.h"
+#include "common/config/well_known_names.h"
 #include "common/runtime/runtime_impl.h"
+#include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
+#include "common/upstream/subset_lb.h"
 #include "common/upstream/upstream_impl.h"
 
 #include "test/common/upstream/utility.h"
@@ -81,6 +85,7 @@ BENCHMARK(BM_RingHashLoadBalancerBuildRing)
     ->Args({100, 256000})
     ->Args({200, 256000})
     ->Args({500, 256000})
+    ->Args({500, 4194304})
     ->Unit(benchmark::kMillisecond);
 
 void BM_MaglevLoadBalancerBuildTable(benchmark::State& state) {
@@ -164,6 +169,7 @@ BENCHMARK(BM_RingHashLoadBalancerChooseHost)
     ->Args({100, 256000, 100000})
     ->Args({200, 256000, 100000})
     ->Args({500, 256000, 100000})
+    ->Args({500, 4194304, 100000})
     ->Unit(benchmark::kMillisecond);
 
 void BM_MaglevLoadBalancerChooseHost(benchmark::State& state) {
@@ -341,6 +347,164 @@ BENCHMARK(BM_MaglevLoadBalancerWeighted)
     ->Args({500, 95, 75, 25, 10000})
     ->Unit(benchmark::kMillisecond);
 
+class TestMetadataMatchCriterion : public Router::MetadataMatchCriterion {
+public:
+  TestMetadataMatchCriterion(const std::string& name, const HashedValue& value)
+      : name_(name), value_(value) {}
+
+  // Router::MetadataMatchCriterion
+  const std::string& name() const override { return name_; }
+  const HashedValue& value() const override { return value_; }
+
+private:
+  const std::string name_;
+  const HashedValue value_;
+};
+
+class TestMetadataMatchCriteria : public Router::MetadataMatchCriteria {
+public:
+  TestMetadataMatchCriteria(const std::string& name, const std::string& value) {
+    ProtobufWkt::Value v;
+    v.set_string_value(value);
+    matches_.emplace_back(std::make_shared<const TestMetadataMatchCriterion>(name, HashedValue(v)));
+  }
+
+  // Router::MetadataMatchCriteria
+  const std::vector<Router::MetadataMatchCriterionConstSharedPtr>&
+  metadataMatchCriteria() const override {
+    return matches_;
+  }
+  Router::MetadataMatchCriteriaConstPtr
+  mergeMatchCriteria(const ProtobufWkt::Struct&) const override {
+    return nullptr;
+  }
+
+private:
+  std::vector<Router::MetadataMatchCriterionConstSharedPtr> matches_;
+};
+
+class TestSubsetLoadBalancerContext : public LoadBalancerContextBase {
+public:
+  TestSubsetLoadBalancerContext(const std::string& version) : criteria_("version", version) {}
+
+  // Upstream::LoadBalancerContext
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return &criteria_; }
+
+private:
+  const TestMetadataMatchCriteria criteria_;
+};
+
+// Each host is assigned to one of num_subsets subsets via its "version" metadata.
+class SubsetTester {
+public:
+  SubsetTester(uint64_t num_hosts, uint64_t num_subsets) {
+    envoy::api::v2::Cluster::LbSubsetConfig subset_config;
+    subset_config.set_fallback_policy(envoy::api::v2::Cluster::LbSubsetConfig::ANY_ENDPOINT);
+    subset_config.add_subset_selectors()->add_keys("version");
+    subset_info_ = std::make_unique<LoadBalancerSubsetInfoImpl>(subset_config);
+
+    HostVector hosts;
+    ASSERT(num_hosts < 65536);
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      envoy::api::v2::core::Metadata metadata;
+      Config::Metadata::mutableMetadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                             "version")
+          .set_string_value(std::to_string(i % num_subsets));
+      hosts.push_back(
+          makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256), metadata));
+    }
+    hosts_ = std::make_shared<HostVector>(hosts);
+    updateHosts(hosts, {});
+  }
+
+  void initialize() {
+    subset_lb_ = std::make_unique<SubsetLoadBalancer>(
+        LoadBalancerType::Random, priority_set_, nullptr, stats_, runtime_, random_, *subset_info_,
+        absl::nullopt, absl::nullopt, common_config_);
+  }
+
+  // Deliver an update with no membership changes, as happens for health and metadata changes.
+  void updateHosts(const HostVector& hosts_added, const HostVector& hosts_removed) {
+    priority_set_.updateHosts(
+        0,
+        HostSetImpl::partitionHosts(hosts_,
+                                    std::make_shared<const HostsPerLocalityImpl>(*hosts_, false)),
+        {}, hosts_added, hosts_removed, absl::nullopt);
+  }
+
+  PrioritySetImpl priority_set_;
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  HostVectorConstSharedPtr hosts_;
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStats stats_{ClusterInfoImpl::generateStats(stats_store_)};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Runtime::RandomGeneratorImpl random_;
+  envoy::api::v2::Cluster::CommonLbConfig common_config_;
+  std::unique_ptr<LoadBalancerSubsetInfo> subset_info_;
+  std::unique_ptr<SubsetLoadBalancer> subset_lb_;
+};
+
+void BM_SubsetLoadBalancerBuild(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t num_subsets = state.range(1);
+    SubsetTester tester(num_hosts, num_subsets);
+    state.ResumeTiming();
+
+    tester.initialize();
+  }
+}
+BENCHMARK(BM_SubsetLoadBalancerBuild)
+    ->Args({5000, 10})
+    ->Args({5000, 128})
+    ->Args({5000, 512})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SubsetLoadBalancerRefresh(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t num_subsets = state.range(1);
+    SubsetTester tester(num_hosts, num_subsets);
+    tester.initialize();
+    state.ResumeTiming();
+
+    // An update with no hosts added or removed refreshes every subset.
+    tester.updateHosts({}, {});
+  }
+}
+BENCHMARK(BM_SubsetLoadBalancerRefresh)
+    ->Args({5000, 10})
+    ->Args({5000, 128})
+    ->Args({5000, 512})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SubsetLoadBalancerChooseHost(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    const uint64_t num_subsets = state.range(1);
+    const uint64_t keys_to_simulate = state.range(2);
+    SubsetTester tester(num_hosts, num_subsets);
+    tester.initialize();
+    std::vector<std::unique_ptr<TestSubsetLoadBalancerContext>> contexts;
+    for (uint64_t i = 0; i < num_subsets; i++) {
+      contexts.emplace_back(std::make_unique<TestSubsetLoadBalancerContext>(std::to_string(i)));
+    }
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < keys_to_simulate; i++) {
+      benchmark::DoNotOptimize(tester.subset_lb_->chooseHost(contexts[i % num_subsets].get()));
+    }
+  }
+}
+BENCHMARK(BM_SubsetLoadBalancerChooseHost)
+    ->Args({5000, 10, 100000})
+    ->Args({5000, 128, 100000})
+    ->Args({5000, 512, 100000})
+    ->Unit(benchmark::kMillisecond);
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -11,6 +11,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -1324,6 +1325,65 @@ TEST_P(RandomLoadBalancerTest, Normal) {
 
 INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, RandomLoadBalancerTest, ::testing::Values(true, false));
 
+class PeakEwmaLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  Event::SimulatedTimeSystem time_system_;
+  PeakEwmaLoadBalancer lb_{
+      priority_set_, nullptr, stats_, runtime_, random_, common_config_, time_system_};
+};
+
+TEST_P(PeakEwmaLoadBalancerTest, NoHosts) { EXPECT_EQ(nullptr, lb_.chooseHost(nullptr)); }
+
+TEST_P(PeakEwmaLoadBalancerTest, SingleHost) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, PrefersLowerCost) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
+                              makeTestHost(info_, "tcp://127.0.0.1:81")};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  const MonotonicTime now = time_system_.monotonicTime();
+  hostSet().healthy_hosts_[0]->recordResponseTime(std::chrono::microseconds(1000), now);
+  hostSet().healthy_hosts_[1]->recordResponseTime(std::chrono::microseconds(100), now);
+
+  // The faster host wins whichever order the two are sampled in.
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+
+  // Outstanding requests scale the cost: 100us * 11 > 1000us * 1.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(10);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, UnknownLatencyWithActiveRequestsIsPenalized) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
+                              makeTestHost(info_, "tcp://127.0.0.1:81")};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  const MonotonicTime now = time_system_.monotonicTime();
+  hostSet().healthy_hosts_[0]->recordResponseTime(std::chrono::seconds(1), now);
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(1);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(1)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+
+  // Once idle, a host without history is the cheapest possible choice.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(0);
+  EXPECT_CALL(random_, random()).WillOnce(Return(0)).WillOnce(Return(0)).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, PeakEwmaLoadBalancerTest,
+                         ::testing::Values(true, false));
+
 TEST(LoadBalancerSubsetInfoImplTest, DefaultConfigIsDiabled) {
   auto subset_info =
       LoadBalancerSubsetInfoImpl(envoy::api::v2::Cluster::LbSubsetConfig::default_instance());
@@ -73,6 +73,27 @@ TEST_F(MaglevLoadBalancerTest, Basic) {
   }
 }
 
+// Overloaded hosts are skipped when bounded loads are enabled.
+TEST_F(MaglevLoadBalancerTest, BoundedLoad) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90"),
+                      makeTestHost(info_, "tcp://127.0.0.1:91")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      100);
+  init(7);
+
+  // The bound is ceil(5 / 2) = 3 active requests, so all requests go to the idle host.
+  stats_.upstream_rq_active_.set(4);
+  host_set_.hosts_[0]->stats().rq_active_.set(4);
+  LoadBalancerPtr lb = lb_->factory()->create();
+  for (uint32_t i = 0; i < 7; ++i) {
+    TestLoadBalancerContext context(i);
+    EXPECT_EQ(host_set_.hosts_[1], lb->chooseHost(&context));
+  }
+  EXPECT_LT(0UL, stats_.lb_hash_bounded_load_spillover_.value());
+}
+
 // Weighted sanity test.
 TEST_F(MaglevLoadBalancerTest, Weighted) {
   host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", 1),
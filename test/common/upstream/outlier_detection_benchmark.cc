@@ -0,0 +1,103 @@
+// Usage: bazel run //test/common/upstream:outlier_detection_benchmark
+
+#include <memory>
+
+#include "common/upstream/outlier_detection_impl.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace Outlier {
+namespace {
+
+class DetectorTester {
+public:
+  DetectorTester(uint64_t num_hosts) {
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts_.push_back(makeTestHost(
+          cluster_.info_,
+          fmt::format("tcp://10.{}.{}.{}:80", i / 65536, (i / 256) % 256, i % 256)));
+    }
+    config_.mutable_success_rate_request_volume()->set_value(RequestsPerInterval);
+    detector_ =
+        DetectorImpl::create(cluster_, config_, dispatcher_, runtime_, time_system_, nullptr);
+  }
+
+  // Load every host with a full success rate window.
+  void loadHosts() {
+    for (const HostSharedPtr& host : hosts_) {
+      for (uint32_t i = 0; i < RequestsPerInterval; i++) {
+        host->outlierDetector().putHttpResponseCode(200);
+      }
+    }
+  }
+
+  static constexpr uint32_t RequestsPerInterval = 10;
+
+  NiceMock<MockClusterMockPrioritySet> cluster_;
+  HostVector& hosts_ = cluster_.prioritySet().getMockHostSet(0)->hosts_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Event::MockTimer>* interval_timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+  Event::SimulatedTimeSystem time_system_;
+  envoy::api::v2::cluster::OutlierDetection config_;
+  std::shared_ptr<DetectorImpl> detector_;
+};
+
+constexpr uint32_t DetectorTester::RequestsPerInterval;
+
+// Cost of recording a response on the worker path. Run with several threads to see contention on
+// a single hot host.
+void BM_OutlierDetectionPutHttpResponseCode(benchmark::State& state) {
+  static DetectorTester* tester = new DetectorTester(1);
+  DetectorHostMonitor& monitor = tester->hosts_[0]->outlierDetector();
+  for (auto _ : state) {
+    monitor.putHttpResponseCode(200);
+  }
+}
+BENCHMARK(BM_OutlierDetectionPutHttpResponseCode)->ThreadRange(1, 8);
+
+// Cost of the main thread interval pass, which rotates every host's success rate window and
+// computes the cluster success rate statistics.
+void BM_OutlierDetectionInterval(benchmark::State& state) {
+  DetectorTester tester(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    tester.loadHosts();
+    state.ResumeTiming();
+
+    tester.interval_timer_->callback_();
+  }
+  state.counters["success_rate_average"] = tester.detector_->successRateAverage();
+}
+BENCHMARK(BM_OutlierDetectionInterval)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Outlier
+} // namespace Upstream
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -847,11 +847,7 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
 }
 
 TEST(OutlierUtility, SRThreshold) {
-  std::vector<HostSuccessRatePair> data = {
-      HostSuccessRatePair(nullptr, 50),  HostSuccessRatePair(nullptr, 100),
-      HostSuccessRatePair(nullptr, 100), HostSuccessRatePair(nullptr, 100),
-      HostSuccessRatePair(nullptr, 100),
-  };
+  std::vector<double> data = {50, 100, 100, 100, 100};
   double sum = 450;
 
   Utility::EjectionPair ejection_pair = Utility::successRateEjectionThreshold(sum, data, 1.9);
@@ -859,6 +855,29 @@ TEST(OutlierUtility, SRThreshold) {
   EXPECT_EQ(90.0, ejection_pair.success_rate_average_);
 }
 
+TEST(OutlierUtility, SuccessRateAccumulator) {
+  SuccessRateAccumulator accumulator;
+  SuccessRateAccumulatorBucket* bucket = accumulator.updateCurrentWriter();
+  for (int i = 0; i < 3; i++) {
+    bucket->recordRequest(true);
+  }
+  bucket->recordRequest(false);
+
+  // Nothing is visible until the writer is rotated.
+  EXPECT_FALSE(accumulator.getSuccessRate(1));
+
+  bucket = accumulator.updateCurrentWriter();
+  bucket->recordRequest(false);
+  EXPECT_FALSE(accumulator.getSuccessRate(5));
+  EXPECT_EQ(75.0, accumulator.getSuccessRate(4).value());
+
+  // The bucket that was read is cleared before it is written to again.
+  accumulator.updateCurrentWriter();
+  EXPECT_EQ(0.0, accumulator.getSuccessRate(1).value());
+  accumulator.updateCurrentWriter();
+  EXPECT_FALSE(accumulator.getSuccessRate(1));
+}
+
 TEST(DetectorHostMonitorImpl, resultToHttpCode) {
   EXPECT_EQ(Http::Code::OK, DetectorHostMonitorImpl::resultToHttpCode(Result::SUCCESS));
   EXPECT_EQ(Http::Code::GatewayTimeout, DetectorHostMonitorImpl::resultToHttpCode(Result::TIMEOUT));
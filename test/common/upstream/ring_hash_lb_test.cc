@@ -1,10 +1,13 @@
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
 #include "envoy/router/router.h"
 
+#include "common/common/hash.h"
 #include "common/network/utility.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/upstream_impl.h"
@@ -327,5 +330,139 @@ TEST_P(RingHashLoadBalancerTest, UnevenHosts) {
   }
 }
 
+// With bounded loads enabled, a host above the load bound is skipped in favor of a consistent
+// alternative, and the original host is used again once its load drops.
+TEST_P(RingHashLoadBalancerTest, BoundedLoad) {
+  hostSet().hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:90"), makeTestHost(info_, "tcp://127.0.0.1:91"),
+      makeTestHost(info_, "tcp://127.0.0.1:92"), makeTestHost(info_, "tcp://127.0.0.1:93"),
+      makeTestHost(info_, "tcp://127.0.0.1:94"), makeTestHost(info_, "tcp://127.0.0.1:95")};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = (envoy::api::v2::Cluster::RingHashLbConfig());
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      150);
+  init();
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+
+  // The bound is ceil(1.5 * 11 / 6) = 3 active requests.
+  stats_.upstream_rq_active_.set(10);
+  hostSet().hosts_[4]->stats().rq_active_.set(10);
+  HostConstSharedPtr spillover_host = lb->chooseHost(&context);
+  EXPECT_NE(hostSet().hosts_[4], spillover_host);
+  EXPECT_EQ(spillover_host, lb->chooseHost(&context));
+  EXPECT_EQ(2UL, stats_.lb_hash_bounded_load_spillover_.value());
+
+  // Once the load is even, the hashed host is under the bound again.
+  stats_.upstream_rq_active_.set(60);
+  for (auto& host : hostSet().hosts_) {
+    host->stats().rq_active_.set(10);
+  }
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+  EXPECT_EQ(2UL, stats_.lb_hash_bounded_load_spillover_.value());
+
+  stats_.upstream_rq_active_.set(0);
+  for (auto& host : hostSet().hosts_) {
+    host->stats().rq_active_.set(0);
+  }
+  EXPECT_EQ(hostSet().hosts_[4], lb->chooseHost(&context));
+  EXPECT_EQ(2UL, stats_.lb_hash_bounded_load_spillover_.value());
+}
+
+// The load bound only counts the share of the active requests sent to the chosen priority, and
+// scales with the host weights.
+TEST_P(RingHashFailoverTest, BoundedLoadPerPriorityAndWeight) {
+  // With 2 of the 3 primary hosts healthy, the primary priority receives 93% of the load and the
+  // failover priority the remaining 7%.
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", 1),
+                      makeTestHost(info_, "tcp://127.0.0.1:91", 3),
+                      makeTestHost(info_, "tcp://127.0.0.1:92")};
+  host_set_.healthy_hosts_ = {host_set_.hosts_[0], host_set_.hosts_[1]};
+  host_set_.runCallbacks({}, {});
+  failover_host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:93")};
+  failover_host_set_.healthy_hosts_ = failover_host_set_.hosts_;
+  failover_host_set_.runCallbacks({}, {});
+
+  common_config_.mutable_consistent_hashing_lb_config()->mutable_hash_balance_factor()->set_value(
+      100);
+  init();
+  LoadBalancerPtr lb = lb_->factory()->create();
+
+  // Find a key hashed to each healthy primary host.
+  absl::optional<uint64_t> light_key;
+  absl::optional<uint64_t> heavy_key;
+  for (uint64_t i = 0; !light_key || !heavy_key; i++) {
+    ASSERT_LT(i, 1000);
+    TestLoadBalancerContext context(i);
+    const HostConstSharedPtr host = lb->chooseHost(&context);
+    if (host == host_set_.hosts_[0]) {
+      light_key = i;
+    } else if (host == host_set_.hosts_[1]) {
+      heavy_key = i;
+    }
+  }
+  TestLoadBalancerContext light_context(light_key.value());
+  TestLoadBalancerContext heavy_context(heavy_key.value());
+
+  // With 100 active requests in the cluster, the primary priority is estimated to have 93 of them.
+  // The bounds are ceil(94 * 1 / 4) = 24 for the light host and ceil(94 * 3 / 4) = 71 for the
+  // heavy host.
+  stats_.upstream_rq_active_.set(100);
+  host_set_.hosts_[0]->stats().rq_active_.set(24);
+  host_set_.hosts_[1]->stats().rq_active_.set(24);
+  EXPECT_EQ(host_set_.hosts_[1], lb->chooseHost(&light_context));
+  EXPECT_EQ(1UL, stats_.lb_hash_bounded_load_spillover_.value());
+  EXPECT_EQ(host_set_.hosts_[1], lb->chooseHost(&heavy_context));
+  EXPECT_EQ(1UL, stats_.lb_hash_bounded_load_spillover_.value());
+
+  host_set_.hosts_[0]->stats().rq_active_.set(23);
+  EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(&light_context));
+  EXPECT_EQ(1UL, stats_.lb_hash_bounded_load_spillover_.value());
+}
+
+// Verify that lookups over a large ring agree with a plain sorted search of the same ring,
+// including keys that wrap around past the largest entry.
+TEST_P(RingHashLoadBalancerTest, LargeRingMatchesSortedSearch) {
+  for (uint32_t i = 0; i < 10; i++) {
+    hostSet().hosts_.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 80 + i)));
+  }
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+
+  config_ = (envoy::api::v2::Cluster::RingHashLbConfig());
+  config_.value().mutable_minimum_ring_size()->set_value(1000);
+  init();
+
+  std::vector<std::pair<uint64_t, HostSharedPtr>> expected_ring;
+  for (const auto& host : hostSet().hosts_) {
+    for (uint32_t i = 0; i < 100; i++) {
+      expected_ring.emplace_back(
+          HashUtil::xxHash64(fmt::format("{}_{}", host->address()->asString(), i)), host);
+    }
+  }
+  std::sort(expected_ring.begin(), expected_ring.end(),
+            [](const std::pair<uint64_t, HostSharedPtr>& lhs,
+               const std::pair<uint64_t, HostSharedPtr>& rhs) { return lhs.first < rhs.first; });
+
+  LoadBalancerPtr lb = lb_->factory()->create();
+  for (uint64_t i = 0; i < 10000; i++) {
+    const uint64_t hash =
+        i == 0 ? std::numeric_limits<uint64_t>::max() : HashUtil::xxHash64(std::to_string(i));
+    auto it = std::lower_bound(expected_ring.begin(), expected_ring.end(), hash,
+                               [](const std::pair<uint64_t, HostSharedPtr>& entry,
+                                  uint64_t value) { return entry.first < value; });
+    const HostSharedPtr& expected_host =
+        it == expected_ring.end() ? expected_ring[0].second : it->second;
+
+    TestLoadBalancerContext context(hash);
+    EXPECT_EQ(expected_host, lb->chooseHost(&context));
+  }
+}
+
 } // namespace Upstream
 } // namespace Envoy
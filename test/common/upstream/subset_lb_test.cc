@@ -962,6 +962,32 @@ TEST_F(SubsetLoadBalancerTest, BalancesNestedSubsets) {
   EXPECT_EQ(nullptr, lb_->chooseHost(&context_unknown_version));
 }
 
+// Criteria matching only some of the keys of a subset selector do not select a subset, even
+// though they identify an intermediate entry of the subset hierarchy.
+TEST_F(SubsetLoadBalancerTest, IgnoresPartialSubsetKeys) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<std::set<std::string>> subset_keys = {{"stage", "version"}};
+  EXPECT_CALL(subset_info_, subsetKeys()).WillRepeatedly(ReturnRef(subset_keys));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}, {"stage", "prod"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.1"}, {"stage", "prod"}}},
+  });
+
+  TestLoadBalancerContext context_prod({{"stage", "prod"}});
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_prod_11({{"version", "1.1"}, {"stage", "prod"}});
+  TestLoadBalancerContext context_prod_11_extra(
+      {{"version", "1.1"}, {"stage", "prod"}, {"zone", "a"}});
+
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_prod));
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_10));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context_prod_11));
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_prod_11_extra));
+}
+
 TEST_F(SubsetLoadBalancerTest, IgnoresUnselectedMetadata) {
   EXPECT_CALL(subset_info_, fallbackPolicy())
       .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
@@ -1,4 +1,5 @@
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <list>
 #include <string>
@@ -866,6 +867,32 @@ TEST(HostImplTest, HealthFlags) {
   EXPECT_EQ(Host::Health::Unhealthy, host->health());
 }
 
+TEST(HostImplTest, PeakEwmaResponseTime) {
+  MockClusterMockPrioritySet cluster;
+  HostSharedPtr host = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", 1);
+  const MonotonicTime start(std::chrono::seconds(100));
+  const MonotonicTime later = start + std::chrono::seconds(10);
+
+  // No history yet.
+  EXPECT_EQ(0, host->peakEwmaResponseTime(start));
+
+  // The first sample is a peak and is adopted as is.
+  host->recordResponseTime(std::chrono::microseconds(1000), start);
+  EXPECT_DOUBLE_EQ(1000, host->peakEwmaResponseTime(start));
+
+  // Reads decay toward zero with a 10s time constant.
+  EXPECT_DOUBLE_EQ(1000 * std::exp(-1.0), host->peakEwmaResponseTime(later));
+
+  // A faster sample is blended in using the same decay.
+  host->recordResponseTime(std::chrono::microseconds(100), later);
+  EXPECT_DOUBLE_EQ(1000 * std::exp(-1.0) + 100 * (1 - std::exp(-1.0)),
+                   host->peakEwmaResponseTime(later));
+
+  // A slower sample replaces the estimate immediately.
+  host->recordResponseTime(std::chrono::microseconds(2000), later);
+  EXPECT_DOUBLE_EQ(2000, host->peakEwmaResponseTime(later));
+}
+
 class StaticClusterImplTest : public testing::Test, public UpstreamImplTestBase {};
 
 TEST_F(StaticClusterImplTest, InitialHosts) {
@@ -1673,6 +1700,24 @@ TEST_F(ClusterInfoImplTest, Metadata) {
   EXPECT_EQ(LoadBalancerType::Maglev, cluster->info()->lbType());
 }
 
+// Peak EWMA cannot be combined with subset load balancing.
+TEST_F(ClusterInfoImplTest, PeakEwmaWithSubsets) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: PEAK_EWMA
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+    lb_subset_config:
+      subset_selectors:
+        - keys: [ "version" ]
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(
+      makeCluster(yaml), EnvoyException,
+      "cluster: LB type 'peak_ewma' may not be used with subset load balancing");
+}
+
 // Typed metadata loading throws exception.
 TEST_F(ClusterInfoImplTest, BrokenTypedMetadata) {
   const std::string yaml = R"EOF(
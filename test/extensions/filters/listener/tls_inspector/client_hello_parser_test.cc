@@ -0,0 +1,182 @@
+#include <string>
+#include <vector>
+
+#include "extensions/filters/listener/tls_inspector/client_hello_parser.h"
+
+#include "test/extensions/filters/listener/tls_inspector/tls_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ListenerFilters {
+namespace TlsInspector {
+namespace {
+
+// Prefixes data with its length, encoded in length_size bytes.
+std::string lengthPrefixed(size_t length_size, const std::string& data) {
+  std::string prefixed;
+  for (size_t i = length_size; i > 0; i--) {
+    prefixed.push_back(static_cast<char>((data.size() >> (8 * (i - 1))) & 0xff));
+  }
+  return prefixed + data;
+}
+
+std::string extension(uint16_t type, const std::string& data) {
+  return std::string{static_cast<char>(type >> 8), static_cast<char>(type & 0xff)} +
+         lengthPrefixed(2, data);
+}
+
+std::string serverName(const std::string& name) {
+  return extension(0, lengthPrefixed(2, std::string(1, '\0') + lengthPrefixed(2, name)));
+}
+
+std::string applicationProtocols(const std::string& protocols) {
+  return extension(16, lengthPrefixed(2, protocols));
+}
+
+// Builds a ClientHello handshake message, with an extension block unless extensions is empty.
+std::string clientHello(const std::string& extensions) {
+  std::string body("\x03\x03", 2);
+  body.append(32, '\0');                                // Random.
+  body.append(lengthPrefixed(1, ""));                   // Session ID.
+  body.append(lengthPrefixed(2, "\x13\x01"));           // Cipher suites.
+  body.append(lengthPrefixed(1, std::string(1, '\0'))); // Compression methods.
+  if (!extensions.empty()) {
+    body.append(lengthPrefixed(2, extensions));
+  }
+  return "\x01" + lengthPrefixed(3, body);
+}
+
+std::string record(const std::string& fragment) {
+  return "\x16\x03\x01" + lengthPrefixed(2, fragment);
+}
+
+class ClientHelloParserTest : public testing::Test {
+public:
+  ClientHelloParser::Result parse(const std::string& data) {
+    return parser_.parse(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  }
+
+  ClientHelloParser::Result parse(const std::vector<uint8_t>& data) {
+    return parser_.parse(data.data(), data.size());
+  }
+
+  ClientHelloParser parser_;
+};
+
+// Test that the server name and application protocols of a ClientHello of the TLS stack are found.
+TEST_F(ClientHelloParserTest, ServerNameAndApplicationProtocols) {
+  EXPECT_EQ(ClientHelloParser::Result::ClientHello,
+            parse(Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1")));
+  EXPECT_EQ("example.com", parser_.serverName());
+  EXPECT_EQ((std::vector<absl::string_view>{"h2", "http/1.1"}), parser_.applicationProtocols());
+
+  // Nothing is kept from the previous ClientHello.
+  EXPECT_EQ(ClientHelloParser::Result::ClientHello,
+            parse(Tls::Test::generateClientHello("", "")));
+  EXPECT_EQ("", parser_.serverName());
+  EXPECT_TRUE(parser_.applicationProtocols().empty());
+}
+
+// Test that a ClientHello without an extension block is found.
+TEST_F(ClientHelloParserTest, NoExtensions) {
+  EXPECT_EQ(ClientHelloParser::Result::ClientHello, parse(record(clientHello(""))));
+  EXPECT_EQ("", parser_.serverName());
+  EXPECT_TRUE(parser_.applicationProtocols().empty());
+}
+
+// Test that every part of a ClientHello needs more data.
+TEST_F(ClientHelloParserTest, Truncated) {
+  const std::vector<uint8_t> client_hello =
+      Tls::Test::generateClientHello("example.com", "\x02h2");
+  for (size_t i = 0; i < client_hello.size(); i++) {
+    EXPECT_EQ(ClientHelloParser::Result::NeedMoreData, parser_.parse(client_hello.data(), i));
+  }
+}
+
+// Test that a ClientHello fragmented over several records is reassembled.
+TEST_F(ClientHelloParserTest, Fragmented) {
+  const std::string handshake =
+      clientHello(serverName("example.com") + applicationProtocols("\x02h2"));
+  std::string records;
+  for (size_t i = 0; i < handshake.size(); i += 7) {
+    records.append(record(handshake.substr(i, 7)));
+  }
+  EXPECT_EQ(ClientHelloParser::Result::ClientHello, parse(records));
+  EXPECT_EQ("example.com", parser_.serverName());
+  EXPECT_EQ((std::vector<absl::string_view>{"h2"}), parser_.applicationProtocols());
+
+  EXPECT_EQ(ClientHelloParser::Result::NeedMoreData, parse(records.substr(0, records.size() - 1)));
+}
+
+// Test that other protocols are told apart from their first bytes.
+TEST_F(ClientHelloParserTest, NotTls) {
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello, parse(std::string("G")));
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello, parse(std::string("\x16\x01", 2)));
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello, parse(std::string(100, '\0')));
+}
+
+// Test that handshake messages other than ClientHello are rejected.
+TEST_F(ClientHelloParserTest, NotClientHello) {
+  std::string server_hello = clientHello("");
+  server_hello[0] = 2;
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello, parse(record(server_hello)));
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello, parse(record(server_hello).substr(0, 6)));
+}
+
+// Test that records larger than TLS allows are rejected.
+TEST_F(ClientHelloParserTest, RecordTooLarge) {
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello,
+            parse(record(clientHello(extension(0xff00, std::string(16 * 1024, 'a'))))));
+}
+
+// Test that truncated or trailing data inside the ClientHello is rejected.
+TEST_F(ClientHelloParserTest, Malformed) {
+  std::string handshake = clientHello(serverName("example.com"));
+  // Claim one byte of extensions less than there are.
+  handshake[handshake.size() - serverName("example.com").size() - 1]--;
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello, parse(record(handshake)));
+
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello,
+            parse(record(clientHello(serverName("example.com") + std::string(1, '\0')))));
+}
+
+// Test that invalid server names are rejected, like the TLS stack does.
+TEST_F(ClientHelloParserTest, InvalidServerName) {
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello, parse(record(clientHello(serverName("")))));
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello,
+            parse(record(clientHello(serverName(std::string("a\0b", 3))))));
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello,
+            parse(record(clientHello(serverName(std::string(256, 'a'))))));
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello,
+            parse(record(clientHello(serverName("a.com") + serverName("b.com")))));
+  // A list of several names.
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello,
+            parse(record(clientHello(
+                extension(0, lengthPrefixed(2, std::string(1, '\0') + lengthPrefixed(2, "a.com") +
+                                                   std::string(1, '\0') +
+                                                   lengthPrefixed(2, "b.com")))))));
+}
+
+// Test that invalid application protocols are ignored, like the TLS inspector always did.
+TEST_F(ClientHelloParserTest, InvalidApplicationProtocols) {
+  EXPECT_EQ(ClientHelloParser::Result::ClientHello,
+            parse(record(clientHello(serverName("example.com") + applicationProtocols("\x02h")))));
+  EXPECT_EQ("example.com", parser_.serverName());
+  EXPECT_TRUE(parser_.applicationProtocols().empty());
+
+  EXPECT_EQ(ClientHelloParser::Result::ClientHello,
+            parse(record(clientHello(applicationProtocols(std::string("\x02h2\x00", 4))))));
+  EXPECT_TRUE(parser_.applicationProtocols().empty());
+
+  EXPECT_EQ(ClientHelloParser::Result::NotClientHello,
+            parse(record(clientHello(applicationProtocols("\x02h2") +
+                                     applicationProtocols("\x08http/1.1")))));
+}
+
+} // namespace
+} // namespace TlsInspector
+} // namespace ListenerFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -3,6 +3,7 @@
 #include "common/network/io_socket_handle_impl.h"
 #include "common/network/listen_socket_impl.h"
 
+#include "extensions/filters/listener/tls_inspector/client_hello_parser.h"
 #include "extensions/filters/listener/tls_inspector/tls_inspector.h"
 
 #include "test/extensions/filters/listener/tls_inspector/tls_utility.h"
@@ -100,6 +101,64 @@ static void BM_TlsInspector(benchmark::State& state) {
 
 BENCHMARK(BM_TlsInspector)->Unit(benchmark::kMicrosecond);
 
+// The extraction of the server name and application protocols by the TLS inspector.
+static void BM_ClientHelloParser(benchmark::State& state) {
+  const std::vector<uint8_t> client_hello =
+      Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1");
+
+  for (auto _ : state) {
+    ClientHelloParser parser;
+    RELEASE_ASSERT(parser.parse(client_hello.data(), client_hello.size()) ==
+                       ClientHelloParser::Result::ClientHello,
+                   "");
+    RELEASE_ASSERT(parser.serverName() == "example.com", "");
+    RELEASE_ASSERT(parser.applicationProtocols().size() == 2, "");
+  }
+}
+
+BENCHMARK(BM_ClientHelloParser)->Unit(benchmark::kMicrosecond);
+
+// The same extraction through the callbacks of a BoringSSL handshake, aborted once the ClientHello
+// was processed, which is how the TLS inspector used to do it.
+static void BM_BoringSslClientHello(benchmark::State& state) {
+  const std::vector<uint8_t> client_hello =
+      Tls::Test::generateClientHello("example.com", "\x02h2\x08http/1.1");
+  bssl::UniquePtr<SSL_CTX> ssl_ctx(SSL_CTX_new(TLS_with_buffers_method()));
+  SSL_CTX_set_options(ssl_ctx.get(), SSL_OP_NO_TICKET);
+  SSL_CTX_set_session_cache_mode(ssl_ctx.get(), SSL_SESS_CACHE_OFF);
+  SSL_CTX_set_select_certificate_cb(
+      ssl_ctx.get(), [](const SSL_CLIENT_HELLO* client_hello) -> ssl_select_cert_result_t {
+        const uint8_t* data;
+        size_t len;
+        RELEASE_ASSERT(SSL_early_callback_ctx_extension_get(
+                           client_hello, TLSEXT_TYPE_application_layer_protocol_negotiation,
+                           &data, &len),
+                       "");
+        return ssl_select_cert_success;
+      });
+  SSL_CTX_set_tlsext_servername_callback(
+      ssl_ctx.get(), [](SSL* ssl, int* out_alert, void*) -> int {
+        RELEASE_ASSERT(absl::string_view(SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name)) ==
+                           "example.com",
+                       "");
+        *out_alert = SSL_AD_USER_CANCELLED;
+        return SSL_TLSEXT_ERR_ALERT_FATAL;
+      });
+
+  for (auto _ : state) {
+    bssl::UniquePtr<SSL> ssl(SSL_new(ssl_ctx.get()));
+    SSL_set_accept_state(ssl.get());
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(client_hello.data(), client_hello.size()));
+    BIO_set_mem_eof_return(bio.get(), -1);
+    SSL_set_bio(ssl.get(), bio.get(), bio.get());
+    bio.release();
+    const int ret = SSL_do_handshake(ssl.get());
+    RELEASE_ASSERT(SSL_get_error(ssl.get(), ret) == SSL_ERROR_SSL, "");
+  }
+}
+
+BENCHMARK(BM_BoringSslClientHello)->Unit(benchmark::kMicrosecond);
+
 } // namespace TlsInspector
 } // namespace ListenerFilters
 } // namespace Extensions
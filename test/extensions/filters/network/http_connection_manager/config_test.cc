@@ -18,6 +18,7 @@
 using testing::_;
 using testing::ContainerEq;
 using testing::Return;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Extensions {
@@ -477,6 +478,37 @@ TEST_F(FilterChainTest, createFilterChain) {
   config.createFilterChain(callbacks);
 }
 
+// Test that the filters of the sampled streams are wrapped for timing, and the others are not.
+TEST_F(FilterChainTest, createTimedFilterChain) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  http_filters:
+  - name: envoy.router
+  filter_timing:
+    sampling:
+      value: 5
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromV2Yaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_);
+
+  Http::MockFilterChainFactoryCallbacks callbacks;
+  Http::StreamDecoderFilterSharedPtr filter;
+  EXPECT_CALL(context_.runtime_loader_.snapshot_,
+              featureEnabled("http_connection_manager.filter_timing_sampling", 500, _, 10000))
+      .WillOnce(Return(false))
+      .WillOnce(Return(true));
+  EXPECT_CALL(callbacks, addStreamDecoderFilter(_)).WillRepeatedly(SaveArg<0>(&filter));
+
+  // The router is only a decoder filter, unlike the filters timing it.
+  config.createFilterChain(callbacks);
+  EXPECT_EQ(nullptr, dynamic_cast<Http::StreamEncoderFilter*>(filter.get()));
+  config.createFilterChain(callbacks);
+  EXPECT_NE(nullptr, dynamic_cast<Http::StreamEncoderFilter*>(filter.get()));
+}
+
 // Tests where upgrades are configured on via the HCM.
 TEST_F(FilterChainTest, createUpgradeFilterChain) {
   auto hcm_config = parseHttpConnectionManagerFromJson(basic_config_);
@@ -108,7 +108,7 @@ TEST(HealthCheckerFactoryTest, createRedisViaUpstreamHealthCheckerFactory) {
   EXPECT_NE(nullptr, dynamic_cast<CustomRedisHealthChecker*>(
                          Upstream::HealthCheckerFactory::create(
                              Upstream::parseHealthCheckFromV2Yaml(yaml), cluster, runtime, random,
-                             dispatcher, log_manager)
+                             dispatcher, log_manager, {})
                              .get()));
 }
 
@@ -133,7 +133,7 @@ TEST(HealthCheckerFactoryTest, createRedisWithDeprecatedV1JsonConfig) {
                          // deprecated config.
                          Upstream::HealthCheckerFactory::create(
                              Upstream::parseHealthCheckFromV1Json(json), cluster, runtime, random,
-                             dispatcher, log_manager)
+                             dispatcher, log_manager, {})
                              .get()));
 }
 
@@ -159,7 +159,7 @@ TEST(HealthCheckerFactoryTest, createRedisWithDeprecatedV1JsonConfigWithKey) {
                          // deprecated config.
                          Upstream::HealthCheckerFactory::create(
                              Upstream::parseHealthCheckFromV1Json(json), cluster, runtime, random,
-                             dispatcher, log_manager)
+                             dispatcher, log_manager, {})
                              .get()));
 }
 
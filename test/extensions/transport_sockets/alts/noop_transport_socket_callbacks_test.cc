@@ -26,6 +26,7 @@ public:
   bool shouldDrainReadBuffer() override { return false; }
   void setReadBufferReady() override { set_read_buffer_ready_ = true; }
   void raiseEvent(Network::ConnectionEvent) override { event_raised_ = true; }
+  void flushWriteBuffer() override {}
 
   bool event_raised() const { return event_raised_; }
   bool set_read_buffer_ready() const { return set_read_buffer_ready_; }
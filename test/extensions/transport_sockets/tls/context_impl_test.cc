@@ -596,6 +596,84 @@ TEST_F(ClientContextConfigImplTest, RSA2048Cert) {
   manager.createSslClientContext(store, client_context_config);
 }
 
+// Validate that only client contexts with the same settings share a session cache key, and that
+// sessions are only exported from contexts that have some.
+TEST_F(ClientContextConfigImplTest, SessionCacheKey) {
+  envoy::api::v2::auth::UpstreamTlsContext tls_context;
+  tls_context.set_sni("example.com");
+  ClientContextConfigImpl client_context_config(tls_context, factory_context_);
+  tls_context.set_sni("example.org");
+  ClientContextConfigImpl other_client_context_config(tls_context, factory_context_);
+
+  Event::SimulatedTimeSystem time_system;
+  ContextManagerImpl manager(time_system);
+  Stats::IsolatedStoreImpl store;
+  ClientContextImpl context(store, client_context_config, time_system);
+  ClientContextImpl same_context(store, client_context_config, time_system);
+  ClientContextImpl other_context(store, other_client_context_config, time_system);
+  EXPECT_EQ(context.sessionCacheKey(), same_context.sessionCacheKey());
+  EXPECT_NE(context.sessionCacheKey(), other_context.sessionCacheKey());
+
+  Envoy::Ssl::ClientContextSharedPtr manager_context =
+      manager.createSslClientContext(store, client_context_config);
+  EXPECT_EQ("", manager.exportClientSessions());
+}
+
+// Validate that client contexts created by a manager with the same session cache key share their
+// sessions for as long as any of them is alive.
+TEST_F(ClientContextConfigImplTest, SharedSessionCache) {
+  envoy::api::v2::auth::UpstreamTlsContext tls_context;
+  tls_context.set_sni("example.com");
+  ClientContextConfigImpl client_context_config(tls_context, factory_context_);
+  tls_context.set_sni("example.org");
+  ClientContextConfigImpl other_client_context_config(tls_context, factory_context_);
+  tls_context.mutable_max_session_keys()->set_value(0);
+  ClientContextConfigImpl no_sessions_client_context_config(tls_context, factory_context_);
+
+  Event::SimulatedTimeSystem time_system;
+  ContextManagerImpl manager(time_system);
+  Stats::IsolatedStoreImpl store;
+  auto context = std::dynamic_pointer_cast<ClientContextImpl>(
+      manager.createSslClientContext(store, client_context_config));
+  auto same_context = std::dynamic_pointer_cast<ClientContextImpl>(
+      manager.createSslClientContext(store, client_context_config));
+  auto other_context = std::dynamic_pointer_cast<ClientContextImpl>(
+      manager.createSslClientContext(store, other_client_context_config));
+  auto no_sessions_context = std::dynamic_pointer_cast<ClientContextImpl>(
+      manager.createSslClientContext(store, no_sessions_client_context_config));
+  ASSERT_NE(nullptr, context->sessionCache());
+  EXPECT_EQ(context->sessionCache(), same_context->sessionCache());
+  EXPECT_NE(context->sessionCache(), other_context->sessionCache());
+  EXPECT_EQ(nullptr, no_sessions_context->sessionCache());
+
+  // The cache outlives the context that created it.
+  const ClientSessionCache* session_cache = context->sessionCache().get();
+  context.reset();
+  auto replacement_context = std::dynamic_pointer_cast<ClientContextImpl>(
+      manager.createSslClientContext(store, client_context_config));
+  EXPECT_EQ(session_cache, replacement_context->sessionCache().get());
+}
+
+// Validate that malformed imported sessions are ignored.
+TEST_F(ClientContextConfigImplTest, ImportMalformedSessions) {
+  envoy::api::v2::auth::UpstreamTlsContext tls_context;
+  ClientContextConfigImpl client_context_config(tls_context, factory_context_);
+  Event::SimulatedTimeSystem time_system;
+  ContextManagerImpl manager(time_system);
+  Stats::IsolatedStoreImpl store;
+
+  // A truncated key.
+  manager.importClientSessions(std::string("\x10\x00\x00\x00", 4) + "abc");
+  // A session count with no sessions following it.
+  manager.importClientSessions(std::string("\x01\x00\x00\x00k\x02\x00\x00\x00", 9));
+  // A session that doesn't parse, for an empty server name.
+  manager.importClientSessions(std::string("\x01\x00\x00\x00k\x01\x00\x00\x00", 9) +
+                               std::string("\x00\x00\x00\x00\x03\x00\x00\x00", 8) + "abc");
+  Envoy::Ssl::ClientContextSharedPtr context =
+      manager.createSslClientContext(store, client_context_config);
+  EXPECT_EQ("", manager.exportClientSessions());
+}
+
 // Validate that 1024-bit RSA certificates are rejected.
 TEST_F(ClientContextConfigImplTest, RSA1024Cert) {
   envoy::api::v2::auth::UpstreamTlsContext tls_context;
@@ -741,6 +819,17 @@ TEST_F(ClientContextConfigImplTest, TlsCertificatesAndSdsConfig) {
       "Multiple TLS certificates are not supported for client contexts");
 }
 
+// Kernel TLS offload can't be combined with renegotiation, which BoringSSL would handle with keys
+// the kernel has taken over.
+TEST_F(ClientContextConfigImplTest, KernelTlsOffloadWithRenegotiation) {
+  envoy::api::v2::auth::UpstreamTlsContext tls_context;
+  tls_context.set_allow_renegotiation(true);
+  tls_context.mutable_common_tls_context()->set_kernel_tls_offload(true);
+  EXPECT_THROW_WITH_MESSAGE(
+      ClientContextConfigImpl client_context_config(tls_context, factory_context_), EnvoyException,
+      "Kernel TLS offload can't be used with renegotiation");
+}
+
 // Validate context config supports SDS, and is marked as not ready if secrets are not yet
 // downloaded.
 TEST_F(ClientContextConfigImplTest, SecretNotReady) {
@@ -1058,6 +1147,35 @@ TEST_F(ServerContextConfigImplTest, MultipleTlsCertificates) {
   EXPECT_THAT(tls_certs[1].get().privateKeyPath(), EndsWith("selfsigned_ecdsa_p256_key.pem"));
 }
 
+// Contexts offloading private key operations with the same settings share a thread pool.
+TEST_F(ServerContextConfigImplTest, PrivateKeyOffloadShared) {
+  const std::string yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+    private_key_offload:
+      threads: 2
+  )EOF";
+  envoy::api::v2::auth::DownstreamTlsContext tls_context;
+  MessageUtil::loadFromYaml(TestEnvironment::substitute(yaml), tls_context);
+  ServerContextConfigImpl config1(tls_context, factory_context_);
+  ServerContextConfigImpl config2(tls_context, factory_context_);
+  ASSERT_NE(nullptr, config1.privateKeyMethodProvider());
+  EXPECT_EQ(config1.privateKeyMethodProvider(), config2.privateKeyMethodProvider());
+
+  auto* offload = tls_context.mutable_common_tls_context()->mutable_private_key_offload();
+  offload->mutable_threads()->set_value(1);
+  ServerContextConfigImpl config3(tls_context, factory_context_);
+  EXPECT_NE(config1.privateKeyMethodProvider(), config3.privateKeyMethodProvider());
+
+  tls_context.mutable_common_tls_context()->clear_private_key_offload();
+  ServerContextConfigImpl config4(tls_context, factory_context_);
+  EXPECT_EQ(nullptr, config4.privateKeyMethodProvider());
+}
+
 TEST_F(ServerContextConfigImplTest, TlsCertificatesAndSdsConfig) {
   envoy::api::v2::auth::DownstreamTlsContext tls_context;
   EXPECT_THROW_WITH_MESSAGE(
@@ -1201,6 +1319,67 @@ TEST_F(ServerContextConfigImplTest, InvalidIgnoreCertsNoCA) {
   EXPECT_NO_THROW(ServerContextConfigImpl server_context_config(tls_context, factory_context_));
 }
 
+TEST(CertificateVerificationCacheTest, ReuseUntilExpiration) {
+  bssl::UniquePtr<X509> cert = readCertFromFile(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"));
+  const std::string key = CertificateVerificationCache::key(*cert, nullptr);
+  const SystemTime now = std::chrono::system_clock::from_time_t(1000000);
+  CertificateVerificationCache cache(2);
+
+  EXPECT_FALSE(cache.lookup(key, now));
+  EXPECT_EQ(0UL, cache.insert(key, std::move(cert), now + std::chrono::seconds(10)));
+  EXPECT_TRUE(cache.lookup(key, now + std::chrono::seconds(9)));
+  EXPECT_FALSE(cache.lookup(key, now + std::chrono::seconds(10)));
+  // The expired outcome is gone for good.
+  EXPECT_FALSE(cache.lookup(key, now));
+}
+
+TEST(CertificateVerificationCacheTest, KeyCoversChain) {
+  bssl::UniquePtr<X509> cert = readCertFromFile(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns3_cert.pem"));
+  bssl::UniquePtr<X509> intermediate = readCertFromFile(
+      TestEnvironment::substitute("{{ test_rundir }}/test/extensions/transport_sockets/tls/"
+                                  "test_data/intermediate_ca_cert.pem"));
+  bssl::UniquePtr<STACK_OF(X509)> chain(sk_X509_new_null());
+  ASSERT_NE(0, sk_X509_push(chain.get(), intermediate.release()));
+
+  EXPECT_EQ(CertificateVerificationCache::key(*cert, nullptr),
+            CertificateVerificationCache::key(*cert, nullptr));
+  EXPECT_NE(CertificateVerificationCache::key(*cert, nullptr),
+            CertificateVerificationCache::key(*cert, chain.get()));
+}
+
+TEST(CertificateVerificationCacheTest, EvictLeastRecentlyUsed) {
+  std::vector<bssl::UniquePtr<X509>> certs;
+  std::vector<std::string> keys;
+  std::vector<std::string> serial_numbers;
+  for (const char* name : {"san_dns_cert", "san_dns2_cert", "no_san_cert"}) {
+    certs.emplace_back(readCertFromFile(TestEnvironment::substitute(
+        std::string("{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/") + name +
+        ".pem")));
+    keys.emplace_back(CertificateVerificationCache::key(*certs.back(), nullptr));
+    serial_numbers.emplace_back(Utility::getSerialNumberFromCertificate(*certs.back()));
+  }
+  const SystemTime now = std::chrono::system_clock::from_time_t(1000000);
+  const SystemTime expiration = now + std::chrono::seconds(10);
+  CertificateVerificationCache cache(2);
+
+  EXPECT_EQ(0UL, cache.insert(keys[0], std::move(certs[0]), expiration));
+  EXPECT_EQ(0UL, cache.insert(keys[1], std::move(certs[1]), expiration));
+  EXPECT_TRUE(cache.lookup(keys[0], now));
+  EXPECT_EQ(1UL, cache.insert(keys[2], std::move(certs[2]), expiration));
+  EXPECT_FALSE(cache.lookup(keys[1], now));
+  EXPECT_TRUE(cache.lookup(keys[0], now));
+
+  std::vector<std::string> cached_serial_numbers;
+  cache.iterate([&](X509& cert, SystemTime cert_expiration) -> void {
+    cached_serial_numbers.emplace_back(Utility::getSerialNumberFromCertificate(cert));
+    EXPECT_EQ(expiration, cert_expiration);
+  });
+  EXPECT_EQ(std::vector<std::string>({serial_numbers[0], serial_numbers[2]}),
+            cached_serial_numbers);
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -639,7 +639,8 @@ protected:
 
   void testClientSessionResumption(const std::string& server_ctx_yaml,
                                    const std::string& client_ctx_yaml, bool expect_reuse,
-                                   const Network::Address::IpVersion version);
+                                   const Network::Address::IpVersion version,
+                                   bool hand_off_sessions = false);
 
   Event::DispatcherPtr dispatcher_;
 };
@@ -879,6 +880,125 @@ TEST_P(SslSocketTest, MultiCertPreferEcdsa) {
   testUtil(test_options);
 }
 
+// Private key operations on both sides run on thread pools, with the client signing for its
+// certificate.
+TEST_P(SslSocketTest, PrivateKeyOffload) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    private_key_offload: {}
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+    private_key_offload:
+      threads: 2
+      max_batch_size: 4
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options.setExpectedDigest(TEST_NO_SAN_CERT_HASH)
+               .setExpectedSerialNumber(TEST_NO_SAN_CERT_SERIAL));
+}
+
+TEST_P(SslSocketTest, PrivateKeyOffloadTls13) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    private_key_offload: {}
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+    private_key_offload: {}
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options.setExpectedDigest(TEST_NO_SAN_CERT_HASH)
+               .setExpectedSerialNumber(TEST_NO_SAN_CERT_SERIAL));
+}
+
+TEST_P(SslSocketTest, PrivateKeyOffloadEcdsa) {
+  const std::string client_ctx_yaml = absl::StrCat(R"EOF(
+    common_tls_context:
+      tls_params:
+        cipher_suites:
+        - ECDHE-ECDSA-AES128-GCM-SHA256
+      validation_context:
+        verify_certificate_hash: )EOF",
+                                                   TEST_SELFSIGNED_ECDSA_P256_CERT_HASH);
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_ecdsa_p256_key.pem"
+    private_key_offload: {}
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options);
+}
+
+// RSA key exchange decrypts the premaster secret rather than signing.
+TEST_P(SslSocketTest, PrivateKeyOffloadRsaKeyExchange) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - AES128-GCM-SHA256
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      cipher_suites:
+      - AES128-GCM-SHA256
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    private_key_offload: {}
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options);
+}
+
 TEST_P(SslSocketTest, GetUriWithLocalUriSan) {
   const std::string client_ctx_yaml = R"EOF(
   common_tls_context:
@@ -2082,6 +2202,114 @@ TEST_P(SslSocketTest, HalfClose) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Test that data and half-close are exchanged correctly with kernel TLS offload enabled. Whether
+// a connection is actually offloaded depends on the kernel, which may not support kTLS.
+TEST_P(SslSocketTest, KernelTlsOffload) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+      cipher_suites:
+      - ECDHE-RSA-AES128-GCM-SHA256
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+    kernel_tls_offload: true
+)EOF";
+
+  envoy::api::v2::auth::DownstreamTlsContext server_tls_context;
+  MessageUtil::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_);
+  ContextManagerImpl manager(time_system_);
+  Stats::IsolatedStoreImpl server_stats_store;
+  ServerSslSocketFactory server_ssl_socket_factory(std::move(server_cfg), manager,
+                                                   server_stats_store, std::vector<std::string>{});
+
+  Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr,
+                                  true);
+  Network::MockListenerCallbacks listener_callbacks;
+  Network::MockConnectionHandler connection_handler;
+  Network::ListenerPtr listener =
+      dispatcher_->createListener(socket, listener_callbacks, true, false);
+  std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      kernel_tls_offload: true
+  )EOF";
+
+  envoy::api::v2::auth::UpstreamTlsContext tls_context;
+  MessageUtil::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+  auto client_cfg = std::make_unique<ClientContextConfigImpl>(tls_context, factory_context_);
+  Stats::IsolatedStoreImpl client_stats_store;
+  ClientSslSocketFactory client_ssl_socket_factory(std::move(client_cfg), manager,
+                                                   client_stats_store);
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket.localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+  client_connection->enableHalfClose(true);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->connect();
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+
+  // Larger than a record, so that the data is split into several records.
+  const std::string request(64 * 1024, 'a');
+  std::string received_request;
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(listener_callbacks, onAccept_(_, _))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket, bool) -> void {
+        Network::ConnectionPtr new_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory.createTransportSocket(nullptr));
+        listener_callbacks.onNewConnection(std::move(new_connection));
+      }));
+  EXPECT_CALL(listener_callbacks, onNewConnection_(_))
+      .WillOnce(Invoke([&](Network::ConnectionPtr& conn) -> void {
+        server_connection = std::move(conn);
+        server_connection->enableHalfClose(true);
+        server_connection->addReadFilter(server_read_filter);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+      }));
+
+  EXPECT_CALL(*server_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+        Buffer::OwnedImpl buffer(request);
+        client_connection->write(buffer, true);
+      }));
+  EXPECT_CALL(*server_read_filter, onData(_, _))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool end_stream) -> Network::FilterStatus {
+        received_request.append(data.toString());
+        data.drain(data.length());
+        if (end_stream) {
+          EXPECT_EQ(request, received_request);
+          Buffer::OwnedImpl buffer("hello");
+          server_connection->write(buffer, true);
+        }
+        return Network::FilterStatus::Continue;
+      }));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("hello"), true));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  for (Stats::IsolatedStoreImpl* store : {&server_stats_store, &client_stats_store}) {
+    EXPECT_EQ(1UL, store->counter("ssl.kernel_tls_tx_offload").value() +
+                       store->counter("ssl.kernel_tls_fallback").value());
+    EXPECT_EQ(0UL, store->counter("ssl.connection_error").value());
+  }
+}
+
 TEST_P(SslSocketTest, ClientAuthMultipleCAs) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -2169,13 +2397,18 @@ TEST_P(SslSocketTest, ClientAuthMultipleCAs) {
 
 namespace {
 
-// Test connecting with a client to server1, then trying to reuse the session on server2
+// Test connecting with a client to server1, then trying to reuse the session on server2. If
+// use_tickets is false, the client doesn't support session tickets, so the session can only be
+// resumed by its session ID. expected_client_verify_cache_hits is the number of times the client
+// reuses the outcome of verifying the certificate chain of server1 for server2.
 void testTicketSessionResumption(const std::string& server_ctx_yaml1,
                                  const std::vector<std::string>& server_names1,
                                  const std::string& server_ctx_yaml2,
                                  const std::vector<std::string>& server_names2,
                                  const std::string& client_ctx_yaml, bool expect_reuse,
-                                 const Network::Address::IpVersion ip_version) {
+                                 const Network::Address::IpVersion ip_version,
+                                 bool use_tickets = true,
+                                 uint64_t expected_client_verify_cache_hits = 0) {
   Event::SimulatedTimeSystem time_system;
   ContextManagerImpl manager(*time_system);
 
@@ -2224,6 +2457,10 @@ void testTicketSessionResumption(const std::string& server_ctx_yaml1,
   Network::ClientConnectionPtr client_connection = dispatcher->createClientConnection(
       socket1.localAddress(), Network::Address::InstanceConstSharedPtr(),
       ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+  if (!use_tickets) {
+    SSL_set_options(dynamic_cast<const SslSocket*>(client_connection->ssl())->rawSslForTest(),
+                    SSL_OP_NO_TICKET);
+  }
 
   Network::MockConnectionCallbacks client_connection_callbacks;
   client_connection->addConnectionCallbacks(client_connection_callbacks);
@@ -2267,6 +2504,9 @@ void testTicketSessionResumption(const std::string& server_ctx_yaml1,
   const SslSocket* ssl_socket = dynamic_cast<const SslSocket*>(client_connection->ssl());
   SSL_set_session(ssl_socket->rawSslForTest(), ssl_session);
   SSL_SESSION_free(ssl_session);
+  if (!use_tickets) {
+    SSL_set_options(ssl_socket->rawSslForTest(), SSL_OP_NO_TICKET);
+  }
 
   client_connection->connect();
 
@@ -2301,6 +2541,12 @@ void testTicketSessionResumption(const std::string& server_ctx_yaml1,
 
   EXPECT_EQ(expect_reuse ? 1UL : 0UL, server_stats_store.counter("ssl.session_reused").value());
   EXPECT_EQ(expect_reuse ? 1UL : 0UL, client_stats_store.counter("ssl.session_reused").value());
+  if (!use_tickets) {
+    EXPECT_EQ(expect_reuse ? 1UL : 0UL,
+              server_stats_store.counter("ssl.session_cache_hit").value());
+  }
+  EXPECT_EQ(expected_client_verify_cache_hits,
+            client_stats_store.counter("ssl.cert_verify_cache_hit").value());
 }
 } // namespace
 
@@ -2458,6 +2704,190 @@ TEST_P(SslSocketTest, TicketSessionResumptionDifferentServerNames) {
                               client_ctx_yaml, false, GetParam());
 }
 
+// Sessions resumed by session ID are kept in the cache shared by all server contexts of a manager,
+// so a context with the same settings resumes the sessions of another.
+TEST_P(SslSocketTest, SessionIdResumptionAcrossContexts) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      tls_params:
+        tls_maximum_protocol_version: TLSv1_2
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, true,
+                              GetParam(), false);
+}
+
+TEST_P(SslSocketTest, SessionIdResumptionDifferentServerNames) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"
+)EOF";
+
+  std::vector<std::string> server_names1 = {"server1.example.com"};
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      tls_params:
+        tls_maximum_protocol_version: TLSv1_2
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, server_names1, server_ctx_yaml, {},
+                              client_ctx_yaml, false, GetParam(), false);
+}
+
+namespace {
+
+// A server context validating client certificates, followed by the given additional settings.
+std::string clientValidatingServerContextYaml(const std::string& extra_yaml) {
+  return R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+)EOF" + extra_yaml;
+}
+
+// A client presenting a certificate that the CRL of the test data does not revoke.
+std::string clientWithCertificateContextYaml() {
+  return R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns2_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns2_key.pem"
+)EOF";
+}
+
+} // namespace
+
+// The session of a client validated with the same settings is resumed by session ID.
+TEST_P(SslSocketTest, SessionIdResumptionWithClientCA) {
+  testTicketSessionResumption(clientValidatingServerContextYaml(""), {},
+                              clientValidatingServerContextYaml(""), {},
+                              clientWithCertificateContextYaml(), true, GetParam(), false);
+}
+
+// A session established where a client certificate is optional isn't resumed where one is
+// required, since BoringSSL doesn't require a certificate of a resumed session.
+TEST_P(SslSocketTest, SessionIdResumptionDifferentRequireClientCertificate) {
+  testTicketSessionResumption(clientValidatingServerContextYaml(""), {},
+                              clientValidatingServerContextYaml(R"EOF(
+  require_client_certificate: true
+)EOF"),
+                              {}, clientWithCertificateContextYaml(), false, GetParam(), false);
+}
+
+// A session validated before a revocation list was added isn't resumed with it.
+TEST_P(SslSocketTest, SessionIdResumptionDifferentCrl) {
+  testTicketSessionResumption(clientValidatingServerContextYaml(""), {},
+                              clientValidatingServerContextYaml(R"EOF(
+      crl:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.crl"
+)EOF"),
+                              {}, clientWithCertificateContextYaml(), false, GetParam(), false);
+}
+
+// A session validated while expired certificates were allowed isn't resumed once they are not.
+TEST_P(SslSocketTest, SessionIdResumptionDifferentAllowExpiredCertificate) {
+  testTicketSessionResumption(clientValidatingServerContextYaml(R"EOF(
+      allow_expired_certificate: true
+)EOF"),
+                              {}, clientValidatingServerContextYaml(""), {},
+                              clientWithCertificateContextYaml(), false, GetParam(), false);
+}
+
+// Contexts that don't use the shared session cache only resume their own sessions.
+TEST_P(SslSocketTest, SessionIdResumptionSharedCacheDisabled) {
+  const std::string server_ctx_yaml = clientValidatingServerContextYaml(R"EOF(
+  disable_shared_session_cache: true
+)EOF");
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {},
+                              clientWithCertificateContextYaml(), false, GetParam(), false);
+}
+
+// A full handshake with a server presenting a chain the client has verified before reuses the
+// outcome of the verification.
+TEST_P(SslSocketTest, CertificateVerificationCache) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"
+)EOF";
+
+  std::vector<std::string> server_names1 = {"server1.example.com"};
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      tls_params:
+        tls_maximum_protocol_version: TLSv1_2
+      validation_context:
+        trusted_ca:
+          filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, server_names1, server_ctx_yaml, {},
+                              client_ctx_yaml, false, GetParam(), false, 1);
+}
+
+// A different chain is verified in full, even with the same names and issuer.
+TEST_P(SslSocketTest, CertificateVerificationCacheDifferentServerCert) {
+  const std::string server_ctx_yaml1 = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_key.pem"
+)EOF";
+
+  const std::string server_ctx_yaml2 = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns2_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns2_key.pem"
+)EOF";
+
+  std::vector<std::string> server_names1 = {"server1.example.com"};
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      tls_params:
+        tls_maximum_protocol_version: TLSv1_2
+      validation_context:
+        trusted_ca:
+          filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml1, server_names1, server_ctx_yaml2, {},
+                              client_ctx_yaml, false, GetParam(), false, 0);
+}
+
 // Sessions can be resumed because the server certificates are different but the CN/SANs and
 // issuer are identical
 TEST_P(SslSocketTest, TicketSessionResumptionDifferentServerCert) {
@@ -2705,10 +3135,13 @@ TEST_P(SslSocketTest, ClientAuthCrossListenerSessionResumption) {
 void SslSocketTest::testClientSessionResumption(const std::string& server_ctx_yaml,
                                                 const std::string& client_ctx_yaml,
                                                 bool expect_reuse,
-                                                const Network::Address::IpVersion version) {
+                                                const Network::Address::IpVersion version,
+                                                bool hand_off_sessions) {
   InSequence s;
 
   ContextManagerImpl manager(time_system_);
+  // The manager the sessions are handed off to, as during a hot restart, if hand_off_sessions.
+  ContextManagerImpl child_manager(time_system_);
 
   Stats::IsolatedStoreImpl server_stats_store;
   Api::ApiPtr server_api = Api::createApiForTest(server_stats_store, time_system_);
@@ -2813,9 +3246,21 @@ void SslSocketTest::testClientSessionResumption(const std::string& server_ctx_ya
   connect_count = 0;
   close_count = 0;
 
+  // When handing off sessions, the second connection uses a new context created by another
+  // manager, which only has the sessions it was handed.
+  std::unique_ptr<ClientSslSocketFactory> child_client_ssl_socket_factory;
+  Network::TransportSocketFactory* second_client_ssl_socket_factory = &client_ssl_socket_factory;
+  if (hand_off_sessions) {
+    child_manager.importClientSessions(manager.exportClientSessions());
+    child_client_ssl_socket_factory = std::make_unique<ClientSslSocketFactory>(
+        std::make_unique<ClientContextConfigImpl>(client_ctx_proto, client_factory_context),
+        child_manager, client_stats_store);
+    second_client_ssl_socket_factory = child_client_ssl_socket_factory.get();
+  }
+
   client_connection = dispatcher->createClientConnection(
       socket.localAddress(), Network::Address::InstanceConstSharedPtr(),
-      client_ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+      second_client_ssl_socket_factory->createTransportSocket(nullptr), nullptr);
   client_connection->addConnectionCallbacks(client_connection_callbacks);
   client_connection->connect();
 
@@ -2971,6 +3416,58 @@ TEST_P(SslSocketTest, ClientSessionResumptionEnabledTls13) {
   testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+// Test that sessions handed off to another context manager with TLS 1.0-1.2 are resumed by its
+// contexts with the same configuration.
+TEST_P(SslSocketTest, ClientSessionResumptionHandOffTls12) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_0
+      tls_maximum_protocol_version: TLSv1_2
+  max_session_keys: 2
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam(), true);
+}
+
+// Test that sessions handed off to another context manager with TLS 1.3 are resumed by its
+// contexts with the same configuration.
+TEST_P(SslSocketTest, ClientSessionResumptionHandOffTls13) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+  max_session_keys: 2
+)EOF";
+
+  testClientSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam(), true);
+}
+
 TEST_P(SslSocketTest, SslError) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -3669,7 +4166,8 @@ protected:
   }
 
   void readBufferLimitTest(uint32_t read_buffer_limit, uint32_t expected_chunk_size,
-                           uint32_t write_size, uint32_t num_writes, bool reserve_write_space) {
+                           uint32_t write_size, uint32_t num_writes, bool reserve_write_space,
+                           uint64_t expected_write_bytes_copied = 0) {
     initialize();
 
     EXPECT_CALL(listener_callbacks_, onAccept_(_, _))
@@ -3731,6 +4229,8 @@ protected:
 
     EXPECT_EQ(0UL, server_stats_store_.counter("ssl.connection_error").value());
     EXPECT_EQ(0UL, client_stats_store_.counter("ssl.connection_error").value());
+    EXPECT_EQ(expected_write_bytes_copied,
+              client_stats_store_.counter("ssl.write_bytes_copied").value());
   }
 
   void singleWriteTest(uint32_t read_buffer_limit, uint32_t bytes_to_write) {
@@ -3855,8 +4355,10 @@ TEST_P(SslReadBufferLimitTest, NoLimit) {
 
 TEST_P(SslReadBufferLimitTest, NoLimitReserveSpace) { readBufferLimitTest(0, 512, 512, 1, true); }
 
+// Each small write is its own slice of the write buffer, so all of them are copied into full
+// records rather than each being sealed into a record of its own.
 TEST_P(SslReadBufferLimitTest, NoLimitSmallWrites) {
-  readBufferLimitTest(0, 256 * 1024, 1, 256 * 1024, false);
+  readBufferLimitTest(0, 256 * 1024, 1, 256 * 1024, false, 256 * 1024);
 }
 
 TEST_P(SslReadBufferLimitTest, SomeLimit) {
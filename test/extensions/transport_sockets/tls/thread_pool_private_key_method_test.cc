@@ -0,0 +1,131 @@
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/ssl/private_key_method.h"
+
+#include "extensions/transport_sockets/tls/thread_pool_private_key_method.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class MockPrivateKeyConnectionCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  MOCK_METHOD0(onPrivateKeyMethodComplete, void());
+};
+
+class ThreadPoolPrivateKeyMethodProviderTest : public testing::Test {
+public:
+  ThreadPoolPrivateKeyMethodProviderTest()
+      : provider_(Thread::threadFactoryForTest(), 1, 1), ctx_(SSL_CTX_new(TLS_method())) {
+    const std::string key = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"));
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(key.data(), key.size()));
+    bssl::UniquePtr<EVP_PKEY> pkey(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+    EXPECT_EQ(1, SSL_CTX_use_PrivateKey(ctx_.get(), pkey.get()));
+    SSL_CTX_set_private_key_method(ctx_.get(), &provider_.boringSslPrivateKeyMethod());
+    ssl_.reset(SSL_new(ctx_.get()));
+
+    // Results are posted from the thread of the pool. The completions are run by the test.
+    ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([this](std::function<void()> callback) {
+      posted_ = std::move(callback);
+      posted_notification_.Notify();
+    }));
+  }
+
+  // Starts signing with the key of the connection and waits for the result to be posted.
+  void sign() {
+    const uint8_t input[] = "hello";
+    size_t out_len;
+    EXPECT_EQ(ssl_private_key_retry,
+              provider_.boringSslPrivateKeyMethod().sign(ssl_.get(), nullptr, &out_len, 0,
+                                                         SSL_SIGN_RSA_PKCS1_SHA256, input,
+                                                         sizeof(input)));
+    posted_notification_.WaitForNotification();
+  }
+
+  ssl_private_key_result_t complete() {
+    size_t out_len;
+    return provider_.boringSslPrivateKeyMethod().complete(ssl_.get(), out_, &out_len,
+                                                          sizeof(out_));
+  }
+
+  ThreadPoolPrivateKeyMethodProvider provider_;
+  bssl::UniquePtr<SSL_CTX> ctx_;
+  bssl::UniquePtr<SSL> ssl_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  MockPrivateKeyConnectionCallbacks callbacks_;
+  std::function<void()> posted_;
+  absl::Notification posted_notification_;
+  uint8_t out_[1024];
+};
+
+// Test that the connection is told once the result of its operation is posted.
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, Complete) {
+  provider_.registerPrivateKeyMethod(ssl_.get(), callbacks_, dispatcher_);
+  sign();
+
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete());
+  posted_();
+  EXPECT_EQ(ssl_private_key_success, complete());
+  provider_.unregisterPrivateKeyMethod(ssl_.get());
+}
+
+// Test that a connection that collected its result before the posted completion runs, for
+// instance because the handshake was driven by a socket event, and was then closed, isn't called
+// back.
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, CompleteBeforePostedCompletion) {
+  provider_.registerPrivateKeyMethod(ssl_.get(), callbacks_, dispatcher_);
+  sign();
+
+  EXPECT_EQ(ssl_private_key_success, complete());
+  provider_.unregisterPrivateKeyMethod(ssl_.get());
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(0);
+  posted_();
+}
+
+// Test that a connection closed with an operation in flight isn't called back.
+TEST_F(ThreadPoolPrivateKeyMethodProviderTest, UnregisterBeforePostedCompletion) {
+  provider_.registerPrivateKeyMethod(ssl_.get(), callbacks_, dispatcher_);
+  sign();
+
+  provider_.unregisterPrivateKeyMethod(ssl_.get());
+  EXPECT_CALL(callbacks_, onPrivateKeyMethodComplete()).Times(0);
+  posted_();
+}
+
+// Test that providers are shared by their settings, and started again once released.
+TEST(ThreadPoolPrivateKeyMethodProvidersTest, SharedBySettings) {
+  ThreadPoolPrivateKeyMethodProviders providers(Thread::threadFactoryForTest());
+  Ssl::PrivateKeyMethodProviderSharedPtr provider = providers.get(2, 4);
+  EXPECT_EQ(provider, providers.get(2, 4));
+  EXPECT_NE(provider, providers.get(1, 4));
+  EXPECT_NE(provider, providers.get(2, 8));
+
+  std::weak_ptr<Ssl::PrivateKeyMethodProvider> released = provider;
+  provider.reset();
+  EXPECT_TRUE(released.expired());
+  EXPECT_NE(nullptr, providers.get(2, 4));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -152,9 +152,15 @@ public:
     xds_stream_->startGrpcStream();
     fake_upstreams_[0]->set_allow_unexpected_disconnects(true);
 
-    EXPECT_TRUE(compareDiscoveryRequest(Config::TypeUrl::get().Cluster, "", {}));
-    sendDiscoveryResponse<envoy::api::v2::Cluster>(Config::TypeUrl::get().Cluster,
-                                                   {buildCluster(ClusterName)}, "1");
+    if (incremental_) {
+      EXPECT_TRUE(compareIncrementalDiscoveryRequest(Config::TypeUrl::get().Cluster, {}, {}));
+      sendIncrementalDiscoveryResponse<envoy::api::v2::Cluster>({buildCluster(ClusterName)}, {},
+                                                                "1");
+    } else {
+      EXPECT_TRUE(compareDiscoveryRequest(Config::TypeUrl::get().Cluster, "", {}));
+      sendDiscoveryResponse<envoy::api::v2::Cluster>(Config::TypeUrl::get().Cluster,
+                                                     {buildCluster(ClusterName)}, "1");
+    }
     // We can continue the test once we're sure that Envoy's ClusterManager has made use of
     // the DiscoveryResponse describing cluster_0 that we sent.
     // 2 because the statically specified CDS server itself counts as a cluster.
@@ -165,10 +171,28 @@ public:
     test_server_->waitUntilListenersReady();
     registerTestServerPorts({"http"});
   }
+
+  bool incremental_{false};
 };
 
 INSTANTIATE_TEST_SUITE_P(IpVersionsClientType, CdsIntegrationTest, GRPC_CLIENT_INTEGRATION_PARAMS);
 
+class IncrementalCdsIntegrationTest : public CdsIntegrationTest {
+public:
+  IncrementalCdsIntegrationTest() {
+    incremental_ = true;
+    config_helper_.addConfigModifier([](envoy::config::bootstrap::v2::Bootstrap& bootstrap) {
+      bootstrap.mutable_dynamic_resources()
+          ->mutable_cds_config()
+          ->mutable_api_config_source()
+          ->set_api_type(envoy::api::v2::core::ApiConfigSource::INCREMENTAL_GRPC);
+    });
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(IpVersionsClientType, IncrementalCdsIntegrationTest,
+                         GRPC_CLIENT_INTEGRATION_PARAMS);
+
 // 1) Envoy starts up with no static clusters (other than the CDS-over-gRPC server).
 // 2) Envoy is told of a cluster via CDS.
 // 3) We send Envoy a request, which we verify is properly proxied to and served by that cluster.
@@ -211,5 +235,44 @@ TEST_P(CdsIntegrationTest, CdsClusterUpDownUp) {
   cleanupUpstreamAndDownstream();
 }
 
+// Same as CdsClusterUpDownUp, but over the incremental protocol: the removal of cluster_0 is sent
+// as just its name, and adding a second cluster does not resend (or touch) cluster_0.
+TEST_P(IncrementalCdsIntegrationTest, CdsClusterUpDownUp) {
+  // Calls our initialize(), which includes establishing a listener, route, and cluster.
+  testRouterHeaderOnlyRequestAndResponse(nullptr, UpstreamIndex);
+
+  // Tell Envoy that cluster_0 is gone.
+  EXPECT_TRUE(compareIncrementalDiscoveryRequest(Config::TypeUrl::get().Cluster, {}, {}));
+  sendIncrementalDiscoveryResponse<envoy::api::v2::Cluster>({}, {ClusterName}, "42");
+  test_server_->waitForCounterGe("cluster_manager.cluster_removed", 1);
+
+  // Now that cluster_0 is gone, the listener (with its routing to cluster_0) should 503.
+  BufferingStreamDecoderPtr response = IntegrationUtil::makeSingleRequest(
+      lookupPort("http"), "GET", "/unknown", "", downstream_protocol_, version_, "foo.com");
+  ASSERT_TRUE(response->complete());
+  EXPECT_STREQ("503", response->headers().Status()->value().c_str());
+
+  cleanupUpstreamAndDownstream();
+  codec_client_->waitForDisconnect();
+
+  // Tell Envoy that cluster_0 is back.
+  EXPECT_TRUE(compareIncrementalDiscoveryRequest(Config::TypeUrl::get().Cluster, {}, {}));
+  sendIncrementalDiscoveryResponse<envoy::api::v2::Cluster>({buildCluster(ClusterName)}, {},
+                                                            "413");
+  test_server_->waitForGaugeGe("cluster_manager.active_clusters", 2);
+
+  // Add a second cluster. Only the new cluster is sent, and cluster_0 is left untouched.
+  EXPECT_TRUE(compareIncrementalDiscoveryRequest(Config::TypeUrl::get().Cluster, {}, {}));
+  sendIncrementalDiscoveryResponse<envoy::api::v2::Cluster>({buildCluster("cluster_1")}, {},
+                                                            "414");
+  test_server_->waitForGaugeGe("cluster_manager.active_clusters", 3);
+  EXPECT_EQ(0, test_server_->counter("cluster_manager.cluster_modified")->value());
+
+  // Does *not* call our initialize().
+  testRouterHeaderOnlyRequestAndResponse(nullptr, UpstreamIndex);
+
+  cleanupUpstreamAndDownstream();
+}
+
 } // namespace
 } // namespace Envoy
@@ -525,4 +525,44 @@ AssertionResult BaseIntegrationTest::compareDiscoveryRequest(
   }
   return AssertionSuccess();
 }
+
+AssertionResult BaseIntegrationTest::compareIncrementalDiscoveryRequest(
+    const std::string& expected_type_url,
+    const std::vector<std::string>& expected_resource_subscriptions,
+    const std::vector<std::string>& expected_resource_unsubscriptions,
+    const Protobuf::int32 expected_error_code, const std::string& expected_error_message) {
+  envoy::api::v2::IncrementalDiscoveryRequest request;
+  VERIFY_ASSERTION(xds_stream_->waitForGrpcMessage(*dispatcher_, request));
+
+  if (!(expected_type_url == request.type_url())) {
+    return AssertionFailure() << fmt::format("type_url {} does not match expected {}",
+                                             request.type_url(), expected_type_url);
+  }
+  if (!(expected_error_code == request.error_detail().code())) {
+    return AssertionFailure() << fmt::format("error_code {} does not match expected {}",
+                                             request.error_detail().code(), expected_error_code);
+  }
+  EXPECT_TRUE(IsSubstring("", "", expected_error_message, request.error_detail().message()));
+  const std::vector<std::string> resource_subscriptions(request.resource_names_subscribe().cbegin(),
+                                                        request.resource_names_subscribe().cend());
+  if (expected_resource_subscriptions != resource_subscriptions) {
+    return AssertionFailure() << fmt::format(
+               "newly subscribed resources {} do not match expected {} in {}",
+               fmt::join(resource_subscriptions.begin(), resource_subscriptions.end(), ","),
+               fmt::join(expected_resource_subscriptions.begin(),
+                         expected_resource_subscriptions.end(), ","),
+               request.DebugString());
+  }
+  const std::vector<std::string> resource_unsubscriptions(
+      request.resource_names_unsubscribe().cbegin(), request.resource_names_unsubscribe().cend());
+  if (expected_resource_unsubscriptions != resource_unsubscriptions) {
+    return AssertionFailure() << fmt::format(
+               "newly unsubscribed resources {} do not match expected {} in {}",
+               fmt::join(resource_unsubscriptions.begin(), resource_unsubscriptions.end(), ","),
+               fmt::join(expected_resource_unsubscriptions.begin(),
+                         expected_resource_unsubscriptions.end(), ","),
+               request.DebugString());
+  }
+  return AssertionSuccess();
+}
 } // namespace Envoy
@@ -42,6 +42,9 @@ public:
   // Network::DnsResolver
   MOCK_METHOD3(resolve, ActiveDnsQuery*(const std::string& dns_name,
                                         DnsLookupFamily dns_lookup_family, ResolveCb callback));
+  MOCK_METHOD3(resolveWithTtl,
+               ActiveDnsQuery*(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                               ResolveWithTtlCb callback));
 
   testing::NiceMock<MockActiveDnsQuery> active_query_;
 };
@@ -396,6 +399,7 @@ public:
   MOCK_METHOD0(shouldDrainReadBuffer, bool());
   MOCK_METHOD0(setReadBufferReady, void());
   MOCK_METHOD1(raiseEvent, void(ConnectionEvent));
+  MOCK_METHOD0(flushWriteBuffer, void());
 
   testing::NiceMock<MockConnection> connection_;
 };
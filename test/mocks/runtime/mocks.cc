@@ -14,7 +14,10 @@ MockRandomGenerator::MockRandomGenerator() { ON_CALL(*this, uuid()).WillByDefaul
 
 MockRandomGenerator::~MockRandomGenerator() {}
 
-MockSnapshot::MockSnapshot() { ON_CALL(*this, getInteger(_, _)).WillByDefault(ReturnArg<1>()); }
+MockSnapshot::MockSnapshot() {
+  ON_CALL(*this, getInteger(_, _)).WillByDefault(ReturnArg<1>());
+  ON_CALL(*this, getDouble(_, _)).WillByDefault(ReturnArg<1>());
+}
 
 MockSnapshot::~MockSnapshot() {}
 
@@ -22,6 +25,10 @@ MockLoader::MockLoader() { ON_CALL(*this, snapshot()).WillByDefault(ReturnRef(sn
 
 MockLoader::~MockLoader() {}
 
+InternedKey MockLoader::internKey(const std::string& key) {
+  return InternedKey(key, interned_keys_.emplace(key, interned_keys_.size()).first->second);
+}
+
 MockOverrideLayer::MockOverrideLayer() {}
 
 MockOverrideLayer::~MockOverrideLayer() {}
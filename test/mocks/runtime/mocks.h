@@ -40,7 +40,28 @@ public:
                                           uint64_t random_value));
   MOCK_CONST_METHOD1(get, const std::string&(const std::string& key));
   MOCK_CONST_METHOD2(getInteger, uint64_t(const std::string& key, uint64_t default_value));
+  MOCK_CONST_METHOD2(getDouble, double(const std::string& key, double default_value));
   MOCK_CONST_METHOD0(getLayers, const std::vector<OverrideLayerConstPtr>&());
+
+  // Lookups of interned keys are forwarded to the mocks taking the key name, so that tests set
+  // expectations the same way for both.
+  bool featureEnabled(const InternedKey& key, uint64_t default_value) const override {
+    return featureEnabled(key.name(), default_value);
+  }
+  bool featureEnabled(const InternedKey& key, uint64_t default_value, uint64_t random_value,
+                      uint64_t num_buckets) const override {
+    return featureEnabled(key.name(), default_value, random_value, num_buckets);
+  }
+  bool featureEnabled(const InternedKey& key, const envoy::type::FractionalPercent& default_value,
+                      uint64_t random_value) const override {
+    return featureEnabled(key.name(), default_value, random_value);
+  }
+  uint64_t getInteger(const InternedKey& key, uint64_t default_value) const override {
+    return getInteger(key.name(), default_value);
+  }
+  double getDouble(const InternedKey& key, double default_value) const override {
+    return getDouble(key.name(), default_value);
+  }
 };
 
 class MockLoader : public Loader {
@@ -50,8 +71,10 @@ public:
 
   MOCK_METHOD0(snapshot, Snapshot&());
   MOCK_METHOD1(mergeValues, void(const std::unordered_map<std::string, std::string>&));
+  InternedKey internKey(const std::string& key) override;
 
   testing::NiceMock<MockSnapshot> snapshot_;
+  std::unordered_map<std::string, uint32_t> interned_keys_;
 };
 
 class MockOverrideLayer : public Snapshot::OverrideLayer {
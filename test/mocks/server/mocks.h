@@ -77,6 +77,7 @@ public:
   MOCK_CONST_METHOD0(maxStats, uint64_t());
   MOCK_CONST_METHOD0(statsOptions, const Stats::StatsOptions&());
   MOCK_CONST_METHOD0(hotRestartDisabled, bool());
+  MOCK_CONST_METHOD0(growableHotRestartStats, bool());
   MOCK_CONST_METHOD0(signalHandlingEnabled, bool());
   MOCK_CONST_METHOD0(mutexTracingEnabled, bool());
   MOCK_CONST_METHOD0(toCommandLineOptions, Server::CommandLineOptionsPtr());
@@ -93,6 +94,7 @@ public:
   uint32_t concurrency_{1};
   uint64_t hot_restart_epoch_{};
   bool hot_restart_disabled_{};
+  bool growable_hot_restart_stats_{};
   bool signal_handling_enabled_{true};
   bool mutex_tracing_enabled_{};
 };
@@ -196,6 +198,7 @@ public:
   MOCK_METHOD0(drainParentListeners, void());
   MOCK_METHOD1(duplicateParentListenSocket, int(const std::string& address));
   MOCK_METHOD1(getParentStats, void(GetParentStatsInfo& info));
+  MOCK_METHOD0(getParentTlsSessions, std::string());
   MOCK_METHOD2(initialize, void(Event::Dispatcher& dispatcher, Server::Instance& server));
   MOCK_METHOD1(shutdownParentAdmin, void(ShutdownParentAdminInfo& info));
   MOCK_METHOD0(terminateParent, void());
@@ -349,6 +352,9 @@ public:
   MOCK_METHOD0(singletonManager, Singleton::Manager&());
   MOCK_METHOD0(startTimeCurrentEpoch, time_t());
   MOCK_METHOD0(startTimeFirstEpoch, time_t());
+  MOCK_METHOD2(recordStartupPhase,
+               void(const std::string& name, std::chrono::microseconds duration));
+  MOCK_METHOD0(startupPhases, const std::vector<StartupPhase>&());
   MOCK_METHOD0(stats, Stats::Store&());
   MOCK_METHOD0(httpContext, Http::Context&());
   MOCK_METHOD0(threadLocal, ThreadLocal::Instance&());
@@ -381,6 +387,7 @@ public:
   testing::NiceMock<MockOverloadManager> overload_manager_;
   Singleton::ManagerPtr singleton_manager_;
   Http::ContextImpl http_context_;
+  std::vector<StartupPhase> startup_phases_;
 };
 
 namespace Configuration {
@@ -477,6 +484,7 @@ public:
 
   std::unique_ptr<Secret::SecretManager> secret_manager_;
   testing::NiceMock<Api::MockApi> api_;
+  Singleton::ManagerPtr singleton_manager_;
 };
 
 class MockListenerFactoryContext : public MockFactoryContext, public ListenerFactoryContext {
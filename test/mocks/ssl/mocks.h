@@ -28,6 +28,8 @@ public:
                                       const std::vector<std::string>& server_names));
   MOCK_CONST_METHOD0(daysUntilFirstCertExpires, size_t());
   MOCK_METHOD1(iterateContexts, void(std::function<void(const Context&)> callback));
+  MOCK_METHOD0(exportClientSessions, std::string());
+  MOCK_METHOD1(importClientSessions, void(const std::string& sessions));
 };
 
 class MockConnection : public Connection {
@@ -57,6 +59,7 @@ public:
   MOCK_CONST_METHOD0(daysUntilFirstCertExpires, size_t());
   MOCK_CONST_METHOD0(getCaCertInformation, CertificateDetailsPtr());
   MOCK_CONST_METHOD0(getCertChainInformation, std::vector<CertificateDetailsPtr>());
+  MOCK_CONST_METHOD0(getVerificationCacheInformation, std::vector<CertificateVerificationPtr>());
 };
 
 } // namespace Ssl
@@ -90,6 +90,8 @@ public:
   MOCK_CONST_METHOD0(locality, const envoy::api::v2::core::Locality&());
   MOCK_CONST_METHOD0(priority, uint32_t());
   MOCK_METHOD1(priority, void(uint32_t));
+  MOCK_CONST_METHOD2(recordResponseTime, void(std::chrono::microseconds, MonotonicTime));
+  MOCK_CONST_METHOD1(peakEwmaResponseTime, double(MonotonicTime));
 
   std::string hostname_;
   Network::Address::InstanceConstSharedPtr address_;
@@ -163,6 +165,8 @@ public:
   MOCK_CONST_METHOD0(locality, const envoy::api::v2::core::Locality&());
   MOCK_CONST_METHOD0(priority, uint32_t());
   MOCK_METHOD1(priority, void(uint32_t));
+  MOCK_CONST_METHOD2(recordResponseTime, void(std::chrono::microseconds, MonotonicTime));
+  MOCK_CONST_METHOD1(peakEwmaResponseTime, double(MonotonicTime));
 
   testing::NiceMock<MockClusterInfo> cluster_;
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
@@ -0,0 +1,141 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/network/address_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/listen_socket_impl.h"
+
+#include "server/listener_manager_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::InvokeWithoutArgs;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+// Connections requesting a server name matching an exact name, matching a wildcard, and matching
+// nothing.
+std::vector<std::unique_ptr<Network::ConnectionSocket>> exact_sockets;
+std::vector<std::unique_ptr<Network::ConnectionSocket>> wildcard_sockets;
+std::vector<std::unique_ptr<Network::ConnectionSocket>> unknown_sockets;
+
+/**
+ * A listener manager whose listener has 2,500 filter chains matching 5,000 server names: an exact
+ * name and a wildcard domain each, spread over 50 parent domains.
+ */
+class FilterChainSpeedTest {
+public:
+  FilterChainSpeedTest() : api_(Api::createApiForTest()) {
+    ON_CALL(server_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(listener_factory_, createDrainManager_(_))
+        .WillByDefault(InvokeWithoutArgs([]() { return new NiceMock<MockDrainManager>(); }));
+    manager_ = std::make_unique<ListenerManagerImpl>(server_, listener_factory_, worker_factory_);
+
+    // Two versions of the listener, so that every update builds a new listener.
+    for (size_t i = 0; i < 2; i++) {
+      envoy::api::v2::Listener& config = configs_[i];
+      config.set_name("speed_test");
+      config.mutable_address()->mutable_socket_address()->set_address("127.0.0.1");
+      config.mutable_address()->mutable_socket_address()->set_port_value(1234);
+      config.mutable_per_connection_buffer_limit_bytes()->set_value(1024 * (i + 1));
+    }
+    for (size_t domain = 0; domain < 50; domain++) {
+      for (size_t service = 0; service < 50; service++) {
+        const std::string name =
+            absl::StrCat("service-", service, ".domain-", domain, ".example.com");
+        for (envoy::api::v2::Listener& config : configs_) {
+          auto* match = config.add_filter_chains()->mutable_filter_chain_match();
+          match->add_server_names(name);
+          match->add_server_names(absl::StrCat("*.", name));
+        }
+        exact_sockets.push_back(createSocket(name));
+        wildcard_sockets.push_back(createSocket(absl::StrCat("pod-", service, ".", name)));
+        unknown_sockets.push_back(createSocket(
+            absl::StrCat("service-", service, ".domain-", domain, ".example.org")));
+      }
+    }
+
+    manager_->addOrUpdateListener(configs_[0], "", true);
+  }
+
+  std::unique_ptr<Network::ConnectionSocket> createSocket(const std::string& server_name) {
+    auto socket = std::make_unique<Network::ConnectionSocketImpl>(
+        std::make_unique<Network::IoSocketHandle>(), local_address_, remote_address_);
+    socket->setDetectedTransportProtocol("tls");
+    socket->setRequestedServerName(server_name);
+    return socket;
+  }
+
+  const Network::FilterChainManager& filterChainManager() {
+    return manager_->listeners().back().get().filterChainManager();
+  }
+
+  NiceMock<MockInstance> server_;
+  NiceMock<MockListenerComponentFactory> listener_factory_;
+  NiceMock<MockWorkerFactory> worker_factory_;
+  Api::ApiPtr api_;
+  std::unique_ptr<ListenerManagerImpl> manager_;
+  envoy::api::v2::Listener configs_[2];
+  const Network::Address::InstanceConstSharedPtr local_address_{
+      new Network::Address::Ipv4Instance("127.0.0.1", 1234)};
+  const Network::Address::InstanceConstSharedPtr remote_address_{
+      new Network::Address::Ipv4Instance("10.0.0.1", 4321)};
+};
+
+FilterChainSpeedTest* speed_test;
+
+} // namespace
+
+// Listener update, i.e. building the filter chains of the new listener and destroying the old one.
+static void BM_ListenerUpdate(benchmark::State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    i++;
+    speed_test->manager_->addOrUpdateListener(speed_test->configs_[i % 2], "", true);
+  }
+}
+BENCHMARK(BM_ListenerUpdate)->Unit(benchmark::kMillisecond);
+
+static void
+BM_FindFilterChain(benchmark::State& state,
+                   const std::vector<std::unique_ptr<Network::ConnectionSocket>>& sockets) {
+  const Network::FilterChainManager& filter_chain_manager = speed_test->filterChainManager();
+  size_t i = 0;
+  size_t matches = 0;
+  for (auto _ : state) {
+    i = (i + 1) % sockets.size();
+    matches += filter_chain_manager.findFilterChain(*sockets[i]) != nullptr;
+  }
+  benchmark::DoNotOptimize(matches);
+}
+BENCHMARK_CAPTURE(BM_FindFilterChain, Exact, exact_sockets);
+BENCHMARK_CAPTURE(BM_FindFilterChain, Wildcard, wildcard_sockets);
+BENCHMARK_CAPTURE(BM_FindFilterChain, Unknown, unknown_sockets);
+
+} // namespace Server
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Server::FilterChainSpeedTest fixture;
+  Envoy::Server::speed_test = &fixture;
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
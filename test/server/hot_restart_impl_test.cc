@@ -2,6 +2,7 @@
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/hex.h"
+#include "common/stats/growable_raw_stat_data_allocator.h"
 
 #include "server/hot_restart_impl.h"
 
@@ -151,6 +152,98 @@ TEST_F(HotRestartImplTest, allocFail) {
   EXPECT_EQ(s3, nullptr);
 }
 
+class HotRestartImplGrowableStatsTest : public HotRestartImplTest {
+public:
+  HotRestartImplGrowableStatsTest() : stats_region_(new uint8_t[StatsRegionSize]()) {
+    ON_CALL(options_, growableHotRestartStats()).WillByDefault(Return(true));
+    ON_CALL(options_, statsOptions()).WillByDefault(ReturnRef(stats_options_));
+  }
+
+  // Expects the shared memory segment and the stats region to be opened and mapped, resizing the
+  // stats region within stats_region_ if we are the first process.
+  void expectMapping(bool first) {
+    EXPECT_CALL(os_sys_calls_, shmOpen(_, _, _))
+        .Times(2)
+        .WillRepeatedly(WithArg<0>(Invoke([](const char* name) {
+          return Api::SysCallIntResult{
+              absl::StartsWith(name, "/envoy_stats_memory_") ? StatsRegionFd : SharedMemoryFd, 0};
+        })));
+    // The stats region is closed along with the hot restarter.
+    EXPECT_CALL(os_sys_calls_, close(StatsRegionFd)).RetiresOnSaturation();
+    EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, _, _))
+        .Times(2)
+        .WillRepeatedly(WithArg<1>(Invoke([this](size_t length) {
+          if (length == HotRestartImpl::STATS_REGION_RESERVED_SIZE) {
+            return Api::SysCallPtrResult{stats_region_.get(), 0};
+          }
+          return Api::SysCallPtrResult{buffer_.data(), 0};
+        })));
+    if (first) {
+      EXPECT_CALL(os_sys_calls_, shmUnlink(_)).Times(2);
+      EXPECT_CALL(os_sys_calls_, ftruncate(_, _))
+          .WillOnce(WithArg<1>(Invoke([this](off_t size) {
+            buffer_.resize(size);
+            return Api::SysCallIntResult{0, 0};
+          })))
+          .WillRepeatedly(WithArg<1>(Invoke([this](off_t size) {
+            stats_region_size_ = size;
+            return Api::SysCallIntResult{size <= StatsRegionSize ? 0 : -1, 0};
+          })));
+    }
+    EXPECT_CALL(os_sys_calls_, bind(_, _, _));
+  }
+
+  static constexpr off_t StatsRegionSize = 4 * 1024 * 1024;
+  static constexpr int SharedMemoryFd = 10;
+  static constexpr int StatsRegionFd = 11;
+
+  std::unique_ptr<uint8_t[]> stats_region_;
+  off_t stats_region_size_{};
+};
+
+constexpr off_t HotRestartImplGrowableStatsTest::StatsRegionSize;
+constexpr int HotRestartImplGrowableStatsTest::SharedMemoryFd;
+constexpr int HotRestartImplGrowableStatsTest::StatsRegionFd;
+
+TEST_F(HotRestartImplGrowableStatsTest, versionString) {
+  expectMapping(true);
+  hot_restart_ = std::make_unique<HotRestartImpl>(options_);
+
+  const std::string version = hot_restart_->version();
+  EXPECT_TRUE(absl::StartsWith(version, fmt::format("{}.", SharedMemory::VERSION))) << version;
+  EXPECT_EQ(version, HotRestartImpl::hotRestartVersion(options_.maxStats(),
+                                                       stats_options_.maxNameLength(), true));
+  EXPECT_NE(version, HotRestartImpl::hotRestartVersion(options_.maxStats(),
+                                                       stats_options_.maxNameLength(), false));
+  // The number of stats and their name length don't matter with a growable stats region.
+  EXPECT_EQ(version, HotRestartImpl::hotRestartVersion(2 * options_.maxStats(),
+                                                       2 * stats_options_.maxNameLength(), true));
+}
+
+// Stats are neither limited by --max-stats nor truncated, and are shared with the next process.
+TEST_F(HotRestartImplGrowableStatsTest, crossAlloc) {
+  EXPECT_CALL(options_, maxStats()).WillRepeatedly(Return(2));
+  expectMapping(true);
+  hot_restart_ = std::make_unique<HotRestartImpl>(options_);
+  EXPECT_FALSE(hot_restart_->statsAllocator().requiresBoundedStatNameSize());
+
+  const std::string long_name(stats_options_.maxNameLength() + 1, 'A');
+  std::vector<Stats::RawStatData*> stats;
+  for (uint64_t i = 0; i < 10000; i++) {
+    stats.push_back(hot_restart_->statsAllocator().alloc(fmt::format("{}.{}", long_name, i)));
+    ASSERT_NE(stats.back(), nullptr);
+  }
+  EXPECT_EQ(fmt::format("{}.0", long_name), stats[0]->key());
+  EXPECT_GT(stats_region_size_, Stats::GrowableRawStatDataAllocator::MinRegionSize);
+
+  EXPECT_CALL(options_, restartEpoch()).WillRepeatedly(Return(1));
+  expectMapping(false);
+  HotRestartImpl hot_restart2(options_);
+  for (uint64_t i = 0; i < stats.size(); i++) {
+    EXPECT_EQ(stats[i], hot_restart2.statsAllocator().alloc(fmt::format("{}.{}", long_name, i)));
+  }
+}
+
 // Because the shared memory is managed manually, make sure it meets
 // basic requirements:
 //   - Objects are correctly aligned so that std::atomic works properly
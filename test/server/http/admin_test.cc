@@ -877,7 +877,8 @@ TEST_P(AdminInstanceTest, ContextThatReturnsNullCertDetails) {
  "certificates": [
   {
    "ca_cert": [],
-   "cert_chain": []
+   "cert_chain": [],
+   "verification_cache": []
   }
  ]
 }
@@ -886,6 +887,7 @@ TEST_P(AdminInstanceTest, ContextThatReturnsNullCertDetails) {
   // Validate that cert details are null and /certs handles it correctly.
   EXPECT_EQ(nullptr, client_ctx->getCaCertInformation());
   EXPECT_TRUE(client_ctx->getCertChainInformation().empty());
+  EXPECT_TRUE(client_ctx->getVerificationCacheInformation().empty());
   EXPECT_EQ(Http::Code::OK, getCallback("/certs", header_map, response));
   EXPECT_EQ(expected_empty_json, response.toString());
 }
@@ -1132,6 +1134,8 @@ TEST_P(AdminInstanceTest, GetRequest) {
   }));
   NiceMock<Init::MockManager> initManager;
   ON_CALL(server_, initManager()).WillByDefault(ReturnRef(initManager));
+  server_.startup_phases_ = {{"bootstrap", std::chrono::microseconds(1500)},
+                             {"warming", std::chrono::microseconds(2000000)}};
 
   {
     Http::HeaderMapImpl response_headers;
@@ -1149,6 +1153,11 @@ TEST_P(AdminInstanceTest, GetRequest) {
     EXPECT_EQ(server_info_proto.state(), envoy::admin::v2alpha::ServerInfo::LIVE);
     EXPECT_EQ(server_info_proto.command_line_options().restart_epoch(), 2);
     EXPECT_EQ(server_info_proto.command_line_options().service_cluster(), "cluster");
+    ASSERT_EQ(2, server_info_proto.startup_phases_size());
+    EXPECT_EQ("bootstrap", server_info_proto.startup_phases(0).name());
+    EXPECT_EQ(1500000, server_info_proto.startup_phases(0).duration().nanos());
+    EXPECT_EQ("warming", server_info_proto.startup_phases(1).name());
+    EXPECT_EQ(2, server_info_proto.startup_phases(1).duration().seconds());
   }
 
   {
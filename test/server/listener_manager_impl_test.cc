@@ -2112,6 +2112,33 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, SingleFilterChainWithInvalidServe
                             "supported in \"server_names\"");
 }
 
+// "*." and wildcards with empty labels would match names other than subdomains, so they are
+// rejected.
+TEST_F(ListenerManagerImplWithRealFiltersTest, SingleFilterChainWithEmptyWildcardLabelMatch) {
+  const std::string yaml = TestEnvironment::substitute(R"EOF(
+    address:
+      socket_address: { address: 127.0.0.1, port_value: 1234 }
+    listener_filters:
+    - name: "envoy.listener.tls_inspector"
+      config: {}
+    filter_chains:
+    - filter_chain_match: {}
+  )EOF",
+                                                       Network::Address::IpVersion::v4);
+  envoy::api::v2::Listener listener = parseListenerFromV2Yaml(yaml);
+
+  for (const std::string server_name : {"*.", "*..example.com", "*.example..com"}) {
+    auto* filter_chain_match = listener.mutable_filter_chains(0)->mutable_filter_chain_match();
+    filter_chain_match->clear_server_names();
+    filter_chain_match->add_server_names(server_name);
+    EXPECT_THROW_WITH_MESSAGE(
+        manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+        fmt::format("error adding listener '127.0.0.1:1234': wildcard server name '{}' has an "
+                    "empty domain label in \"server_names\"",
+                    server_name));
+  }
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, MultipleFilterChainsWithSameMatch) {
   const std::string yaml = TestEnvironment::substitute(R"EOF(
     address:
@@ -31,7 +31,7 @@ public:
       argv.push_back(s.c_str());
     }
     return std::make_unique<OptionsImpl>(argv.size(), argv.data(),
-                                         [](uint64_t, uint64_t, bool) { return "1"; },
+                                         [](uint64_t, uint64_t, bool, bool) { return "1"; },
                                          spdlog::level::warn);
   }
 };
@@ -66,7 +66,7 @@ TEST_F(OptionsImplTest, All) {
       "--service-cluster cluster --service-node node --service-zone zone "
       "--file-flush-interval-msec 9000 "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 --log-path /foo/bar "
-      "--disable-hot-restart");
+      "--disable-hot-restart --growable-hot-restart-stats");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
   EXPECT_EQ("hello", options->configPath());
@@ -84,6 +84,7 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ(std::chrono::seconds(60), options->drainTime());
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
   EXPECT_EQ(true, options->hotRestartDisabled());
+  EXPECT_EQ(true, options->growableHotRestartStats());
 
   options = createOptionsImpl("envoy --mode init_only");
   EXPECT_EQ(Server::Mode::InitOnly, options->mode());
@@ -117,6 +118,7 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setMaxStats(12345);
   options->setStatsOptions(stats_options);
   options->setHotRestartDisabled(!options->hotRestartDisabled());
+  options->setGrowableHotRestartStats(!options->growableHotRestartStats());
   options->setSignalHandling(!options->signalHandlingEnabled());
 
   EXPECT_EQ(109876, options->baseId());
@@ -140,6 +142,7 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(stats_options.max_obj_name_length_, options->statsOptions().maxObjNameLength());
   EXPECT_EQ(stats_options.max_stat_suffix_length_, options->statsOptions().maxStatSuffixLength());
   EXPECT_EQ(!hot_restart_disabled, options->hotRestartDisabled());
+  EXPECT_TRUE(options->growableHotRestartStats());
   EXPECT_EQ(!signal_handling_enabled, options->signalHandlingEnabled());
 
   // Validate that CommandLineOptions is constructed correctly.
@@ -170,6 +173,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->maxStats(), command_line_options->max_stats());
   EXPECT_EQ(options->statsOptions().maxObjNameLength(), command_line_options->max_obj_name_len());
   EXPECT_EQ(options->hotRestartDisabled(), command_line_options->disable_hot_restart());
+  EXPECT_EQ(options->growableHotRestartStats(),
+            command_line_options->growable_hot_restart_stats());
   EXPECT_EQ(options->mutexTracingEnabled(), command_line_options->enable_mutex_tracing());
 }
 
@@ -303,6 +308,8 @@ TEST_F(OptionsImplTest, SaneTestConstructor) {
   EXPECT_EQ(regular_options_impl->statsOptions().maxStatSuffixLength(),
             test_options_impl.statsOptions().maxStatSuffixLength());
   EXPECT_EQ(regular_options_impl->hotRestartDisabled(), test_options_impl.hotRestartDisabled());
+  EXPECT_EQ(regular_options_impl->growableHotRestartStats(),
+            test_options_impl.growableHotRestartStats());
 }
 
 } // namespace Envoy
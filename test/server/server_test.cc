@@ -54,6 +54,36 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, source);
 }
 
+// Validate that a bootstrap with enough static resources to be validated on several threads
+// reports the first invalid resource, and is left unchanged.
+TEST(ServerInstanceUtil, ValidateBootstrapOnThreads) {
+  envoy::config::bootstrap::v2::Bootstrap bootstrap;
+  for (int i = 0; i < 512; i++) {
+    envoy::api::v2::Cluster& cluster = *bootstrap.mutable_static_resources()->add_clusters();
+    cluster.set_name(fmt::format("cluster_{}", i));
+    cluster.mutable_connect_timeout()->set_seconds(i + 1);
+  }
+  const envoy::config::bootstrap::v2::Bootstrap original = bootstrap;
+  EXPECT_NO_THROW(InstanceUtil::validateBootstrap(bootstrap, 4, Thread::threadFactoryForTest()));
+  EXPECT_TRUE(TestUtility::protoEqual(original, bootstrap));
+
+  bootstrap.mutable_static_resources()->mutable_clusters(300)->clear_name();
+  bootstrap.mutable_static_resources()->mutable_clusters(400)->clear_name();
+  EXPECT_THROW_WITH_REGEX(
+      InstanceUtil::validateBootstrap(bootstrap, 4, Thread::threadFactoryForTest()),
+      ProtoValidationException, "ClusterValidationError.Name(.|\n)*seconds: 301");
+  EXPECT_EQ(512, bootstrap.static_resources().clusters_size());
+
+  // Errors outside of the static resources are still reported.
+  bootstrap.mutable_static_resources()->mutable_clusters(300)->set_name("cluster_300");
+  bootstrap.mutable_static_resources()->mutable_clusters(400)->set_name("cluster_400");
+  bootstrap.mutable_runtime();
+  EXPECT_THROW_WITH_REGEX(
+      InstanceUtil::validateBootstrap(bootstrap, 4, Thread::threadFactoryForTest()),
+      ProtoValidationException, "BootstrapValidationError.Runtime");
+  EXPECT_EQ(512, bootstrap.static_resources().clusters_size());
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {
@@ -202,6 +232,18 @@ TEST_P(ServerInstanceImplTest, Stats) {
 }
 
 // Validate server localInfo() from bootstrap Node.
+// Validate that the time taken by the phases of startup is recorded.
+TEST_P(ServerInstanceImplTest, StartupPhases) {
+  initialize("test/server/empty_bootstrap.yaml");
+  std::vector<std::string> phase_names;
+  for (const StartupPhase& phase : server_->startupPhases()) {
+    phase_names.push_back(phase.name_);
+  }
+  EXPECT_EQ(std::vector<std::string>({"bootstrap", "server_setup", "static_secrets",
+                                      "static_clusters", "static_listeners"}),
+            phase_names);
+}
+
 TEST_P(ServerInstanceImplTest, BootstrapNode) {
   initialize("test/server/node_bootstrap.yaml");
   EXPECT_EQ("bootstrap_zone", server_->localInfo().zoneName());
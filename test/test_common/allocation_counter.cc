@@ -0,0 +1,50 @@
+#include "test/test_common/allocation_counter.h"
+
+#include <atomic>
+
+#include "common/common/macros.h"
+
+#ifdef TCMALLOC
+#include "gperftools/malloc_hook.h"
+#endif
+
+namespace Envoy {
+namespace Memory {
+namespace TestUtil {
+
+namespace {
+
+#ifdef TCMALLOC
+std::atomic<uint64_t> allocation_count{0};
+
+void countAllocation(const void*, size_t) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Adds the hook on first use, so that only the binaries using the counter pay for it.
+uint64_t currentAllocations() {
+  static const bool hook_added = MallocHook::AddNewHook(&countAllocation);
+  UNREFERENCED_PARAMETER(hook_added);
+  return allocation_count.load(std::memory_order_relaxed);
+}
+#else
+uint64_t currentAllocations() { return 0; }
+#endif
+
+} // namespace
+
+AllocationCounter::AllocationCounter() : start_(currentAllocations()) {}
+
+uint64_t AllocationCounter::allocations() const { return currentAllocations() - start_; }
+
+bool AllocationCounter::supported() {
+#ifdef TCMALLOC
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace TestUtil
+} // namespace Memory
+} // namespace Envoy
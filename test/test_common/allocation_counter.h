@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Envoy {
+namespace Memory {
+namespace TestUtil {
+
+/**
+ * Counts the heap allocations made by all threads since its construction, e.g. to measure the
+ * allocations of a code path in benchmarks. Allocations can only be counted when built with
+ * tcmalloc, see supported().
+ */
+class AllocationCounter {
+public:
+  AllocationCounter();
+
+  /**
+   * @return uint64_t the number of allocations since the counter was constructed, or 0 if
+   *         allocations can't be counted.
+   */
+  uint64_t allocations() const;
+
+  /**
+   * @return bool whether allocations can be counted in this build.
+   */
+  static bool supported();
+
+private:
+  const uint64_t start_;
+};
+
+} // namespace TestUtil
+} // namespace Memory
+} // namespace Envoy
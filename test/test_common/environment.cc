@@ -164,7 +164,7 @@ std::vector<Network::Address::IpVersion> TestEnvironment::getIpVersionsForTest()
 
 Server::Options& TestEnvironment::getOptions() {
   static OptionsImpl* options = new OptionsImpl(
-      argc_, argv_, [](uint64_t, uint64_t, bool) { return "1"; }, spdlog::level::err);
+      argc_, argv_, [](uint64_t, uint64_t, bool, bool) { return "1"; }, spdlog::level::err);
   return *options;
 }
 